@@ -11,7 +11,15 @@
 package com.example.blur
 
 import android.graphics.Bitmap
+import android.os.Build
 import androidx.test.ext.junit.runners.AndroidJUnit4
+import com.example.liquidglass.AsyncRenderer
+import com.example.liquidglass.DispersionMapGenerator
+import com.example.liquidglass.NativeChromaticAberration
+import com.example.liquidglass.DisplacementMode
+import com.example.liquidglass.HardwareBufferRenderer
+import com.example.liquidglass.NativeDisplacementMap
+import com.example.liquidglass.NativeGlassPipeline
 import org.junit.Assert.*
 import org.junit.Test
 import org.junit.runner.RunWith
@@ -116,6 +124,27 @@ class NativeGaussTest {
         bitmap2.recycle()
     }
     
+    /**
+     * 测试：线性模式查表转换 - 纯色（含半透明）模糊后保持不变，标量与 NEON 一致
+     */
+    @Test
+    fun testLinearBlurFlatTranslucent() {
+        val color = android.graphics.Color.argb(128, 120, 200, 40)
+        val scalar = createSolidBitmap(64, 64, color)
+        val neon = createSolidBitmap(64, 64, color)
+        val expected = scalar.getPixel(32, 32)
+
+        NativeGauss.gaussianIIRInplace(scalar, 8f, true)
+        NativeGauss.gaussianIIRNeonInplace(neon, 8f, true)
+
+        assertEquals(expected, scalar.getPixel(32, 32))
+        assertEquals(expected, neon.getPixel(32, 32))
+        assertEquals(expected, neon.getPixel(0, 63))
+
+        scalar.recycle()
+        neon.recycle()
+    }
+    
     /**
      * 测试：IIR vs Box3 近似质量
      */
@@ -201,6 +230,762 @@ class NativeGaussTest {
         largeBitmap.recycle()
     }
     
+    /**
+     * 测试：临时缓冲池复用与释放
+     */
+    @Test
+    fun testScratchReuseAndRelease() {
+        val bitmap1 = createTestPattern(128, 128)
+        val bitmap2 = bitmap1.copy(Bitmap.Config.ARGB_8888, true)
+        
+        NativeGauss.prewarmScratch(128, 128)
+        NativeGauss.box3Inplace(bitmap1, 6)
+        
+        // 缓冲归还到池中，释放后应有字节被回收
+        assertTrue(NativeGauss.releaseScratch() > 0)
+        
+        // 释放后再次调用应重新分配并得到相同结果
+        NativeGauss.box3Inplace(bitmap2, 6)
+        assertTrue(bitmapsEqual(bitmap1, bitmap2))
+        
+        bitmap1.recycle()
+        bitmap2.recycle()
+    }
+
+    /**
+     * 测试：分阶段性能统计记录 IIR 各阶段
+     */
+    @Test
+    fun testStageStats() {
+        val bitmap = createTestPattern(128, 128)
+
+        NativeGauss.resetStats()
+        NativeGauss.gaussianIIRInplace(bitmap, 6.0f, false)
+
+        val stats = NativeGauss.getStats().filter { it.filter == "IIR" }
+        val total = stats.firstOrNull { it.stage == "total" }
+        assertNotNull(total)
+        assertEquals(1L, total!!.count)
+        assertTrue(total.totalNs > 0)
+        assertTrue(stats.any { it.stage == "horizontal" } && stats.any { it.stage == "vertical" })
+
+        // 清空后不再有条目
+        NativeGauss.resetStats()
+        assertTrue(NativeGauss.getStats().isEmpty())
+
+        bitmap.recycle()
+    }
+
+    /**
+     * 测试：FP16 半精度 IIR 与 FP32 版本最大误差 ≤ 2 LSB（不支持 FP16 时走回退路径，结果相同）
+     */
+    @Test
+    fun testFp16MatchesFp32() {
+        for (sigma in floatArrayOf(2f, 12f, 32f)) {
+            val expected = createTestPattern(131, 77)
+            val actual = expected.copy(Bitmap.Config.ARGB_8888, true)
+
+            if (NativeGauss.hasNeonSupport()) {
+                NativeGauss.gaussianIIRNeonInplace(expected, sigma, false)
+            } else {
+                NativeGauss.gaussianIIRInplace(expected, sigma, false)
+            }
+            NativeGauss.gaussianIIRFp16Inplace(actual, sigma)
+
+            var maxDiff = 0
+            for (y in 0 until expected.height) {
+                for (x in 0 until expected.width) {
+                    val p1 = expected.getPixel(x, y)
+                    val p2 = actual.getPixel(x, y)
+                    for (shift in intArrayOf(0, 8, 16, 24)) {
+                        maxDiff = maxOf(maxDiff, abs(((p1 shr shift) and 0xFF) - ((p2 shr shift) and 0xFF)))
+                    }
+                }
+            }
+            assertTrue("sigma=$sigma maxDiff=$maxDiff", maxDiff <= 2)
+
+            expected.recycle()
+            actual.recycle()
+        }
+    }
+
+    /**
+     * 测试：金字塔模糊保持纯色不变，且与同 σ 的 IIR 模糊程度一致（PSNR > 35 dB）
+     */
+    @Test
+    fun testPyramidBlurMatchesIIR() {
+        val solid = createSolidBitmap(157, 93, 0xFF808080.toInt())
+        NativeGauss.pyramidBlurInplace(solid, 20f)
+        assertEquals(0xFF808080.toInt(), solid.getPixel(0, 0))
+        assertEquals(0xFF808080.toInt(), solid.getPixel(156, 92))
+        solid.recycle()
+
+        for (sigma in floatArrayOf(8f, 24f)) {
+            val expected = createTestPattern(301, 203)
+            val actual = expected.copy(Bitmap.Config.ARGB_8888, true)
+
+            NativeGauss.gaussianIIRInplace(expected, sigma, false)
+            NativeGauss.pyramidBlurInplace(actual, sigma)
+
+            val psnr = calculatePSNR(expected, actual)
+            assertTrue("sigma=$sigma PSNR=$psnr", psnr > 35.0)
+
+            expected.recycle()
+            actual.recycle()
+        }
+    }
+
+    /**
+     * 测试：定点双线性缩放 2× 降采样等于 2×2 块平均（±1 LSB），尺寸相同时逐位复制
+     */
+    @Test
+    fun testResizeBilinearHalf() {
+        val source = createTestPattern(64, 48)
+        val half = Bitmap.createBitmap(32, 24, Bitmap.Config.ARGB_8888)
+        NativeGauss.resizeBilinear(source, half)
+
+        var maxDiff = 0
+        for (y in 0 until 24) {
+            for (x in 0 until 32) {
+                val expected = (0 until 4).sumOf { k ->
+                    source.getPixel(2 * x + (k and 1), 2 * y + (k shr 1)) and 0xFF
+                } / 4.0
+                maxDiff = maxOf(maxDiff, abs((half.getPixel(x, y) and 0xFF) - expected).toInt())
+            }
+        }
+        assertTrue("maxDiff=$maxDiff", maxDiff <= 1)
+
+        val copy = Bitmap.createBitmap(64, 48, Bitmap.Config.ARGB_8888)
+        NativeGauss.resizeBilinear(source, copy)
+        assertTrue(bitmapsEqual(source, copy))
+
+        source.recycle()
+        half.recycle()
+        copy.recycle()
+    }
+
+    /**
+     * 测试：色差的红色偏移作用于红色通道（蓝色通道不动）
+     */
+    @Test
+    fun testAberrationRedOffsetChannel() {
+        val w = 48
+        val h = 32
+        val source = Bitmap.createBitmap(w, h, Bitmap.Config.ARGB_8888)
+        for (y in 0 until h) {
+            for (x in 0 until w) {
+                source.setPixel(x, y, android.graphics.Color.rgb(x * 4, 0, x * 4))
+            }
+        }
+        // 位移贴图 128 为中心点：无位移，只剩通道偏移
+        val displacement = createSolidBitmap(w, h, android.graphics.Color.rgb(128, 128, 128))
+
+        val result = NativeChromaticAberration.apply(
+            source, displacement,
+            intensity = 1f, scale = 20f,
+            redOffset = 2f, greenOffset = 0f, blueOffset = 0f,
+            useBilinear = false
+        )
+
+        val px = result.getPixel(20, 10)
+        assertEquals(22 * 4, android.graphics.Color.red(px))
+        assertEquals(20 * 4, android.graphics.Color.blue(px))
+
+        source.recycle()
+        displacement.recycle()
+        result.recycle()
+    }
+
+    /**
+     * 测试：融合管线（仅模糊）与单独调用 Box3 结果一致，且不修改背景
+     */
+    @Test
+    fun testGlassPipelineMatchesBox3() {
+        val backdrop = createTestPattern(96, 96)
+        val original = backdrop.copy(Bitmap.Config.ARGB_8888, true)
+        val expected = backdrop.copy(Bitmap.Config.ARGB_8888, true)
+        val result = Bitmap.createBitmap(96, 96, Bitmap.Config.ARGB_8888)
+        
+        // σ = 5 → Box3 半径 6
+        NativeGauss.box3Inplace(expected, 6)
+        NativeGlassPipeline.render(
+            backdrop = backdrop,
+            result = result,
+            blurMode = NativeGlassPipeline.BLUR_BOX3,
+            sigma = 5f
+        )
+        
+        assertTrue(bitmapsEqual(expected, result))
+        assertTrue(bitmapsEqual(original, backdrop))
+        
+        backdrop.recycle()
+        original.recycle()
+        expected.recycle()
+        result.recycle()
+    }
+
+    /**
+     * 测试：背景局部变化时，增量管线（Box3 + 色差）与整帧重算逐位一致
+     */
+    @Test
+    fun testGlassPipelineRegionMatchesFull() {
+        val w = 120
+        val h = 90
+        val before = createTestPattern(w, h)
+        val after = before.copy(Bitmap.Config.ARGB_8888, true)
+        for (y in 40 until 50) {
+            for (x in 30 until 42) {
+                after.setPixel(x, y, 0xFFFF0000.toInt())
+            }
+        }
+        val displacement = createTestPattern(w, h)
+        val blurred = Bitmap.createBitmap(w, h, Bitmap.Config.ARGB_8888)
+        val result = Bitmap.createBitmap(w, h, Bitmap.Config.ARGB_8888)
+        val expected = Bitmap.createBitmap(w, h, Bitmap.Config.ARGB_8888)
+
+        val damage = NativeGlassPipeline.computeDamage(before, after)
+        assertEquals(android.graphics.Rect(30, 40, 42, 50), damage)
+        assertNull(NativeGlassPipeline.computeDamage(before, before))
+
+        fun render(backdrop: Bitmap, rect: android.graphics.Rect) {
+            NativeGlassPipeline.renderGlassPipelineRegion(
+                backdrop, displacement, null, null, blurred, result,
+                rect.left, rect.top, rect.right, rect.bottom,
+                NativeGlassPipeline.BLUR_BOX3, 3f, false, 1.2f,
+                NativeGlassPipeline.EFFECT_ABERRATION, 20f, 1f, -0.5f, -1f,
+                100f, 1.5f, 7f, 1f, true
+            )
+        }
+        render(before, android.graphics.Rect(0, 0, w, h))
+        render(after, damage!!)
+        NativeGlassPipeline.render(
+            backdrop = after,
+            result = expected,
+            blurMode = NativeGlassPipeline.BLUR_BOX3,
+            sigma = 3f,
+            saturation = 1.2f,
+            effect = NativeGlassPipeline.EFFECT_ABERRATION,
+            displacement = displacement,
+            scale = 20f,
+            redOffset = 1f,
+            greenOffset = -0.5f,
+            blueOffset = -1f
+        )
+
+        assertTrue(bitmapsEqual(expected, result))
+
+        before.recycle()
+        after.recycle()
+        displacement.recycle()
+        blurred.recycle()
+        result.recycle()
+        expected.recycle()
+    }
+
+    /**
+     * 测试：线性色彩空间 IIR 下，硬边缘色块背景的增量管线与整帧重算相差 ≤ 2 LSB（暗部放大截断误差的最坏情形）
+     */
+    @Test
+    fun testGlassPipelineRegionLinearHardEdges() {
+        val w = 400
+        val h = 300
+        val before = createHardEdgeBlocks(w, h)
+        val after = before.copy(Bitmap.Config.ARGB_8888, true)
+        val damage = android.graphics.Rect(190, 140, 210, 155)
+        for (y in damage.top until damage.bottom) {
+            for (x in damage.left until damage.right) {
+                after.setPixel(x, y, if ((x / 5 + y / 5) % 2 == 0) 0xFF000000.toInt() else 0xFFFFFFFF.toInt())
+            }
+        }
+        val result = Bitmap.createBitmap(w, h, Bitmap.Config.ARGB_8888)
+        val expected = Bitmap.createBitmap(w, h, Bitmap.Config.ARGB_8888)
+
+        for (sigma in floatArrayOf(1f, 2f, 5f)) {
+            fun render(backdrop: Bitmap, rect: android.graphics.Rect) {
+                NativeGlassPipeline.renderGlassPipelineRegion(
+                    backdrop, null, null, null, null, result,
+                    rect.left, rect.top, rect.right, rect.bottom,
+                    NativeGlassPipeline.BLUR_IIR, sigma, true, 1f,
+                    NativeGlassPipeline.EFFECT_NONE, 0f, 0f, 0f, 0f,
+                    100f, 1.5f, 7f, 1f, true
+                )
+            }
+            render(before, android.graphics.Rect(0, 0, w, h))
+            render(after, damage)
+            NativeGlassPipeline.render(
+                backdrop = after,
+                result = expected,
+                blurMode = NativeGlassPipeline.BLUR_IIR,
+                sigma = sigma,
+                highQuality = true
+            )
+
+            val maxDiff = maxChannelDiff(expected, result)
+            assertTrue("sigma=$sigma maxDiff=$maxDiff", maxDiff <= 2)
+        }
+
+        before.recycle()
+        after.recycle()
+        result.recycle()
+        expected.recycle()
+    }
+
+    /**
+     * 测试：圆角遮罩下可见像素与整帧结果逐位一致（Box3 + 色差），遮罩外的像素不被色差写入
+     */
+    @Test
+    fun testGlassPipelineMaskSkipsInvisiblePixels() {
+        val w = 120
+        val h = 90
+        val backdrop = createTestPattern(w, h)
+        val displacement = createTestPattern(w, h)
+        val expected = Bitmap.createBitmap(w, h, Bitmap.Config.ARGB_8888)
+        val result = Bitmap.createBitmap(w, h, Bitmap.Config.ARGB_8888)
+        val sentinel = 0xFF123456.toInt()
+        result.eraseColor(sentinel)
+
+        fun render(target: Bitmap, maskRadius: Float) {
+            NativeGlassPipeline.renderGlassPipeline(
+                backdrop, displacement, null, null, target,
+                NativeGlassPipeline.BLUR_BOX3, 3f, false, 1.2f,
+                NativeGlassPipeline.EFFECT_ABERRATION, 20f, 1f, -0.5f, -1f,
+                100f, 1.5f, 7f, 1f, true,
+                10, 8, 110, 82, maskRadius
+            )
+        }
+        render(expected, -1f)
+        render(result, 30f)
+
+        // 中间的十字区域不受圆角影响，必然可见
+        for (y in 8 until 82) {
+            for (x in 10 until 110) {
+                val visible = x in 40 until 80 || y in 38 until 52
+                if (visible) assertEquals("($x,$y)", expected.getPixel(x, y), result.getPixel(x, y))
+            }
+        }
+        // 圆角与矩形外保持原值
+        for ((x, y) in listOf(0 to 0, 11 to 9, 108 to 80, 5 to 45, 60 to 85)) {
+            assertEquals("($x,$y)", sentinel, result.getPixel(x, y))
+        }
+
+        backdrop.recycle()
+        displacement.recycle()
+        expected.recycle()
+        result.recycle()
+    }
+
+    /**
+     * 测试：内容哈希只取决于像素；相同背景再次渲染命中模糊结果缓存，结果不变
+     */
+    @Test
+    fun testBlurCacheHitOnSameContent() {
+        val backdrop = createTestPattern(80, 60)
+        val copy = backdrop.copy(Bitmap.Config.ARGB_8888, true)
+        assertEquals(NativeGlassPipeline.hashBitmap(backdrop), NativeGlassPipeline.hashBitmap(copy))
+        copy.setPixel(41, 29, copy.getPixel(41, 29) xor 0x00000100)
+        assertNotEquals(NativeGlassPipeline.hashBitmap(backdrop), NativeGlassPipeline.hashBitmap(copy))
+
+        val first = Bitmap.createBitmap(80, 60, Bitmap.Config.ARGB_8888)
+        val second = Bitmap.createBitmap(80, 60, Bitmap.Config.ARGB_8888)
+        NativeGlassPipeline.clearBlurCache()
+        NativeGlassPipeline.render(backdrop, first, blurMode = NativeGlassPipeline.BLUR_IIR, sigma = 5f, saturation = 1.3f)
+        val before = NativeGlassPipeline.blurCacheStats()
+        NativeGlassPipeline.render(backdrop, second, blurMode = NativeGlassPipeline.BLUR_IIR, sigma = 5f, saturation = 1.3f)
+        val after = NativeGlassPipeline.blurCacheStats()
+
+        assertEquals(before.hits + 1, after.hits)
+        assertTrue(bitmapsEqual(first, second))
+
+        backdrop.recycle()
+        copy.recycle()
+        first.recycle()
+        second.recycle()
+    }
+
+    /**
+     * 测试：异步渲染队列只渲染最新请求，结果与同步管线一致
+     */
+    @Test
+    fun testAsyncRendererLatestWins() {
+        val backdrop = createTestPattern(96, 64)
+        val result = Bitmap.createBitmap(96, 64, Bitmap.Config.ARGB_8888)
+        val expected = Bitmap.createBitmap(96, 64, Bitmap.Config.ARGB_8888)
+        val renderer = AsyncRenderer()
+
+        // 连续提交，最后一次为 σ = 6
+        for (i in 1..6) {
+            assertTrue(renderer.submit(backdrop, blurMode = NativeGlassPipeline.BLUR_BOX3, sigma = i.toFloat()))
+        }
+        val deadline = System.currentTimeMillis() + 5000
+        while (renderer.hasPendingFrames && System.currentTimeMillis() < deadline) {
+            renderer.acquire(result)
+            Thread.sleep(2)
+        }
+        assertFalse(renderer.hasPendingFrames)
+
+        NativeGlassPipeline.render(backdrop, expected, blurMode = NativeGlassPipeline.BLUR_BOX3, sigma = 6f)
+        assertTrue(bitmapsEqual(expected, result))
+
+        val stats = renderer.stats()!!
+        assertEquals(6L, stats.submitted)
+        assertEquals(stats.submitted, stats.coalesced + stats.rendered)
+        renderer.stop()
+
+        backdrop.recycle()
+        result.recycle()
+        expected.recycle()
+    }
+
+    /**
+     * 测试：HardwareBuffer 零拷贝路径捕获 → 渲染的往返结果与绘制内容一致
+     */
+    @Test
+    fun testHardwareBufferRoundTrip() {
+        // 零拷贝路径需要 API 29+ 且设备提供 AImageReader / AHardwareBuffer
+        if (Build.VERSION.SDK_INT < Build.VERSION_CODES.Q || !HardwareBufferRenderer.isSupported()) return
+
+        val color = 0xFF3366CC.toInt()
+        val renderer = HardwareBufferRenderer()
+        val canvas = renderer.beginCapture(64, 48)
+        assertNotNull(canvas)
+        canvas!!.drawColor(color)
+        renderer.endCapture(canvas)
+
+        // GPU 异步绘制：轮询直到取到捕获帧
+        var frame: Bitmap? = null
+        val deadline = System.currentTimeMillis() + 5000
+        while (frame == null && System.currentTimeMillis() < deadline) {
+            frame = renderer.render(blurMode = NativeGlassPipeline.BLUR_NONE)
+            if (frame == null) Thread.sleep(2)
+        }
+        assertNotNull(frame)
+        assertEquals(Bitmap.Config.HARDWARE, frame!!.config)
+
+        // 无模糊、饱和度 1：结果与捕获内容一致
+        val pixels = frame.copy(Bitmap.Config.ARGB_8888, false)
+        assertEquals(color, pixels.getPixel(0, 0))
+        assertEquals(color, pixels.getPixel(32, 24))
+        pixels.recycle()
+        renderer.release()
+    }
+
+    /**
+     * 测试：从 Alpha 生成的边缘距离场在透明处为 0、向内递增，法线指向最近的透明边缘
+     */
+    @Test
+    fun testEdgeMapsFromAlpha() {
+        // 不透明 64×64，中心挖一个透明像素
+        val source = createSolidBitmap(64, 64, 0xFFFFFFFF.toInt())
+        source.setPixel(40, 32, 0)
+        
+        val (edgeMap, normalMap) = DispersionMapGenerator.generateEdgeMapsFromAlpha(source)
+        assertNotNull(normalMap)
+        
+        // 图像边界与透明像素为 0，远离边缘处距离更大
+        assertEquals(0, edgeMap.getPixel(0, 10) and 0xFF)
+        assertEquals(0, edgeMap.getPixel(40, 32) and 0xFF)
+        assertTrue((edgeMap.getPixel(20, 32) and 0xFF) > (edgeMap.getPixel(38, 32) and 0xFF))
+        
+        // 透明像素右侧邻居的法线指向 -X（R < 128）
+        assertTrue(android.graphics.Color.red(normalMap!!.getPixel(41, 32)) < 64)
+        
+        source.recycle()
+        edgeMap.recycle()
+        normalMap.recycle()
+    }
+    
+    /**
+     * 测试：各模式位移贴图中心与边框编码为零位移，且 B = G、A = 255
+     */
+    @Test
+    fun testDisplacementMapEncoding() {
+        for (mode in DisplacementMode.values()) {
+            val map = NativeDisplacementMap.generate(64, 48, mode)
+            
+            // 中心位移为 0（编码为 127），边框衰减为 0
+            val center = map.getPixel(32, 24)
+            assertEquals(127, android.graphics.Color.red(center))
+            assertEquals(127, android.graphics.Color.green(center))
+            assertEquals(127, android.graphics.Color.red(map.getPixel(0, 10)))
+            
+            // B = G，A = 255
+            val px = map.getPixel(10, 6)
+            assertEquals(android.graphics.Color.green(px), android.graphics.Color.blue(px))
+            assertEquals(255, android.graphics.Color.alpha(px))
+            
+            map.recycle()
+        }
+    }
+    
+    /**
+     * 测试：融合进模糊的饱和度矩阵与"先模糊、再单独套用矩阵"的结果一致（≤ 1 LSB）
+     */
+    @Test
+    fun testFusedSaturationMatchesSeparate() {
+        val matrix = android.graphics.ColorMatrix().apply { setSaturation(1.4f) }.array
+
+        val fused = createTestPattern(131, 77)
+        val separate = fused.copy(Bitmap.Config.ARGB_8888, true)
+        NativeGauss.box3Inplace(fused, 4, matrix)
+        NativeGauss.box3Inplace(separate, 4)
+        NativeGauss.colorMatrixInplace(separate, matrix)
+
+        var maxDiff = 0
+        for (y in 0 until fused.height) {
+            for (x in 0 until fused.width) {
+                val p1 = fused.getPixel(x, y)
+                val p2 = separate.getPixel(x, y)
+                for (shift in intArrayOf(0, 8, 16, 24)) {
+                    maxDiff = maxOf(maxDiff, abs(((p1 shr shift) and 0xFF) - ((p2 shr shift) and 0xFF)))
+                }
+            }
+        }
+        assertTrue("maxDiff=$maxDiff", maxDiff <= 1)
+
+        // 矩阵长度错误时抛出异常
+        try {
+            NativeGauss.colorMatrixInplace(fused, FloatArray(19))
+            fail("Should throw IllegalArgumentException")
+        } catch (e: IllegalArgumentException) {
+            // 预期异常
+        }
+
+        fused.recycle()
+        separate.recycle()
+    }
+    
+    /**
+     * 测试：边缘扭曲——中心位移贴图（128）结果与原图相同；淡化模式下图像边框不位移
+     */
+    @Test
+    fun testEdgeDistortionIdentityAndFade() {
+        val source = createTestPattern(97, 61)
+        val neutral = createSolidBitmap(97, 61, android.graphics.Color.rgb(128, 128, 0))
+        val result = Bitmap.createBitmap(97, 61, Bitmap.Config.ARGB_8888)
+
+        NativeChromaticAberration.edgeDistortion(source, neutral, result, 70f, 0, true)
+        assertTrue(bitmapsEqual(source, result))
+
+        // 强位移 + 淡化：距边缘 0 的像素位移系数为 0
+        val strong = createSolidBitmap(97, 61, android.graphics.Color.rgb(255, 0, 0))
+        NativeChromaticAberration.edgeDistortion(source, strong, result, 70f, 20, true)
+        for (x in 0 until 97) {
+            assertEquals(source.getPixel(x, 0), result.getPixel(x, 0))
+            assertEquals(source.getPixel(x, 60), result.getPixel(x, 60))
+        }
+        assertNotEquals(source.getPixel(48, 30), result.getPixel(48, 30))
+
+        source.recycle()
+        neutral.recycle()
+        strong.recycle()
+        result.recycle()
+    }
+    
+    /**
+     * 测试：批量区域模糊（Box3）与整帧模糊后裁剪逐位一致，重叠矩形合并为一块
+     */
+    @Test
+    fun testBlurRegionsMatchFullFrame() {
+        val backdrop = createTestPattern(320, 240)
+        val full = Bitmap.createBitmap(320, 240, Bitmap.Config.ARGB_8888)
+        NativeGlassPipeline.render(backdrop, full, blurMode = NativeGlassPipeline.BLUR_BOX3, sigma = 4f, saturation = 1.4f)
+
+        val rects = listOf(
+            android.graphics.Rect(10, 10, 110, 80),
+            android.graphics.Rect(60, 40, 170, 120),   // 与第一个重叠
+            android.graphics.Rect(230, 160, 310, 230)
+        )
+        val outputs = NativeGlassPipeline.blurRegions(
+            backdrop, rects, blurMode = NativeGlassPipeline.BLUR_BOX3, sigma = 4f, saturation = 1.4f)
+
+        rects.forEachIndexed { i, r ->
+            val expected = Bitmap.createBitmap(full, r.left, r.top, r.width(), r.height())
+            assertTrue("rect $i", bitmapsEqual(expected, outputs[i]))
+            expected.recycle()
+        }
+
+        val frame = Bitmap.createBitmap(320, 240, Bitmap.Config.ARGB_8888)
+        val blocks = NativeGlassPipeline.blurRegionsIntoFrame(
+            backdrop, rects, frame, blurMode = NativeGlassPipeline.BLUR_BOX3, sigma = 4f, saturation = 1.4f)
+        assertEquals(2, blocks)
+        assertEquals(full.getPixel(100, 60), frame.getPixel(100, 60))
+        assertEquals(0, frame.getPixel(200, 20))   // 矩形以外保持不变
+
+        outputs.forEach { it.recycle() }
+        backdrop.recycle()
+        full.recycle()
+        frame.recycle()
+    }
+
+    /**
+     * 测试：线性色彩空间 IIR 下，硬边缘色块背景的批量区域模糊与整帧模糊后裁剪相差 ≤ 2 LSB
+     */
+    @Test
+    fun testBlurRegionsLinearHardEdges() {
+        val backdrop = createHardEdgeBlocks(400, 300)
+        val full = Bitmap.createBitmap(400, 300, Bitmap.Config.ARGB_8888)
+        val rects = listOf(
+            android.graphics.Rect(40, 30, 140, 90),
+            android.graphics.Rect(190, 140, 210, 155),
+            android.graphics.Rect(300, 200, 380, 280)
+        )
+
+        for (sigma in floatArrayOf(1f, 2f, 5f)) {
+            NativeGlassPipeline.render(
+                backdrop, full, blurMode = NativeGlassPipeline.BLUR_IIR, sigma = sigma, highQuality = true)
+            val outputs = NativeGlassPipeline.blurRegions(
+                backdrop, rects, blurMode = NativeGlassPipeline.BLUR_IIR, sigma = sigma, highQuality = true)
+
+            rects.forEachIndexed { i, r ->
+                val expected = Bitmap.createBitmap(full, r.left, r.top, r.width(), r.height())
+                val maxDiff = maxChannelDiff(expected, outputs[i])
+                assertTrue("sigma=$sigma rect $i maxDiff=$maxDiff", maxDiff <= 2)
+                expected.recycle()
+            }
+            outputs.forEach { it.recycle() }
+        }
+
+        backdrop.recycle()
+        full.recycle()
+    }
+
+    /**
+     * 测试：各向量后端（NEON / SSE4.1 / AVX2）与屏蔽全部特性后的标量回退一致（IIR ≤ 2 LSB，Box3 逐位一致）
+     */
+    @Test
+    fun testSimdBackendsMatchScalar() {
+        val source = createTestPattern(131, 77)
+        val scalarIir = source.copy(Bitmap.Config.ARGB_8888, true)
+        val scalarBox = source.copy(Bitmap.Config.ARGB_8888, true)
+
+        try {
+            NativeGauss.setCpuFeaturesDisabled(-1)
+            assertEquals("scalar", NativeGauss.describeCpuFeatures())
+            NativeGauss.gaussianIIRNeonInplace(scalarIir, 12f, false)
+            NativeGauss.box3Inplace(scalarBox, 6)
+
+            // 全部启用，以及 x86 上只保留 SSE4.1
+            for (disabled in intArrayOf(0, NativeGauss.CPU_FEATURE_AVX2)) {
+                NativeGauss.setCpuFeaturesDisabled(disabled)
+                val backend = NativeGauss.describeCpuFeatures()
+                val iir = source.copy(Bitmap.Config.ARGB_8888, true)
+                val box = source.copy(Bitmap.Config.ARGB_8888, true)
+                NativeGauss.gaussianIIRNeonInplace(iir, 12f, false)
+                NativeGauss.box3Inplace(box, 6)
+
+                var maxDiff = 0
+                for (y in 0 until iir.height) {
+                    for (x in 0 until iir.width) {
+                        val p1 = scalarIir.getPixel(x, y)
+                        val p2 = iir.getPixel(x, y)
+                        for (shift in intArrayOf(0, 8, 16, 24)) {
+                            maxDiff = maxOf(maxDiff, abs(((p1 shr shift) and 0xFF) - ((p2 shr shift) and 0xFF)))
+                        }
+                    }
+                }
+                assertTrue("$backend maxDiff=$maxDiff", maxDiff <= 2)
+                assertTrue(backend, bitmapsEqual(scalarBox, box))
+
+                iir.recycle()
+                box.recycle()
+            }
+        } finally {
+            NativeGauss.setCpuFeaturesDisabled(0)
+        }
+
+        source.recycle()
+        scalarIir.recycle()
+        scalarBox.recycle()
+    }
+
+    /**
+     * 测试：smartBlur 交叉点表（默认表与原固定阈值一致，导出 / 导入往返，拒绝损坏的表）
+     */
+    @Test
+    fun testSmartBlurTunerTable() {
+        try {
+            NativeGauss.resetSmartBlurTable()
+            assertFalse(NativeGauss.isSmartBlurCalibrated())
+            assertEquals(NativeGauss.SMART_METHOD_BOX3, NativeGauss.selectSmartMethod(48, 48, 4f, false))
+            assertEquals(NativeGauss.SMART_METHOD_IIR, NativeGauss.selectSmartMethod(48, 48, 12f, false))
+            assertEquals(NativeGauss.SMART_METHOD_IIR, NativeGauss.selectSmartMethod(1080, 1920, 4f, false))
+
+            val table = NativeGauss.calibrateSmartBlur(200)
+            assertTrue(NativeGauss.isSmartBlurCalibrated())
+            assertTrue(NativeGauss.selectSmartMethod(1080, 1920, 24f, true) != NativeGauss.SMART_METHOD_PYRAMID)
+
+            NativeGauss.resetSmartBlurTable()
+            assertTrue(NativeGauss.importSmartBlurTable(table))
+            assertTrue(NativeGauss.isSmartBlurCalibrated())
+            assertArrayEquals(table, NativeGauss.exportSmartBlurTable())
+
+            val corrupt = table.copyOf()
+            corrupt[corrupt.size - 1] = 0x7F
+            assertFalse(NativeGauss.importSmartBlurTable(corrupt))
+            assertFalse(NativeGauss.importSmartBlurTable(ByteArray(3)))
+            assertArrayEquals(table, NativeGauss.exportSmartBlurTable())
+
+            // 任意方法下 smartBlur 都应真正模糊
+            val bitmap = createTestPattern(96, 96)
+            val before = calculateVariance(bitmap)
+            NativeGauss.smartBlur(bitmap, 6f)
+            assertTrue(calculateVariance(bitmap) < before)
+            bitmap.recycle()
+        } finally {
+            NativeGauss.resetSmartBlurTable()
+        }
+    }
+    
+    /**
+     * 测试：流式模糊按小条带输入 / 输出，与整帧 IIR 相差 ≤ 1 LSB，工作内存小于整帧
+     */
+    @Test
+    fun testStreamingBlurMatchesFullFrame() {
+        val w = 90
+        val h = 700
+        val source = createTestPattern(w, h)
+
+        for ((sigma, highQuality) in listOf(3f to false, 10f to true, 40f to false)) {
+            val reference = source.copy(Bitmap.Config.ARGB_8888, true)
+            NativeGauss.gaussianIIRInplace(reference, sigma, highQuality)
+
+            val result = blurStreaming(source, sigma, highQuality)
+            val maxDiff = maxChannelDiff(reference, result)
+            assertTrue("sigma=$sigma maxDiff=$maxDiff", maxDiff <= 1)
+
+            reference.recycle()
+            result.recycle()
+        }
+
+        source.recycle()
+    }
+
+    /**
+     * 测试：硬边色块上流式模糊与整帧 IIR 相差 ≤ 1 LSB（线性模式向下看 6σ，4σ 时暗部会差出 4 ~ 8 LSB）
+     */
+    @Test
+    fun testStreamingBlurHardEdges() {
+        val w = 200
+        val h = 600
+        val source = createHardEdgeBlocks(w, h)
+
+        for (highQuality in listOf(false, true)) {
+            for (sigma in listOf(1f, 2f, 5f, 20f)) {
+                val reference = source.copy(Bitmap.Config.ARGB_8888, true)
+                NativeGauss.gaussianIIRInplace(reference, sigma, highQuality)
+
+                val result = blurStreaming(source, sigma, highQuality)
+                val maxDiff = maxChannelDiff(reference, result)
+                assertTrue("sigma=$sigma highQuality=$highQuality maxDiff=$maxDiff", maxDiff <= 1)
+
+                reference.recycle()
+                result.recycle()
+            }
+        }
+
+        source.recycle()
+    }
+    
     // ========== 辅助函数 ==========
     
     private fun createSolidBitmap(w: Int, h: Int, color: Int): Bitmap {
@@ -227,6 +1012,83 @@ class NativeGaussTest {
         return bitmap
     }
     
+    /**
+     * 25×25 硬边缘色块（黑、白、近黑与纯色随机排列，固定种子）：暗部紧邻全对比度边缘
+     */
+    private fun createHardEdgeBlocks(w: Int, h: Int): Bitmap {
+        val colors = intArrayOf(
+            0xFF000000.toInt(), 0xFFFFFFFF.toInt(), 0xFF0A0A0A.toInt(),
+            0xFFFF0000.toInt(), 0xFF00FF00.toInt(), 0xFF0000FF.toInt()
+        )
+        val random = java.util.Random(7)
+        val blocksX = (w + 24) / 25
+        val blocks = IntArray(blocksX * ((h + 24) / 25)) { colors[random.nextInt(colors.size)] }
+        val pixels = IntArray(w * h) { i -> blocks[(i / w / 25) * blocksX + (i % w) / 25] }
+        val bitmap = Bitmap.createBitmap(w, h, Bitmap.Config.ARGB_8888)
+        bitmap.setPixels(pixels, 0, w, 0, 0, w, h)
+        return bitmap
+    }
+    
+    /**
+     * 按 37 行条带输入、23 行条带取走做流式模糊，覆盖部分接受与跨块取走
+     */
+    private fun blurStreaming(source: Bitmap, sigma: Float, highQuality: Boolean): Bitmap {
+        val w = source.width
+        val h = source.height
+        val result = Bitmap.createBitmap(w, h, Bitmap.Config.ARGB_8888)
+        val out = Bitmap.createBitmap(w, 23, Bitmap.Config.ARGB_8888)
+        StreamingGaussianBlur(w, h, sigma, highQuality).use { blur ->
+            assertTrue(blur.workingMemoryBytes < w * h * 4L)
+            fun drain() {
+                while (true) {
+                    val outTop = blur.rowsPulled
+                    val pulled = blur.pull(out)
+                    if (pulled == 0) return
+                    val pixels = IntArray(w * pulled)
+                    out.getPixels(pixels, 0, w, 0, 0, w, pulled)
+                    result.setPixels(pixels, 0, w, 0, outTop, w, pulled)
+                }
+            }
+
+            var top = 0
+            while (top < h) {
+                val rows = minOf(37, h - top)
+                val strip = Bitmap.createBitmap(source, 0, top, w, rows)
+                var offset = 0
+                while (offset < rows) {
+                    offset += blur.push(strip, offset)
+                    drain()
+                }
+                strip.recycle()
+                top += rows
+            }
+            drain()
+            assertTrue(blur.isFinished)
+        }
+
+        out.recycle()
+        return result
+    }
+
+    /**
+     * 两张同尺寸 Bitmap 各通道的最大差值
+     */
+    private fun maxChannelDiff(b1: Bitmap, b2: Bitmap): Int {
+        val w = b1.width
+        val h = b1.height
+        val p1 = IntArray(w * h)
+        val p2 = IntArray(w * h)
+        b1.getPixels(p1, 0, w, 0, 0, w, h)
+        b2.getPixels(p2, 0, w, 0, 0, w, h)
+        var maxDiff = 0
+        for (i in p1.indices) {
+            for (shift in 0..24 step 8) {
+                maxDiff = maxOf(maxDiff, abs(((p1[i] shr shift) and 0xFF) - ((p2[i] shr shift) and 0xFF)))
+            }
+        }
+        return maxDiff
+    }
+    
     private fun bitmapsEqual(b1: Bitmap, b2: Bitmap): Boolean {
         if (b1.width != b2.width || b1.height != b2.height) return false
         
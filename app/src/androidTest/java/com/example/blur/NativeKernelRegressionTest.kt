@@ -0,0 +1,660 @@
+/**
+ * NativeKernelRegressionTest - 原生模糊内核的精度与性能回归测试
+ *
+ * 精度：
+ * - 固定种子生成的两组测试图（不透明 / 半透明），结果逐次可复现：
+ *   - 随机色块 + 渐变 + 噪声（自然图像）
+ *   - 9×9 纯色硬边色块（黑、白、近黑 0x0A、饱和 R / G / B 等），线性模式的暗部误差
+ *     经 sRGB 编码放大约 12.92 倍，噪声图会把它掩盖
+ * - 与双精度参考高斯（可分离卷积，半径 ⌈4σ⌉，边界复制；线性模式在线性光下卷积）比较 PSNR
+ * - 向量后端（NEON / SSE4.1 / AVX2）、FP16、流式模糊与标量 IIR 比较（最大逐字节误差）
+ * - 边界尺寸：1×1、1×N、N×1 与奇数宽度（ARGB_8888 行跨度为 4 × 宽度，
+ *   奇数宽度即非对齐行跨度，覆盖向量尾部与不足一块的列）
+ * - σ 极值：≤ 0.1 原样返回、刚超过 0.1、标量钳位的 50 及以上
+ *
+ * 性能：
+ * - 720×1280、σ = 12 下各内核的中位耗时，与本机基线相比慢 10% 以上即失败（超限时复测一次）
+ * - 基线只取 androidTest/assets/perf_baselines.json 中本机的条目（随代码提交，卸载 / 重装不受影响）；
+ *   没有本机条目时失败，而不是把本次结果当作基线
+ * - 记录 / 更新本机基线（新设备、内核有意变慢、换 ROM 等）：
+ *   ./gradlew connectedAndroidTest -Pandroid.testInstrumentationRunnerArguments.updatePerfBaselines=true
+ *   此时只测量不比较，合并了本机条目的 perf_baselines.json 写入 AGP 的附加测试输出目录，
+ *   测试结束后被拉回主机：app/build/outputs/connected_android_test_additional_output/…/perf_baselines.json，
+ *   复制到 app/src/androidTest/assets/ 并提交
+ * - 每次运行同时把测量结果以 JSON 输出到 logcat（tag NativeKernelPerf）
+ *
+ * 阈值在主机上用同一测试图与参考实现标定（括号内为实测最小值）：
+ * - IIR（标量 / 向量 / FP16）对参考高斯 ≥ 36 dB（39.6）；硬边 sRGB ≥ 32 dB（34.7），硬边线性 ≥ 27 dB（29.6）
+ * - Box3（等效 σ = √(r(r+1))）≥ 33 dB（36.3），硬边 ≥ 32 dB（35.3）
+ * - 金字塔 ≥ 32 dB（34.6），硬边 ≥ 27 dB（29.4）
+ * - 各后端与标量 IIR 相差 ≤ 2 LSB（1），流式与整帧 ≤ 1 LSB（1，两组测试图、两种色彩空间）
+ */
+package com.example.blur
+
+import android.content.Context
+import android.content.pm.ApplicationInfo
+import android.graphics.Bitmap
+import android.os.Build
+import android.util.Log
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.platform.app.InstrumentationRegistry
+import org.json.JSONObject
+import org.junit.Assert.*
+import org.junit.Test
+import org.junit.runner.RunWith
+import java.io.File
+import java.io.FileNotFoundException
+import java.nio.ByteBuffer
+import kotlin.math.abs
+import kotlin.math.ceil
+import kotlin.math.exp
+import kotlin.math.log10
+import kotlin.math.max
+import kotlin.math.min
+import kotlin.math.pow
+import kotlin.math.sqrt
+
+@RunWith(AndroidJUnit4::class)
+class NativeKernelRegressionTest {
+
+    companion object {
+        private const val TAG = "NativeKernelPerf"
+
+        // 精度阈值
+        private const val IIR_MIN_PSNR = 36.0
+        private const val BOX3_MIN_PSNR = 33.0
+        private const val PYRAMID_MIN_PSNR = 32.0
+        private const val HARD_EDGE_IIR_MIN_PSNR = 32.0
+        private const val HARD_EDGE_IIR_LINEAR_MIN_PSNR = 27.0
+        private const val HARD_EDGE_BOX3_MIN_PSNR = 32.0
+        private const val HARD_EDGE_PYRAMID_MIN_PSNR = 27.0
+        private const val BACKEND_MAX_DIFF = 2
+        private const val STREAM_MAX_DIFF = 1
+
+        // 性能用例
+        private const val PERF_WIDTH = 720
+        private const val PERF_HEIGHT = 1280
+        private const val PERF_SIGMA = 12f
+        private const val PERF_BOX_RADIUS = 10
+        private const val PERF_WARMUP = 2
+        private const val PERF_ITERATIONS = 9
+        private const val MAX_SLOWDOWN = 1.10
+
+        private const val BASELINE_ASSET = "perf_baselines.json"
+        private const val ARG_UPDATE_BASELINES = "updatePerfBaselines"
+        // AGP 传入的附加测试输出目录（测试结束后拉回主机）
+        private const val ARG_ADDITIONAL_OUTPUT_DIR = "additionalTestOutputDir"
+
+        private val ACCURACY_SIZES = listOf(131 to 77, 1 to 97, 97 to 1, 17 to 33)
+        private val ACCURACY_SIGMAS = floatArrayOf(0.5f, 1f, 3f, 8f, 20f, 50f)
+        private val BOUNDARY_SIZES = listOf(1 to 1, 1 to 97, 97 to 1, 2 to 3, 3 to 5, 17 to 33, 131 to 77)
+
+        // 测试图：(translucent, hardEdges)
+        private val IMAGE_KINDS = listOf(false to false, true to false, false to true, true to true)
+
+        // 硬边色块：黑、白、近黑、饱和三原色、深灰、浅灰
+        private val HARD_EDGE_PALETTE = intArrayOf(
+            0x000000, 0xFFFFFF, 0x0A0A0A, 0xFF0000, 0x00FF00, 0x0000FF, 0x202020, 0xF0F0F0
+        )
+    }
+
+    /**
+     * 测试：IIR 各实现与双精度参考高斯（PSNR），向量 / FP16 后端与标量一致（≤ 2 LSB）
+     */
+    @Test
+    fun testIirMatchesReferenceGaussian() {
+        for ((w, h) in ACCURACY_SIZES) {
+            for ((translucent, hardEdges) in IMAGE_KINDS) {
+                val source = testPixels(w, h, w * 31 + h, translucent, hardEdges)
+                for (sigma in ACCURACY_SIGMAS) {
+                    for (linear in booleanArrayOf(false, true)) {
+                        val label = "${w}x$h translucent=$translucent hardEdges=$hardEdges sigma=$sigma linear=$linear"
+                        val reference = referenceGaussian(source, w, h, sigma.toDouble(), linear)
+                        val minPsnr = when {
+                            !hardEdges -> IIR_MIN_PSNR
+                            linear -> HARD_EDGE_IIR_LINEAR_MIN_PSNR
+                            else -> HARD_EDGE_IIR_MIN_PSNR
+                        }
+
+                        val scalar = blurred(source, w, h) { NativeGauss.gaussianIIRInplace(it, sigma, linear) }
+                        val vector = blurred(source, w, h) { NativeGauss.gaussianIIRNeonInplace(it, sigma, linear) }
+                        assertPsnrAtLeast("$label scalar", scalar, reference, minPsnr)
+                        assertPsnrAtLeast("$label vector", vector, reference, minPsnr)
+                        assertMaxDiffAtMost("$label vector vs scalar", vector, scalar, BACKEND_MAX_DIFF)
+
+                        if (!linear) {
+                            val fp16 = blurred(source, w, h) { NativeGauss.gaussianIIRFp16Inplace(it, sigma) }
+                            assertPsnrAtLeast("$label fp16", fp16, reference, minPsnr)
+                            assertMaxDiffAtMost("$label fp16 vs vector", fp16, vector, BACKEND_MAX_DIFF)
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * 测试：Box3（等效 σ = √(r(r+1))）与金字塔模糊对参考高斯的 PSNR
+     */
+    @Test
+    fun testBox3AndPyramidMatchReferenceGaussian() {
+        for ((w, h) in ACCURACY_SIZES + (256 to 256)) {
+            for ((translucent, hardEdges) in IMAGE_KINDS) {
+                val source = testPixels(w, h, w * 31 + h, translucent, hardEdges)
+                val label = "${w}x$h translucent=$translucent hardEdges=$hardEdges"
+                val boxMinPsnr = if (hardEdges) HARD_EDGE_BOX3_MIN_PSNR else BOX3_MIN_PSNR
+                val pyramidMinPsnr = if (hardEdges) HARD_EDGE_PYRAMID_MIN_PSNR else PYRAMID_MIN_PSNR
+
+                for (radius in intArrayOf(1, 3, 8)) {
+                    val sigma = sqrt(radius * (radius + 1.0))
+                    val reference = referenceGaussian(source, w, h, sigma, false)
+                    val box = blurred(source, w, h) { NativeGauss.box3Inplace(it, radius) }
+                    assertPsnrAtLeast("$label box3 radius=$radius", box, reference, boxMinPsnr)
+                }
+
+                for (sigma in floatArrayOf(3f, 8f, 20f, 50f)) {
+                    val reference = referenceGaussian(source, w, h, sigma.toDouble(), false)
+                    val pyramid = blurred(source, w, h) { NativeGauss.pyramidBlurInplace(it, sigma) }
+                    assertPsnrAtLeast("$label pyramid sigma=$sigma", pyramid, reference, pyramidMinPsnr)
+                }
+            }
+        }
+    }
+
+    /**
+     * 测试：边界尺寸下流式模糊（1 行 / 7 行条带）与整帧标量 IIR 一致（≤ 1 LSB）
+     */
+    @Test
+    fun testStreamingMatchesFullFrameAtBoundarySizes() {
+        for ((w, h) in BOUNDARY_SIZES) {
+            for (hardEdges in booleanArrayOf(false, true)) {
+                val source = testPixels(w, h, w * 17 + h, translucent = true, hardEdges = hardEdges)
+                for (sigma in floatArrayOf(0.5f, 3f, 50f)) {
+                    for (linear in booleanArrayOf(false, true)) {
+                        val full = blurred(source, w, h) { NativeGauss.gaussianIIRInplace(it, sigma, linear) }
+                        for (stripRows in intArrayOf(1, 7)) {
+                            val streamed = streamBlurred(source, w, h, sigma, linear, stripRows)
+                            assertMaxDiffAtMost(
+                                "${w}x$h hardEdges=$hardEdges sigma=$sigma linear=$linear strip=$stripRows",
+                                streamed, full, STREAM_MAX_DIFF
+                            )
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * 测试：硬边色块上流式模糊（多块、跨块截断）与整帧标量 IIR 一致（≤ 1 LSB）
+     *
+     * 边界尺寸的图像不超过一块，反因果 pass 总能看到底边；这里用 600 行覆盖块间的截断误差，
+     * 线性模式向下看 6σ（4σ 时暗部会差出 4 ~ 8 LSB）
+     */
+    @Test
+    fun testStreamingMatchesFullFrameOnHardEdges() {
+        val w = 64
+        val h = 600
+        for (translucent in booleanArrayOf(false, true)) {
+            val source = hardEdgePixels(w, h, 29, translucent)
+            for (sigma in floatArrayOf(1f, 2f, 5f, 20f)) {
+                for (linear in booleanArrayOf(false, true)) {
+                    val full = blurred(source, w, h) { NativeGauss.gaussianIIRInplace(it, sigma, linear) }
+                    val streamed = streamBlurred(source, w, h, sigma, linear, 37)
+                    assertMaxDiffAtMost(
+                        "translucent=$translucent sigma=$sigma linear=$linear", streamed, full, STREAM_MAX_DIFF
+                    )
+                }
+            }
+        }
+    }
+
+    /**
+     * 测试：σ 极值
+     * - σ ≤ 0.1 时各内核逐字节不变
+     * - σ 刚超过 0.1 时仍与参考高斯一致
+     * - 标量 IIR 把 σ 钳位到 50（σ = 400 与 σ = 50 逐字节一致）
+     */
+    @Test
+    fun testSigmaExtremes() {
+        val w = 131
+        val h = 77
+        val source = seededPixels(w, h, 9, translucent = true)
+
+        for (sigma in floatArrayOf(0f, 0.05f, 0.1f)) {
+            for (linear in booleanArrayOf(false, true)) {
+                val label = "sigma=$sigma linear=$linear"
+                assertArrayEquals(label, source, blurred(source, w, h) { NativeGauss.gaussianIIRInplace(it, sigma, linear) })
+                assertArrayEquals(label, source, blurred(source, w, h) { NativeGauss.gaussianIIRNeonInplace(it, sigma, linear) })
+                assertArrayEquals(label, source, streamBlurred(source, w, h, sigma, linear, 16))
+            }
+            assertArrayEquals("sigma=$sigma", source, blurred(source, w, h) { NativeGauss.gaussianIIRFp16Inplace(it, sigma) })
+            assertArrayEquals("sigma=$sigma", source, blurred(source, w, h) { NativeGauss.pyramidBlurInplace(it, sigma) })
+        }
+        assertArrayEquals("radius=0", source, blurred(source, w, h) { NativeGauss.box3Inplace(it, 0) })
+
+        for (sigma in floatArrayOf(0.11f, 0.2f)) {
+            for (linear in booleanArrayOf(false, true)) {
+                val label = "sigma=$sigma linear=$linear"
+                val reference = referenceGaussian(source, w, h, sigma.toDouble(), linear)
+                val scalar = blurred(source, w, h) { NativeGauss.gaussianIIRInplace(it, sigma, linear) }
+                val vector = blurred(source, w, h) { NativeGauss.gaussianIIRNeonInplace(it, sigma, linear) }
+                assertPsnrAtLeast("$label scalar", scalar, reference, IIR_MIN_PSNR)
+                assertMaxDiffAtMost("$label vector vs scalar", vector, scalar, BACKEND_MAX_DIFF)
+            }
+        }
+
+        for (linear in booleanArrayOf(false, true)) {
+            val clamped = blurred(source, w, h) { NativeGauss.gaussianIIRInplace(it, 50f, linear) }
+            val huge = blurred(source, w, h) { NativeGauss.gaussianIIRInplace(it, 400f, linear) }
+            assertArrayEquals("linear=$linear", clamped, huge)
+        }
+    }
+
+    /**
+     * 测试：边界尺寸与大 σ 下纯色（半透明）图像保持不变（≤ 1 LSB，无越界读写、无数值发散）
+     */
+    @Test
+    fun testFlatImagePreservedAtBoundarySizes() {
+        for ((w, h) in BOUNDARY_SIZES) {
+            // 预乘 (R, G, B, A) = (60, 40, 100, 128)
+            val flat = ByteArray(w * h * 4)
+            for (i in 0 until w * h) {
+                flat[i * 4] = 60
+                flat[i * 4 + 1] = 40
+                flat[i * 4 + 2] = 100
+                flat[i * 4 + 3] = 128.toByte()
+            }
+
+            for (sigma in floatArrayOf(3f, 50f, 400f)) {
+                val label = "${w}x$h sigma=$sigma"
+                for (linear in booleanArrayOf(false, true)) {
+                    assertMaxDiffAtMost("$label scalar linear=$linear", flat,
+                        blurred(flat, w, h) { NativeGauss.gaussianIIRInplace(it, sigma, linear) }, 1)
+                    assertMaxDiffAtMost("$label vector linear=$linear", flat,
+                        blurred(flat, w, h) { NativeGauss.gaussianIIRNeonInplace(it, sigma, linear) }, 1)
+                    assertMaxDiffAtMost("$label stream linear=$linear", flat,
+                        streamBlurred(flat, w, h, sigma, linear, 5), 1)
+                }
+                assertMaxDiffAtMost("$label fp16", flat,
+                    blurred(flat, w, h) { NativeGauss.gaussianIIRFp16Inplace(it, sigma) }, 1)
+                assertMaxDiffAtMost("$label pyramid", flat,
+                    blurred(flat, w, h) { NativeGauss.pyramidBlurInplace(it, sigma) }, 1)
+            }
+            for (radius in intArrayOf(1, 5, 50)) {
+                assertMaxDiffAtMost("${w}x$h box3 radius=$radius", flat,
+                    blurred(flat, w, h) { NativeGauss.box3Inplace(it, radius) }, 1)
+            }
+        }
+    }
+
+    /**
+     * 测试：各内核吞吐量与已提交的本机基线比较（慢 10% 以上或没有本机基线时失败）
+     */
+    @Test
+    fun testThroughputAgainstBaselines() {
+        val source = toBitmap(seededPixels(PERF_WIDTH, PERF_HEIGHT, 2024, translucent = false), PERF_WIDTH, PERF_HEIGHT)
+        val work = source.copy(Bitmap.Config.ARGB_8888, true)
+        val original = ByteBuffer.allocate(source.byteCount)
+        source.copyPixelsToBuffer(original)
+
+        val kernels = linkedMapOf<String, (Bitmap) -> Unit>(
+            "iir" to { bitmap: Bitmap -> NativeGauss.gaussianIIRInplace(bitmap, PERF_SIGMA, false) },
+            "iir_linear" to { bitmap: Bitmap -> NativeGauss.gaussianIIRInplace(bitmap, PERF_SIGMA, true) },
+            "vector" to { bitmap: Bitmap -> NativeGauss.gaussianIIRNeonInplace(bitmap, PERF_SIGMA, false) },
+            "vector_linear" to { bitmap: Bitmap -> NativeGauss.gaussianIIRNeonInplace(bitmap, PERF_SIGMA, true) },
+            "box3" to { bitmap: Bitmap -> NativeGauss.box3Inplace(bitmap, PERF_BOX_RADIUS) },
+            "pyramid" to { bitmap: Bitmap -> NativeGauss.pyramidBlurInplace(bitmap, PERF_SIGMA) },
+            "stream" to { bitmap: Bitmap -> streamBlurInPlace(bitmap, PERF_SIGMA, StreamingGaussianBlur.DEFAULT_STRIP_HEIGHT) }
+        )
+        if (NativeGauss.hasFp16Support()) {
+            kernels["fp16"] = { bitmap: Bitmap -> NativeGauss.gaussianIIRFp16Inplace(bitmap, PERF_SIGMA) }
+        }
+
+        fun measure(kernel: (Bitmap) -> Unit): Double {
+            val times = DoubleArray(PERF_ITERATIONS)
+            for (i in -PERF_WARMUP until PERF_ITERATIONS) {
+                original.rewind()
+                work.copyPixelsFromBuffer(original)
+                val start = System.nanoTime()
+                kernel(work)
+                if (i >= 0) times[i] = (System.nanoTime() - start) / 1e6
+            }
+            times.sort()
+            return times[PERF_ITERATIONS / 2]
+        }
+
+        val measured = linkedMapOf<String, Double>()
+        for ((name, kernel) in kernels) {
+            measured[name] = measure(kernel)
+        }
+
+        val key = deviceKey()
+        val json = JSONObject()
+        for ((name, ms) in measured) {
+            json.put(name, Math.round(ms * 100) / 100.0)
+        }
+        Log.i(TAG, "\"$key\": $json")
+
+        val update = InstrumentationRegistry.getArguments().getString(ARG_UPDATE_BASELINES) == "true"
+        if (update) {
+            writeUpdatedBaselines(key, json)
+            source.recycle()
+            work.recycle()
+            return
+        }
+
+        val committed = committedBaselines(key)
+        val failures = mutableListOf<String>()
+
+        for ((name, ms) in measured) {
+            val baseline = committed[name]
+            if (baseline == null) {
+                failures += "$name: no baseline in $BASELINE_ASSET (measured ${"%.2f".format(ms)} ms; " +
+                        "record with -Pandroid.testInstrumentationRunnerArguments.$ARG_UPDATE_BASELINES=true)"
+                continue
+            }
+
+            // 超限时复测一次，排除偶发的调度 / 降频干扰
+            var current = ms
+            if (current > baseline * MAX_SLOWDOWN) {
+                current = min(current, measure(kernels.getValue(name)))
+            }
+            if (current > baseline * MAX_SLOWDOWN) {
+                failures += "$name: ${"%.2f".format(current)} ms vs baseline ${"%.2f".format(baseline)} ms " +
+                        "(+${"%.0f".format((current / baseline - 1) * 100)}%)"
+            }
+        }
+
+        source.recycle()
+        work.recycle()
+        assertTrue("Throughput regression on $key:\n" + failures.joinToString("\n"), failures.isEmpty())
+    }
+
+    // ---------------------------------------------------------------------
+    // 测试图与参考实现
+    // ---------------------------------------------------------------------
+
+    /**
+     * 固定种子的测试图（预乘 RGBA 字节，内存顺序同 ARGB_8888 Bitmap）
+     *
+     * 12×12 随机色块（3/4）+ 对角渐变（1/4）+ ±12 噪声；translucent 时每个色块 Alpha 取 48 ~ 255
+     */
+    private fun seededPixels(w: Int, h: Int, seed: Int, translucent: Boolean): ByteArray {
+        val pixels = ByteArray(w * h * 4)
+        var state = seed * -1640531535 + 1 // seed × 2654435761 + 1（xorshift32 状态）
+
+        for (y in 0 until h) {
+            for (x in 0 until w) {
+                val cell = hash3(x / 12, y / 12, seed)
+                val a = if (translucent) 48 + cell % 208 else 255
+                val gradient = (x * 255 / max(1, w - 1) + y * 255 / max(1, h - 1)) / 2
+                for (k in 0 until 3) {
+                    state = state xor (state shl 13)
+                    state = state xor (state ushr 17)
+                    state = state xor (state shl 5)
+                    val noise = ((state.toLong() and 0xFFFFFFFFL) % 25).toInt() - 12
+                    val base = (cell shr (k * 8)) and 0xFF
+                    val v = ((base * 3 + gradient) / 4 + noise).coerceIn(0, 255)
+                    pixels[(y * w + x) * 4 + k] = ((v * a + 127) / 255).toByte()
+                }
+                pixels[(y * w + x) * 4 + 3] = a.toByte()
+            }
+        }
+        return pixels
+    }
+
+    /**
+     * 9×9 纯色硬边色块（无渐变 / 噪声），颜色取自 HARD_EDGE_PALETTE；translucent 时 Alpha 取 48 ~ 255
+     */
+    private fun hardEdgePixels(w: Int, h: Int, seed: Int, translucent: Boolean): ByteArray {
+        val pixels = ByteArray(w * h * 4)
+        for (y in 0 until h) {
+            for (x in 0 until w) {
+                val cell = hash3(x / 9, y / 9, seed)
+                val a = if (translucent) 48 + (cell shr 8) % 208 else 255
+                val rgb = HARD_EDGE_PALETTE[cell % HARD_EDGE_PALETTE.size]
+                for (k in 0 until 3) {
+                    val v = (rgb shr (16 - k * 8)) and 0xFF
+                    pixels[(y * w + x) * 4 + k] = ((v * a + 127) / 255).toByte()
+                }
+                pixels[(y * w + x) * 4 + 3] = a.toByte()
+            }
+        }
+        return pixels
+    }
+
+    private fun testPixels(w: Int, h: Int, seed: Int, translucent: Boolean, hardEdges: Boolean): ByteArray =
+        if (hardEdges) hardEdgePixels(w, h, seed, translucent) else seededPixels(w, h, seed, translucent)
+
+    private fun hash3(a: Int, b: Int, seed: Int): Int {
+        var h = (a * 73856093) xor (b * 19349663) xor (seed * 83492791)
+        h = h xor (h ushr 13)
+        h *= 0x5bd1e995
+        h = h xor (h ushr 15)
+        return h and 0x7FFFFFFF
+    }
+
+    /**
+     * 双精度参考高斯：可分离卷积，半径 ⌈4σ⌉，边界复制（与 IIR 的稳态边界一致）
+     *
+     * linear 时在预乘线性光下卷积（精确 sRGB 曲线），最后量化 Alpha 并转换回预乘 sRGB
+     */
+    private fun referenceGaussian(src: ByteArray, w: Int, h: Int, sigma: Double, linear: Boolean): ByteArray {
+        val radius = ceil(4 * sigma).toInt()
+        val kernel = DoubleArray(2 * radius + 1) { exp(-((it - radius) * (it - radius)) / (2 * sigma * sigma)) }
+        val total = kernel.sum()
+        for (i in kernel.indices) kernel[i] /= total
+
+        val a = DoubleArray(w * h * 4)
+        val b = DoubleArray(w * h * 4)
+        for (i in 0 until w * h) {
+            val alpha = (src[i * 4 + 3].toInt() and 0xFF) / 255.0
+            for (c in 0 until 3) {
+                val v = (src[i * 4 + c].toInt() and 0xFF) / 255.0
+                a[i * 4 + c] = if (!linear) v else if (alpha > 0) srgbToLinear(min(1.0, v / alpha)) * alpha else 0.0
+            }
+            a[i * 4 + 3] = alpha
+        }
+
+        for (y in 0 until h) {
+            for (x in 0 until w) {
+                for (c in 0 until 4) {
+                    var acc = 0.0
+                    for (k in -radius..radius) {
+                        acc += kernel[k + radius] * a[(y * w + (x + k).coerceIn(0, w - 1)) * 4 + c]
+                    }
+                    b[(y * w + x) * 4 + c] = acc
+                }
+            }
+        }
+        for (y in 0 until h) {
+            for (x in 0 until w) {
+                for (c in 0 until 4) {
+                    var acc = 0.0
+                    for (k in -radius..radius) {
+                        acc += kernel[k + radius] * b[((y + k).coerceIn(0, h - 1) * w + x) * 4 + c]
+                    }
+                    a[(y * w + x) * 4 + c] = acc
+                }
+            }
+        }
+
+        val out = ByteArray(w * h * 4)
+        for (i in 0 until w * h) {
+            val alpha = Math.round(a[i * 4 + 3].coerceIn(0.0, 1.0) * 255).toInt()
+            out[i * 4 + 3] = alpha.toByte()
+            for (c in 0 until 3) {
+                var v = a[i * 4 + c]
+                if (linear) {
+                    v = if (alpha > 0) linearToSrgb((v / (alpha / 255.0)).coerceIn(0.0, 1.0)) * (alpha / 255.0) else 0.0
+                }
+                out[i * 4 + c] = Math.round(v.coerceIn(0.0, 1.0) * 255).toInt().toByte()
+            }
+        }
+        return out
+    }
+
+    private fun srgbToLinear(c: Double): Double =
+        if (c <= 0.04045) c / 12.92 else ((c + 0.055) / 1.055).pow(2.4)
+
+    private fun linearToSrgb(c: Double): Double =
+        if (c <= 0.0031308) c * 12.92 else 1.055 * c.pow(1 / 2.4) - 0.055
+
+    // ---------------------------------------------------------------------
+    // 辅助函数
+    // ---------------------------------------------------------------------
+
+    private fun targetContext(): Context = InstrumentationRegistry.getInstrumentation().targetContext
+
+    private fun toBitmap(pixels: ByteArray, w: Int, h: Int): Bitmap {
+        val bitmap = Bitmap.createBitmap(w, h, Bitmap.Config.ARGB_8888)
+        bitmap.copyPixelsFromBuffer(ByteBuffer.wrap(pixels))
+        return bitmap
+    }
+
+    private fun pixelsOf(bitmap: Bitmap, rows: Int = bitmap.height): ByteArray {
+        val buffer = ByteBuffer.allocate(bitmap.byteCount)
+        bitmap.copyPixelsToBuffer(buffer)
+        return buffer.array().copyOf(bitmap.width * rows * 4)
+    }
+
+    /**
+     * 对测试图的副本执行 op，返回结果像素
+     */
+    private fun blurred(source: ByteArray, w: Int, h: Int, op: (Bitmap) -> Unit): ByteArray {
+        val bitmap = toBitmap(source, w, h)
+        op(bitmap)
+        val result = pixelsOf(bitmap)
+        bitmap.recycle()
+        return result
+    }
+
+    /**
+     * 流式模糊：按 stripRows 行的条带输入，每次输入后取走全部已完成的行（输出条带同样为 stripRows 行）
+     */
+    private fun streamBlurred(source: ByteArray, w: Int, h: Int, sigma: Float, linear: Boolean, stripRows: Int): ByteArray {
+        val input = toBitmap(source, w, h)
+        val out = Bitmap.createBitmap(w, stripRows, Bitmap.Config.ARGB_8888)
+        val result = ByteArray(w * h * 4)
+
+        StreamingGaussianBlur(w, h, sigma, linear).use { blur ->
+            fun drain() {
+                while (true) {
+                    val top = blur.rowsPulled
+                    val rows = blur.pull(out)
+                    if (rows == 0) return
+                    pixelsOf(out, rows).copyInto(result, top * w * 4)
+                }
+            }
+
+            while (blur.rowsPushed < h) {
+                blur.push(input, blur.rowsPushed, min(stripRows, h - blur.rowsPushed))
+                drain()
+            }
+            drain()
+            assertTrue("${w}x$h stream unfinished", blur.isFinished)
+        }
+
+        input.recycle()
+        out.recycle()
+        return result
+    }
+
+    /**
+     * 流式模糊整张 Bitmap（输入 / 输出为同一个 Bitmap：取走的行总在已输入的行之前）
+     */
+    private fun streamBlurInPlace(bitmap: Bitmap, sigma: Float, stripRows: Int) {
+        StreamingGaussianBlur(bitmap.width, bitmap.height, sigma).use { blur ->
+            while (!blur.isFinished) {
+                if (blur.rowsPushed < bitmap.height) {
+                    blur.push(bitmap, blur.rowsPushed, min(stripRows, bitmap.height - blur.rowsPushed))
+                }
+                while (blur.pull(bitmap, blur.rowsPulled, min(stripRows, blur.rowsPushed - blur.rowsPulled)) > 0) { }
+            }
+        }
+    }
+
+    private fun psnr(a: ByteArray, b: ByteArray): Double {
+        var mse = 0.0
+        for (i in a.indices) {
+            val d = (a[i].toInt() and 0xFF) - (b[i].toInt() and 0xFF)
+            mse += d * d
+        }
+        mse /= a.size
+        return if (mse == 0.0) Double.POSITIVE_INFINITY else 10 * log10(255.0 * 255.0 / mse)
+    }
+
+    private fun maxDiff(a: ByteArray, b: ByteArray): Int {
+        var result = 0
+        for (i in a.indices) {
+            result = max(result, abs((a[i].toInt() and 0xFF) - (b[i].toInt() and 0xFF)))
+        }
+        return result
+    }
+
+    private fun assertPsnrAtLeast(label: String, actual: ByteArray, reference: ByteArray, minPsnr: Double) {
+        val value = psnr(actual, reference)
+        assertTrue("$label PSNR=${"%.1f".format(value)} dB < $minPsnr dB", value >= minPsnr)
+    }
+
+    private fun assertMaxDiffAtMost(label: String, actual: ByteArray, expected: ByteArray, limit: Int) {
+        val value = maxDiff(actual, expected)
+        assertTrue("$label maxDiff=$value > $limit", value <= limit)
+    }
+
+    /**
+     * 基线键：设备型号 / 主 ABI / 启用的向量后端 / 构建类型（Debug 构建的原生代码为 -O0）
+     */
+    private fun deviceKey(): String {
+        val debuggable = targetContext().applicationInfo.flags and ApplicationInfo.FLAG_DEBUGGABLE != 0
+        return "${Build.MANUFACTURER} ${Build.MODEL}|${Build.SUPPORTED_ABIS[0]}|" +
+                "${NativeGauss.describeCpuFeatures()}|${if (debuggable) "debug" else "release"}"
+    }
+
+    /**
+     * 已提交的 perf_baselines.json；资源不存在时为空文档
+     */
+    private fun baselineDocument(): JSONObject {
+        val text = try {
+            InstrumentationRegistry.getInstrumentation().context.assets.open(BASELINE_ASSET)
+                .bufferedReader().use { it.readText() }
+        } catch (e: FileNotFoundException) {
+            return JSONObject().put("devices", JSONObject())
+        }
+        return JSONObject(text)
+    }
+
+    /**
+     * perf_baselines.json 中本机的基线（毫秒）；没有条目时为空
+     */
+    private fun committedBaselines(key: String): Map<String, Double> {
+        val device = baselineDocument().optJSONObject("devices")?.optJSONObject(key) ?: return emptyMap()
+        val result = mutableMapOf<String, Double>()
+        for (name in device.keys()) {
+            result[name] = device.getDouble(name)
+        }
+        return result
+    }
+
+    /**
+     * 把本机条目合并进 perf_baselines.json，写入附加测试输出目录（AGP 在测试结束后拉回主机）
+     *
+     * 没有该参数时（如直接用 am instrument 运行）只能从 logcat 复制本机条目
+     */
+    private fun writeUpdatedBaselines(key: String, measured: JSONObject) {
+        val document = baselineDocument()
+        val devices = document.optJSONObject("devices") ?: JSONObject().also { document.put("devices", it) }
+        devices.put(key, measured)
+
+        val dir = InstrumentationRegistry.getArguments().getString(ARG_ADDITIONAL_OUTPUT_DIR)
+        if (dir == null) {
+            Log.w(TAG, "$ARG_ADDITIONAL_OUTPUT_DIR not set; copy the \"$key\" entry above into $BASELINE_ASSET")
+            return
+        }
+        val file = File(dir, BASELINE_ASSET)
+        file.parentFile?.mkdirs()
+        file.writeText(document.toString(2) + "\n")
+        Log.i(TAG, "Updated baselines written to ${file.absolutePath}")
+    }
+}
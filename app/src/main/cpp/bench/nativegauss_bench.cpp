@@ -0,0 +1,450 @@
+/**
+ * nativegauss_bench.cpp - 原生滤波器微基准（adb shell 可执行程序）
+ *
+ * 覆盖的内核：
+ * - IIR 高斯：gaussian_iir_rgba8888_inplace / gaussian_iir_rgba8888_neon（sRGB 与线性）/
+ *   gaussian_iir_rgba8888_fp16（仅 sRGB，设备支持 FP16 时）
+ * - Box3：box3_rgba8888_inplace
+ * - 金字塔模糊：pyramid_blur_rgba8888_inplace
+ * - 降采样盒式模糊：advanced_box_blur_rgba8888 / advanced_box_blur_rgba8888_hq
+ * - 双线性缩放：resize_bilinear_rgba8888（0.5× 降采样 / 2× 上采样）
+ * - 色差 / 色散：chromatic_aberration_rgba8888 / chromatic_dispersion_rgba8888（双线性 / 最近邻）
+ * - 辅助贴图：generate_displacement_map_rgba8888 / generate_edge_maps_from_alpha
+ * - 融合管线：render_glass_pipeline
+ *
+ * 输出：每个用例一行，包含中位数 / p99（毫秒）与 MPix/s（按中位数计算）
+ *
+ * 构建与运行（需要 NDK）：
+ *   cmake -S app/src/main/cpp -B build-bench \
+ *         -DCMAKE_TOOLCHAIN_FILE=$NDK/build/cmake/android.toolchain.cmake \
+ *         -DANDROID_ABI=arm64-v8a -DANDROID_PLATFORM=21 \
+ *         -DCMAKE_BUILD_TYPE=Release -DNATIVEGAUSS_BUILD_BENCH=ON
+ *   cmake --build build-bench --target nativegauss_bench
+ *   adb push build-bench/nativegauss_bench /data/local/tmp/
+ *   adb shell /data/local/tmp/nativegauss_bench --cores big
+ *
+ * 选项：
+ *   --cores big|little|all   绑定到大核 / 小核 / 全部核心（默认 all）
+ *   --iterations N           每个用例的计时次数（默认 30）
+ *   --warmup N               预热次数（默认 3）
+ *   --sizes WxH,WxH,...      图像尺寸（默认 128x128,512x512,1080x1920）
+ *   --filter TEXT            只运行名称包含 TEXT 的用例
+ *   --disable-features MASK  屏蔽 CPU 特性位（见 cpu_features.h，如 16 = AVX2），对比各后端
+ *
+ * 注意：
+ * - 绑核在创建线程池之前进行，工作线程继承同一 CPU 掩码
+ * - 线程数仍按大核数量确定（与应用内一致），--cores little 时这些线程共享小核
+ * - 原位滤波器每次计时前重新复制输入（复制不计入耗时），结果不随迭代累积
+ */
+
+#include "gauss_iir.h"
+#include "gauss_iir_neon.h"
+#include "gauss_iir_fp16.h"
+#include "cpu_features.h"
+#include "boxblur.h"
+#include "pyramid_blur.h"
+#include "resampler.h"
+#include "chromatic_aberration.h"
+#include "displacement_map.h"
+#include "sdf_generator.h"
+#include "glass_pipeline.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+#include <sched.h>
+#include <unistd.h>
+
+/**
+ * 测试图像：棋盘格 + 渐变 + 伪随机噪声（避免内容过于平坦）
+ */
+struct Image {
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+    std::vector<uint8_t> pixels;
+
+    Image(int w, int h) : width(w), height(h), stride(w * 4), pixels(static_cast<size_t>(w) * h * 4) {}
+
+    uint8_t* data() { return pixels.data(); }
+    const uint8_t* data() const { return pixels.data(); }
+};
+
+static Image make_pattern(int width, int height) {
+    Image image(width, height);
+    uint32_t seed = 0x12345678u;
+    for (int y = 0; y < height; ++y) {
+        uint8_t* row = image.data() + y * image.stride;
+        for (int x = 0; x < width; ++x) {
+            seed = seed * 1664525u + 1013904223u;
+            const int checker = ((x / 8 + y / 8) & 1) ? 192 : 64;
+            const int gradient = x * 255 / width;
+            const int noise = static_cast<int>(seed >> 28);
+            row[x * 4 + 0] = static_cast<uint8_t>((checker + gradient) / 2 + noise);
+            row[x * 4 + 1] = static_cast<uint8_t>((checker + y * 255 / height) / 2);
+            row[x * 4 + 2] = static_cast<uint8_t>(gradient);
+            row[x * 4 + 3] = 255;
+        }
+    }
+    return image;
+}
+
+// ============================================================================
+// 计时与统计
+// ============================================================================
+
+static double now_ms() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1.0e6;
+}
+
+struct BenchOptions {
+    int iterations = 30;
+    int warmup = 3;
+    std::string cores = "all";
+    std::string filter;
+    std::vector<std::pair<int, int>> sizes = {{128, 128}, {512, 512}, {1080, 1920}};
+};
+
+/**
+ * 运行一个用例并打印统计结果
+ *
+ * @param prepare 每次计时前调用（不计时），用于恢复原位滤波器的输入
+ * @param run 被计时的内核调用
+ */
+static void run_case(
+    const BenchOptions& options,
+    const std::string& name,
+    int width,
+    int height,
+    const std::function<void()>& prepare,
+    const std::function<void()>& run
+) {
+    if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+
+    for (int i = 0; i < options.warmup; ++i) {
+        prepare();
+        run();
+    }
+
+    std::vector<double> samples;
+    samples.reserve(options.iterations);
+    for (int i = 0; i < options.iterations; ++i) {
+        prepare();
+        const double start = now_ms();
+        run();
+        samples.push_back(now_ms() - start);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const size_t n = samples.size();
+    const double median = samples[n / 2];
+    const size_t p99Index = std::min(n - 1, static_cast<size_t>(n * 0.99));
+    const double p99 = samples[p99Index];
+    const double mpix = median > 0.0 ? (static_cast<double>(width) * height / 1.0e6) / (median / 1000.0) : 0.0;
+
+    printf("%-40s %5dx%-5d  median %8.3f ms  p99 %8.3f ms  %8.1f MPix/s\n",
+           name.c_str(), width, height, median, p99, mpix);
+    fflush(stdout);
+}
+
+// ============================================================================
+// 绑核
+// ============================================================================
+
+static long read_cpu_max_freq(int cpu) {
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+    FILE* f = fopen(path, "r");
+    if (!f) return 0;
+    long freq = 0;
+    if (fscanf(f, "%ld", &freq) != 1) freq = 0;
+    fclose(f);
+    return freq;
+}
+
+/**
+ * 绑定当前线程（及之后创建的线程池）到大核 / 小核
+ *
+ * 与 thread_pool.cpp 的划分一致：最高频率高于最低档的核心算作大核
+ *
+ * @return 绑定的核心数；0 表示未绑定（all 或频率信息不可用）
+ */
+static int pin_to_cores(const std::string& which) {
+    if (which == "all") return 0;
+
+    const int cpuCount = static_cast<int>(sysconf(_SC_NPROCESSORS_CONF));
+    std::vector<long> freqs(std::max(cpuCount, 0));
+    long minFreq = 0;
+    for (int i = 0; i < cpuCount; ++i) {
+        freqs[i] = read_cpu_max_freq(i);
+        if (freqs[i] > 0 && (minFreq == 0 || freqs[i] < minFreq)) minFreq = freqs[i];
+    }
+    if (minFreq == 0) {
+        fprintf(stderr, "cpufreq not available, running unpinned\n");
+        return 0;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    int selected = 0;
+    for (int i = 0; i < cpuCount; ++i) {
+        if (freqs[i] <= 0) continue;
+        const bool isBig = freqs[i] > minFreq;
+        if ((which == "big") == isBig) {
+            CPU_SET(i, &set);
+            ++selected;
+        }
+    }
+
+    // 无大小核之分（所有核心频率相同）时 big 选不到核心：不绑核
+    if (selected == 0) {
+        fprintf(stderr, "no %s cores found, running unpinned\n", which.c_str());
+        return 0;
+    }
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        perror("sched_setaffinity");
+        return 0;
+    }
+    return selected;
+}
+
+// ============================================================================
+// 用例
+// ============================================================================
+
+static void bench_size(const BenchOptions& options, int width, int height) {
+    const Image source = make_pattern(width, height);
+    Image work(width, height);
+    Image result(width, height);
+
+    auto restore = [&]() { memcpy(work.data(), source.data(), source.pixels.size()); };
+    auto nothing = []() {};
+
+    // 辅助贴图（同时作为色差 / 色散用例的输入）
+    Image displacement(width, height);
+    Image edgeDistance(width, height);
+    Image normalMap(width, height);
+    Image alphaMask = make_pattern(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            // 圆形轮廓：圆外透明
+            const float dx = x - width * 0.5f;
+            const float dy = y - height * 0.5f;
+            const float r = std::min(width, height) * 0.5f;
+            alphaMask.data()[y * alphaMask.stride + x * 4 + 3] = (dx * dx + dy * dy <= r * r) ? 255 : 0;
+        }
+    }
+
+    generate_displacement_map_rgba8888(displacement.data(), width, height, displacement.stride, DISPLACEMENT_MODE_STANDARD);
+    generate_edge_maps_from_alpha(alphaMask.data(), alphaMask.stride,
+                                  edgeDistance.data(), edgeDistance.stride,
+                                  normalMap.data(), normalMap.stride,
+                                  width, height, 10, 0.0f);
+
+    char name[96];
+
+    // IIR 高斯
+    static const float kSigmas[] = {2.0f, 6.0f, 12.0f, 24.0f};
+    for (float sigma : kSigmas) {
+        for (int linear = 0; linear <= 1; ++linear) {
+            snprintf(name, sizeof(name), "iir_scalar sigma=%.0f%s", sigma, linear ? " linear" : "");
+            run_case(options, name, width, height, restore, [&]() {
+                gaussian_iir_rgba8888_inplace(work.data(), width, height, work.stride, sigma, linear != 0);
+            });
+            snprintf(name, sizeof(name), "iir_neon sigma=%.0f%s", sigma, linear ? " linear" : "");
+            run_case(options, name, width, height, restore, [&]() {
+                gaussian_iir_rgba8888_neon(work.data(), width, height, work.stride, sigma, linear != 0);
+            });
+            if (!linear && has_fp16_support()) {
+                snprintf(name, sizeof(name), "iir_fp16 sigma=%.0f", sigma);
+                run_case(options, name, width, height, restore, [&]() {
+                    gaussian_iir_rgba8888_fp16(work.data(), width, height, work.stride, sigma);
+                });
+            }
+        }
+    }
+
+    // Box3
+    static const int kRadii[] = {2, 6, 12, 24};
+    for (int radius : kRadii) {
+        snprintf(name, sizeof(name), "box3 radius=%d", radius);
+        run_case(options, name, width, height, restore, [&]() {
+            box3_rgba8888_inplace(work.data(), width, height, work.stride, radius);
+        });
+    }
+
+    // 金字塔模糊（与 IIR 使用相同 σ，便于对比）
+    for (float sigma : kSigmas) {
+        snprintf(name, sizeof(name), "pyramid sigma=%.0f", sigma);
+        run_case(options, name, width, height, restore, [&]() {
+            pyramid_blur_rgba8888_inplace(work.data(), width, height, work.stride, sigma);
+        });
+    }
+
+    // 降采样盒式模糊
+    static const float kAdvancedRadii[] = {10.0f, 25.0f};
+    static const float kDownscales[] = {0.25f, 0.5f};
+    for (float radius : kAdvancedRadii) {
+        for (float downscale : kDownscales) {
+            snprintf(name, sizeof(name), "advanced_box radius=%.0f ds=%.2f", radius, downscale);
+            run_case(options, name, width, height, nothing, [&]() {
+                advanced_box_blur_rgba8888(source.data(), result.data(), width, height, source.stride, radius, downscale);
+            });
+            snprintf(name, sizeof(name), "advanced_box_hq radius=%.0f ds=%.2f", radius, downscale);
+            run_case(options, name, width, height, nothing, [&]() {
+                advanced_box_blur_rgba8888_hq(source.data(), result.data(), width, height, source.stride, radius, downscale);
+            });
+        }
+    }
+
+    // 双线性缩放（半尺寸往返）
+    {
+        const int halfWidth = std::max(1, width / 2);
+        const int halfHeight = std::max(1, height / 2);
+        Image half(halfWidth, halfHeight);
+        run_case(options, "resize_bilinear 0.5x", width, height, nothing, [&]() {
+            resize_bilinear_rgba8888(source.data(), width, height, source.stride,
+                                     half.data(), halfWidth, halfHeight, half.stride);
+        });
+        run_case(options, "resize_bilinear 2x", width, height, nothing, [&]() {
+            resize_bilinear_rgba8888(half.data(), halfWidth, halfHeight, half.stride,
+                                     result.data(), width, height, result.stride);
+        });
+    }
+
+    // 色差 / 色散
+    for (int bilinear = 1; bilinear >= 0; --bilinear) {
+        const char* sampling = bilinear ? "bilinear" : "nearest";
+
+        snprintf(name, sizeof(name), "aberration %s", sampling);
+        run_case(options, name, width, height, nothing, [&]() {
+            chromatic_aberration_rgba8888(source.data(), displacement.data(), result.data(),
+                                          width, height, source.stride, displacement.stride, result.stride,
+                                          2.0f, 70.0f, 0.0f, -0.05f, -0.1f, bilinear != 0);
+        });
+
+        snprintf(name, sizeof(name), "dispersion radial %s", sampling);
+        run_case(options, name, width, height, nothing, [&]() {
+            chromatic_dispersion_rgba8888(source.data(), edgeDistance.data(), nullptr, result.data(),
+                                          width, height, source.stride, edgeDistance.stride, 0, result.stride,
+                                          100.0f, 1.5f, 7.0f, 1.0f, bilinear != 0);
+        });
+
+        snprintf(name, sizeof(name), "dispersion normals %s", sampling);
+        run_case(options, name, width, height, nothing, [&]() {
+            chromatic_dispersion_rgba8888(source.data(), edgeDistance.data(), normalMap.data(), result.data(),
+                                          width, height, source.stride, edgeDistance.stride, normalMap.stride,
+                                          result.stride, 100.0f, 1.5f, 7.0f, 1.0f, bilinear != 0);
+        });
+    }
+
+    // 辅助贴图生成
+    run_case(options, "displacement_map standard", width, height, nothing, [&]() {
+        generate_displacement_map_rgba8888(result.data(), width, height, result.stride, DISPLACEMENT_MODE_STANDARD);
+    });
+    run_case(options, "edge_maps with normals", width, height, nothing, [&]() {
+        generate_edge_maps_from_alpha(alphaMask.data(), alphaMask.stride,
+                                      edgeDistance.data(), edgeDistance.stride,
+                                      normalMap.data(), normalMap.stride,
+                                      width, height, 10, 0.0f);
+    });
+
+    // 融合管线（智能模糊 + 饱和度 + 色差）
+    GlassPipelineParams params;
+    params.blurMode = GLASS_BLUR_SMART;
+    params.sigma = 8.0f;
+    params.saturation = 1.4f;
+    params.effect = GLASS_EFFECT_ABERRATION;
+    params.displacement = displacement.data();
+    params.displacementStride = displacement.stride;
+    params.scale = 70.0f;
+    params.greenOffset = -0.05f * 2.0f;
+    params.blueOffset = -0.1f * 2.0f;
+    run_case(options, "pipeline smart+sat+aberration", width, height, nothing, [&]() {
+        render_glass_pipeline(source.data(), source.stride, result.data(), result.stride, width, height, params);
+    });
+}
+
+// ============================================================================
+// 入口
+// ============================================================================
+
+static bool parse_sizes(const char* text, std::vector<std::pair<int, int>>* sizes) {
+    sizes->clear();
+    std::string s(text);
+    size_t pos = 0;
+    while (pos < s.size()) {
+        size_t comma = s.find(',', pos);
+        if (comma == std::string::npos) comma = s.size();
+        int w = 0, h = 0;
+        if (sscanf(s.substr(pos, comma - pos).c_str(), "%dx%d", &w, &h) != 2 || w <= 0 || h <= 0) {
+            return false;
+        }
+        sizes->emplace_back(w, h);
+        pos = comma + 1;
+    }
+    return !sizes->empty();
+}
+
+static void print_usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--cores big|little|all] [--iterations N] [--warmup N]\n"
+            "          [--sizes WxH,WxH,...] [--filter TEXT] [--disable-features MASK]\n", argv0);
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--cores") == 0 && hasValue) {
+            options.cores = argv[++i];
+        } else if (strcmp(arg, "--iterations") == 0 && hasValue) {
+            options.iterations = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(arg, "--warmup") == 0 && hasValue) {
+            options.warmup = std::max(0, atoi(argv[++i]));
+        } else if (strcmp(arg, "--sizes") == 0 && hasValue) {
+            if (!parse_sizes(argv[++i], &options.sizes)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(arg, "--filter") == 0 && hasValue) {
+            options.filter = argv[++i];
+        } else if (strcmp(arg, "--disable-features") == 0 && hasValue) {
+            cpu_features_set_disabled(static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0)));
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.cores != "big" && options.cores != "little" && options.cores != "all") {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // 必须在首次使用线程池之前绑核
+    const int pinned = pin_to_cores(options.cores);
+
+    char features[64];
+    cpu_features_describe(cpu_features(), features, sizeof(features));
+    printf("nativegauss_bench: cores=%s (%d pinned), threads=%d, cpu=%s, iterations=%d\n",
+           options.cores.c_str(), pinned, thread_pool_concurrency(), features, options.iterations);
+
+    for (const auto& size : options.sizes) {
+        bench_size(options, size.first, size.second);
+    }
+
+    scratch_arena_trim();
+    return 0;
+}
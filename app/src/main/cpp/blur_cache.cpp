@@ -0,0 +1,178 @@
+/**
+ * blur_cache.cpp - 模糊结果缓存实现
+ *
+ * 实现细节：
+ * - 条目数很少（默认 4），线性查找即可；lastUse 为单调递增的访问序号
+ * - 复制在锁内进行：条目缓冲可能被并发的 store 复用，不能在锁外读取
+ */
+
+#include "blur_cache.h"
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <android/log.h>
+
+#define LOG_TAG "BlurCache"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+/**
+ * 缓存条目（像素紧密存放）
+ */
+struct BlurCacheEntry {
+    BlurCacheKey key;
+    std::vector<uint8_t> pixels;
+    uint64_t lastUse = 0;
+};
+
+/**
+ * 全局缓存状态（所有字段由 mutex 保护）
+ */
+struct BlurCache {
+    std::mutex mutex;
+    std::vector<BlurCacheEntry> entries;
+    std::vector<uint8_t> spare;     // 最近淘汰的缓冲，供下一个新条目复用
+    int maxEntries = 4;
+    size_t maxBytes = 32u * 1024 * 1024;
+    size_t bytes = 0;
+    uint64_t clock = 0;
+    int64_t hits = 0;
+    int64_t misses = 0;
+};
+
+static BlurCache& cache() {
+    static BlurCache instance;
+    return instance;
+}
+
+static bool valid_key(const BlurCacheKey& key) {
+    return key.hash != 0 && key.width > 0 && key.height > 0;
+}
+
+static size_t entry_bytes(const BlurCacheKey& key) {
+    return static_cast<size_t>(key.width) * key.height * 4;
+}
+
+static BlurCacheEntry* find_locked(BlurCache& c, const BlurCacheKey& key) {
+    for (BlurCacheEntry& e : c.entries) {
+        if (e.key == key) return &e;
+    }
+    return nullptr;
+}
+
+/**
+ * 淘汰最久未用的条目（缓冲移入 spare）
+ */
+static void evict_lru_locked(BlurCache& c) {
+    if (c.entries.empty()) return;
+    size_t oldest = 0;
+    for (size_t i = 1; i < c.entries.size(); ++i) {
+        if (c.entries[i].lastUse < c.entries[oldest].lastUse) oldest = i;
+    }
+    c.bytes -= c.entries[oldest].pixels.size();
+    c.spare.swap(c.entries[oldest].pixels);
+    c.entries.erase(c.entries.begin() + oldest);
+}
+
+static void trim_locked(BlurCache& c, int entries, size_t bytes) {
+    while (!c.entries.empty() &&
+           (static_cast<int>(c.entries.size()) > entries || c.bytes > bytes)) {
+        evict_lru_locked(c);
+    }
+}
+
+void blur_cache_set_capacity(int entries, size_t maxBytes) {
+    BlurCache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    c.maxEntries = entries > 0 ? entries : 0;
+    c.maxBytes = maxBytes;
+    trim_locked(c, c.maxEntries, c.maxBytes);
+    if (c.maxEntries == 0) {
+        std::vector<uint8_t>().swap(c.spare);
+    }
+    LOGD("Capacity: %d entries, %zu KB", c.maxEntries, c.maxBytes / 1024);
+}
+
+bool blur_cache_enabled() {
+    BlurCache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    return c.maxEntries > 0;
+}
+
+bool blur_cache_lookup(const BlurCacheKey& key, uint8_t* dst, int dstStride) {
+    if (!valid_key(key) || !dst || dstStride < key.width * 4) return false;
+
+    BlurCache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    BlurCacheEntry* e = find_locked(c, key);
+    if (!e) {
+        ++c.misses;
+        return false;
+    }
+
+    const size_t rowBytes = static_cast<size_t>(key.width) * 4;
+    for (int y = 0; y < key.height; ++y) {
+        memcpy(dst + static_cast<size_t>(y) * dstStride, e->pixels.data() + y * rowBytes, rowBytes);
+    }
+    e->lastUse = ++c.clock;
+    ++c.hits;
+    return true;
+}
+
+bool blur_cache_contains(const BlurCacheKey& key) {
+    if (!valid_key(key)) return false;
+
+    BlurCache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    return find_locked(c, key) != nullptr;
+}
+
+void blur_cache_store(const BlurCacheKey& key, const uint8_t* src, int srcStride) {
+    if (!valid_key(key) || !src || srcStride < key.width * 4) return;
+
+    const size_t bytes = entry_bytes(key);
+    BlurCache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    if (c.maxEntries == 0 || bytes > c.maxBytes) return;
+
+    BlurCacheEntry* e = find_locked(c, key);
+    if (!e) {
+        trim_locked(c, c.maxEntries - 1, c.maxBytes - bytes);
+        c.entries.emplace_back();
+        e = &c.entries.back();
+        e->key = key;
+        e->pixels.swap(c.spare);
+        e->pixels.resize(bytes);
+        c.bytes += bytes;
+    }
+
+    const size_t rowBytes = static_cast<size_t>(key.width) * 4;
+    for (int y = 0; y < key.height; ++y) {
+        memcpy(e->pixels.data() + y * rowBytes, src + static_cast<size_t>(y) * srcStride, rowBytes);
+    }
+    e->lastUse = ++c.clock;
+}
+
+size_t blur_cache_clear() {
+    BlurCache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    size_t released = c.spare.capacity();
+    for (const BlurCacheEntry& e : c.entries) {
+        released += e.pixels.capacity();
+    }
+    c.entries.clear();
+    std::vector<uint8_t>().swap(c.spare);
+    c.bytes = 0;
+    return released;
+}
+
+BlurCacheStats blur_cache_stats() {
+    BlurCache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    BlurCacheStats stats;
+    stats.hits = c.hits;
+    stats.misses = c.misses;
+    stats.entries = static_cast<int>(c.entries.size());
+    stats.bytes = c.bytes;
+    return stats;
+}
@@ -0,0 +1,109 @@
+/**
+ * blur_cache.h - 模糊结果缓存（按背景内容哈希 + 参数查找）
+ *
+ * 背景：
+ * - 静止背景、只有玻璃在移动或参数来回切换时，同一张背景会以相同参数被反复模糊
+ * - 这里保存最近几次的模糊 + 饱和度结果，键相同时直接复制，跳过全部滤波
+ *
+ * 设计：
+ * - 键：背景内容哈希（frame_hash_rgba8888）+ 尺寸 + 模糊方式 + 变体 + σ + 饱和度
+ * - 全局 LRU，默认 4 个条目、总计 32 MB；单个结果超过上限时不缓存
+ * - 淘汰的条目缓冲留给新条目复用，尺寸不变的稳态下不产生分配
+ * - 内容紧密存放（行跨度 = width × 4），查找时按目标行跨度复制
+ *
+ * method 取值约定：
+ * - 融合管线使用 GlassBlurMode（< kBlurCacheCustomMethod）
+ * - 其他调用方（如 Kotlin 分步渲染）使用 >= kBlurCacheCustomMethod 的自定义值，
+ *   避免与管线结果混用（两者饱和度 / 模糊实现不同）
+ *
+ * 线程安全：所有函数可从任意线程调用（内部互斥锁）
+ */
+
+#ifndef BLUR_CACHE_H
+#define BLUR_CACHE_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * 自定义模糊方式的起始值
+ */
+static const int kBlurCacheCustomMethod = 16;
+
+/**
+ * 缓存键
+ */
+struct BlurCacheKey {
+    uint64_t hash = 0;          // 背景内容哈希（0 = 未知，不参与缓存）
+    int width = 0;
+    int height = 0;
+    int method = 0;             // 模糊方式（见上方取值约定）
+    int variant = 0;            // 其余影响结果的选项（如 highQuality）
+    float sigma = 0.0f;
+    float saturation = 1.0f;
+    uint32_t mask = 0;          // 可见区域遮罩摘要（0 = 整帧有效；遮罩下只有部分区域有效）
+
+    bool operator==(const BlurCacheKey& o) const {
+        return hash == o.hash && width == o.width && height == o.height && method == o.method &&
+               variant == o.variant && sigma == o.sigma && saturation == o.saturation && mask == o.mask;
+    }
+};
+
+/**
+ * 缓存统计
+ */
+struct BlurCacheStats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int entries = 0;
+    size_t bytes = 0;
+};
+
+/**
+ * 设置缓存容量（超出部分立即淘汰）
+ *
+ * @param entries 最大条目数（0 = 关闭缓存）
+ * @param maxBytes 所有条目的总字节数上限
+ */
+void blur_cache_set_capacity(int entries, size_t maxBytes);
+
+/**
+ * 缓存是否开启（关闭时调用方可跳过内容哈希）
+ */
+bool blur_cache_enabled();
+
+/**
+ * 查找缓存并复制到 dst
+ *
+ * @param dst 目标像素（RGBA8888，尺寸为 key.width × key.height）
+ * @param dstStride 目标行跨度（字节数）
+ * @return true 如果命中（dst 已写入）
+ */
+bool blur_cache_lookup(const BlurCacheKey& key, uint8_t* dst, int dstStride);
+
+/**
+ * 是否存在对应条目（不复制、不计入命中统计）
+ */
+bool blur_cache_contains(const BlurCacheKey& key);
+
+/**
+ * 保存结果（相同键的旧条目被替换）
+ *
+ * @param src 结果像素（RGBA8888，尺寸为 key.width × key.height）
+ * @param srcStride 结果行跨度（字节数）
+ */
+void blur_cache_store(const BlurCacheKey& key, const uint8_t* src, int srcStride);
+
+/**
+ * 清空缓存（用于 onTrimMemory / 页面退出）
+ *
+ * @return 释放的字节数
+ */
+size_t blur_cache_clear();
+
+/**
+ * 统计快照
+ */
+BlurCacheStats blur_cache_stats();
+
+#endif // BLUR_CACHE_H
@@ -0,0 +1,318 @@
+/**
+ * blur_tuner.cpp - 智能模糊交叉点表与校准实现
+ *
+ * 实现细节：
+ * - 每个格子的代表尺寸 / σ 取档位中间附近的值（kTunerSizes / kTunerSigmas）
+ * - 每个候选先预热一次（首次调用的临时缓冲分配不计入），再取若干次计时的中位数；
+ *   每次计时前重新复制输入，结果不随迭代累积
+ * - 校准结果先写入局部表，每个尺寸档完成后再发布，查表方不会看到半档结果
+ */
+
+#include "blur_tuner.h"
+#include "boxblur.h"
+#include "gauss_iir_fp16.h"
+#include "gauss_iir_neon.h"
+#include "perf_trace.h"
+#include "pyramid_blur.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <android/log.h>
+
+#define LOG_TAG "BlurTuner"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// 导出格式：'B' 'T' 版本 档位数（高 4 位尺寸档、低 4 位 σ 档），随后按 [模式][尺寸档][σ 档] 排列
+static const uint8_t kTunerMagic0 = 'B';
+static const uint8_t kTunerMagic1 = 'T';
+static const uint8_t kTunerVersion = 1;
+static const uint8_t kTunerShape = (kTunerSizeBuckets << 4) | kTunerSigmaBuckets;
+
+// 尺寸档上限（像素数，不含）与代表尺寸
+static const int64_t kTunerSizeLimits[kTunerSizeBuckets - 1] = {
+    64 * 64, 128 * 128, 256 * 256, 512 * 512, 1024 * 1024
+};
+static const int kTunerSizes[kTunerSizeBuckets][2] = {
+    { 48, 48 }, { 96, 96 }, { 192, 192 }, { 384, 384 }, { 768, 768 }, { 1280, 960 }
+};
+
+// σ 档上限（不含）与代表 σ
+static const float kTunerSigmaLimits[kTunerSigmaBuckets - 1] = { 4.0f, 8.0f, 16.0f, 32.0f };
+static const float kTunerSigmas[kTunerSigmaBuckets] = { 2.5f, 6.0f, 12.0f, 24.0f, 40.0f };
+
+/**
+ * 候选替换 IIR 所需的最小收益：耗时须低于 IIR 的 90%
+ */
+static const double kTunerMinGain = 0.9;
+
+/**
+ * 每个候选的计时次数（累计超过 kTunerSampleBudgetNs 后提前结束，至少 kTunerMinSamples 次）
+ */
+static const int kTunerMaxSamples = 5;
+static const int kTunerMinSamples = 2;
+static const uint64_t kTunerSampleBudgetNs = 40ull * 1000 * 1000;
+
+/**
+ * 默认表：与原先的固定阈值一致（< 64×64 且 σ < 8 用 Box3，其余 IIR）
+ */
+static int default_method(int sizeBucket, int sigmaBucket) {
+    return (sizeBucket == 0 && sigmaBucket <= 1) ? BLUR_TUNER_BOX3 : BLUR_TUNER_IIR;
+}
+
+/**
+ * 候选是否允许出现在该格子
+ *
+ * - 金字塔只支持 sRGB 模式
+ * - 线性模式的 Box3 在 sRGB 空间平均，只在默认表本来就用 Box3 的格子里参与比较；
+ *   其余格子换成 Box3 虽然更快，但丢掉了 highQuality 所要求的线性空间模糊
+ */
+static bool method_allowed(int method, bool highQuality, int sizeBucket, int sigmaBucket) {
+    if (!highQuality || method == BLUR_TUNER_IIR) return true;
+    return method == BLUR_TUNER_BOX3 && default_method(sizeBucket, sigmaBucket) == BLUR_TUNER_BOX3;
+}
+
+/**
+ * 全局状态
+ */
+struct BlurTuner {
+    std::atomic<uint8_t> cells[2][kTunerSizeBuckets][kTunerSigmaBuckets];
+    std::atomic<bool> calibrated{false};
+    std::mutex calibrateMutex;     // 同一时刻只允许一次校准
+
+    BlurTuner() { reset(); }
+
+    void reset() {
+        for (int mode = 0; mode < 2; ++mode) {
+            for (int s = 0; s < kTunerSizeBuckets; ++s) {
+                for (int g = 0; g < kTunerSigmaBuckets; ++g) {
+                    cells[mode][s][g].store(default_method(s, g), std::memory_order_relaxed);
+                }
+            }
+        }
+        calibrated.store(false, std::memory_order_relaxed);
+    }
+};
+
+static BlurTuner& tuner() {
+    static BlurTuner instance;
+    return instance;
+}
+
+static int size_bucket(int width, int height) {
+    const int64_t pixels = static_cast<int64_t>(width) * height;
+    for (int i = 0; i < kTunerSizeBuckets - 1; ++i) {
+        if (pixels < kTunerSizeLimits[i]) return i;
+    }
+    return kTunerSizeBuckets - 1;
+}
+
+static int sigma_bucket(float sigma) {
+    for (int i = 0; i < kTunerSigmaBuckets - 1; ++i) {
+        if (sigma < kTunerSigmaLimits[i]) return i;
+    }
+    return kTunerSigmaBuckets - 1;
+}
+
+int blur_tuner_select(int width, int height, float sigma, bool highQuality) {
+    const int method = tuner().cells[highQuality ? 1 : 0][size_bucket(width, height)][sigma_bucket(sigma)]
+                           .load(std::memory_order_relaxed);
+    // 线性模式的表不会含金字塔（导入时已校验），这里再兜底一次
+    return (highQuality && method == BLUR_TUNER_PYRAMID) ? BLUR_TUNER_IIR : method;
+}
+
+/**
+ * 执行一个候选（与 smartBlur / 融合管线的实际调用一致）
+ */
+static void run_candidate(int method, uint8_t* base, int w, int h, int stride, float sigma, bool highQuality) {
+    if (method == BLUR_TUNER_BOX3) {
+        box3_rgba8888_inplace(base, w, h, stride, std::max(1, static_cast<int>(sigma * 1.2f)));
+    } else if (method == BLUR_TUNER_PYRAMID) {
+        pyramid_blur_rgba8888_inplace(base, w, h, stride, sigma);
+    } else if (!highQuality && sigma <= kFp16MaxSigma && has_fp16_support()) {
+        gaussian_iir_rgba8888_fp16(base, w, h, stride, sigma);
+    } else {
+        // 无向量后端时内部回退标量
+        gaussian_iir_rgba8888_neon(base, w, h, stride, sigma, highQuality);
+    }
+}
+
+/**
+ * 候选的中位耗时（纳秒）
+ */
+static uint64_t time_candidate(
+    int method,
+    const std::vector<uint8_t>& input,
+    std::vector<uint8_t>& work,
+    int w,
+    int h,
+    float sigma,
+    bool highQuality
+) {
+    const int stride = w * 4;
+
+    // 预热：临时缓冲分配、查找表生成不计入
+    memcpy(work.data(), input.data(), input.size());
+    run_candidate(method, work.data(), w, h, stride, sigma, highQuality);
+
+    uint64_t samples[kTunerMaxSamples];
+    uint64_t total = 0;
+    int count = 0;
+    while (count < kTunerMaxSamples && (count < kTunerMinSamples || total < kTunerSampleBudgetNs)) {
+        memcpy(work.data(), input.data(), input.size());
+        const uint64_t start = perf_trace_now_ns();
+        run_candidate(method, work.data(), w, h, stride, sigma, highQuality);
+        samples[count] = perf_trace_now_ns() - start;
+        total += samples[count];
+        ++count;
+    }
+
+    std::sort(samples, samples + count);
+    return samples[count / 2];
+}
+
+/**
+ * 校准输入：棋盘格 + 渐变 + 伪随机噪声（与基准程序的测试图相同构造）
+ */
+static void fill_pattern(std::vector<uint8_t>& pixels, int w, int h) {
+    uint32_t seed = 0x12345678u;
+    for (int y = 0; y < h; ++y) {
+        uint8_t* row = pixels.data() + static_cast<size_t>(y) * w * 4;
+        for (int x = 0; x < w; ++x) {
+            seed = seed * 1664525u + 1013904223u;
+            const int checker = ((x / 8 + y / 8) & 1) ? 192 : 64;
+            const int gradient = x * 255 / w;
+            row[x * 4 + 0] = static_cast<uint8_t>((checker + gradient) / 2 + (seed >> 28));
+            row[x * 4 + 1] = static_cast<uint8_t>((checker + y * 255 / h) / 2);
+            row[x * 4 + 2] = static_cast<uint8_t>(gradient);
+            row[x * 4 + 3] = 255;
+        }
+    }
+}
+
+int blur_tuner_calibrate(int budgetMs) {
+    BlurTuner& t = tuner();
+    std::lock_guard<std::mutex> lock(t.calibrateMutex);
+
+    const uint64_t start = perf_trace_now_ns();
+    const uint64_t budgetNs = budgetMs > 0 ? static_cast<uint64_t>(budgetMs) * 1000 * 1000 : 0;
+    uint8_t table[2][kTunerSizeBuckets][kTunerSigmaBuckets];
+    int calibratedBuckets = 0;
+
+    for (int s = 0; s < kTunerSizeBuckets; ++s) {
+        if (s > 0 && budgetNs > 0 && perf_trace_now_ns() - start > budgetNs) break;
+
+        const int w = kTunerSizes[s][0];
+        const int h = kTunerSizes[s][1];
+        std::vector<uint8_t> input(static_cast<size_t>(w) * h * 4);
+        std::vector<uint8_t> work(input.size());
+        fill_pattern(input, w, h);
+
+        for (int mode = 0; mode < 2; ++mode) {
+            const bool highQuality = mode == 1;
+            for (int g = 0; g < kTunerSigmaBuckets; ++g) {
+                const float sigma = kTunerSigmas[g];
+                const uint64_t iirNs = time_candidate(BLUR_TUNER_IIR, input, work, w, h, sigma, highQuality);
+                int best = BLUR_TUNER_IIR;
+                uint64_t bestNs = iirNs;
+
+                for (int method = BLUR_TUNER_BOX3; method < BLUR_TUNER_METHOD_COUNT; ++method) {
+                    if (!method_allowed(method, highQuality, s, g) ||
+                        (method == BLUR_TUNER_PYRAMID && pyramid_blur_levels(w, h, sigma) == 0)) {
+                        continue;   // 0 层金字塔与 IIR 相同
+                    }
+                    const uint64_t ns = time_candidate(method, input, work, w, h, sigma, highQuality);
+                    if (ns < bestNs && ns < iirNs * kTunerMinGain) {
+                        best = method;
+                        bestNs = ns;
+                    }
+                }
+                table[mode][s][g] = static_cast<uint8_t>(best);
+                LOGD("%dx%d sigma=%.1f %s: method=%d (%.3f ms, IIR %.3f ms)", w, h, sigma,
+                     highQuality ? "linear" : "srgb", best, bestNs / 1.0e6, iirNs / 1.0e6);
+            }
+        }
+
+        // 每档完成后发布
+        for (int mode = 0; mode < 2; ++mode) {
+            for (int g = 0; g < kTunerSigmaBuckets; ++g) {
+                t.cells[mode][s][g].store(table[mode][s][g], std::memory_order_relaxed);
+            }
+        }
+        calibratedBuckets = s + 1;
+    }
+
+    // 超出预算：剩余尺寸档沿用最后一个已校准档
+    for (int s = calibratedBuckets; s < kTunerSizeBuckets; ++s) {
+        for (int mode = 0; mode < 2; ++mode) {
+            for (int g = 0; g < kTunerSigmaBuckets; ++g) {
+                t.cells[mode][s][g].store(table[mode][calibratedBuckets - 1][g], std::memory_order_relaxed);
+            }
+        }
+    }
+    t.calibrated.store(true, std::memory_order_relaxed);
+
+    const int elapsedMs = static_cast<int>((perf_trace_now_ns() - start) / 1000000);
+    LOGD("Calibrated %d/%d size buckets in %d ms", calibratedBuckets, kTunerSizeBuckets, elapsedMs);
+    return elapsedMs;
+}
+
+void blur_tuner_reset() {
+    BlurTuner& t = tuner();
+    std::lock_guard<std::mutex> lock(t.calibrateMutex);
+    t.reset();
+}
+
+bool blur_tuner_calibrated() {
+    return tuner().calibrated.load(std::memory_order_relaxed);
+}
+
+size_t blur_tuner_export(uint8_t* out, size_t size) {
+    if (!out || size < kTunerTableBytes) return 0;
+
+    BlurTuner& t = tuner();
+    out[0] = kTunerMagic0;
+    out[1] = kTunerMagic1;
+    out[2] = kTunerVersion;
+    out[3] = kTunerShape;
+    size_t i = 4;
+    for (int mode = 0; mode < 2; ++mode) {
+        for (int s = 0; s < kTunerSizeBuckets; ++s) {
+            for (int g = 0; g < kTunerSigmaBuckets; ++g) {
+                out[i++] = t.cells[mode][s][g].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    return i;
+}
+
+bool blur_tuner_import(const uint8_t* data, size_t size) {
+    if (!data || size != kTunerTableBytes || data[0] != kTunerMagic0 || data[1] != kTunerMagic1 ||
+        data[2] != kTunerVersion || data[3] != kTunerShape) {
+        LOGE("Rejected tuner table: %zu bytes", size);
+        return false;
+    }
+
+    const uint8_t* cells = data + 4;
+    const int perMode = kTunerSizeBuckets * kTunerSigmaBuckets;
+    for (int i = 0; i < 2 * perMode; ++i) {
+        const bool linear = i >= perMode;
+        const int s = (i % perMode) / kTunerSigmaBuckets;
+        const int g = i % kTunerSigmaBuckets;
+        if (cells[i] >= BLUR_TUNER_METHOD_COUNT || !method_allowed(cells[i], linear, s, g)) {
+            LOGE("Rejected tuner table: invalid method %d", cells[i]);
+            return false;
+        }
+    }
+
+    BlurTuner& t = tuner();
+    std::lock_guard<std::mutex> lock(t.calibrateMutex);
+    for (int i = 0; i < 2 * perMode; ++i) {
+        t.cells[i / perMode][(i % perMode) / kTunerSigmaBuckets][i % kTunerSigmaBuckets]
+            .store(cells[i], std::memory_order_relaxed);
+    }
+    t.calibrated.store(true, std::memory_order_relaxed);
+    return true;
+}
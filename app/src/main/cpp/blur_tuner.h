@@ -0,0 +1,100 @@
+/**
+ * blur_tuner.h - 智能模糊的设备自适应选择（运行时校准的交叉点表）
+ *
+ * 背景：
+ * - smartBlur / GLASS_BLUR_SMART 原先按固定阈值选择（图像 < 64×64 且 σ < 8 时用 Box3），
+ *   各滤波器的快慢交叉点随 CPU、缓存与后端（NEON / FP16 / x86）差异很大，固定阈值在不少设备上选错
+ *
+ * 设计：
+ * - 交叉点表：[模式（sRGB / 线性）][尺寸档][σ 档] → 方法（IIR / Box3 / 金字塔）
+ * - 未校准时使用默认表，与原先的固定阈值完全一致
+ * - blur_tuner_calibrate() 在每个格子的代表尺寸 / σ 上实测各候选的中位耗时，选最快者；
+ *   候选必须比 IIR 快 kTunerMinGain 以上才替换 IIR（避免测量噪声造成的来回翻转）
+ * - 线性模式（highQuality）只在默认表用 Box3 的格子里比较 IIR（线性）与 Box3，其余格子固定 IIR：
+ *   金字塔只支持 sRGB 模式，Box3 在 sRGB 空间平均
+ * - 表可导出为字节串（Kotlin 侧持久化），下次启动直接导入，不必重新校准
+ *
+ * 线程安全：
+ * - 查表、导入、导出可从任意线程调用；每个格子为原子变量，校准过程中查表得到新旧值之一
+ * - 校准应在后台线程执行：耗时约数百毫秒，期间占用线程池
+ */
+
+#ifndef BLUR_TUNER_H
+#define BLUR_TUNER_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * 智能模糊的候选方法
+ */
+enum BlurTunerMethod {
+    BLUR_TUNER_IIR = 0,      // IIR 递归高斯（非线性模式优先 FP16，其次向量 / 标量版本）
+    BLUR_TUNER_BOX3 = 1,     // 三次盒式模糊（radius = σ × 1.2）
+    BLUR_TUNER_PYRAMID = 2,  // 降采样金字塔（仅 sRGB 模式）
+    BLUR_TUNER_METHOD_COUNT
+};
+
+/**
+ * 尺寸档（按像素数）：< 64², < 128², < 256², < 512², < 1024², 其余
+ */
+static const int kTunerSizeBuckets = 6;
+
+/**
+ * σ 档：< 4, < 8, < 16, < 32, 其余
+ */
+static const int kTunerSigmaBuckets = 5;
+
+/**
+ * 导出表的字节数（头部 4 字节 + 2 × 尺寸档 × σ 档）
+ */
+static const size_t kTunerTableBytes = 4 + 2 * kTunerSizeBuckets * kTunerSigmaBuckets;
+
+/**
+ * 按当前交叉点表选择方法
+ *
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param sigma 高斯标准差
+ * @param highQuality 是否线性色彩空间（为 true 时不会返回 BLUR_TUNER_PYRAMID）
+ * @return BlurTunerMethod
+ */
+int blur_tuner_select(int width, int height, float sigma, bool highQuality);
+
+/**
+ * 实测校准并更新交叉点表
+ *
+ * 按尺寸从小到大校准；累计耗时超过 budgetMs 时，剩余尺寸档沿用最后一个已校准档的结果
+ *
+ * @param budgetMs 时间预算（毫秒，≤ 0 表示不限）
+ * @return 实际耗时（毫秒）
+ */
+int blur_tuner_calibrate(int budgetMs);
+
+/**
+ * 恢复默认表（与原先的固定阈值一致），并清除已校准标记
+ */
+void blur_tuner_reset();
+
+/**
+ * 交叉点表是否来自校准（或导入的校准结果）
+ */
+bool blur_tuner_calibrated();
+
+/**
+ * 导出交叉点表
+ *
+ * @param out 输出缓冲（至少 kTunerTableBytes 字节）
+ * @param size 缓冲大小
+ * @return 写入的字节数；缓冲不足时为 0
+ */
+size_t blur_tuner_export(uint8_t* out, size_t size);
+
+/**
+ * 导入交叉点表（blur_tuner_export 的结果）
+ *
+ * @return false 如果版本、档位数或方法取值不匹配（表保持不变）
+ */
+bool blur_tuner_import(const uint8_t* data, size_t size);
+
+#endif // BLUR_TUNER_H
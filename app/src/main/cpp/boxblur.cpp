@@ -18,119 +18,558 @@
  * 
  * 三次迭代：
  *   根据中心极限定理，三次盒式模糊的结果趋近于高斯分布
+ *   先对每行连续做三次横向（行缓冲驻留 L1），再对每个 16 列条带连续做三次纵向，
+ *   整帧只读写两遍，无整帧临时缓冲
  *   等效 σ ≈ sqrt(radius² * 3 / 12) ≈ radius / 2
  * 
- * 时间复杂度：O(W×H)，每像素约 4 次加法 + 1 次除法（单通道单次）
- * 空间复杂度：O(W×H)，需要一个临时缓冲区
+ * 时间复杂度：O(W×H)，每像素约 4 次加法 + 1 次定点乘法（单通道单次）
+ * 
+ * NEON 优化：
+ *   横向 RGBA 窗口和放在一个 uint32x4_t，纵向每次处理 16 字节（4 个像素）；
+ *   循环拆分为边界段与无钳位内部段
+ * x86 优化（运行时分派）：
+ *   SSE4.1 与 NEON 版本逐项对应（_mm_mullo_epi32 做定点乘法）；
+ *   AVX2 纵向每次处理 32 字节（8 个像素），横向窗口只有 4 个通道，沿用 SSE4.1
+ * 空间复杂度：Box3 为 O(max(W, 16×H))；单次模糊需要整帧临时缓冲（取自 scratch_arena，跨帧复用）
  */
 
 #include "boxblur.h"
+#include "color_matrix.h"
+#include "cpu_features.h"
+#include "perf_trace.h"
+#include "resampler.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
 #include <cstring>
 #include <algorithm>
 #include <android/log.h>
 
+// NEON intrinsics
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BOX_NEON 1
+#else
+#define BOX_NEON 0
+#endif
+
+// x86：内核函数单独启用指令集（target 属性），运行时按 cpu_features() 选择
+#if !BOX_NEON && (defined(__i386__) || defined(__x86_64__))
+#include <immintrin.h>
+#define BOX_X86 1
+#define X86_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define X86_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BOX_X86 0
+#endif
+
 #define LOG_TAG "BoxBlur"
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
+// Box3 纵向列条带宽度：16 列 × 4 字节 = 64 字节，每行正好一条缓存行
+static const int kBoxStripColumns = 16;
+
 /**
- * 一维盒式模糊（横向）
+ * 盒式核参数
+ *
+ * 除法改为定点倒数乘法：avg = (sum * mul + 2^15) >> 16，mul = round(2^16 / (2r+1))
+ * - sum ≤ 255 × 101，mul ≤ 21846，乘积 < 2^30，uint32 不会溢出
+ * - 与浮点 sum / d + 0.5 截断相比误差 < 0.2，结果最多相差 1
  */
-static void box_blur_h(
+struct BoxParams {
+    int radius;
+    uint32_t mul;
+};
+
+static inline BoxParams make_box_params(int radius) {
+    const uint32_t diameter = 2 * radius + 1;
+    BoxParams p;
+    p.radius = radius;
+    p.mul = (65536u + diameter / 2) / diameter;
+    return p;
+}
+
+static inline uint8_t box_average(uint32_t sum, uint32_t mul) {
+    return static_cast<uint8_t>((sum * mul + 32768u) >> 16);
+}
+
+#if !BOX_NEON
+/**
+ * 单行盒式模糊（横向，标量版本；NEON 版本的逐位对照）
+ */
+static void box_blur_row_scalar(
+    const uint8_t* srcRow,
+    uint8_t* dstRow,
+    int w,
+    const BoxParams& p
+) {
+    const int radius = p.radius;
+    
+    // 初始化累加器（前 radius+1 个像素）
+    int sumR = 0, sumG = 0, sumB = 0, sumA = 0;
+    
+    // 左边界：复制第一个像素
+    for (int i = -radius; i <= radius; ++i) {
+        int x = std::max(0, std::min(w - 1, i));
+        sumB += srcRow[x * 4 + 0];
+        sumG += srcRow[x * 4 + 1];
+        sumR += srcRow[x * 4 + 2];
+        sumA += srcRow[x * 4 + 3];
+    }
+    
+    // 滑动窗口
+    for (int x = 0; x < w; ++x) {
+        // 输出当前窗口的平均值
+        dstRow[x * 4 + 0] = box_average(sumB, p.mul);
+        dstRow[x * 4 + 1] = box_average(sumG, p.mul);
+        dstRow[x * 4 + 2] = box_average(sumR, p.mul);
+        dstRow[x * 4 + 3] = box_average(sumA, p.mul);
+        
+        // 移除左边像素，添加右边像素
+        int xLeft = std::max(0, x - radius);
+        int xRight = std::min(w - 1, x + radius + 1);
+        
+        sumB += srcRow[xRight * 4 + 0] - srcRow[xLeft * 4 + 0];
+        sumG += srcRow[xRight * 4 + 1] - srcRow[xLeft * 4 + 1];
+        sumR += srcRow[xRight * 4 + 2] - srcRow[xLeft * 4 + 2];
+        sumA += srcRow[xRight * 4 + 3] - srcRow[xLeft * 4 + 3];
+    }
+}
+#endif // !BOX_NEON
+
+/**
+ * 多列盒式模糊（纵向，标量版本）
+ *
+ * 每行处理 bytes 个连续字节（= 列数 × 4），相邻行间隔 pitch 字节；
+ * 每个字节通道独立累加，按 64 字节一组处理，内层循环可自动向量化
+ */
+static void box_blur_cols_scalar(
     const uint8_t* src,
     uint8_t* dst,
-    int w, int h, int stride,
-    int radius
+    int h,
+    int pitch,
+    int bytes,
+    const BoxParams& p
 ) {
-    int diameter = 2 * radius + 1;
-    float inv = 1.0f / diameter;
+    const int radius = p.radius;
+    int sums[kBoxStripColumns * 4];
     
-    for (int y = 0; y < h; ++y) {
-        const uint8_t* srcRow = src + y * stride;
-        uint8_t* dstRow = dst + y * stride;
-        
-        // 初始化累加器（前 radius+1 个像素）
-        int sumR = 0, sumG = 0, sumB = 0, sumA = 0;
+    for (int j0 = 0; j0 < bytes; j0 += kBoxStripColumns * 4) {
+        const int lanes = std::min(kBoxStripColumns * 4, bytes - j0);
         
-        // 左边界：复制第一个像素
+        // 上边界：复制第一行
+        for (int j = 0; j < lanes; ++j) sums[j] = 0;
         for (int i = -radius; i <= radius; ++i) {
-            int x = std::max(0, std::min(w - 1, i));
-            sumB += srcRow[x * 4 + 0];
-            sumG += srcRow[x * 4 + 1];
-            sumR += srcRow[x * 4 + 2];
-            sumA += srcRow[x * 4 + 3];
+            const uint8_t* row = src + std::max(0, std::min(h - 1, i)) * pitch + j0;
+            for (int j = 0; j < lanes; ++j) sums[j] += row[j];
         }
         
         // 滑动窗口
-        for (int x = 0; x < w; ++x) {
-            // 输出当前窗口的平均值
-            dstRow[x * 4 + 0] = static_cast<uint8_t>(sumB * inv + 0.5f);
-            dstRow[x * 4 + 1] = static_cast<uint8_t>(sumG * inv + 0.5f);
-            dstRow[x * 4 + 2] = static_cast<uint8_t>(sumR * inv + 0.5f);
-            dstRow[x * 4 + 3] = static_cast<uint8_t>(sumA * inv + 0.5f);
-            
-            // 移除左边像素，添加右边像素
-            int xLeft = std::max(0, x - radius);
-            int xRight = std::min(w - 1, x + radius + 1);
+        for (int y = 0; y < h; ++y) {
+            uint8_t* out = dst + y * pitch + j0;
+            for (int j = 0; j < lanes; ++j) {
+                out[j] = box_average(sums[j], p.mul);
+            }
             
-            sumB += srcRow[xRight * 4 + 0] - srcRow[xLeft * 4 + 0];
-            sumG += srcRow[xRight * 4 + 1] - srcRow[xLeft * 4 + 1];
-            sumR += srcRow[xRight * 4 + 2] - srcRow[xLeft * 4 + 2];
-            sumA += srcRow[xRight * 4 + 3] - srcRow[xLeft * 4 + 3];
+            const uint8_t* top = src + std::max(0, y - radius) * pitch + j0;
+            const uint8_t* bottom = src + std::min(h - 1, y + radius + 1) * pitch + j0;
+            for (int j = 0; j < lanes; ++j) {
+                sums[j] += bottom[j] - top[j];
+            }
         }
     }
 }
 
+#if BOX_NEON
+
 /**
- * 一维盒式模糊（纵向）
+ * 加载一个 RGBA 像素并拓宽为 uint32x4
  */
-static void box_blur_v(
+static inline uint32x4_t load_pixel_u32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    uint8x8_t b = vreinterpret_u8_u32(vdup_n_u32(v));
+    return vmovl_u16(vget_low_u16(vmovl_u8(b)));
+}
+
+/**
+ * 定点平均并写回一个 RGBA 像素
+ */
+static inline void store_average_u32(uint8_t* p, uint32x4_t sum, uint32x4_t vmul, uint32x4_t vround) {
+    uint16x4_t n16 = vshrn_n_u32(vmlaq_u32(vround, sum, vmul), 16);
+    uint8x8_t n8 = vmovn_u16(vcombine_u16(n16, n16));
+    uint32_t v = vget_lane_u32(vreinterpret_u32_u8(n8), 0);
+    memcpy(p, &v, 4);
+}
+
+/**
+ * 单行盒式模糊（横向，NEON 版本）
+ *
+ * RGBA 四个通道的窗口和保存在一个 uint32x4_t 中；
+ * 循环拆分为左边界 / 无分支内部 / 右边界三段，只有边界段需要钳位下标
+ */
+static void box_blur_row_neon(
+    const uint8_t* srcRow,
+    uint8_t* dstRow,
+    int w,
+    const BoxParams& p
+) {
+    const int radius = p.radius;
+    const uint32x4_t vmul = vdupq_n_u32(p.mul);
+    const uint32x4_t vround = vdupq_n_u32(32768u);
+    
+    // 左边界：复制第一个像素
+    uint32x4_t sum = vdupq_n_u32(0);
+    for (int i = -radius; i <= radius; ++i) {
+        sum = vaddq_u32(sum, load_pixel_u32(srcRow + std::max(0, std::min(w - 1, i)) * 4));
+    }
+    
+    // [0, xa)：左侧越界（x - r < 0）；[xb, w)：右侧越界（x + r + 1 > w - 1）
+    const int xa = std::min(radius, w);
+    const int xb = std::max(xa, w - radius - 1);
+    
+    int x = 0;
+    for (; x < xa; ++x) {
+        store_average_u32(dstRow + x * 4, sum, vmul, vround);
+        sum = vaddq_u32(sum, load_pixel_u32(srcRow + std::min(w - 1, x + radius + 1) * 4));
+        sum = vsubq_u32(sum, load_pixel_u32(srcRow));
+    }
+    
+    // 内部：无钳位
+    const uint8_t* right = srcRow + (x + radius + 1) * 4;
+    const uint8_t* left = srcRow + (x - radius) * 4;
+    for (; x < xb; ++x, right += 4, left += 4) {
+        store_average_u32(dstRow + x * 4, sum, vmul, vround);
+        sum = vaddq_u32(sum, load_pixel_u32(right));
+        sum = vsubq_u32(sum, load_pixel_u32(left));
+    }
+    
+    const uint32x4_t last = load_pixel_u32(srcRow + (w - 1) * 4);
+    for (; x < w; ++x) {
+        store_average_u32(dstRow + x * 4, sum, vmul, vround);
+        sum = vaddq_u32(sum, last);
+        sum = vsubq_u32(sum, load_pixel_u32(srcRow + std::max(0, x - radius) * 4));
+    }
+}
+
+/**
+ * 16 字节（4 像素）宽的纵向盒式模糊（NEON 版本）
+ *
+ * 16 个字节通道的窗口和保存在 4 个 int32x4_t 中；
+ * 窗口更新用 vsubl_u8 一次求出 (bottom - top) 的有符号差值再累加
+ */
+static void box_blur_col16_neon(
     const uint8_t* src,
     uint8_t* dst,
-    int w, int h, int stride,
-    int radius
+    int h,
+    int pitch,
+    const BoxParams& p
 ) {
-    int diameter = 2 * radius + 1;
-    float inv = 1.0f / diameter;
+    const int radius = p.radius;
+    const uint32x4_t vmul = vdupq_n_u32(p.mul);
+    const uint32x4_t vround = vdupq_n_u32(32768u);
     
-    for (int x = 0; x < w; ++x) {
-        // 初始化累加器
-        int sumR = 0, sumG = 0, sumB = 0, sumA = 0;
+    // 上边界：复制第一行
+    int32x4_t s0 = vdupq_n_s32(0), s1 = s0, s2 = s0, s3 = s0;
+    for (int i = -radius; i <= radius; ++i) {
+        uint8x16_t v = vld1q_u8(src + std::max(0, std::min(h - 1, i)) * pitch);
+        uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+        s0 = vaddq_s32(s0, vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(lo))));
+        s1 = vaddq_s32(s1, vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(lo))));
+        s2 = vaddq_s32(s2, vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(hi))));
+        s3 = vaddq_s32(s3, vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(hi))));
+    }
+    
+    for (int y = 0; y < h; ++y) {
+        // 输出当前窗口的平均值
+        uint16x8_t n0 = vcombine_u16(
+            vshrn_n_u32(vmlaq_u32(vround, vreinterpretq_u32_s32(s0), vmul), 16),
+            vshrn_n_u32(vmlaq_u32(vround, vreinterpretq_u32_s32(s1), vmul), 16));
+        uint16x8_t n1 = vcombine_u16(
+            vshrn_n_u32(vmlaq_u32(vround, vreinterpretq_u32_s32(s2), vmul), 16),
+            vshrn_n_u32(vmlaq_u32(vround, vreinterpretq_u32_s32(s3), vmul), 16));
+        vst1q_u8(dst + y * pitch, vcombine_u8(vmovn_u16(n0), vmovn_u16(n1)));
         
-        // 上边界：复制第一个像素
-        for (int i = -radius; i <= radius; ++i) {
-            int y = std::max(0, std::min(h - 1, i));
-            const uint8_t* pixel = src + y * stride + x * 4;
-            sumB += pixel[0];
-            sumG += pixel[1];
-            sumR += pixel[2];
-            sumA += pixel[3];
+        // 行号钳位只在标量寄存器上做（编译为条件选择，无分支），16 字节向量共用
+        const uint8x16_t top = vld1q_u8(src + std::max(0, y - radius) * pitch);
+        const uint8x16_t bottom = vld1q_u8(src + std::min(h - 1, y + radius + 1) * pitch);
+        
+        int16x8_t dLo = vreinterpretq_s16_u16(vsubl_u8(vget_low_u8(bottom), vget_low_u8(top)));
+        int16x8_t dHi = vreinterpretq_s16_u16(vsubl_u8(vget_high_u8(bottom), vget_high_u8(top)));
+        s0 = vaddw_s16(s0, vget_low_s16(dLo));
+        s1 = vaddw_s16(s1, vget_high_s16(dLo));
+        s2 = vaddw_s16(s2, vget_low_s16(dHi));
+        s3 = vaddw_s16(s3, vget_high_s16(dHi));
+    }
+}
+
+/**
+ * 多列盒式模糊（纵向，NEON 版本）：每 16 字节一组，剩余部分走标量
+ */
+static void box_blur_cols_neon(
+    const uint8_t* src,
+    uint8_t* dst,
+    int h,
+    int pitch,
+    int bytes,
+    const BoxParams& p
+) {
+    int j = 0;
+    for (; j + 16 <= bytes; j += 16) {
+        box_blur_col16_neon(src + j, dst + j, h, pitch, p);
+    }
+    if (j < bytes) {
+        box_blur_cols_scalar(src + j, dst + j, h, pitch, bytes - j, p);
+    }
+}
+
+#endif // BOX_NEON
+
+#if BOX_X86
+
+/**
+ * 加载一个 RGBA 像素并拓宽为 4 × int32
+ */
+X86_TARGET_SSE41 static inline __m128i load_pixel_sse41(const uint8_t* p) {
+    int32_t v;
+    memcpy(&v, p, 4);
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(v));
+}
+
+/**
+ * 4 × int32 窗口和 → 定点平均（仍为 int32）
+ */
+X86_TARGET_SSE41 static inline __m128i average_sse41(__m128i sum, __m128i vmul, __m128i vround) {
+    return _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi32(sum, vmul), vround), 16);
+}
+
+/**
+ * 定点平均并写回一个 RGBA 像素
+ */
+X86_TARGET_SSE41 static inline void store_average_sse41(uint8_t* p, __m128i sum, __m128i vmul, __m128i vround) {
+    const __m128i n16 = _mm_packus_epi32(average_sse41(sum, vmul, vround), _mm_setzero_si128());
+    const int32_t v = _mm_cvtsi128_si32(_mm_packus_epi16(n16, n16));
+    memcpy(p, &v, 4);
+}
+
+/**
+ * 单行盒式模糊（横向，SSE4.1 版本；三段循环与 NEON 版本相同）
+ */
+X86_TARGET_SSE41 static void box_blur_row_sse41(
+    const uint8_t* srcRow,
+    uint8_t* dstRow,
+    int w,
+    const BoxParams& p
+) {
+    const int radius = p.radius;
+    const __m128i vmul = _mm_set1_epi32(static_cast<int>(p.mul));
+    const __m128i vround = _mm_set1_epi32(32768);
+    
+    // 左边界：复制第一个像素
+    __m128i sum = _mm_setzero_si128();
+    for (int i = -radius; i <= radius; ++i) {
+        sum = _mm_add_epi32(sum, load_pixel_sse41(srcRow + std::max(0, std::min(w - 1, i)) * 4));
+    }
+    
+    const int xa = std::min(radius, w);
+    const int xb = std::max(xa, w - radius - 1);
+    
+    int x = 0;
+    for (; x < xa; ++x) {
+        store_average_sse41(dstRow + x * 4, sum, vmul, vround);
+        sum = _mm_add_epi32(sum, load_pixel_sse41(srcRow + std::min(w - 1, x + radius + 1) * 4));
+        sum = _mm_sub_epi32(sum, load_pixel_sse41(srcRow));
+    }
+    
+    // 内部：无钳位
+    const uint8_t* right = srcRow + (x + radius + 1) * 4;
+    const uint8_t* left = srcRow + (x - radius) * 4;
+    for (; x < xb; ++x, right += 4, left += 4) {
+        store_average_sse41(dstRow + x * 4, sum, vmul, vround);
+        sum = _mm_add_epi32(sum, load_pixel_sse41(right));
+        sum = _mm_sub_epi32(sum, load_pixel_sse41(left));
+    }
+    
+    const __m128i last = load_pixel_sse41(srcRow + (w - 1) * 4);
+    for (; x < w; ++x) {
+        store_average_sse41(dstRow + x * 4, sum, vmul, vround);
+        sum = _mm_add_epi32(sum, last);
+        sum = _mm_sub_epi32(sum, load_pixel_sse41(srcRow + std::max(0, x - radius) * 4));
+    }
+}
+
+/**
+ * 16 字节宽的纵向盒式模糊（SSE4.1 版本，16 个字节通道的窗口和保存在 4 个 __m128i 中）
+ */
+X86_TARGET_SSE41 static void box_blur_col16_sse41(
+    const uint8_t* src,
+    uint8_t* dst,
+    int h,
+    int pitch,
+    const BoxParams& p
+) {
+    const int radius = p.radius;
+    const __m128i vmul = _mm_set1_epi32(static_cast<int>(p.mul));
+    const __m128i vround = _mm_set1_epi32(32768);
+    const __m128i zero = _mm_setzero_si128();
+    
+    // 上边界：复制第一行
+    __m128i s0 = zero, s1 = zero, s2 = zero, s3 = zero;
+    for (int i = -radius; i <= radius; ++i) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + std::max(0, std::min(h - 1, i)) * pitch));
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+        s0 = _mm_add_epi32(s0, _mm_unpacklo_epi16(lo, zero));
+        s1 = _mm_add_epi32(s1, _mm_unpackhi_epi16(lo, zero));
+        s2 = _mm_add_epi32(s2, _mm_unpacklo_epi16(hi, zero));
+        s3 = _mm_add_epi32(s3, _mm_unpackhi_epi16(hi, zero));
+    }
+    
+    for (int y = 0; y < h; ++y) {
+        const __m128i n0 = _mm_packus_epi32(average_sse41(s0, vmul, vround), average_sse41(s1, vmul, vround));
+        const __m128i n1 = _mm_packus_epi32(average_sse41(s2, vmul, vround), average_sse41(s3, vmul, vround));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + y * pitch), _mm_packus_epi16(n0, n1));
+        
+        const __m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + std::max(0, y - radius) * pitch));
+        const __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + std::min(h - 1, y + radius + 1) * pitch));
+        
+        // (bottom - top) 的有符号 16 位差值，再符号扩展累加
+        const __m128i dLo = _mm_sub_epi16(_mm_unpacklo_epi8(bottom, zero), _mm_unpacklo_epi8(top, zero));
+        const __m128i dHi = _mm_sub_epi16(_mm_unpackhi_epi8(bottom, zero), _mm_unpackhi_epi8(top, zero));
+        s0 = _mm_add_epi32(s0, _mm_cvtepi16_epi32(dLo));
+        s1 = _mm_add_epi32(s1, _mm_cvtepi16_epi32(_mm_srli_si128(dLo, 8)));
+        s2 = _mm_add_epi32(s2, _mm_cvtepi16_epi32(dHi));
+        s3 = _mm_add_epi32(s3, _mm_cvtepi16_epi32(_mm_srli_si128(dHi, 8)));
+    }
+}
+
+/**
+ * 加载 8 个字节通道并拓宽为 8 × int32
+ */
+X86_TARGET_AVX2 static inline __m256i widen8_avx2(const uint8_t* p) {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+/**
+ * 32 字节宽的纵向盒式模糊（AVX2 版本，32 个字节通道的窗口和保存在 4 个 __m256i 中）
+ */
+X86_TARGET_AVX2 static void box_blur_col32_avx2(
+    const uint8_t* src,
+    uint8_t* dst,
+    int h,
+    int pitch,
+    const BoxParams& p
+) {
+    const int radius = p.radius;
+    const __m256i vmul = _mm256_set1_epi32(static_cast<int>(p.mul));
+    const __m256i vround = _mm256_set1_epi32(32768);
+    // packus 按 128 位通道交织，dword 顺序 [0 4 1 5 2 6 3 7] 还原为连续字节
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    
+    // 上边界：复制第一行
+    __m256i s[4] = { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+    for (int i = -radius; i <= radius; ++i) {
+        const uint8_t* row = src + std::max(0, std::min(h - 1, i)) * pitch;
+        for (int k = 0; k < 4; ++k) s[k] = _mm256_add_epi32(s[k], widen8_avx2(row + k * 8));
+    }
+    
+    for (int y = 0; y < h; ++y) {
+        __m256i q[4];
+        for (int k = 0; k < 4; ++k) {
+            q[k] = _mm256_srli_epi32(_mm256_add_epi32(_mm256_mullo_epi32(s[k], vmul), vround), 16);
         }
+        const __m256i n8 = _mm256_packus_epi16(_mm256_packus_epi32(q[0], q[1]), _mm256_packus_epi32(q[2], q[3]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + y * pitch), _mm256_permutevar8x32_epi32(n8, order));
         
-        // 滑动窗口
-        for (int y = 0; y < h; ++y) {
-            // 输出当前窗口的平均值
-            uint8_t* dstPixel = dst + y * stride + x * 4;
-            dstPixel[0] = static_cast<uint8_t>(sumB * inv + 0.5f);
-            dstPixel[1] = static_cast<uint8_t>(sumG * inv + 0.5f);
-            dstPixel[2] = static_cast<uint8_t>(sumR * inv + 0.5f);
-            dstPixel[3] = static_cast<uint8_t>(sumA * inv + 0.5f);
-            
-            // 移除上边像素，添加下边像素
-            int yTop = std::max(0, y - radius);
-            int yBottom = std::min(h - 1, y + radius + 1);
-            
-            const uint8_t* topPixel = src + yTop * stride + x * 4;
-            const uint8_t* bottomPixel = src + yBottom * stride + x * 4;
-            
-            sumB += bottomPixel[0] - topPixel[0];
-            sumG += bottomPixel[1] - topPixel[1];
-            sumR += bottomPixel[2] - topPixel[2];
-            sumA += bottomPixel[3] - topPixel[3];
+        const uint8_t* top = src + std::max(0, y - radius) * pitch;
+        const uint8_t* bottom = src + std::min(h - 1, y + radius + 1) * pitch;
+        for (int k = 0; k < 4; ++k) {
+            s[k] = _mm256_add_epi32(s[k], _mm256_sub_epi32(widen8_avx2(bottom + k * 8), widen8_avx2(top + k * 8)));
         }
     }
 }
 
+/**
+ * 多列盒式模糊（纵向，x86 版本）：AVX2 每 32 字节一组，SSE4.1 每 16 字节一组，剩余部分走标量
+ */
+static void box_blur_cols_x86(
+    const uint8_t* src,
+    uint8_t* dst,
+    int h,
+    int pitch,
+    int bytes,
+    const BoxParams& p,
+    uint32_t features
+) {
+    int j = 0;
+    if (features & CPU_FEATURE_AVX2) {
+        for (; j + 32 <= bytes; j += 32) {
+            box_blur_col32_avx2(src + j, dst + j, h, pitch, p);
+        }
+    }
+    if (features & (CPU_FEATURE_SSE41 | CPU_FEATURE_AVX2)) {
+        for (; j + 16 <= bytes; j += 16) {
+            box_blur_col16_sse41(src + j, dst + j, h, pitch, p);
+        }
+    }
+    if (j < bytes) {
+        box_blur_cols_scalar(src + j, dst + j, h, pitch, bytes - j, p);
+    }
+}
+
+#endif // BOX_X86
+
+static inline void box_blur_row(const uint8_t* srcRow, uint8_t* dstRow, int w, const BoxParams& p) {
+#if BOX_NEON
+    box_blur_row_neon(srcRow, dstRow, w, p);
+#elif BOX_X86
+    if (cpu_features() & (CPU_FEATURE_SSE41 | CPU_FEATURE_AVX2)) {
+        box_blur_row_sse41(srcRow, dstRow, w, p);
+    } else {
+        box_blur_row_scalar(srcRow, dstRow, w, p);
+    }
+#else
+    box_blur_row_scalar(srcRow, dstRow, w, p);
+#endif
+}
+
+static inline void box_blur_cols(const uint8_t* src, uint8_t* dst, int h, int pitch, int bytes, const BoxParams& p) {
+#if BOX_NEON
+    box_blur_cols_neon(src, dst, h, pitch, bytes, p);
+#elif BOX_X86
+    box_blur_cols_x86(src, dst, h, pitch, bytes, p, cpu_features());
+#else
+    box_blur_cols_scalar(src, dst, h, pitch, bytes, p);
+#endif
+}
+
+/**
+ * 一维盒式模糊（横向，处理 [rowBegin, rowEnd) 行）
+ */
+static void box_blur_h(
+    const uint8_t* src,
+    uint8_t* dst,
+    int w, int rowBegin, int rowEnd, int stride,
+    const BoxParams& p
+) {
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        box_blur_row(src + y * stride, dst + y * stride, w, p);
+    }
+}
+
+/**
+ * 一维盒式模糊（纵向，处理 [colBegin, colEnd) 列）
+ */
+static void box_blur_v(
+    const uint8_t* src,
+    uint8_t* dst,
+    int colBegin, int colEnd, int h, int stride,
+    const BoxParams& p
+) {
+    box_blur_cols(src + colBegin * 4, dst + colBegin * 4, h, stride, (colEnd - colBegin) * 4, p);
+}
+
 /**
  * 单次盒式模糊（横向 + 纵向）
  */
@@ -140,16 +579,36 @@ void box_blur_single_pass(
     int w, int h, int stride,
     int radius
 ) {
-    // 分配临时缓冲区
-    uint8_t* temp = new uint8_t[h * stride];
+    TraceScope total(TRACE_FILTER_BOX_SINGLE, TRACE_STAGE_TOTAL);
     
-    // 横向模糊：src → temp
-    box_blur_h(src, temp, w, h, stride, radius);
+    // 取用临时缓冲区（线程本地内存池，跨帧复用）
+    TraceScope allocScope(TRACE_FILTER_BOX_SINGLE, TRACE_STAGE_ALLOC);
+    ScratchBuffer tempBuf(static_cast<size_t>(h) * stride);
+    allocScope.stop();
+    if (!tempBuf) {
+        LOGE("Failed to allocate temp buffer: %dx%d", w, h);
+        return;
+    }
+    uint8_t* temp = tempBuf.as<uint8_t>();
     
-    // 纵向模糊：temp → dst
-    box_blur_v(temp, dst, w, h, stride, radius);
+    const BoxParams p = make_box_params(radius);
     
-    delete[] temp;
+    // 横向模糊：src → temp（按行分块并行）
+    {
+        TraceScope scope(TRACE_FILTER_BOX_SINGLE, TRACE_STAGE_HORIZONTAL);
+        parallel_for(0, h, parallel_rows_grain(w), [&](int y0, int y1, int) {
+            box_blur_h(src, temp, w, y0, y1, stride, p);
+        });
+    }
+    
+    // 纵向模糊：temp → dst（按列条带并行，条带宽度对齐到 16 列）
+    {
+        TraceScope scope(TRACE_FILTER_BOX_SINGLE, TRACE_STAGE_VERTICAL);
+        const int strips = (w + kBoxStripColumns - 1) / kBoxStripColumns;
+        parallel_for(0, strips, parallel_rows_grain(h * kBoxStripColumns), [&](int s0, int s1, int) {
+            box_blur_v(temp, dst, s0 * kBoxStripColumns, std::min(w, s1 * kBoxStripColumns), h, stride, p);
+        });
+    }
 }
 
 /**
@@ -158,7 +617,8 @@ void box_blur_single_pass(
 void box3_rgba8888_inplace(
     uint8_t* base,
     int w, int h, int stride,
-    int radius
+    int radius,
+    const ColorMatrix* colorMatrix
 ) {
     // 参数校验
     if (!base || w <= 0 || h <= 0 || stride < w * 4) {
@@ -166,8 +626,9 @@ void box3_rgba8888_inplace(
         return;
     }
     
-    // radius 太小，直接返回
+    // radius 太小，直接返回（仍需套用颜色矩阵）
     if (radius <= 0) {
+        if (colorMatrix) color_matrix_rgba8888_inplace(base, w, h, stride, *colorMatrix);
         return;
     }
     
@@ -177,20 +638,66 @@ void box3_rgba8888_inplace(
         radius = 50;
     }
     
-    // 分配临时缓冲区（用于乒乓缓冲）
-    uint8_t* temp = new uint8_t[h * stride];
+    TraceScope total(TRACE_FILTER_BOX3, TRACE_STAGE_TOTAL);
+    const BoxParams p = make_box_params(radius);
     
-    // 第一次模糊：base → temp
-    box_blur_single_pass(base, temp, w, h, stride, radius);
-    
-    // 第二次模糊：temp → base
-    box_blur_single_pass(temp, base, w, h, stride, radius);
+    // 每个线程的工作区：横向两行乒乓 / 纵向两份列条带乒乓（均可驻留 L1/L2）
+    const size_t rowBytes = static_cast<size_t>(w) * 4;
+    const size_t stripBytes = static_cast<size_t>(h) * kBoxStripColumns * 4;
+    const size_t slotBytes = 2 * std::max(rowBytes, stripBytes);
+    const int threads = thread_pool_concurrency();
+    TraceScope allocScope(TRACE_FILTER_BOX3, TRACE_STAGE_ALLOC);
+    ScratchBuffer work(slotBytes * threads);
+    allocScope.stop();
+    if (!work) {
+        LOGE("Failed to allocate work buffer: %dx%d", w, h);
+        return;
+    }
     
-    // 第三次模糊：base → temp → base
-    box_blur_single_pass(base, temp, w, h, stride, radius);
-    memcpy(base, temp, h * stride);
+    // 第一阶段：每行读入一次，连续三次横向盒式模糊后写回
+    TraceScope horizontal(TRACE_FILTER_BOX3, TRACE_STAGE_HORIZONTAL);
+    parallel_for(0, h, parallel_rows_grain(w), [&](int y0, int y1, int slot) {
+        uint8_t* bufA = work.as<uint8_t>() + slot * slotBytes;
+        uint8_t* bufB = bufA + slotBytes / 2;
+        for (int y = y0; y < y1; ++y) {
+            uint8_t* row = base + y * stride;
+            box_blur_row(row, bufA, w, p);
+            box_blur_row(bufA, bufB, w, p);
+            box_blur_row(bufB, row, w, p);
+        }
+    });
+    horizontal.stop();
     
-    delete[] temp;
+    // 第二阶段：每个列条带收集一次，连续三次纵向盒式模糊后写回
+    TraceScope vertical(TRACE_FILTER_BOX3, TRACE_STAGE_VERTICAL);
+    const int strips = (w + kBoxStripColumns - 1) / kBoxStripColumns;
+    parallel_for(0, strips, parallel_rows_grain(h * kBoxStripColumns), [&](int s0, int s1, int slot) {
+        uint8_t* bufA = work.as<uint8_t>() + slot * slotBytes;
+        uint8_t* bufB = bufA + slotBytes / 2;
+        for (int strip = s0; strip < s1; ++strip) {
+            const int x0 = strip * kBoxStripColumns;
+            const int lanes = std::min(kBoxStripColumns, w - x0) * 4;
+            
+            for (int y = 0; y < h; ++y) {
+                memcpy(bufA + y * lanes, base + y * stride + x0 * 4, lanes);
+            }
+            
+            box_blur_cols(bufA, bufB, h, lanes, lanes, p);
+            box_blur_cols(bufB, bufA, h, lanes, lanes, p);
+            box_blur_cols(bufA, bufB, h, lanes, lanes, p);
+            
+            // 写回（有颜色矩阵时在写回的同时套用，不再单独遍历整帧）
+            if (colorMatrix) {
+                for (int y = 0; y < h; ++y) {
+                    color_matrix_rgba8888_row(*colorMatrix, bufB + y * lanes, base + y * stride + x0 * 4, lanes / 4);
+                }
+            } else {
+                for (int y = 0; y < h; ++y) {
+                    memcpy(base + y * stride + x0 * 4, bufB + y * lanes, lanes);
+                }
+            }
+        }
+    });
 }
 
 /**
@@ -233,63 +740,6 @@ static void downsample_nearest(
     }
 }
 
-/**
- * 双线性插值降采样（高质量版本）
- *
- * 优势：
- * - 质量好，平滑无锯齿
- * - 适合需要高质量的场景
- *
- * 缺点：
- * - 速度较慢（大量浮点运算）
- */
-static void downsample_bilinear(
-    const uint8_t* src,
-    uint8_t* dst,
-    int srcWidth, int srcHeight, int srcStride,
-    int dstWidth, int dstHeight, int dstStride
-) {
-    float scaleX = static_cast<float>(srcWidth) / dstWidth;
-    float scaleY = static_cast<float>(srcHeight) / dstHeight;
-
-    for (int y = 0; y < dstHeight; ++y) {
-        for (int x = 0; x < dstWidth; ++x) {
-            // 计算源图像中的浮点坐标
-            float srcX = (x + 0.5f) * scaleX - 0.5f;
-            float srcY = (y + 0.5f) * scaleY - 0.5f;
-
-            // 钳位到有效范围
-            srcX = std::max(0.0f, std::min(srcX, srcWidth - 1.0f));
-            srcY = std::max(0.0f, std::min(srcY, srcHeight - 1.0f));
-
-            // 获取四个邻近像素的坐标
-            int x0 = static_cast<int>(srcX);
-            int y0 = static_cast<int>(srcY);
-            int x1 = std::min(x0 + 1, srcWidth - 1);
-            int y1 = std::min(y0 + 1, srcHeight - 1);
-
-            // 计算插值权重
-            float wx = srcX - x0;
-            float wy = srcY - y0;
-
-            // 获取四个邻近像素
-            const uint8_t* p00 = src + y0 * srcStride + x0 * 4;
-            const uint8_t* p10 = src + y0 * srcStride + x1 * 4;
-            const uint8_t* p01 = src + y1 * srcStride + x0 * 4;
-            const uint8_t* p11 = src + y1 * srcStride + x1 * 4;
-
-            // 双线性插值（每个通道）
-            uint8_t* dstPixel = dst + y * dstStride + x * 4;
-            for (int c = 0; c < 4; ++c) {
-                float v0 = p00[c] * (1 - wx) + p10[c] * wx;
-                float v1 = p01[c] * (1 - wx) + p11[c] * wx;
-                float v = v0 * (1 - wy) + v1 * wy;
-                dstPixel[c] = static_cast<uint8_t>(v + 0.5f);
-            }
-        }
-    }
-}
-
 /**
  * 最近邻插值上采样（快速版本）
  */
@@ -303,19 +753,6 @@ static void upsample_nearest(
     downsample_nearest(src, dst, srcWidth, srcHeight, srcStride, dstWidth, dstHeight, dstStride);
 }
 
-/**
- * 双线性插值上采样（高质量版本）
- */
-static void upsample_bilinear(
-    const uint8_t* src,
-    uint8_t* dst,
-    int srcWidth, int srcHeight, int srcStride,
-    int dstWidth, int dstHeight, int dstStride
-) {
-    // 与降采样相同的逻辑
-    downsample_bilinear(src, dst, srcWidth, srcHeight, srcStride, dstWidth, dstHeight, dstStride);
-}
-
 /**
  * AdvancedFastBlur 风格的 Box Blur（降采样优化）
  */
@@ -326,7 +763,8 @@ void advanced_box_blur_rgba8888(
     int height,
     int stride,
     float radius,
-    float downscale
+    float downscale,
+    const ColorMatrix* colorMatrix
 ) {
     // 参数校验
     if (!src || !dst || width <= 0 || height <= 0 || stride < width * 4) {
@@ -338,13 +776,14 @@ void advanced_box_blur_rgba8888(
     downscale = std::max(0.01f, std::min(1.0f, downscale));
     radius = std::max(0.0f, std::min(25.0f, radius));
 
-    // 如果半径太小，直接复制
+    // 如果半径太小，直接复制（仍需套用颜色矩阵）
     if (radius < 0.5f) {
         if (src != dst) {
             for (int y = 0; y < height; ++y) {
                 memcpy(dst + y * stride, src + y * stride, width * 4);
             }
         }
+        if (colorMatrix) color_matrix_rgba8888_inplace(dst, width, height, stride, *colorMatrix);
         return;
     }
 
@@ -353,16 +792,27 @@ void advanced_box_blur_rgba8888(
     int smallHeight = std::max(1, static_cast<int>(height * downscale + 0.5f));
     int smallStride = smallWidth * 4;
 
-    LOGD("AdvancedBoxBlur: %dx%d -> %dx%d (scale=%.2f), radius=%.1f",
-         width, height, smallWidth, smallHeight, downscale, radius);
+    TraceScope total(TRACE_FILTER_ADVANCED_BOX, TRACE_STAGE_TOTAL);
 
-    // 分配临时缓冲区
-    uint8_t* smallImage = new uint8_t[smallHeight * smallStride];
-    uint8_t* blurredSmall = new uint8_t[smallHeight * smallStride];
+    // 取用临时缓冲区（线程本地内存池）
+    const size_t smallBytes = static_cast<size_t>(smallHeight) * smallStride;
+    TraceScope allocScope(TRACE_FILTER_ADVANCED_BOX, TRACE_STAGE_ALLOC);
+    ScratchBuffer smallBuf(smallBytes);
+    ScratchBuffer blurredBuf(smallBytes);
+    allocScope.stop();
+    if (!smallBuf || !blurredBuf) {
+        LOGE("Failed to allocate downsample buffers: %dx%d", smallWidth, smallHeight);
+        return;
+    }
+    uint8_t* smallImage = smallBuf.as<uint8_t>();
+    uint8_t* blurredSmall = blurredBuf.as<uint8_t>();
 
     // 1. 降采样（使用最近邻插值 - 快速版本）
     // 注意：由于后续会模糊，最近邻插值的质量损失可以接受
-    downsample_nearest(src, smallImage, width, height, stride, smallWidth, smallHeight, smallStride);
+    {
+        TraceScope scope(TRACE_FILTER_ADVANCED_BOX, TRACE_STAGE_CONVERT);
+        downsample_nearest(src, smallImage, width, height, stride, smallWidth, smallHeight, smallStride);
+    }
 
     // 2. 在小图上模糊（调整半径）
     float scaledRadius = radius * downscale;
@@ -371,12 +821,17 @@ void advanced_box_blur_rgba8888(
     // 使用单次 Box Blur（而不是三次，以匹配 AdvancedFastBlur 的行为）
     box_blur_single_pass(smallImage, blurredSmall, smallWidth, smallHeight, smallStride, intRadius);
 
-    // 3. 上采样回原尺寸（使用最近邻插值 - 快速版本）
-    upsample_nearest(blurredSmall, dst, smallWidth, smallHeight, smallStride, width, height, stride);
+    // 颜色矩阵作用于小图（像素数只有原图的 downscale²）：上采样只做复制 / 插值，
+    // 与先上采样再套用的结果基本一致
+    if (colorMatrix) {
+        color_matrix_rgba8888_inplace(blurredSmall, smallWidth, smallHeight, smallStride, *colorMatrix);
+    }
 
-    // 释放临时缓冲区
-    delete[] smallImage;
-    delete[] blurredSmall;
+    // 3. 上采样回原尺寸（使用最近邻插值 - 快速版本）
+    {
+        TraceScope scope(TRACE_FILTER_ADVANCED_BOX, TRACE_STAGE_PACK);
+        upsample_nearest(blurredSmall, dst, smallWidth, smallHeight, smallStride, width, height, stride);
+    }
 }
 
 /**
@@ -389,7 +844,8 @@ void advanced_box_blur_rgba8888_hq(
     int height,
     int stride,
     float radius,
-    float downscale
+    float downscale,
+    const ColorMatrix* colorMatrix
 ) {
     // 参数校验
     if (!src || !dst || width <= 0 || height <= 0 || stride < width * 4) {
@@ -401,13 +857,14 @@ void advanced_box_blur_rgba8888_hq(
     downscale = std::max(0.01f, std::min(1.0f, downscale));
     radius = std::max(0.0f, std::min(25.0f, radius));
 
-    // 如果半径太小，直接复制
+    // 如果半径太小，直接复制（仍需套用颜色矩阵）
     if (radius < 0.5f) {
         if (src != dst) {
             for (int y = 0; y < height; ++y) {
                 memcpy(dst + y * stride, src + y * stride, width * 4);
             }
         }
+        if (colorMatrix) color_matrix_rgba8888_inplace(dst, width, height, stride, *colorMatrix);
         return;
     }
 
@@ -416,15 +873,26 @@ void advanced_box_blur_rgba8888_hq(
     int smallHeight = std::max(1, static_cast<int>(height * downscale + 0.5f));
     int smallStride = smallWidth * 4;
 
-    LOGD("AdvancedBoxBlur HQ: %dx%d -> %dx%d (scale=%.2f), radius=%.1f",
-         width, height, smallWidth, smallHeight, downscale, radius);
+    TraceScope total(TRACE_FILTER_ADVANCED_BOX_HQ, TRACE_STAGE_TOTAL);
 
-    // 分配临时缓冲区
-    uint8_t* smallImage = new uint8_t[smallHeight * smallStride];
-    uint8_t* blurredSmall = new uint8_t[smallHeight * smallStride];
+    // 取用临时缓冲区（线程本地内存池）
+    const size_t smallBytes = static_cast<size_t>(smallHeight) * smallStride;
+    TraceScope allocScope(TRACE_FILTER_ADVANCED_BOX_HQ, TRACE_STAGE_ALLOC);
+    ScratchBuffer smallBuf(smallBytes);
+    ScratchBuffer blurredBuf(smallBytes);
+    allocScope.stop();
+    if (!smallBuf || !blurredBuf) {
+        LOGE("Failed to allocate downsample buffers: %dx%d", smallWidth, smallHeight);
+        return;
+    }
+    uint8_t* smallImage = smallBuf.as<uint8_t>();
+    uint8_t* blurredSmall = blurredBuf.as<uint8_t>();
 
     // 1. 降采样（使用双线性插值 - 高质量）
-    downsample_bilinear(src, smallImage, width, height, stride, smallWidth, smallHeight, smallStride);
+    {
+        TraceScope scope(TRACE_FILTER_ADVANCED_BOX_HQ, TRACE_STAGE_CONVERT);
+        resize_bilinear_rgba8888(src, width, height, stride, smallImage, smallWidth, smallHeight, smallStride);
+    }
 
     // 2. 在小图上模糊（调整半径）
     float scaledRadius = radius * downscale;
@@ -433,11 +901,16 @@ void advanced_box_blur_rgba8888_hq(
     // 使用单次 Box Blur（而不是三次，以匹配 AdvancedFastBlur 的行为）
     box_blur_single_pass(smallImage, blurredSmall, smallWidth, smallHeight, smallStride, intRadius);
 
-    // 3. 上采样回原尺寸（使用双线性插值 - 高质量）
-    upsample_bilinear(blurredSmall, dst, smallWidth, smallHeight, smallStride, width, height, stride);
+    // 颜色矩阵作用于小图（像素数只有原图的 downscale²）：上采样只做复制 / 插值，
+    // 与先上采样再套用的结果基本一致
+    if (colorMatrix) {
+        color_matrix_rgba8888_inplace(blurredSmall, smallWidth, smallHeight, smallStride, *colorMatrix);
+    }
 
-    // 释放临时缓冲区
-    delete[] smallImage;
-    delete[] blurredSmall;
+    // 3. 上采样回原尺寸（使用双线性插值 - 高质量）
+    {
+        TraceScope scope(TRACE_FILTER_ADVANCED_BOX_HQ, TRACE_STAGE_PACK);
+        resize_bilinear_rgba8888(blurredSmall, smallWidth, smallHeight, smallStride, dst, width, height, stride);
+    }
 }
 
@@ -21,13 +21,14 @@
  * 
  * 性能特性：
  * - 每像素约 12 次整数加法（4 通道）
- * - 无浮点运算，无分支预测失败
+ * - 无浮点运算（定点倒数乘法代替除法），内部区域无边界钳位分支
+ * - NEON：横向每像素 RGBA 一次向量累加，纵向每次 16 字节
  * - 内存访问：顺序读写，缓存友好
  * 
  * 与 IIR 高斯的对比：
  * - 性能：Box3 快 20-40%（小图）
  * - 质量：IIR 更接近真实高斯，边缘更平滑
- * - 选择：σ < 8 且图像 < 128×128 时优先 Box3
+ * - 选择：由 blur_tuner.h 的交叉点表决定（默认 σ < 8 且图像 < 64×64 时用 Box3）
  */
 
 #ifndef BOXBLUR_H
@@ -36,6 +37,8 @@
 #include <cstdint>
 #include <cstddef>
 
+struct ColorMatrix;
+
 /**
  * 三次盒式模糊（RGBA8888 格式，原位处理）
  * 
@@ -48,11 +51,12 @@
  *               - radius = 3：轻度模糊，近似 σ ≈ 2.5
  *               - radius = 6：中度模糊，近似 σ ≈ 5.0
  *               - radius = 12：强烈模糊，近似 σ ≈ 10.0
+ * @param colorMatrix 可选颜色矩阵（见 color_matrix.h），在最后一遍纵向写回时套用；nullptr 表示不套用
  * 
  * 注意事项：
  * - 函数会直接修改 base 指向的内存
  * - radius ≤ 0 时直接返回，不做处理
- * - 内部会分配临时缓冲区，大小为 w * h * 4
+ * - 原位处理：三次横向 + 三次纵向合并为两遍整帧读写，仅使用行/列条带级临时缓冲
  * - 非线程安全，不要对同一块内存并发调用
  */
 void box3_rgba8888_inplace(
@@ -60,7 +64,8 @@ void box3_rgba8888_inplace(
     int w,
     int h,
     int stride,
-    int radius
+    int radius,
+    const ColorMatrix* colorMatrix = nullptr
 );
 
 /**
@@ -103,6 +108,7 @@ void box_blur_single_pass(
  * @param stride 行跨度（字节数）
  * @param radius 模糊半径（应用于降采样后的图像）
  * @param downscale 降采样比例（0.01-1.0），推荐 0.5
+ * @param colorMatrix 可选颜色矩阵（见 color_matrix.h），在上采样前作用于小图；nullptr 表示不套用
  *
  * 注意事项：
  * - 函数会分配临时缓冲区用于降采样和模糊
@@ -117,7 +123,8 @@ void advanced_box_blur_rgba8888(
     int height,
     int stride,
     float radius,
-    float downscale
+    float downscale,
+    const ColorMatrix* colorMatrix = nullptr
 );
 
 /**
@@ -132,8 +139,8 @@ void advanced_box_blur_rgba8888(
  * - 质量好，平滑无锯齿
  * - 适合需要高质量的场景
  *
- * 缺点：
- * - 速度较慢（大量浮点运算）
+ * 性能：
+ * - 缩放使用 resize_bilinear_rgba8888（查找表 + 8.8 定点 NEON），开销接近最近邻版本
  *
  * @param src 源图像数据（ARGB_8888）
  * @param dst 目标图像数据（ARGB_8888，可以与 src 相同）
@@ -142,6 +149,7 @@ void advanced_box_blur_rgba8888(
  * @param stride 行跨度（字节数）
  * @param radius 模糊半径（应用于降采样后的图像）
  * @param downscale 降采样比例（0.01-1.0），推荐 0.5
+ * @param colorMatrix 可选颜色矩阵（见 color_matrix.h），在上采样前作用于小图；nullptr 表示不套用
  */
 void advanced_box_blur_rgba8888_hq(
     const uint8_t* src,
@@ -150,7 +158,8 @@ void advanced_box_blur_rgba8888_hq(
     int height,
     int stride,
     float radius,
-    float downscale
+    float downscale,
+    const ColorMatrix* colorMatrix = nullptr
 );
 
 #endif // BOXBLUR_H
@@ -16,18 +16,43 @@
  * 性能优化：
  * - 内联函数减少函数调用开销
  * - 缓存友好的内存访问模式
- * - 避免重复计算
+ * - 避免重复计算：位移量每像素只计算一次，三个通道共用
  * - 使用快速浮点运算
+ * - NEON：色差每次处理 4 个输出像素，越界判断为无分支掩码（越界 = 权重为 0 的最近邻）
+ * - 色散：折射强度查 256 项表，径向法线查缓存表，热循环内无三角函数 / 开方 / 除法
+ * - 调试采样日志移出热循环，仅在 CHROMATIC_DEBUG_SAMPLES 编译时打开
+ * - 行内核按 <双线性, 法线贴图, 通道布局> 模板特化，整帧只在入口查一次分派表，热循环内无模式分支
+ * - 边缘扭曲与色差共用采样器：NEON 邻域计算与通道读取分开，扭曲的四个通道共用一组邻域
  * 
  * 时间复杂度：O(W×H)
  * 空间复杂度：O(1)（原位处理）
  */
 
 #include "chromatic_aberration.h"
+#include "perf_trace.h"
+#include "pixel_layout.h"
+#include "thread_pool.h"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include <android/log.h>
 
+// NEON intrinsics
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ABERRATION_NEON 1
+#else
+#define ABERRATION_NEON 0
+#endif
+
+// 逐像素调试采样日志（热循环内，默认关闭；CMake 选项 NATIVEGAUSS_DEBUG_SAMPLES 打开）
+#ifndef CHROMATIC_DEBUG_SAMPLES
+#define CHROMATIC_DEBUG_SAMPLES 0
+#endif
+
 #define LOG_TAG "ChromaticAberration"
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
@@ -41,7 +66,7 @@
  * @param stride 行跨度（字节数）
  * @param x 采样 X 坐标（可以是小数）
  * @param y 采样 Y 坐标（可以是小数）
- * @param channelOffset 通道偏移（0=B, 1=G, 2=R, 3=A）
+ * @param channelOffset 通道字节下标（见 pixel_layout.h）
  * @return 插值后的通道值（0-255）
  */
 static inline uint8_t sample_bilinear_channel(
@@ -99,7 +124,7 @@ static inline uint8_t sample_bilinear_channel(
  * @param stride 行跨度（字节数）
  * @param x 采样 X 坐标（可以是小数）
  * @param y 采样 Y 坐标（可以是小数）
- * @param channelOffset 通道偏移（0=B, 1=G, 2=R, 3=A）
+ * @param channelOffset 通道字节下标（见 pixel_layout.h）
  * @return 最近邻像素的通道值（0-255）
  */
 static inline uint8_t sample_nearest_channel(
@@ -119,35 +144,268 @@ static inline uint8_t sample_nearest_channel(
 }
 
 /**
- * 双线性插值采样完整像素（ARGB）
- *
- * @param pixels 像素数据
- * @param width 图像宽度
- * @param height 图像高度
- * @param stride 行跨度（字节数）
- * @param x 采样 X 坐标
- * @param y 采样 Y 坐标
- * @param outB 输出蓝色通道
- * @param outG 输出绿色通道
- * @param outR 输出红色通道
- * @param outA 输出 Alpha 通道
+ * 单通道采样（编译期选择双线性 / 最近邻）
  */
-static inline void sample_bilinear_pixel(
+template <bool Bilinear>
+static inline uint8_t sample_channel(
     const uint8_t* pixels,
     int width,
     int height,
     int stride,
     float x,
     float y,
-    uint8_t& outB,
-    uint8_t& outG,
-    uint8_t& outR,
-    uint8_t& outA
+    int channelOffset
+) {
+    return Bilinear
+        ? sample_bilinear_channel(pixels, width, height, stride, x, y, channelOffset)
+        : sample_nearest_channel(pixels, width, height, stride, x, y, channelOffset);
+}
+
+/**
+ * 色差单行处理参数（整帧共享）
+ */
+struct AberrationParams {
+    const uint8_t* source;
+    int width;
+    int height;
+    int sourceStride;
+    float scaleFactor;
+    float offsets[3];   // 按颜色通道：[0]=R 采样偏移, [1]=G, [2]=B
+};
+
+/**
+ * 色差单像素处理（标量版本，用于非 NEON 平台与行尾）
+ *
+ * 位移量只计算一次，三个通道共用；每个通道的采样位置 = 像素坐标 + 位移 + 通道偏移
+ */
+template <bool Bilinear, typename Layout>
+static inline void aberration_pixel_scalar(
+    const AberrationParams& p,
+    const uint8_t* mapPixel,
+    uint8_t* outPixel,
+    int x,
+    int y
+) {
+    // 位移贴图与源图同为 Bitmap 布局：R 通道 = X 方向位移，G 通道 = Y 方向位移（128 为中心点，表示无位移）
+    const float baseDx = (static_cast<float>(mapPixel[Layout::R]) - 128.0f) * p.scaleFactor;
+    const float baseDy = (static_cast<float>(mapPixel[Layout::G]) - 128.0f) * p.scaleFactor;
+
+    // Alpha 通道取自原始像素（原位处理时须在写入前读取）
+    const uint8_t alpha = p.source[y * p.sourceStride + x * 4 + Layout::A];
+
+    // 注意：与 Kotlin 实现完全一致（X/Y 使用同一通道偏移）
+    for (int c = 0; c < 3; ++c) {
+        const int ch = Layout::channel(c);
+        const float srcX = x + baseDx + p.offsets[c];
+        const float srcY = y + baseDy + p.offsets[c];
+        outPixel[ch] = sample_channel<Bilinear>(p.source, p.width, p.height, p.sourceStride, srcX, srcY, ch);
+    }
+    outPixel[Layout::A] = alpha;
+}
+
+#if ABERRATION_NEON
+
+/**
+ * 4 个像素的双线性采样邻域（字节偏移不含通道下标，同一组邻域可供多个通道共用）
+ */
+struct SampleTaps4 {
+    int32_t o00[4], o10[4], o01[4], o11[4];
+    float32x4_t fx, fy;
+};
+
+/**
+ * 计算 4 个采样点的邻域与权重（NEON 版本）
+ *
+ * 坐标、邻域下标与权重全部在向量中计算，越界判断为无分支掩码：
+ * - 范围内：x0 = trunc(x)，fx = x - x0（与标量版本相同）
+ * - 越界或最近邻模式：x0 = clamp(trunc(x + 0.5))，fx = fy = 0，插值结果即 c00
+ */
+template <bool Bilinear>
+static inline void sample_taps4_neon(
+    const AberrationParams& p,
+    float32x4_t sx,
+    float32x4_t sy,
+    SampleTaps4& taps
+) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const int32x4_t maxX = vdupq_n_s32(p.width - 1);
+    const int32x4_t maxY = vdupq_n_s32(p.height - 1);
+    const int32x4_t zeroI = vdupq_n_s32(0);
+
+    // 双线性插值的有效范围：[0, width - 1) × [0, height - 1)；最近邻模式恒为越界
+    uint32x4_t inRange = vdupq_n_u32(0);
+    if (Bilinear) {
+        inRange = vandq_u32(
+            vandq_u32(vcgeq_f32(sx, zero), vcltq_f32(sx, vdupq_n_f32(p.width - 1.0f))),
+            vandq_u32(vcgeq_f32(sy, zero), vcltq_f32(sy, vdupq_n_f32(p.height - 1.0f))));
+    }
+
+    int32x4_t tx = vcvtq_s32_f32(sx);
+    int32x4_t ty = vcvtq_s32_f32(sy);
+    int32x4_t nx = vmaxq_s32(zeroI, vminq_s32(maxX, vcvtq_s32_f32(vaddq_f32(sx, half))));
+    int32x4_t ny = vmaxq_s32(zeroI, vminq_s32(maxY, vcvtq_s32_f32(vaddq_f32(sy, half))));
+
+    int32x4_t x0 = vbslq_s32(inRange, tx, nx);
+    int32x4_t y0 = vbslq_s32(inRange, ty, ny);
+    int32x4_t x1 = vminq_s32(vaddq_s32(x0, vdupq_n_s32(1)), maxX);
+    int32x4_t y1 = vminq_s32(vaddq_s32(y0, vdupq_n_s32(1)), maxY);
+
+    taps.fx = vreinterpretq_f32_u32(vandq_u32(inRange,
+        vreinterpretq_u32_f32(vsubq_f32(sx, vcvtq_f32_s32(tx)))));
+    taps.fy = vreinterpretq_f32_u32(vandq_u32(inRange,
+        vreinterpretq_u32_f32(vsubq_f32(sy, vcvtq_f32_s32(ty)))));
+
+    // 邻域字节偏移
+    const int32x4_t vstride = vdupq_n_s32(p.sourceStride);
+    int32x4_t row0 = vmulq_s32(y0, vstride);
+    int32x4_t row1 = vmulq_s32(y1, vstride);
+    int32x4_t col0 = vshlq_n_s32(x0, 2);
+    int32x4_t col1 = vshlq_n_s32(x1, 2);
+
+    vst1q_s32(taps.o00, vaddq_s32(row0, col0));
+    vst1q_s32(taps.o10, vaddq_s32(row0, col1));
+    vst1q_s32(taps.o01, vaddq_s32(row1, col0));
+    vst1q_s32(taps.o11, vaddq_s32(row1, col1));
+}
+
+/**
+ * 按邻域读取一个通道并插值（NEON 版本）
+ *
+ * NEON 没有 gather 指令，只有 16 次字节读取是标量，其余运算 4 像素并行
+ */
+static inline uint32x4_t sample_taps4_channel_neon(
+    const AberrationParams& p,
+    const SampleTaps4& taps,
+    int channel
+) {
+    const uint8_t* src = p.source + channel;
+    float c00a[4], c10a[4], c01a[4], c11a[4];
+    for (int i = 0; i < 4; ++i) {
+        c00a[i] = src[taps.o00[i]];
+        c10a[i] = src[taps.o10[i]];
+        c01a[i] = src[taps.o01[i]];
+        c11a[i] = src[taps.o11[i]];
+    }
+
+    // 双线性插值：先 X 后 Y（与标量版本相同的运算顺序）
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t ifx = vsubq_f32(one, taps.fx);
+    const float32x4_t ify = vsubq_f32(one, taps.fy);
+    float32x4_t c0 = vaddq_f32(vmulq_f32(vld1q_f32(c00a), ifx), vmulq_f32(vld1q_f32(c10a), taps.fx));
+    float32x4_t c1 = vaddq_f32(vmulq_f32(vld1q_f32(c01a), ifx), vmulq_f32(vld1q_f32(c11a), taps.fx));
+    float32x4_t value = vaddq_f32(vmulq_f32(c0, ify), vmulq_f32(c1, taps.fy));
+
+    // 钳位到 [0, 255]，+0.5 后截断
+    value = vminq_f32(vmaxq_f32(vaddq_f32(value, vdupq_n_f32(0.5f)), vdupq_n_f32(0.0f)), vdupq_n_f32(255.0f));
+    return vcvtq_u32_f32(value);
+}
+
+/**
+ * 4 个像素同一通道的采样（NEON 版本）
+ */
+template <bool Bilinear>
+static inline uint32x4_t sample_channel4_neon(
+    const AberrationParams& p,
+    float32x4_t sx,
+    float32x4_t sy,
+    int channel
+) {
+    SampleTaps4 taps;
+    sample_taps4_neon<Bilinear>(p, sx, sy, taps);
+    return sample_taps4_channel_neon(p, taps, channel);
+}
+
+/**
+ * 色差 4 像素处理（NEON 版本）
+ */
+template <bool Bilinear, typename Layout>
+static inline void aberration_pixels4_neon(
+    const AberrationParams& p,
+    const uint8_t* mapPixels,
+    uint8_t* outPixels,
+    int x,
+    int y
+) {
+    // 位移贴图：R 通道 = X 位移，G 通道 = Y 位移（小端读取，字节 i 位于 [8i, 8i + 8)）
+    uint32x4_t map = vreinterpretq_u32_u8(vld1q_u8(mapPixels));
+    const uint32x4_t byteMask = vdupq_n_u32(0xFF);
+    float32x4_t mapR = vcvtq_f32_u32(vandq_u32(vshlq_u32(map, vdupq_n_s32(-Layout::R * 8)), byteMask));
+    float32x4_t mapG = vcvtq_f32_u32(vandq_u32(vshlq_u32(map, vdupq_n_s32(-Layout::G * 8)), byteMask));
+
+    const float32x4_t center = vdupq_n_f32(128.0f);
+    const float32x4_t scale = vdupq_n_f32(p.scaleFactor);
+    float32x4_t baseDx = vmulq_f32(vsubq_f32(mapR, center), scale);
+    float32x4_t baseDy = vmulq_f32(vsubq_f32(mapG, center), scale);
+
+    static const float kLaneOffsets[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    float32x4_t px = vaddq_f32(vdupq_n_f32(static_cast<float>(x)), vld1q_f32(kLaneOffsets));
+    float32x4_t py = vdupq_n_f32(static_cast<float>(y));
+    float32x4_t bx = vaddq_f32(px, baseDx);
+    float32x4_t by = vaddq_f32(py, baseDy);
+
+    // Alpha 通道取自原始像素（原位处理时须在写入前读取）
+    uint32x4_t alpha = vandq_u32(
+        vreinterpretq_u32_u8(vld1q_u8(p.source + y * p.sourceStride + x * 4)),
+        vdupq_n_u32(0xFFu << (Layout::A * 8)));
+
+    uint32x4_t packed = alpha;
+    for (int c = 0; c < 3; ++c) {
+        const int ch = Layout::channel(c);
+        const float32x4_t off = vdupq_n_f32(p.offsets[c]);
+        uint32x4_t v = sample_channel4_neon<Bilinear>(p, vaddq_f32(bx, off), vaddq_f32(by, off), ch);
+        packed = vorrq_u32(packed, vshlq_u32(v, vdupq_n_s32(ch * 8)));
+    }
+
+    vst1q_u8(outPixels, vreinterpretq_u8_u32(packed));
+}
+
+#endif // ABERRATION_NEON
+
+/**
+ * 色差单行处理：[left, right) 内先按 4 像素 NEON，再标量处理行尾
+ */
+template <bool Bilinear, typename Layout>
+static void aberration_row(
+    const AberrationParams& p,
+    const uint8_t* displacementRow,
+    uint8_t* resultRow,
+    int left,
+    int right,
+    int y
+) {
+    int x = left;
+#if ABERRATION_NEON
+    for (; x + 4 <= right; x += 4) {
+        aberration_pixels4_neon<Bilinear, Layout>(p, displacementRow + x * 4, resultRow + x * 4, x, y);
+    }
+#endif
+    for (; x < right; ++x) {
+        aberration_pixel_scalar<Bilinear, Layout>(p, displacementRow + x * 4, resultRow + x * 4, x, y);
+    }
+}
+
+typedef void (*AberrationRowKernel)(const AberrationParams&, const uint8_t*, uint8_t*, int, int, int);
+
+/**
+ * 色差行内核分派表：[useBilinear]
+ */
+static const AberrationRowKernel kAberrationRows[2] = {
+    aberration_row<false, BitmapLayout>,
+    aberration_row<true, BitmapLayout>
+};
+
+int chromatic_aberration_reach(
+    float scale,
+    float redOffset,
+    float greenOffset,
+    float blueOffset
 ) {
-    outB = sample_bilinear_channel(pixels, width, height, stride, x, y, 0);
-    outG = sample_bilinear_channel(pixels, width, height, stride, x, y, 1);
-    outR = sample_bilinear_channel(pixels, width, height, stride, x, y, 2);
-    outA = sample_bilinear_channel(pixels, width, height, stride, x, y, 3);
+    // 位移贴图通道偏离中心最多 128：|baseD| <= 128 × scale / 255
+    const float maxOffset = std::max(std::fabs(redOffset), std::max(std::fabs(greenOffset), std::fabs(blueOffset)));
+    const float reach = 128.0f * std::fabs(scale) / 255.0f + maxOffset;
+    // +2：双线性插值的右 / 下邻域与最近邻的四舍五入
+    return static_cast<int>(std::ceil(reach)) + 2;
 }
 
 // 主处理函数
@@ -166,6 +424,36 @@ void chromatic_aberration_rgba8888(
     float greenOffset,
     float blueOffset,
     bool useBilinear
+) {
+    chromatic_aberration_rgba8888_region(
+        source, displacement, result,
+        width, height,
+        sourceStride, displacementStride, resultStride,
+        intensity, scale,
+        redOffset, greenOffset, blueOffset,
+        useBilinear,
+        damage_rect_full(width, height)
+    );
+}
+
+// 区域处理函数（整帧版本也由此实现）
+void chromatic_aberration_rgba8888_region(
+    const uint8_t* source,
+    const uint8_t* displacement,
+    uint8_t* result,
+    int width,
+    int height,
+    int sourceStride,
+    int displacementStride,
+    int resultStride,
+    float intensity,
+    float scale,
+    float redOffset,
+    float greenOffset,
+    float blueOffset,
+    bool useBilinear,
+    const DamageRect& rect,
+    const RowSpan* spans
 ) {
     // 参数校验
     if (!source || !displacement || !result) {
@@ -184,83 +472,61 @@ void chromatic_aberration_rgba8888(
         return;
     }
 
+    const DamageRect region = damage_rect_expand(rect, 0, width, height);
+    if (region.empty()) return;
+
+    TraceScope total(TRACE_FILTER_ABERRATION, TRACE_STAGE_TOTAL);
+
     // 位移缩放因子（与 Kotlin 实现一致）
     const float scaleFactor = scale / 255.0f;
 
     // ✅ 修复：Kotlin 层已经将 offset * intensity * downscale，所以这里直接使用传入的值
     // 不需要再乘以 intensity
+    (void)intensity;
     const float actualRedOffset = redOffset;
     const float actualGreenOffset = greenOffset;
     const float actualBlueOffset = blueOffset;
 
-    LOGD("Processing %dx%d, intensity=%.2f, scale=%.2f, offsets=(%.3f, %.3f, %.3f), useBilinear=%d",
-         width, height, intensity, scale, actualRedOffset, actualGreenOffset, actualBlueOffset, useBilinear);
+    // 按行带并行处理；原位处理（result 与 source 相同）时逐行依赖读取，只能串行
+    const int rowsGrain = (result == source) ? region.height() : parallel_rows_grain(region.width());
 
-    // 处理每个像素
-    for (int y = 0; y < height; ++y) {
-        const uint8_t* displacementRow = displacement + y * displacementStride;
-        uint8_t* resultRow = result + y * resultStride;
-
-        for (int x = 0; x < width; ++x) {
-            // ✅ 修复：位移贴图实际上是 RGBA 格式，不是 BGRA！
-            const uint8_t* mapPixel = displacementRow + x * 4;
-            uint8_t mapR = mapPixel[0];  // R 通道 = X 方向位移
-            uint8_t mapG = mapPixel[1];  // G 通道 = Y 方向位移
-            uint8_t mapB = mapPixel[2];  // B 通道
-            uint8_t mapA = mapPixel[3];  // A 通道
-
-            // 计算基础位移（128 为中心点，表示无位移）
-            float baseDx = (static_cast<float>(mapR) - 128.0f) * scaleFactor;
-            float baseDy = (static_cast<float>(mapG) - 128.0f) * scaleFactor;
-
-            // 调试：打印中心像素的信息和位移贴图值
-            if (x == width / 2 && y == height / 2) {
-                LOGD("C++ center pixel: BGRA=(%d,%d,%d,%d), baseDx=%.3f, baseDy=%.3f, offsets=(%.3f, %.3f, %.3f)",
-                     mapB, mapG, mapR, mapA, baseDx, baseDy, actualRedOffset, actualGreenOffset, actualBlueOffset);
-            }
+    const AberrationParams params = {
+        source, width, height, sourceStride, scaleFactor,
+        { actualRedOffset, actualGreenOffset, actualBlueOffset }
+    };
+    const AberrationRowKernel row = kAberrationRows[useBilinear ? 1 : 0];
 
-            // 打印几个边缘像素的位移贴图值
-            if ((x == 10 && y == 10) || (x == width - 10 && y == 10) ||
-                (x == 10 && y == height - 10) || (x == width - 10 && y == height - 10)) {
-                LOGD("C++ edge pixel (%d,%d): BGRA=(%d,%d,%d,%d), baseDx=%.3f, baseDy=%.3f",
-                     x, y, mapB, mapG, mapR, mapA, baseDx, baseDy);
-            }
+    // 处理每个像素
+    TraceScope sample(TRACE_FILTER_ABERRATION, TRACE_STAGE_SAMPLE);
+    parallel_for(region.top, region.bottom, rowsGrain, [&](int rowBegin, int rowEnd, int) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            const uint8_t* displacementRow = displacement + y * displacementStride;
+            uint8_t* resultRow = result + y * resultStride;
 
-            // 计算三个通道的采样位置（每个通道有不同的位移）
-            // 注意：与 Kotlin 实现完全一致
-            float rSrcX = x + baseDx + actualRedOffset;
-            float rSrcY = y + baseDy + actualRedOffset;
-            float gSrcX = x + baseDx + actualGreenOffset;
-            float gSrcY = y + baseDy + actualGreenOffset;
-            float bSrcX = x + baseDx + actualBlueOffset;
-            float bSrcY = y + baseDy + actualBlueOffset;
-
-            // ✅ 根据设置选择采样方法
-            uint8_t r, g, b;
-            if (useBilinear) {
-                // 双线性插值：高质量，平滑采样，无马赛克
-                r = sample_bilinear_channel(source, width, height, sourceStride, rSrcX, rSrcY, 2);  // R 通道
-                g = sample_bilinear_channel(source, width, height, sourceStride, gSrcX, gSrcY, 1);  // G 通道
-                b = sample_bilinear_channel(source, width, height, sourceStride, bSrcX, bSrcY, 0);  // B 通道
+            if (spans) {
+                const RowSpan span = row_span_clip(spans[y], region.left, region.right);
+                if (!span.empty()) row(params, displacementRow, resultRow, span.left, span.right, y);
             } else {
-                // 最近邻采样：高性能，速度快 2-3 倍
-                r = sample_nearest_channel(source, width, height, sourceStride, rSrcX, rSrcY, 2);  // R 通道
-                g = sample_nearest_channel(source, width, height, sourceStride, gSrcX, gSrcY, 1);  // G 通道
-                b = sample_nearest_channel(source, width, height, sourceStride, bSrcX, bSrcY, 0);  // B 通道
+                row(params, displacementRow, resultRow, region.left, region.right, y);
             }
 
-            // Alpha 通道取自原始像素
-            const uint8_t* sourcePixel = source + y * sourceStride + x * 4;
-            uint8_t alpha = sourcePixel[3];
-
-            // 写入结果（BGRA 格式）
-            uint8_t* outPixel = resultRow + x * 4;
-            outPixel[0] = b;      // B 通道（从蓝色采样位置的 B 通道）
-            outPixel[1] = g;      // G 通道（从绿色采样位置的 G 通道）
-            outPixel[2] = r;      // R 通道（从红色采样位置的 R 通道）
-            outPixel[3] = alpha;  // A 通道（保持原始 Alpha）
+#if CHROMATIC_DEBUG_SAMPLES
+            // 调试：打印中心像素与四个角附近像素的位移贴图值
+            const int sampleXs[3] = { 10, width / 2, width - 10 };
+            for (int sx : sampleXs) {
+                bool hit = (sx == width / 2) ? (y == height / 2)
+                                             : (sx >= 0 && sx < width && (y == 10 || y == height - 10));
+                if (!hit) continue;
+                const uint8_t* mapPixel = displacementRow + sx * 4;
+                LOGD("C++ sample pixel (%d,%d): RGBA=(%d,%d,%d,%d), baseDx=%.3f, baseDy=%.3f",
+                     sx, y, mapPixel[BitmapLayout::R], mapPixel[BitmapLayout::G],
+                     mapPixel[BitmapLayout::B], mapPixel[BitmapLayout::A],
+                     (mapPixel[BitmapLayout::R] - 128.0f) * scaleFactor,
+                     (mapPixel[BitmapLayout::G] - 128.0f) * scaleFactor);
+            }
+#endif
         }
-    }
+    });
 }
 
 // 原位处理版本（简化参数）
@@ -288,10 +554,392 @@ void chromatic_aberration_rgba8888_inplace(
     );
 }
 
+// ============================================================================
+// 边缘扭曲实现（Edge Distortion）
+// ============================================================================
+
+/**
+ * 边缘扭曲单行处理参数（整帧共享）
+ */
+struct DistortionParams {
+    AberrationParams sampler;   // 与色差共用的采样参数（offsets 不使用）
+    int fadeWidth;              // 边缘淡化宽度（像素，<= 0 表示不淡化）
+    float invFadeWidth;
+};
+
+/**
+ * 边缘淡化系数：到最近图像边缘的距离 / fadeWidth，封顶 1
+ */
+static inline float distortion_fade(const DistortionParams& p, int x, int y) {
+    if (p.fadeWidth <= 0) return 1.0f;
+    const int dist = std::min(std::min(x, y), std::min(p.sampler.width - 1 - x, p.sampler.height - 1 - y));
+    return dist < p.fadeWidth ? dist * p.invFadeWidth : 1.0f;
+}
+
+/**
+ * 边缘扭曲单像素处理（标量版本，用于非 NEON 平台与行尾）
+ *
+ * 四个通道（含 Alpha）在同一位置采样，与 Kotlin 版本一致
+ */
+template <bool Bilinear, typename Layout>
+static inline void distortion_pixel_scalar(
+    const DistortionParams& p,
+    const uint8_t* mapPixel,
+    uint8_t* outPixel,
+    int x,
+    int y
+) {
+    const AberrationParams& s = p.sampler;
+    const float fade = distortion_fade(p, x, y);
+    const float dx = (static_cast<float>(mapPixel[Layout::R]) - 128.0f) * s.scaleFactor * fade;
+    const float dy = (static_cast<float>(mapPixel[Layout::G]) - 128.0f) * s.scaleFactor * fade;
+    const float srcX = x + dx;
+    const float srcY = y + dy;
+
+    for (int ch = 0; ch < 4; ++ch) {
+        outPixel[ch] = sample_channel<Bilinear>(s.source, s.width, s.height, s.sourceStride, srcX, srcY, ch);
+    }
+}
+
+#if ABERRATION_NEON
+
+/**
+ * 边缘扭曲 4 像素处理（NEON 版本）：邻域只计算一次，四个通道共用
+ */
+template <bool Bilinear, typename Layout>
+static inline void distortion_pixels4_neon(
+    const DistortionParams& p,
+    const uint8_t* mapPixels,
+    uint8_t* outPixels,
+    int x,
+    int y
+) {
+    const AberrationParams& s = p.sampler;
+    uint32x4_t map = vreinterpretq_u32_u8(vld1q_u8(mapPixels));
+    const uint32x4_t byteMask = vdupq_n_u32(0xFF);
+    float32x4_t mapR = vcvtq_f32_u32(vandq_u32(vshlq_u32(map, vdupq_n_s32(-Layout::R * 8)), byteMask));
+    float32x4_t mapG = vcvtq_f32_u32(vandq_u32(vshlq_u32(map, vdupq_n_s32(-Layout::G * 8)), byteMask));
+
+    static const int32_t kLaneOffsetsI[4] = {0, 1, 2, 3};
+    const int32x4_t xi = vaddq_s32(vdupq_n_s32(x), vld1q_s32(kLaneOffsetsI));
+
+    // 位移缩放 × 边缘淡化（与标量版本相同的乘法顺序）
+    float32x4_t fade = vdupq_n_f32(1.0f);
+    if (p.fadeWidth > 0) {
+        const int distY = std::min(y, s.height - 1 - y);
+        const int32x4_t dist = vminq_s32(vminq_s32(xi, vsubq_s32(vdupq_n_s32(s.width - 1), xi)), vdupq_n_s32(distY));
+        const float32x4_t ramp = vmulq_n_f32(vcvtq_f32_s32(dist), p.invFadeWidth);
+        fade = vbslq_f32(vcltq_s32(dist, vdupq_n_s32(p.fadeWidth)), ramp, fade);
+    }
+
+    const float32x4_t center = vdupq_n_f32(128.0f);
+    float32x4_t dx = vmulq_f32(vmulq_n_f32(vsubq_f32(mapR, center), s.scaleFactor), fade);
+    float32x4_t dy = vmulq_f32(vmulq_n_f32(vsubq_f32(mapG, center), s.scaleFactor), fade);
+
+    SampleTaps4 taps;
+    sample_taps4_neon<Bilinear>(s, vaddq_f32(vcvtq_f32_s32(xi), dx), vaddq_f32(vdupq_n_f32(static_cast<float>(y)), dy), taps);
+
+    uint32x4_t packed = vdupq_n_u32(0);
+    for (int ch = 0; ch < 4; ++ch) {
+        uint32x4_t v = sample_taps4_channel_neon(s, taps, ch);
+        packed = vorrq_u32(packed, vshlq_u32(v, vdupq_n_s32(ch * 8)));
+    }
+
+    vst1q_u8(outPixels, vreinterpretq_u8_u32(packed));
+}
+
+#endif // ABERRATION_NEON
+
+/**
+ * 边缘扭曲单行处理
+ */
+template <bool Bilinear, typename Layout>
+static void distortion_row(
+    const DistortionParams& p,
+    const uint8_t* displacementRow,
+    uint8_t* resultRow,
+    int width,
+    int y
+) {
+    int x = 0;
+#if ABERRATION_NEON
+    for (; x + 4 <= width; x += 4) {
+        distortion_pixels4_neon<Bilinear, Layout>(p, displacementRow + x * 4, resultRow + x * 4, x, y);
+    }
+#endif
+    for (; x < width; ++x) {
+        distortion_pixel_scalar<Bilinear, Layout>(p, displacementRow + x * 4, resultRow + x * 4, x, y);
+    }
+}
+
+typedef void (*DistortionRowKernel)(const DistortionParams&, const uint8_t*, uint8_t*, int, int);
+
+/**
+ * 边缘扭曲行内核分派表：[useBilinear]
+ */
+static const DistortionRowKernel kDistortionRows[2] = {
+    distortion_row<false, BitmapLayout>,
+    distortion_row<true, BitmapLayout>
+};
+
+void edge_distortion_rgba8888(
+    const uint8_t* source,
+    const uint8_t* displacement,
+    uint8_t* result,
+    int width,
+    int height,
+    int sourceStride,
+    int displacementStride,
+    int resultStride,
+    float scale,
+    int fadeWidth,
+    bool useBilinear
+) {
+    // 参数校验
+    if (!source || !displacement || !result || result == source) {
+        LOGE("Invalid parameters: source=%p, displacement=%p, result=%p", source, displacement, result);
+        return;
+    }
+
+    if (width <= 0 || height <= 0) {
+        LOGE("Invalid dimensions: %dx%d", width, height);
+        return;
+    }
+
+    if (sourceStride < width * 4 || displacementStride < width * 4 || resultStride < width * 4) {
+        LOGE("Invalid stride: source=%d, displacement=%d, result=%d, min=%d",
+             sourceStride, displacementStride, resultStride, width * 4);
+        return;
+    }
+
+    TraceScope total(TRACE_FILTER_DISTORTION, TRACE_STAGE_TOTAL);
+
+    const DistortionParams params = {
+        { source, width, height, sourceStride, scale / 255.0f, { 0.0f, 0.0f, 0.0f } },
+        fadeWidth,
+        fadeWidth > 0 ? 1.0f / fadeWidth : 0.0f
+    };
+    const DistortionRowKernel row = kDistortionRows[useBilinear ? 1 : 0];
+
+    TraceScope sample(TRACE_FILTER_DISTORTION, TRACE_STAGE_SAMPLE);
+    parallel_for(0, height, parallel_rows_grain(width), [&](int rowBegin, int rowEnd, int) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            row(params, displacement + y * displacementStride, result + y * resultStride, width, y);
+        }
+    });
+}
+
 // ============================================================================
 // 色散效果实现（Chromatic Dispersion）
 // ============================================================================
 
+/**
+ * 计算折射强度（Snell 定律）
+ *
+ * @param distanceToEdge 到边缘的距离（0-500）
+ */
+static float refraction_edge_factor(float distanceToEdge, float refThickness, float refFactor) {
+    float edgeFactor = 0.0f;
+    if (distanceToEdge < refThickness) {
+        float x_R_ratio = 1.0f - distanceToEdge / refThickness;
+        float thetaI = asinf(powf(x_R_ratio, 2.0f));
+        float thetaT = asinf(1.0f / refFactor * sinf(thetaI));
+        edgeFactor = -tanf(thetaT - thetaI);
+
+        // 边界检查
+        if (edgeFactor < 0.0f) edgeFactor = 0.0f;
+    }
+    return edgeFactor;
+}
+
+/**
+ * 折射强度查找表
+ *
+ * edgeFactor 只取决于 8 位边缘距离与 refThickness / refFactor
+ * （refDispersion 只作用于之后的通道系数），整帧 256 项即可覆盖；
+ * 参数不变时复用上一次的表，避免每像素 4 次三角函数
+ */
+struct RefractionLut {
+    bool valid = false;
+    float refThickness = 0.0f;
+    float refFactor = 0.0f;
+    float edgeFactor[256];
+};
+
+static std::mutex g_refractionLutMutex;
+static RefractionLut g_refractionLut;
+
+/**
+ * 取得（必要时重建）折射强度查找表，复制到调用方的数组中
+ */
+static void get_refraction_lut(float refThickness, float refFactor, float out[256]) {
+    std::lock_guard<std::mutex> lock(g_refractionLutMutex);
+    RefractionLut& lut = g_refractionLut;
+    if (!lut.valid || lut.refThickness != refThickness || lut.refFactor != refFactor) {
+        for (int i = 0; i < 256; ++i) {
+            // 边缘距离归一化到 0-500 范围
+            lut.edgeFactor[i] = refraction_edge_factor(i / 255.0f * 500.0f, refThickness, refFactor);
+        }
+        lut.refThickness = refThickness;
+        lut.refFactor = refFactor;
+        lut.valid = true;
+    }
+    memcpy(out, lut.edgeFactor, sizeof(lut.edgeFactor));
+}
+
+/**
+ * 径向法线表：每像素 (normalX, normalY)，从图像中心指向该像素的单位向量
+ *
+ * 只取决于图像尺寸，缓存最近一次尺寸的表（8 字节/像素）；
+ * 以 shared_ptr 交给调用方，尺寸变化或 chromatic_dispersion_release_cache 时
+ * 旧表在最后一个使用者结束后释放
+ */
+struct RadialNormalTable {
+    int width;
+    int height;
+    std::vector<float> xy;
+};
+
+static std::mutex g_radialNormalMutex;
+static std::shared_ptr<const RadialNormalTable> g_radialNormals;
+
+static std::shared_ptr<const RadialNormalTable> get_radial_normals(int width, int height) {
+    std::lock_guard<std::mutex> lock(g_radialNormalMutex);
+    if (g_radialNormals && g_radialNormals->width == width && g_radialNormals->height == height) {
+        return g_radialNormals;
+    }
+
+    std::shared_ptr<RadialNormalTable> table = std::make_shared<RadialNormalTable>();
+    table->width = width;
+    table->height = height;
+    table->xy.resize(static_cast<size_t>(width) * height * 2);
+
+    // 中心点坐标
+    const float centerX = width * 0.5f;
+    const float centerY = height * 0.5f;
+    float* xy = table->xy.data();
+
+    parallel_for(0, height, parallel_rows_grain(width), [&](int rowBegin, int rowEnd, int) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            float* row = xy + static_cast<size_t>(y) * width * 2;
+            for (int x = 0; x < width; ++x) {
+                float dx = x - centerX;
+                float dy = y - centerY;
+                float len = sqrtf(dx * dx + dy * dy);
+                if (len > 0.0f) {
+                    row[x * 2 + 0] = dx / len;
+                    row[x * 2 + 1] = dy / len;
+                } else {
+                    row[x * 2 + 0] = 0.0f;
+                    row[x * 2 + 1] = 0.0f;
+                }
+            }
+        }
+    });
+
+    g_radialNormals = table;
+    return g_radialNormals;
+}
+
+size_t chromatic_dispersion_release_cache() {
+    std::lock_guard<std::mutex> lock(g_radialNormalMutex);
+    if (!g_radialNormals) return 0;
+    const size_t bytes = g_radialNormals->xy.size() * sizeof(float);
+    g_radialNormals.reset();
+    return bytes;
+}
+
+/**
+ * 色散单行处理参数（整帧共享）
+ */
+struct DispersionParams {
+    const uint8_t* source;
+    int width;
+    int height;
+    int sourceStride;
+    const float* edgeFactorLut;   // 256 项折射强度表
+    float dispersion[3];          // 按颜色通道：[0]=R 色散系数, [1]=G, [2]=B
+    float offsetScaleX;
+    float offsetScaleY;
+};
+
+/**
+ * 色散单行处理
+ *
+ * HasNormalMap 为 false 时 normalRow 为空，法线取自径向法线表 radialRow（每像素 x, y 两个 float）
+ */
+template <bool Bilinear, bool HasNormalMap, typename Layout>
+static void dispersion_row(
+    const DispersionParams& p,
+    const uint8_t* edgeRow,
+    const uint8_t* normalRow,
+    const float* radialRow,
+    uint8_t* resultRow,
+    int left,
+    int right,
+    int y
+) {
+    const uint8_t* sourceRow = p.source + y * p.sourceStride;
+
+    for (int x = left; x < right; ++x) {
+        // 1-2. 边缘距离 → 折射强度（查表；灰度贴图，取 R 通道）
+        // 注意：贴图中现在直接存储"到边缘的距离"（边缘=0，中心=255），无需反转
+        const uint8_t* edgePixel = edgeRow + x * 4;
+        const float edgeFactor = p.edgeFactorLut[edgePixel[Layout::R]];
+
+        // 3. 读取或查表得到法线方向
+        float normalX, normalY;
+        if (HasNormalMap) {
+            // 从法线贴图读取
+            const uint8_t* normalPixel = normalRow + x * 4;
+            normalX = (normalPixel[Layout::R] / 255.0f) * 2.0f - 1.0f;  // R 通道
+            normalY = (normalPixel[Layout::G] / 255.0f) * 2.0f - 1.0f;  // G 通道
+        } else {
+            // 径向法线（从中心指向边缘）
+            normalX = radialRow[x * 2 + 0];
+            normalY = radialRow[x * 2 + 1];
+        }
+
+        // 4. 计算基础偏移（沿法线方向）
+        const float baseOffsetX = -normalX * edgeFactor * p.offsetScaleX;
+        const float baseOffsetY = -normalY * edgeFactor * p.offsetScaleY;
+
+        // 5-6. 应用色散（不同折射率），分别采样三个通道
+        // Alpha 通道取自原始像素（原位处理时须在写入前读取）
+        uint8_t* outPixel = resultRow + x * 4;
+        const uint8_t alpha = sourceRow[x * 4 + Layout::A];
+        for (int c = 0; c < 3; ++c) {
+            const int ch = Layout::channel(c);
+            outPixel[ch] = sample_channel<Bilinear>(
+                p.source, p.width, p.height, p.sourceStride,
+                x + baseOffsetX * p.dispersion[c], y + baseOffsetY * p.dispersion[c], ch);
+        }
+        outPixel[Layout::A] = alpha;
+
+#if CHROMATIC_DEBUG_SAMPLES
+        // 调试：采样边缘、中心和几个关键点
+        if ((x == 10 && y == 10) || (x == p.width - 10 && y == 10) ||
+            (x == p.width / 2 && y == p.height / 2) ||
+            (x == 10 && y == p.height - 10) || (x == p.width - 10 && y == p.height - 10)) {
+            LOGD("Dispersion pixel (%d,%d): edgeByte=%d, edgeFactor=%.2f, offset=(%.2f,%.2f), RGB=(%d,%d,%d)",
+                 x, y, edgePixel[Layout::R], edgeFactor, baseOffsetX, baseOffsetY,
+                 outPixel[Layout::R], outPixel[Layout::G], outPixel[Layout::B]);
+        }
+#endif
+    }
+}
+
+typedef void (*DispersionRowKernel)(const DispersionParams&, const uint8_t*, const uint8_t*, const float*,
+                                    uint8_t*, int, int, int);
+
+/**
+ * 色散行内核分派表：[useBilinear][有法线贴图]
+ */
+static const DispersionRowKernel kDispersionRows[2][2] = {
+    { dispersion_row<false, false, BitmapLayout>, dispersion_row<false, true, BitmapLayout> },
+    { dispersion_row<true, false, BitmapLayout>, dispersion_row<true, true, BitmapLayout> }
+};
+
 /**
  * 色散效果处理 - 基于物理光学原理
  *
@@ -324,6 +972,70 @@ void chromatic_dispersion_rgba8888(
     float refDispersion,
     float dpr,
     bool useBilinear
+) {
+    chromatic_dispersion_rgba8888_region(
+        source, edgeDistance, normalMap, result,
+        width, height,
+        sourceStride, edgeDistanceStride, normalMapStride, resultStride,
+        refThickness, refFactor, refDispersion, dpr,
+        useBilinear,
+        damage_rect_full(width, height)
+    );
+}
+
+/**
+ * 色散采样的最大偏移（像素）
+ *
+ * 每轴偏移 = |法线分量| × edgeFactor × offsetScale × 色散系数，法线分量不超过 1，
+ * edgeFactor 取查找表最大值；NaN（refFactor < 1 时 asin 越界）不参与比较
+ */
+int chromatic_dispersion_reach(
+    int width,
+    int height,
+    float refThickness,
+    float refFactor,
+    float refDispersion,
+    float dpr
+) {
+    if (width <= 0 || height <= 0) return 0;
+
+    float edgeFactorLut[256];
+    get_refraction_lut(refThickness, refFactor, edgeFactorLut);
+    float maxEdgeFactor = 0.0f;
+    for (int i = 0; i < 256; ++i) {
+        if (edgeFactorLut[i] > maxEdgeFactor) maxEdgeFactor = edgeFactorLut[i];
+    }
+
+    // 与 chromatic_dispersion_rgba8888_region 中的系数一致（N_R = 0.98, N_B = 1.02）
+    const float maxDispersion = std::max(std::fabs(1.0f + 0.02f * refDispersion),
+                                         std::fabs(1.0f - 0.02f * refDispersion));
+    const float aspectRatio = static_cast<float>(height) / static_cast<float>(width);
+    const float maxScale = 5.0f * std::fabs(dpr) * std::max(aspectRatio, 1.0f);
+
+    const float reach = maxEdgeFactor * maxScale * maxDispersion;
+    const int limit = std::max(width, height);
+    if (!(reach < static_cast<float>(limit))) return limit;
+    return static_cast<int>(std::ceil(reach)) + 2;
+}
+
+void chromatic_dispersion_rgba8888_region(
+    const uint8_t* source,
+    const uint8_t* edgeDistance,
+    const uint8_t* normalMap,
+    uint8_t* result,
+    int width,
+    int height,
+    int sourceStride,
+    int edgeDistanceStride,
+    int normalMapStride,
+    int resultStride,
+    float refThickness,
+    float refFactor,
+    float refDispersion,
+    float dpr,
+    bool useBilinear,
+    const DamageRect& rect,
+    const RowSpan* spans
 ) {
     // 参数校验
     if (!source || !edgeDistance || !result) {
@@ -341,118 +1053,66 @@ void chromatic_dispersion_rgba8888(
         return;
     }
 
+    const DamageRect region = damage_rect_expand(rect, 0, width, height);
+    if (region.empty()) return;
+
+    TraceScope total(TRACE_FILTER_DISPERSION, TRACE_STAGE_TOTAL);
+
     // 折射率常数（对应不同波长的光）
     const float N_R = 1.0f - 0.02f;  // 0.98 - 红光
     const float N_G = 1.0f;           // 1.0  - 绿光
     const float N_B = 1.0f + 0.02f;  // 1.02 - 蓝光
 
-    // 中心点坐标（用于计算径向法线）
-    const float centerX = width * 0.5f;
-    const float centerY = height * 0.5f;
-
-    LOGD("Dispersion: Processing %dx%d, refThickness=%.2f, refFactor=%.2f, refDispersion=%.2f, dpr=%.2f",
-         width, height, refThickness, refFactor, refDispersion, dpr);
-
-    // 调试：采样几个关键像素
-    bool debugSamples = true;
+    // 色散系数（不同折射率），每帧为常量
+    const float dispersionR = 1.0f - (N_R - 1.0f) * refDispersion;
+    const float dispersionG = 1.0f - (N_G - 1.0f) * refDispersion;
+    const float dispersionB = 1.0f - (N_B - 1.0f) * refDispersion;
 
-    // 处理每个像素
-    for (int y = 0; y < height; ++y) {
-        const uint8_t* edgeRow = edgeDistance + y * edgeDistanceStride;
-        uint8_t* resultRow = result + y * resultStride;
-
-        for (int x = 0; x < width; ++x) {
-            // 1. 读取边缘距离（归一化到 0-500 范围）
-            // 注意：贴图中现在直接存储"到边缘的距离"（边缘=0，中心=255），无需反转
-            const uint8_t* edgePixel = edgeRow + x * 4;
-            float distanceToEdge = edgePixel[2] / 255.0f * 500.0f;  // 使用 R 通道（BGRA 格式中 index=2）
-            float nmerged = distanceToEdge;
-
-            // 2. 计算折射强度（Snell 定律）
-            float edgeFactor = 0.0f;
-            if (nmerged < refThickness) {
-                float x_R_ratio = 1.0f - nmerged / refThickness;
-                float thetaI = asinf(powf(x_R_ratio, 2.0f));
-                float thetaT = asinf(1.0f / refFactor * sinf(thetaI));
-                edgeFactor = -tanf(thetaT - thetaI);
-
-                // 边界检查
-                if (edgeFactor < 0.0f) edgeFactor = 0.0f;
-            }
+    // 增大偏移系数，使效果更明显（从 0.05 增加到 5.0，增大 100 倍）
+    const float aspectRatio = static_cast<float>(height) / static_cast<float>(width);
+    const float offsetScaleX = 5.0f * dpr * aspectRatio;
+    const float offsetScaleY = 5.0f * dpr;
 
-            // 3. 读取或计算法线方向
-            float normalX, normalY;
-            if (normalMap != nullptr) {
-                // 从法线贴图读取
-                const uint8_t* normalPixel = normalMap + y * normalMapStride + x * 4;
-                normalX = (normalPixel[2] / 255.0f) * 2.0f - 1.0f;  // R 通道
-                normalY = (normalPixel[1] / 255.0f) * 2.0f - 1.0f;  // G 通道
-            } else {
-                // 使用径向法线（从中心指向边缘）
-                float dx = x - centerX;
-                float dy = y - centerY;
-                float len = sqrtf(dx * dx + dy * dy);
-                if (len > 0.0f) {
-                    normalX = dx / len;
-                    normalY = dy / len;
-                } else {
-                    normalX = 0.0f;
-                    normalY = 0.0f;
-                }
-            }
+    // 折射强度查找表（按 8 位边缘距离索引）
+    TraceScope setup(TRACE_FILTER_DISPERSION, TRACE_STAGE_SETUP);
+    float edgeFactorLut[256];
+    get_refraction_lut(refThickness, refFactor, edgeFactorLut);
 
-            // 4. 计算基础偏移（沿法线方向）
-            // 增大偏移系数，使效果更明显（从 0.05 增加到 5.0，增大 100 倍）
-            float aspectRatio = static_cast<float>(height) / static_cast<float>(width);
-            float baseOffsetX = -normalX * edgeFactor * 5.0f * dpr * aspectRatio;
-            float baseOffsetY = -normalY * edgeFactor * 5.0f * dpr;
-
-            // 5. 应用色散（不同折射率）
-            float offsetR_x = baseOffsetX * (1.0f - (N_R - 1.0f) * refDispersion);
-            float offsetR_y = baseOffsetY * (1.0f - (N_R - 1.0f) * refDispersion);
-
-            float offsetG_x = baseOffsetX * (1.0f - (N_G - 1.0f) * refDispersion);
-            float offsetG_y = baseOffsetY * (1.0f - (N_G - 1.0f) * refDispersion);
+    // 径向法线表（无法线贴图时使用）
+    std::shared_ptr<const RadialNormalTable> radialNormals;
+    if (normalMap == nullptr) {
+        radialNormals = get_radial_normals(width, height);
+    }
+    setup.stop();
 
-            float offsetB_x = baseOffsetX * (1.0f - (N_B - 1.0f) * refDispersion);
-            float offsetB_y = baseOffsetY * (1.0f - (N_B - 1.0f) * refDispersion);
+    const DispersionParams params = {
+        source, width, height, sourceStride, edgeFactorLut,
+        { dispersionR, dispersionG, dispersionB },
+        offsetScaleX, offsetScaleY
+    };
+    const DispersionRowKernel row = kDispersionRows[useBilinear ? 1 : 0][normalMap ? 1 : 0];
 
-            // 6. 采样三个通道
-            uint8_t r, g, b;
-            if (useBilinear) {
-                r = sample_bilinear_channel(source, width, height, sourceStride, x + offsetR_x, y + offsetR_y, 2);
-                g = sample_bilinear_channel(source, width, height, sourceStride, x + offsetG_x, y + offsetG_y, 1);
-                b = sample_bilinear_channel(source, width, height, sourceStride, x + offsetB_x, y + offsetB_y, 0);
-            } else {
-                r = sample_nearest_channel(source, width, height, sourceStride, x + offsetR_x, y + offsetR_y, 2);
-                g = sample_nearest_channel(source, width, height, sourceStride, x + offsetG_x, y + offsetG_y, 1);
-                b = sample_nearest_channel(source, width, height, sourceStride, x + offsetB_x, y + offsetB_y, 0);
-            }
+    // 按行带并行处理；原位处理（result 与 source 相同）时只能串行
+    const int rowsGrain = (result == source) ? region.height() : parallel_rows_grain(region.width());
 
-            // Alpha 通道取自原始像素
-            const uint8_t* sourcePixel = source + y * sourceStride + x * 4;
-            uint8_t alpha = sourcePixel[3];
-
-            // 写入结果（BGRA 格式）
-            uint8_t* outPixel = resultRow + x * 4;
-            outPixel[0] = b;
-            outPixel[1] = g;
-            outPixel[2] = r;
-            outPixel[3] = alpha;
-
-            // 调试：采样边缘、中心和几个关键点
-            if (debugSamples) {
-                if ((x == 10 && y == 10) || (x == width - 10 && y == 10) ||
-                    (x == width / 2 && y == height / 2) ||
-                    (x == 10 && y == height - 10) || (x == width - 10 && y == height - 10)) {
-                    LOGD("Dispersion pixel (%d,%d): edgeDist=%.2f, edgeFactor=%.2f, offset=(%.2f,%.2f), RGB=(%d,%d,%d)",
-                         x, y, distanceToEdge, edgeFactor, baseOffsetX, baseOffsetY, r, g, b);
-                }
+    // 处理每个像素
+    TraceScope sample(TRACE_FILTER_DISPERSION, TRACE_STAGE_SAMPLE);
+    parallel_for(region.top, region.bottom, rowsGrain, [&](int rowBegin, int rowEnd, int) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            const uint8_t* edgeRow = edgeDistance + y * edgeDistanceStride;
+            const uint8_t* normalRow = normalMap ? normalMap + y * normalMapStride : nullptr;
+            const float* radialRow = radialNormals ? radialNormals->xy.data() + static_cast<size_t>(y) * width * 2 : nullptr;
+            int left = region.left;
+            int right = region.right;
+            if (spans) {
+                const RowSpan span = row_span_clip(spans[y], left, right);
+                if (span.empty()) continue;
+                left = span.left;
+                right = span.right;
             }
+            row(params, edgeRow, normalRow, radialRow, result + y * resultStride, left, right, y);
         }
-    }
-
-    debugSamples = false;  // 只打印一次
+    });
 }
 
 // 原位处理版本（简化参数）
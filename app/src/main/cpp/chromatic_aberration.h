@@ -18,9 +18,10 @@
  * - 缓存友好的内存访问模式
  *
  * 线程安全：
- * - 函数本身是线程安全的（无全局状态）
+ * - 函数本身是线程安全的（色散的折射查找表 / 径向法线表缓存由互斥锁保护）
  * - 不要对同一块内存并发调用
  * - 不同图像可以在不同线程中并发处理
+ * - 内部通过共享线程池（thread_pool.h）按行带并行；result 与 source 相同时退化为串行
  *
  * 参考：
  * - 对应 Kotlin 版本：ChromaticAberrationEffect.kt
@@ -34,6 +35,8 @@
 
 #include <cstdint>
 #include <cstddef>
+#include "damage_rect.h"
+#include "row_spans.h"
 
 /**
  * 色差效果处理（RGBA8888 格式）
@@ -80,6 +83,51 @@ void chromatic_aberration_rgba8888(
     bool useBilinear = true
 );
 
+/**
+ * 色差效果处理（只输出 rect 区域）
+ *
+ * 参数与 chromatic_aberration_rgba8888 相同；采样仍可读取整个 source，
+ * rect 以外的 result 像素保持不变。用于增量管线只重算背景变化附近的区域
+ *
+ * @param rect 输出区域（自动裁剪到图像范围，空矩形时直接返回）
+ * @param spans 可选逐行可见区间（height 项，见 row_spans.h）：只输出 rect 与区间的交集；
+ *              nullptr 表示整个 rect
+ */
+void chromatic_aberration_rgba8888_region(
+    const uint8_t* source,
+    const uint8_t* displacement,
+    uint8_t* result,
+    int width,
+    int height,
+    int sourceStride,
+    int displacementStride,
+    int resultStride,
+    float intensity,
+    float scale,
+    float redOffset,
+    float greenOffset,
+    float blueOffset,
+    bool useBilinear,
+    const DamageRect& rect,
+    const RowSpan* spans = nullptr
+);
+
+/**
+ * 色差采样的最大偏移（像素）
+ *
+ * 输出像素只依赖 source 中距离不超过该值的像素：
+ * source 的 rect 区域变化时，result 需要重算的区域为 rect 向外扩展该值
+ *
+ * @param scale 位移缩放系数
+ * @param redOffset / greenOffset / blueOffset 通道偏移（已乘以强度）
+ */
+int chromatic_aberration_reach(
+    float scale,
+    float redOffset,
+    float greenOffset,
+    float blueOffset
+);
+
 /**
  * 色差效果处理（原位版本，简化参数）
  *
@@ -114,6 +162,39 @@ void chromatic_aberration_rgba8888_inplace(
     bool useBilinear = true
 );
 
+/**
+ * 边缘扭曲效果处理（Edge Distortion，对应 EdgeDistortionEffect.kt）
+ *
+ * 按位移贴图整体移动采样位置（四个通道含 Alpha 同位置采样），模拟玻璃边缘折射；
+ * 与色差共用同一套双线性 / 最近邻采样器
+ *
+ * @param source 源图像像素数据（ARGB_8888）
+ * @param displacement 位移贴图像素数据（ARGB_8888，R = X 位移，G = Y 位移，128 为中心）
+ * @param result 结果图像像素数据（ARGB_8888，不能与 source 相同）
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param sourceStride 源图像行跨度（字节数）
+ * @param displacementStride 位移贴图行跨度（字节数）
+ * @param resultStride 结果图像行跨度（字节数）
+ * @param scale 位移缩放系数（位移 = (通道值 - 128) × scale / 255，负值为反向位移）
+ * @param fadeWidth 边缘淡化宽度（像素）：距图像边缘 d < fadeWidth 的像素位移乘以 d / fadeWidth；
+ *                  <= 0 表示不淡化
+ * @param useBilinear 是否使用双线性插值（false 为最近邻）
+ */
+void edge_distortion_rgba8888(
+    const uint8_t* source,
+    const uint8_t* displacement,
+    uint8_t* result,
+    int width,
+    int height,
+    int sourceStride,
+    int displacementStride,
+    int resultStride,
+    float scale,
+    int fadeWidth = 0,
+    bool useBilinear = true
+);
+
 /**
  * 色散效果处理（Chromatic Dispersion Effect）- 基于物理光学原理
  *
@@ -162,6 +243,58 @@ void chromatic_dispersion_rgba8888(
     bool useBilinear = true
 );
 
+/**
+ * 色散效果处理（只输出 rect 区域）
+ *
+ * 参数与 chromatic_dispersion_rgba8888 相同；宽高比与径向法线仍按整帧计算，
+ * rect 以外的 result 像素保持不变
+ *
+ * @param rect 输出区域（自动裁剪到图像范围，空矩形时直接返回）
+ * @param spans 可选逐行可见区间（同 chromatic_aberration_rgba8888_region）
+ */
+void chromatic_dispersion_rgba8888_region(
+    const uint8_t* source,
+    const uint8_t* edgeDistance,
+    const uint8_t* normalMap,
+    uint8_t* result,
+    int width,
+    int height,
+    int sourceStride,
+    int edgeDistanceStride,
+    int normalMapStride,
+    int resultStride,
+    float refThickness,
+    float refFactor,
+    float refDispersion,
+    float dpr,
+    bool useBilinear,
+    const DamageRect& rect,
+    const RowSpan* spans = nullptr
+);
+
+/**
+ * 色散采样的最大偏移（像素，含义同 chromatic_aberration_reach）
+ *
+ * 由折射强度查找表的最大值推出；参数无效（NaN / 超出图像）时返回 max(width, height)
+ */
+int chromatic_dispersion_reach(
+    int width,
+    int height,
+    float refThickness,
+    float refFactor,
+    float refDispersion,
+    float dpr
+);
+
+/**
+ * 释放色散的径向法线缓存表（8 字节/像素，无法线贴图时按图像尺寸生成）
+ *
+ * 在 onTrimMemory / 视图销毁时调用；正在使用该表的调用结束后才真正释放，之后按需重建
+ *
+ * @return 释放的字节数
+ */
+size_t chromatic_dispersion_release_cache();
+
 /**
  * 色散效果处理（原位版本，简化参数）
  *
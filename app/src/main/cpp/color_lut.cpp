@@ -0,0 +1,36 @@
+/**
+ * color_lut.cpp - sRGB ↔ 线性空间查找表生成
+ *
+ * 曲线（IEC 61966-2-1）：
+ *   decode: s <= 0.04045 ? s / 12.92 : ((s + 0.055) / 1.055)^2.4
+ *   encode: l <= 0.0031308 ? l * 12.92 : 1.055 * l^(1/2.4) - 0.055
+ */
+
+#include "color_lut.h"
+#include <cmath>
+
+static double srgb_decode(double s) {
+    return s <= 0.04045 ? s / 12.92 : pow((s + 0.055) / 1.055, 2.4);
+}
+
+static double srgb_encode(double l) {
+    return l <= 0.0031308 ? l * 12.92 : 1.055 * pow(l, 1.0 / 2.4) - 0.055;
+}
+
+static ColorLut build_color_lut() {
+    ColorLut lut;
+    for (int i = 0; i < 256; ++i) {
+        lut.srgbToLinear[i] = static_cast<float>(srgb_decode(i / 255.0));
+        lut.invAlpha[i] = i > 0 ? 255.0f / static_cast<float>(i) : 0.0f;
+    }
+    for (int i = 0; i < ColorLut::kLinearSize; ++i) {
+        const double s = srgb_encode(static_cast<double>(i) / (ColorLut::kLinearSize - 1));
+        lut.linearToSrgb[i] = static_cast<uint8_t>(std::min(255.0, std::floor(s * 255.0 + 0.5)));
+    }
+    return lut;
+}
+
+const ColorLut& color_lut() {
+    static const ColorLut lut = build_color_lut();
+    return lut;
+}
@@ -0,0 +1,125 @@
+/**
+ * color_lut.h - sRGB ↔ 线性空间查表转换（精确曲线）
+ *
+ * 背景：
+ * - IIR 高质量模式原先逐通道用多项式近似 pow(x, 2.2) / pow(x, 1/2.2)（误差 < 2%），
+ *   每个像素每一遍都要 去预乘 → 转换 → 再预乘，且去预乘需要一次除法
+ *
+ * 设计：
+ * - 三张表，首次使用时按精确 sRGB 分段曲线生成（共约 6 KB，常驻 L1）：
+ *   - srgbToLinear[256]：sRGB 字节 → 线性 [0, 1]
+ *   - linearToSrgb[4096]：12 位量化的线性值 → sRGB 字节
+ *   - invAlpha[256]：255 / a（a = 0 时为 0），用乘法代替去预乘的除法
+ * - 浮点中间值为“预乘的线性值”（与 Alpha 一起滤波，透明像素不会把黑色渗进邻域）
+ * - 写回时先量化 Alpha，再用量化后的 Alpha 去预乘 / 再预乘，结果与写入的 Alpha 严格一致
+ * - 12 位线性量化：暗部每级 < 1 个 sRGB 字节级，全部 256 个 sRGB 值往返无损
+ *
+ * NEON：
+ * - NEON 没有通用 gather 指令，*_neon 版本逐 lane 查表，其余算术保持向量化
+ *
+ * 线程安全：表只读，color_lut() 可从任意线程调用
+ */
+
+#ifndef COLOR_LUT_H
+#define COLOR_LUT_H
+
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define COLOR_LUT_NEON 1
+#else
+#define COLOR_LUT_NEON 0
+#endif
+
+/**
+ * 查找表
+ */
+struct ColorLut {
+    static constexpr int kLinearBits = 12;
+    static constexpr int kLinearSize = 1 << kLinearBits;
+
+    float srgbToLinear[256];
+    uint8_t linearToSrgb[kLinearSize];
+    float invAlpha[256];
+};
+
+/**
+ * 获取查找表（首次调用时生成）
+ */
+const ColorLut& color_lut();
+
+/**
+ * 预乘 sRGB 字节 → 预乘线性值 [0, 1]
+ *
+ * @param c 预乘颜色分量
+ * @param a Alpha
+ */
+static inline float color_lut_to_linear(const ColorLut& lut, int c, int a) {
+    const int s = std::min(255, static_cast<int>(c * lut.invAlpha[a] + 0.5f));
+    return lut.srgbToLinear[s] * (a * (1.0f / 255.0f));
+}
+
+/**
+ * 预乘线性值 → 预乘 sRGB 字节
+ *
+ * @param linear 预乘线性值
+ * @param a 已量化的输出 Alpha（0-255）
+ */
+static inline uint8_t color_lut_to_srgb8(const ColorLut& lut, float linear, int a) {
+    const float u = std::max(0.0f, std::min(1.0f, linear * lut.invAlpha[a]));
+    const int s = lut.linearToSrgb[static_cast<int>(u * (ColorLut::kLinearSize - 1) + 0.5f)];
+    const int x = s * a + 128;                     // round(s * a / 255)
+    return static_cast<uint8_t>((x + (x >> 8)) >> 8);
+}
+
+#if COLOR_LUT_NEON
+/**
+ * 4 个预乘 sRGB 分量 → 预乘线性值
+ *
+ * @param c 预乘颜色分量（0-255）
+ * @param a Alpha（0-255）
+ */
+static inline float32x4_t color_lut_to_linear4_neon(const ColorLut& lut, uint32x4_t c, uint32x4_t a) {
+    uint32_t ai[4];
+    vst1q_u32(ai, a);
+    const float inv[4] = {lut.invAlpha[ai[0]], lut.invAlpha[ai[1]], lut.invAlpha[ai[2]], lut.invAlpha[ai[3]]};
+
+    // s = min(255, round(c * 255 / a))
+    float32x4_t s = vmlaq_f32(vdupq_n_f32(0.5f), vcvtq_f32_u32(c), vld1q_f32(inv));
+    uint32_t si[4];
+    vst1q_u32(si, vminq_u32(vcvtq_u32_f32(s), vdupq_n_u32(255)));
+
+    const float lin[4] = {lut.srgbToLinear[si[0]], lut.srgbToLinear[si[1]],
+                          lut.srgbToLinear[si[2]], lut.srgbToLinear[si[3]]};
+    return vmulq_f32(vld1q_f32(lin), vmulq_n_f32(vcvtq_f32_u32(a), 1.0f / 255.0f));
+}
+
+/**
+ * 4 个预乘线性值 → 预乘 sRGB 分量（0-255）
+ *
+ * @param linear 预乘线性值
+ * @param a 已量化的输出 Alpha（0-255）
+ */
+static inline uint32x4_t color_lut_to_srgb4_neon(const ColorLut& lut, float32x4_t linear, uint32x4_t a) {
+    uint32_t ai[4];
+    vst1q_u32(ai, a);
+    const float inv[4] = {lut.invAlpha[ai[0]], lut.invAlpha[ai[1]], lut.invAlpha[ai[2]], lut.invAlpha[ai[3]]};
+
+    // 去预乘 → 钳位 → 12 位量化
+    float32x4_t u = vmulq_f32(linear, vld1q_f32(inv));
+    u = vmaxq_f32(vminq_f32(u, vdupq_n_f32(1.0f)), vdupq_n_f32(0.0f));
+    uint32_t idx[4];
+    vst1q_u32(idx, vcvtq_u32_f32(vmlaq_n_f32(vdupq_n_f32(0.5f), u, ColorLut::kLinearSize - 1)));
+
+    const uint32_t si[4] = {lut.linearToSrgb[idx[0]], lut.linearToSrgb[idx[1]],
+                            lut.linearToSrgb[idx[2]], lut.linearToSrgb[idx[3]]};
+
+    // 再预乘：round(s * a / 255)
+    uint32x4_t x = vaddq_u32(vmulq_u32(vld1q_u32(si), a), vdupq_n_u32(128));
+    return vshrq_n_u32(vaddq_u32(x, vshrq_n_u32(x, 8)), 8);
+}
+#endif // COLOR_LUT_NEON
+
+#endif // COLOR_LUT_H
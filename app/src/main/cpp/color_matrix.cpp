@@ -0,0 +1,109 @@
+/**
+ * color_matrix.cpp - 4×5 颜色矩阵实现
+ *
+ * 实现细节：
+ * - 8 位路径：NEON 每次 8 个像素（color_matrix_apply8_neon），尾部借助栈上缓冲补齐；
+ *   无 NEON 时逐像素标量处理
+ * - 量化统一为 round(v × 255)，与各滤波器的打包方式一致
+ */
+
+#include "color_matrix.h"
+#include "thread_pool.h"
+#include <cstring>
+#include <android/log.h>
+
+#define LOG_TAG "ColorMatrix"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+ColorMatrix color_matrix_from_android(const float* values) {
+    ColorMatrix cm;
+    for (int i = 0; i < 20; ++i) {
+        // 偏移列（第 5 列）从 0-255 换算到 [0, 1]
+        cm.m[i] = (i % 5 == 4) ? values[i] * (1.0f / 255.0f) : values[i];
+    }
+
+    const float* m = cm.m;
+    cm.premultipliedSafe =
+        m[15] == 0.0f && m[16] == 0.0f && m[17] == 0.0f && m[18] == 1.0f && m[19] == 0.0f &&
+        m[3] == 0.0f && m[8] == 0.0f && m[13] == 0.0f &&
+        m[4] == 0.0f && m[9] == 0.0f && m[14] == 0.0f;
+    return cm;
+}
+
+ColorMatrix color_matrix_saturation(float saturation) {
+    // ColorMatrix.setSaturation 的亮度权重
+    const float invSat = 1.0f - saturation;
+    const float kR = 0.213f * invSat;
+    const float kG = 0.715f * invSat;
+    const float kB = 0.072f * invSat;
+    const float values[20] = {
+        kR + saturation, kG, kB, 0.0f, 0.0f,
+        kR, kG + saturation, kB, 0.0f, 0.0f,
+        kR, kG, kB + saturation, 0.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+    };
+    return color_matrix_from_android(values);
+}
+
+#if !COLOR_MATRIX_NEON
+static inline uint8_t quantize(float v) {
+    return static_cast<uint8_t>(std::max(0.0f, std::min(1.0f, v)) * 255.0f + 0.5f);
+}
+
+static void apply_scalar(const ColorMatrix& cm, const uint8_t* src, uint8_t* dst, int n) {
+    const float kInv255 = 1.0f / 255.0f;
+    for (int i = 0; i < n; ++i) {
+        const uint8_t* s = src + i * 4;
+        float r = s[BitmapLayout::R] * kInv255;
+        float g = s[BitmapLayout::G] * kInv255;
+        float b = s[BitmapLayout::B] * kInv255;
+        float a = s[BitmapLayout::A] * kInv255;
+        color_matrix_apply(cm, r, g, b, a);
+
+        uint8_t* d = dst + i * 4;
+        d[BitmapLayout::R] = quantize(r);
+        d[BitmapLayout::G] = quantize(g);
+        d[BitmapLayout::B] = quantize(b);
+        d[BitmapLayout::A] = quantize(a);
+    }
+}
+#else
+static inline void apply8_neon(const ColorMatrix& cm, const uint8_t* src, uint8_t* dst) {
+    uint8x8x4_t px = vld4_u8(src);
+    color_matrix_apply8_neon(cm, px);
+    vst4_u8(dst, px);
+}
+#endif
+
+void color_matrix_rgba8888_row(const ColorMatrix& cm, const uint8_t* src, uint8_t* dst, int n) {
+#if COLOR_MATRIX_NEON
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        apply8_neon(cm, src + i * 4, dst + i * 4);
+    }
+    if (i < n) {
+        const int rem = n - i;
+        uint8_t tmp[32] = {0};
+        memcpy(tmp, src + i * 4, rem * 4);
+        apply8_neon(cm, tmp, tmp);
+        memcpy(dst + i * 4, tmp, rem * 4);
+    }
+#else
+    apply_scalar(cm, src, dst, n);
+#endif
+}
+
+void color_matrix_rgba8888_inplace(uint8_t* base, int w, int h, int stride, const ColorMatrix& cm) {
+    if (!base || w <= 0 || h <= 0 || stride < w * 4) {
+        LOGE("Invalid parameters: base=%p, w=%d, h=%d, stride=%d", base, w, h, stride);
+        return;
+    }
+
+    parallel_for(0, h, parallel_rows_grain(w), [&](int rowBegin, int rowEnd, int) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            uint8_t* row = base + y * stride;
+            color_matrix_rgba8888_row(cm, row, row, w);
+        }
+    });
+}
@@ -0,0 +1,178 @@
+/**
+ * color_matrix.h - 4×5 颜色矩阵（融合进滤波器的最终打包阶段）
+ *
+ * 背景：
+ * - 饱和度原先在模糊之后单独执行一遍 Canvas + ColorMatrix：
+ *   多一次整帧读写，外加一张整帧 Bitmap 分配
+ * - 这里让滤波器在浮点结果钳位 / 打包之前直接套用矩阵，不再单独走一遍
+ *
+ * 语义：
+ * - 与 android.graphics.ColorMatrix 相同：行主序 4×5，行 / 列依次为 R, G, B, A（+ 偏移），
+ *   作用于未预乘的颜色，偏移列以 0-255 为单位
+ * - 像素为预乘格式：内部先去预乘，套用矩阵后按新 Alpha 重新预乘
+ * - 快速路径：Alpha 行为 [0 0 0 1 0]、颜色行的 Alpha 列与偏移均为 0 时（饱和度、色相旋转等），
+ *   矩阵对预乘颜色直接作用与先去预乘再作用等价，省去除法；结果钳位到 [0, alpha]
+ *
+ * 通道顺序：矩阵按语义通道（R, G, B, A）给出，像素内存顺序由 BitmapLayout 决定
+ */
+
+#ifndef COLOR_MATRIX_H
+#define COLOR_MATRIX_H
+
+#include <cstdint>
+#include <algorithm>
+#include "pixel_layout.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define COLOR_MATRIX_NEON 1
+#else
+#define COLOR_MATRIX_NEON 0
+#endif
+
+/**
+ * 预处理后的颜色矩阵（偏移已换算到 [0, 1]）
+ */
+struct ColorMatrix {
+    float m[20];
+    bool premultipliedSafe;   // 可直接作用于预乘颜色（见文件头的快速路径）
+};
+
+/**
+ * 由 android.graphics.ColorMatrix 数组构造
+ *
+ * @param values 20 个元素（行主序）
+ * @return 构造结果
+ */
+ColorMatrix color_matrix_from_android(const float* values);
+
+/**
+ * 饱和度矩阵（与 android.graphics.ColorMatrix.setSaturation 相同，可走预乘快速路径）
+ *
+ * @param saturation 饱和度系数（1.0 = 原始）
+ * @return 构造结果
+ */
+ColorMatrix color_matrix_saturation(float saturation);
+
+/**
+ * 对一个预乘像素（归一化到 [0, 1]）套用矩阵
+ *
+ * @param r, g, b, a 语义通道，原位更新
+ */
+static inline void color_matrix_apply(const ColorMatrix& cm, float& r, float& g, float& b, float& a) {
+    const float* m = cm.m;
+    if (cm.premultipliedSafe) {
+        const float r2 = m[0] * r + m[1] * g + m[2] * b;
+        const float g2 = m[5] * r + m[6] * g + m[7] * b;
+        const float b2 = m[10] * r + m[11] * g + m[12] * b;
+        a = std::max(0.0f, std::min(1.0f, a));
+        r = std::max(0.0f, std::min(a, r2));
+        g = std::max(0.0f, std::min(a, g2));
+        b = std::max(0.0f, std::min(a, b2));
+        return;
+    }
+
+    const float inv = a > 0.0f ? 1.0f / a : 0.0f;
+    const float ur = r * inv, ug = g * inv, ub = b * inv;
+    const float r2 = m[0] * ur + m[1] * ug + m[2] * ub + m[3] * a + m[4];
+    const float g2 = m[5] * ur + m[6] * ug + m[7] * ub + m[8] * a + m[9];
+    const float b2 = m[10] * ur + m[11] * ug + m[12] * ub + m[13] * a + m[14];
+    const float a2 = std::max(0.0f, std::min(1.0f, m[15] * ur + m[16] * ug + m[17] * ub + m[18] * a + m[19]));
+    r = std::max(0.0f, std::min(1.0f, r2)) * a2;
+    g = std::max(0.0f, std::min(1.0f, g2)) * a2;
+    b = std::max(0.0f, std::min(1.0f, b2)) * a2;
+    a = a2;
+}
+
+#if COLOR_MATRIX_NEON
+/**
+ * 4 个预乘像素（按通道拆开，归一化到 [0, 1]）套用矩阵
+ *
+ * @param px 按内存通道顺序排列（px.val[BitmapLayout::R] 为 4 个像素的 R），原位更新
+ */
+static inline void color_matrix_apply4_neon(const ColorMatrix& cm, float32x4x4_t& px) {
+    const float* m = cm.m;
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    float32x4_t r = px.val[BitmapLayout::R];
+    float32x4_t g = px.val[BitmapLayout::G];
+    float32x4_t b = px.val[BitmapLayout::B];
+    float32x4_t a = px.val[BitmapLayout::A];
+
+    if (cm.premultipliedSafe) {
+        a = vmaxq_f32(vminq_f32(a, one), zero);
+        const float32x4_t r2 = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(r, m[0]), g, m[1]), b, m[2]);
+        const float32x4_t g2 = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(r, m[5]), g, m[6]), b, m[7]);
+        const float32x4_t b2 = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(r, m[10]), g, m[11]), b, m[12]);
+        px.val[BitmapLayout::R] = vmaxq_f32(vminq_f32(r2, a), zero);
+        px.val[BitmapLayout::G] = vmaxq_f32(vminq_f32(g2, a), zero);
+        px.val[BitmapLayout::B] = vmaxq_f32(vminq_f32(b2, a), zero);
+        px.val[BitmapLayout::A] = a;
+        return;
+    }
+
+    // 1 / a：倒数估计 + 两次牛顿迭代（a = 0 时取 0）
+    float32x4_t inv = vrecpeq_f32(a);
+    inv = vmulq_f32(vrecpsq_f32(a, inv), inv);
+    inv = vmulq_f32(vrecpsq_f32(a, inv), inv);
+    inv = vbslq_f32(vcgtq_f32(a, zero), inv, zero);
+    const float32x4_t ur = vmulq_f32(r, inv);
+    const float32x4_t ug = vmulq_f32(g, inv);
+    const float32x4_t ub = vmulq_f32(b, inv);
+
+    auto row = [&](int i) {
+        float32x4_t v = vmlaq_n_f32(vdupq_n_f32(m[i + 4]), ur, m[i]);
+        v = vmlaq_n_f32(v, ug, m[i + 1]);
+        v = vmlaq_n_f32(v, ub, m[i + 2]);
+        v = vmlaq_n_f32(v, a, m[i + 3]);
+        return vmaxq_f32(vminq_f32(v, one), zero);
+    };
+    const float32x4_t a2 = row(15);
+    px.val[BitmapLayout::R] = vmulq_f32(row(0), a2);
+    px.val[BitmapLayout::G] = vmulq_f32(row(5), a2);
+    px.val[BitmapLayout::B] = vmulq_f32(row(10), a2);
+    px.val[BitmapLayout::A] = a2;
+}
+
+/**
+ * 8 个 RGBA8888 像素（vld4_u8 解交错后的寄存器）套用矩阵
+ */
+static inline void color_matrix_apply8_neon(const ColorMatrix& cm, uint8x8x4_t& px) {
+    float32x4x4_t lo, hi;
+    for (int k = 0; k < 4; ++k) {
+        const uint16x8_t w16 = vmovl_u8(px.val[k]);
+        lo.val[k] = vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(w16))), 1.0f / 255.0f);
+        hi.val[k] = vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(w16))), 1.0f / 255.0f);
+    }
+
+    color_matrix_apply4_neon(cm, lo);
+    color_matrix_apply4_neon(cm, hi);
+
+    // 矩阵输出已钳位到 [0, 1]，round(v × 255)
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    for (int k = 0; k < 4; ++k) {
+        const uint16x4_t qLo = vmovn_u32(vcvtq_u32_f32(vmlaq_n_f32(half, lo.val[k], 255.0f)));
+        const uint16x4_t qHi = vmovn_u32(vcvtq_u32_f32(vmlaq_n_f32(half, hi.val[k], 255.0f)));
+        px.val[k] = vmovn_u16(vcombine_u16(qLo, qHi));
+    }
+}
+#endif // COLOR_MATRIX_NEON
+
+/**
+ * 对连续 n 个 RGBA8888 像素套用矩阵（src 可与 dst 相同）
+ */
+void color_matrix_rgba8888_row(const ColorMatrix& cm, const uint8_t* src, uint8_t* dst, int n);
+
+/**
+ * 对整幅图像原位套用矩阵（按行带并行）
+ *
+ * 用于无法融合的路径（如降采样模糊的小图、标量 IIR 回退）
+ *
+ * @param base 像素数据（RGBA8888，预乘 Alpha）
+ * @param w 图像宽度
+ * @param h 图像高度
+ * @param stride 行跨度（字节数）
+ */
+void color_matrix_rgba8888_inplace(uint8_t* base, int w, int h, int stride, const ColorMatrix& cm);
+
+#endif // COLOR_MATRIX_H
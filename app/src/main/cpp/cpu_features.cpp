@@ -0,0 +1,113 @@
+/**
+ * cpu_features.cpp - 运行时 CPU 特性检测实现
+ *
+ * 实现细节：
+ * - 检测结果保存在函数内静态变量（C++11 起初始化线程安全）
+ * - 禁用掩码为原子变量，分派热路径只多一次 relaxed 读取
+ * - 旧版内核头文件可能缺少部分 HWCAP 定义，这里按内核 uapi 的值补齐
+ */
+
+#include "cpu_features.h"
+#include <atomic>
+#include <cstdio>
+#include <android/log.h>
+
+#if (defined(__aarch64__) || defined(__arm__)) && defined(__linux__)
+#include <sys/auxv.h>
+#define CPU_FEATURES_AUXV 1
+#else
+#define CPU_FEATURES_AUXV 0
+#endif
+
+#if defined(__i386__) || defined(__x86_64__)
+#define CPU_FEATURES_X86 1
+#else
+#define CPU_FEATURES_X86 0
+#endif
+
+#define LOG_TAG "CpuFeatures"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// arch/arm64/include/uapi/asm/hwcap.h
+#if defined(__aarch64__)
+#ifndef HWCAP_ASIMD
+#define HWCAP_ASIMD (1 << 1)
+#endif
+#ifndef HWCAP_ASIMDHP
+#define HWCAP_ASIMDHP (1 << 10)
+#endif
+#ifndef HWCAP_ASIMDDP
+#define HWCAP_ASIMDDP (1 << 20)
+#endif
+#endif
+
+// arch/arm/include/uapi/asm/hwcap.h
+#if defined(__arm__) && !defined(HWCAP_NEON)
+#define HWCAP_NEON (1 << 12)
+#endif
+
+static std::atomic<uint32_t> g_disabled(0);
+
+static uint32_t detect_features() {
+    uint32_t features = 0;
+
+#if CPU_FEATURES_AUXV && defined(__aarch64__)
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    if (hwcap & HWCAP_ASIMD) features |= CPU_FEATURE_NEON;
+    if (hwcap & HWCAP_ASIMDHP) features |= CPU_FEATURE_FP16;
+    if (hwcap & HWCAP_ASIMDDP) features |= CPU_FEATURE_DOTPROD;
+#elif CPU_FEATURES_AUXV && defined(__arm__)
+    if (getauxval(AT_HWCAP) & HWCAP_NEON) features |= CPU_FEATURE_NEON;
+#elif CPU_FEATURES_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.1")) features |= CPU_FEATURE_SSE41;
+    // __builtin_cpu_supports("avx2") 已包含 OSXSAVE / XCR0 检查
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) features |= CPU_FEATURE_AVX2;
+#endif
+
+    char desc[64];
+    cpu_features_describe(features, desc, sizeof(desc));
+    LOGD("Detected CPU features: %s", desc);
+    return features;
+}
+
+uint32_t cpu_features_detected() {
+    static const uint32_t detected = detect_features();
+    return detected;
+}
+
+uint32_t cpu_features() {
+    return cpu_features_detected() & ~g_disabled.load(std::memory_order_relaxed);
+}
+
+void cpu_features_set_disabled(uint32_t mask) {
+    g_disabled.store(mask, std::memory_order_relaxed);
+}
+
+void cpu_features_describe(uint32_t features, char* out, size_t size) {
+    if (!out || size == 0) return;
+
+    static const struct {
+        uint32_t bit;
+        const char* name;
+    } kNames[] = {
+        { CPU_FEATURE_NEON, "neon" },
+        { CPU_FEATURE_FP16, "fp16" },
+        { CPU_FEATURE_DOTPROD, "dotprod" },
+        { CPU_FEATURE_SSE41, "sse4.1" },
+        { CPU_FEATURE_AVX2, "avx2" },
+    };
+
+    size_t len = 0;
+    out[0] = '\0';
+    for (const auto& entry : kNames) {
+        if (!(features & entry.bit) || len >= size) continue;
+        const int n = snprintf(out + len, size - len, len == 0 ? "%s" : " %s", entry.name);
+        if (n < 0) break;
+        len += static_cast<size_t>(n);
+    }
+    if (len == 0) {
+        snprintf(out, size, "scalar");
+    }
+}
@@ -0,0 +1,76 @@
+/**
+ * cpu_features.h - 运行时 CPU 特性检测（SIMD 后端选择）
+ *
+ * 背景：
+ * - 原先 NEON 只在编译期判断（has_neon_support() 直接返回宏），x86 / x86_64
+ *   （模拟器、ChromeOS、CI 性能机）一律走标量路径
+ * - 可选扩展（ARMv8.2 FP16 / 点积、x86 AVX2）只能在运行时判断：同一份库要在
+ *   支持与不支持的设备上都能运行
+ *
+ * 检测方式：
+ * - ARM：getauxval(AT_HWCAP)（armeabi-v7a 的 HWCAP_NEON；arm64 的 ASIMD / ASIMDHP / ASIMDDP）
+ * - x86：__builtin_cpu_supports（CPUID；AVX2 同时要求 FMA 与操作系统保存 YMM 状态）
+ * - 结果在首次调用时检测一次，之后只读
+ *
+ * 后端优先级（各滤波器按此选择）：
+ * - ARM：FP16（非线性 IIR）> NEON > 标量
+ * - x86：AVX2 > SSE4.1 > 标量
+ *
+ * 禁用掩码：
+ * - cpu_features_set_disabled() 可屏蔽部分特性（测试 / 基准对比各后端），
+ *   屏蔽后对应的分派立即改走下一级后端；被屏蔽的特性不会因此被重新启用
+ */
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * CPU 特性位
+ */
+enum CpuFeature {
+    CPU_FEATURE_NEON    = 1u << 0,   // ARM Advanced SIMD
+    CPU_FEATURE_FP16    = 1u << 1,   // ARMv8.2-A FP16 向量算术（ASIMDHP）
+    CPU_FEATURE_DOTPROD = 1u << 2,   // ARMv8.2-A 点积（ASIMDDP）
+    CPU_FEATURE_SSE41   = 1u << 3,   // x86 SSE4.1
+    CPU_FEATURE_AVX2    = 1u << 4,   // x86 AVX2 + FMA
+};
+
+/**
+ * 当前可用的特性（检测结果去掉禁用掩码）
+ *
+ * @return CpuFeature 位的组合
+ */
+uint32_t cpu_features();
+
+/**
+ * 硬件检测结果（不受禁用掩码影响）
+ */
+uint32_t cpu_features_detected();
+
+/**
+ * 是否可用（全部位都可用时返回 true）
+ */
+static inline bool cpu_has_features(uint32_t mask) {
+    return (cpu_features() & mask) == mask;
+}
+
+/**
+ * 设置禁用掩码（0 表示全部启用）
+ *
+ * 线程安全；正在执行的滤波不受影响，下一次分派生效
+ */
+void cpu_features_set_disabled(uint32_t mask);
+
+/**
+ * 特性列表的可读描述（如 "neon fp16 dotprod"，无特性时为 "scalar"）
+ *
+ * @param features CpuFeature 位的组合
+ * @param out 输出缓冲（总以 '\0' 结尾）
+ * @param size 缓冲大小
+ */
+void cpu_features_describe(uint32_t features, char* out, size_t size);
+
+#endif // CPU_FEATURES_H
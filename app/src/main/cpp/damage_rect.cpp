@@ -0,0 +1,105 @@
+/**
+ * damage_rect.cpp - 脏矩形检测实现
+ *
+ * 实现细节：
+ * - 上下边界：逐行 memcmp，遇到第一个差异行即停止，静止背景只需一次整帧顺序读取
+ * - 左右边界：每个线程维护自己的左 / 右边界，每行只比较边界以外的像素，
+ *   差异越宽扫描越少；最后合并各线程结果
+ */
+
+#include "damage_rect.h"
+#include "thread_pool.h"
+#include <cstring>
+#include <vector>
+#include <android/log.h>
+
+#define LOG_TAG "DamageRect"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+/**
+ * 读取一个像素（按 32 位整体比较；memcpy 避免非对齐访问）
+ */
+static inline uint32_t load_pixel(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+bool compute_damage_rect(
+    const uint8_t* previous,
+    int previousStride,
+    const uint8_t* current,
+    int currentStride,
+    int width,
+    int height,
+    DamageRect* out
+) {
+    if (!out) {
+        LOGE("Invalid parameters: null output");
+        return false;
+    }
+    *out = DamageRect();
+
+    if (!previous || !current || width <= 0 || height <= 0 ||
+        previousStride < width * 4 || currentStride < width * 4) {
+        LOGE("Invalid parameters: %dx%d, stride=%d/%d", width, height, previousStride, currentStride);
+        return false;
+    }
+
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    auto rowDiffers = [&](int y) {
+        return memcmp(previous + static_cast<size_t>(y) * previousStride,
+                      current + static_cast<size_t>(y) * currentStride, rowBytes) != 0;
+    };
+
+    // 1. 上下边界
+    int top = 0;
+    while (top < height && !rowDiffers(top)) ++top;
+    if (top == height) return false;
+
+    int bottom = height;
+    while (bottom > top + 1 && !rowDiffers(bottom - 1)) --bottom;
+
+    // 2. 左右边界（每个线程独立收缩，最后合并）
+    const int threads = thread_pool_concurrency();
+    std::vector<int> lefts(threads, width);
+    std::vector<int> rights(threads, 0);
+
+    parallel_for(top, bottom, parallel_rows_grain(width), [&](int rowBegin, int rowEnd, int slot) {
+        int left = lefts[slot];
+        int right = rights[slot];
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            const uint8_t* prevRow = previous + static_cast<size_t>(y) * previousStride;
+            const uint8_t* curRow = current + static_cast<size_t>(y) * currentStride;
+
+            for (int x = 0; x < left; ++x) {
+                if (load_pixel(prevRow + x * 4) != load_pixel(curRow + x * 4)) {
+                    left = x;
+                    break;
+                }
+            }
+            for (int x = width - 1; x >= right; --x) {
+                if (load_pixel(prevRow + x * 4) != load_pixel(curRow + x * 4)) {
+                    right = x + 1;
+                    break;
+                }
+            }
+        }
+        lefts[slot] = left;
+        rights[slot] = right;
+    });
+
+    DamageRect damage;
+    damage.left = width;
+    damage.top = top;
+    damage.right = 0;
+    damage.bottom = bottom;
+    for (int i = 0; i < threads; ++i) {
+        damage.left = std::min(damage.left, lefts[i]);
+        damage.right = std::max(damage.right, rights[i]);
+    }
+
+    *out = damage;
+    return !damage.empty();
+}
@@ -0,0 +1,116 @@
+/**
+ * damage_rect.h - 脏矩形（两帧之间变化区域）检测与矩形运算
+ *
+ * 背景：
+ * - 玻璃区域的背景大多数帧只有局部变化（光标、小动画、列表滚入的一行），
+ *   整帧重新模糊浪费了绝大部分计算
+ * - 这里找出前后两帧的最小包围矩形，供增量管线（render_glass_pipeline_region）
+ *   只重算受影响的区域
+ *
+ * 约定：
+ * - 矩形为半开区间 [left, right) × [top, bottom)，像素坐标
+ * - right <= left 或 bottom <= top 视为空矩形
+ */
+
+#ifndef DAMAGE_RECT_H
+#define DAMAGE_RECT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/**
+ * 像素矩形（半开区间）
+ */
+struct DamageRect {
+    int left = 0;
+    int top = 0;
+    int right = 0;
+    int bottom = 0;
+
+    bool empty() const { return right <= left || bottom <= top; }
+    int width() const { return empty() ? 0 : right - left; }
+    int height() const { return empty() ? 0 : bottom - top; }
+    int64_t area() const { return static_cast<int64_t>(width()) * height(); }
+
+    bool operator==(const DamageRect& o) const {
+        return left == o.left && top == o.top && right == o.right && bottom == o.bottom;
+    }
+};
+
+/**
+ * 整帧矩形
+ */
+inline DamageRect damage_rect_full(int width, int height) {
+    DamageRect r;
+    r.right = width;
+    r.bottom = height;
+    return r;
+}
+
+/**
+ * 向四周扩展 margin 像素并裁剪到 [0, width) × [0, height)（空矩形保持为空）
+ */
+inline DamageRect damage_rect_expand(const DamageRect& r, int margin, int width, int height) {
+    if (r.empty()) return DamageRect();
+    DamageRect e;
+    e.left = std::max(0, r.left - margin);
+    e.top = std::max(0, r.top - margin);
+    e.right = std::min(width, r.right + margin);
+    e.bottom = std::min(height, r.bottom + margin);
+    return e;
+}
+
+/**
+ * 两个矩形的包围矩形（空矩形不参与）
+ */
+inline DamageRect damage_rect_union(const DamageRect& a, const DamageRect& b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+    DamageRect u;
+    u.left = std::min(a.left, b.left);
+    u.top = std::min(a.top, b.top);
+    u.right = std::max(a.right, b.right);
+    u.bottom = std::max(a.bottom, b.bottom);
+    return u;
+}
+
+/**
+ * 两个矩形的交集（不相交时为空矩形）
+ */
+inline DamageRect damage_rect_intersect(const DamageRect& a, const DamageRect& b) {
+    DamageRect i;
+    i.left = std::max(a.left, b.left);
+    i.top = std::max(a.top, b.top);
+    i.right = std::min(a.right, b.right);
+    i.bottom = std::min(a.bottom, b.bottom);
+    return i.empty() ? DamageRect() : i;
+}
+
+/**
+ * 比较两帧，计算变化区域的最小包围矩形
+ *
+ * 算法：
+ * 1. 从上、下两端逐行 memcmp，找到第一 / 最后一个有差异的行（未变化的行只读一次）
+ * 2. 在差异行范围内按行带并行，每行只扫描当前左 / 右边界以外的像素
+ *
+ * @param previous 上一帧像素（RGBA8888）
+ * @param previousStride 上一帧行跨度（字节数）
+ * @param current 当前帧像素（RGBA8888，与 previous 尺寸相同）
+ * @param currentStride 当前帧行跨度（字节数）
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param out 输出变化区域（两帧相同时为空矩形）
+ * @return true 如果两帧有差异
+ */
+bool compute_damage_rect(
+    const uint8_t* previous,
+    int previousStride,
+    const uint8_t* current,
+    int currentStride,
+    int width,
+    int height,
+    DamageRect* out
+);
+
+#endif // DAMAGE_RECT_H
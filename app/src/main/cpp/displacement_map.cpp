@@ -0,0 +1,374 @@
+/**
+ * displacement_map.cpp - 位移贴图生成实现
+ *
+ * 实现细节：
+ * - 逐行计算：先把一行的原始位移写入线程本地行缓冲（dx、dy 各一行）
+ * - 第一遍只求 |dx|、|dy| 最大值（每个线程各自累计，最后归并）
+ * - 第二遍重新计算同一行并归一化写出，免去整帧 float 中间缓冲
+ * - NEON 版本每次 4 个像素，行尾不足 4 个时走标量路径
+ */
+
+#include "displacement_map.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+#include <android/log.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define DISPLACEMENT_NEON 1
+#else
+#define DISPLACEMENT_NEON 0
+#endif
+
+#define LOG_TAG "DisplacementMap"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+/**
+ * 各模式的圆角矩形与过渡参数（来自 DisplacementMapGenerator.kt）
+ *
+ * 位移强度 = smoothStep(ramp, 0, SDF - edgeOffset)
+ */
+struct DisplacementShape {
+    int mode;
+    float halfWidth;
+    float halfHeight;
+    float radius;
+    float edgeOffset;
+    float ramp;
+};
+
+static DisplacementShape shape_for_mode(int mode) {
+    switch (mode) {
+        case DISPLACEMENT_MODE_POLAR:
+            return {mode, 0.35f, 0.25f, 0.5f, 0.1f, 0.7f};
+        case DISPLACEMENT_MODE_PROMINENT:
+            return {mode, 0.25f, 0.15f, 0.7f, 0.2f, 0.9f};
+        default:
+            return {DISPLACEMENT_MODE_STANDARD, 0.3f, 0.2f, 0.6f, 0.15f, 0.8f};
+    }
+}
+
+// ============================================================================
+// 标量版本
+// ============================================================================
+
+/**
+ * 单个像素的坐标缩放系数 k：uv' = (uv - 0.5) × k + 0.5
+ *
+ * @param ix 以中心为原点的 X 坐标（uv.x - 0.5）
+ * @param iy 以中心为原点的 Y 坐标（uv.y - 0.5）
+ */
+static inline float displacement_factor(const DisplacementShape& s, float ix, float iy) {
+    // 圆角矩形 SDF
+    const float qx = fabsf(ix) - s.halfWidth + s.radius;
+    const float qy = fabsf(iy) - s.halfHeight + s.radius;
+    const float ox = std::max(qx, 0.0f);
+    const float oy = std::max(qy, 0.0f);
+    const float sdf = std::min(std::max(qx, qy), 0.0f) + sqrtf(ox * ox + oy * oy) - s.radius;
+
+    // smoothStep(ramp, 0, t)
+    const float c = std::max(0.0f, std::min(1.0f, (sdf - s.edgeOffset - s.ramp) / -s.ramp));
+    const float displacement = c * c * (3.0f - 2.0f * c);
+
+    switch (s.mode) {
+        case DISPLACEMENT_MODE_POLAR:
+            // 半径收缩：r × (1 - 0.3d)
+            return 1.0f - displacement * 0.3f;
+        case DISPLACEMENT_MODE_PROMINENT:
+            // 向外推：1 + 0.2 × d^1.5
+            return 1.0f + displacement * sqrtf(displacement) * 0.2f;
+        default:
+            // smoothStep(0, 1, d)
+            return displacement * displacement * (3.0f - 2.0f * displacement);
+    }
+}
+
+/**
+ * 计算一行原始位移（像素单位）
+ */
+static void displacement_row_scalar(
+    const DisplacementShape& s,
+    int xBegin,
+    int width,
+    int height,
+    int y,
+    float* dx,
+    float* dy
+) {
+    const float iy = static_cast<float>(y) / height - 0.5f;
+    for (int x = xBegin; x < width; ++x) {
+        const float ix = static_cast<float>(x) / width - 0.5f;
+        const float k = displacement_factor(s, ix, iy);
+        dx[x] = (ix * k + 0.5f) * width - x;
+        dy[x] = (iy * k + 0.5f) * height - y;
+    }
+}
+
+/**
+ * 归一化一行位移并写出像素（R = dx，G = B = dy，A = 255）
+ */
+static void write_row_scalar(
+    const float* dx,
+    const float* dy,
+    uint8_t* outRow,
+    int xBegin,
+    int width,
+    int height,
+    int y,
+    float invMaxScale
+) {
+    const int edgeY = std::min(y, height - y - 1);
+    for (int x = xBegin; x < width; ++x) {
+        // 边缘 2 像素内平滑衰减
+        const int edgeDistance = std::min(edgeY, std::min(x, width - x - 1));
+        const float edgeFactor = std::min(1.0f, edgeDistance / 2.0f);
+
+        const float r = std::max(0.0f, std::min(1.0f, dx[x] * edgeFactor * invMaxScale + 0.5f));
+        const float g = std::max(0.0f, std::min(1.0f, dy[x] * edgeFactor * invMaxScale + 0.5f));
+        const uint8_t rv = static_cast<uint8_t>(r * 255.0f);
+        const uint8_t gv = static_cast<uint8_t>(g * 255.0f);
+
+        uint8_t* px = outRow + x * 4;
+        px[0] = rv;
+        px[1] = gv;
+        px[2] = gv;
+        px[3] = 255;
+    }
+}
+
+// ============================================================================
+// NEON 版本
+// ============================================================================
+
+#if DISPLACEMENT_NEON
+
+static inline float32x4_t sqrt_neon(float32x4_t x) {
+#if defined(__aarch64__)
+    return vsqrtq_f32(x);
+#else
+    // 倒数平方根估计 + 两次 Newton-Raphson；下限钳位避免 0 × inf = NaN
+    float32x4_t safe = vmaxq_f32(x, vdupq_n_f32(1e-20f));
+    float32x4_t r = vrsqrteq_f32(safe);
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(safe, r), r));
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(safe, r), r));
+    return vmulq_f32(x, r);
+#endif
+}
+
+static inline float32x4_t clamp01_neon(float32x4_t v) {
+    return vminq_f32(vmaxq_f32(v, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+}
+
+/**
+ * 4 个像素的坐标缩放系数（与 displacement_factor 相同）
+ */
+static inline float32x4_t displacement_factor_neon(const DisplacementShape& s, float32x4_t ix, float32x4_t iy) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t radius = vdupq_n_f32(s.radius);
+
+    const float32x4_t qx = vaddq_f32(vsubq_f32(vabsq_f32(ix), vdupq_n_f32(s.halfWidth)), radius);
+    const float32x4_t qy = vaddq_f32(vsubq_f32(vabsq_f32(iy), vdupq_n_f32(s.halfHeight)), radius);
+    const float32x4_t ox = vmaxq_f32(qx, zero);
+    const float32x4_t oy = vmaxq_f32(qy, zero);
+    const float32x4_t len = sqrt_neon(vmlaq_f32(vmulq_f32(ox, ox), oy, oy));
+    const float32x4_t sdf = vsubq_f32(vaddq_f32(vminq_f32(vmaxq_f32(qx, qy), zero), len), radius);
+
+    const float32x4_t t = vsubq_f32(sdf, vdupq_n_f32(s.edgeOffset + s.ramp));
+    const float32x4_t c = clamp01_neon(vmulq_n_f32(t, -1.0f / s.ramp));
+    const float32x4_t three = vdupq_n_f32(3.0f);
+    const float32x4_t displacement = vmulq_f32(vmulq_f32(c, c), vmlsq_n_f32(three, c, 2.0f));
+
+    switch (s.mode) {
+        case DISPLACEMENT_MODE_POLAR:
+            return vmlsq_n_f32(vdupq_n_f32(1.0f), displacement, 0.3f);
+        case DISPLACEMENT_MODE_PROMINENT:
+            return vmlaq_n_f32(vdupq_n_f32(1.0f), vmulq_f32(displacement, sqrt_neon(displacement)), 0.2f);
+        default:
+            return vmulq_f32(vmulq_f32(displacement, displacement), vmlsq_n_f32(three, displacement, 2.0f));
+    }
+}
+
+/**
+ * 计算一行原始位移；返回已处理的像素数（4 的倍数）
+ */
+static int displacement_row_neon(
+    const DisplacementShape& s,
+    int width,
+    int height,
+    int y,
+    float* dx,
+    float* dy
+) {
+    const float invWidth = 1.0f / width;
+    const float fw = static_cast<float>(width);
+    const float fh = static_cast<float>(height);
+    const float iyScalar = static_cast<float>(y) / height - 0.5f;
+    const float32x4_t iy = vdupq_n_f32(iyScalar);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const float32x4_t dyBase = vdupq_n_f32(-static_cast<float>(y));
+
+    static const float kLaneOffsets[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    float32x4_t xf = vld1q_f32(kLaneOffsets);
+    const float32x4_t four = vdupq_n_f32(4.0f);
+
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        const float32x4_t ix = vsubq_f32(vmulq_n_f32(xf, invWidth), half);
+        const float32x4_t k = displacement_factor_neon(s, ix, iy);
+
+        // dx = (ix × k + 0.5) × w - x，dy = (iy × k + 0.5) × h - y
+        const float32x4_t ddx = vsubq_f32(vmulq_n_f32(vmlaq_f32(half, ix, k), fw), xf);
+        const float32x4_t ddy = vmlaq_n_f32(dyBase, vmlaq_f32(half, iy, k), fh);
+        vst1q_f32(dx + x, ddx);
+        vst1q_f32(dy + x, ddy);
+
+        xf = vaddq_f32(xf, four);
+    }
+    return x;
+}
+
+/**
+ * 归一化一行位移并写出像素；返回已处理的像素数（4 的倍数）
+ */
+static int write_row_neon(
+    const float* dx,
+    const float* dy,
+    uint8_t* outRow,
+    int width,
+    int height,
+    int y,
+    float invMaxScale
+) {
+    const float32x4_t edgeY = vdupq_n_f32(static_cast<float>(std::min(y, height - y - 1)));
+    const float32x4_t lastX = vdupq_n_f32(static_cast<float>(width - 1));
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const uint32x4_t alpha = vdupq_n_u32(0xFF000000u);
+
+    static const float kLaneOffsets[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    float32x4_t xf = vld1q_f32(kLaneOffsets);
+    const float32x4_t four = vdupq_n_f32(4.0f);
+
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        // 边缘 2 像素内平滑衰减
+        const float32x4_t edgeDistance = vminq_f32(edgeY, vminq_f32(xf, vsubq_f32(lastX, xf)));
+        const float32x4_t edgeFactor = vmulq_n_f32(vminq_f32(vmulq_n_f32(edgeDistance, 0.5f), one), invMaxScale);
+
+        const float32x4_t r = clamp01_neon(vmlaq_f32(half, vld1q_f32(dx + x), edgeFactor));
+        const float32x4_t g = clamp01_neon(vmlaq_f32(half, vld1q_f32(dy + x), edgeFactor));
+        const uint32x4_t rv = vcvtq_u32_f32(vmulq_n_f32(r, 255.0f));
+        const uint32x4_t gv = vcvtq_u32_f32(vmulq_n_f32(g, 255.0f));
+
+        // 小端 RGBA：R | G << 8 | B(=G) << 16 | A << 24
+        uint32x4_t packed = vorrq_u32(rv, alpha);
+        packed = vorrq_u32(packed, vshlq_n_u32(gv, 8));
+        packed = vorrq_u32(packed, vshlq_n_u32(gv, 16));
+        vst1q_u32(reinterpret_cast<uint32_t*>(outRow + x * 4), packed);
+
+        xf = vaddq_f32(xf, four);
+    }
+    return x;
+}
+
+#endif // DISPLACEMENT_NEON
+
+static void displacement_row(const DisplacementShape& s, int width, int height, int y, float* dx, float* dy) {
+#if DISPLACEMENT_NEON
+    const int done = displacement_row_neon(s, width, height, y, dx, dy);
+#else
+    const int done = 0;
+#endif
+    displacement_row_scalar(s, done, width, height, y, dx, dy);
+}
+
+static void write_row(const float* dx, const float* dy, uint8_t* outRow, int width, int height, int y, float invMaxScale) {
+#if DISPLACEMENT_NEON
+    const int done = write_row_neon(dx, dy, outRow, width, height, y, invMaxScale);
+#else
+    const int done = 0;
+#endif
+    write_row_scalar(dx, dy, outRow, done, width, height, y, invMaxScale);
+}
+
+// ============================================================================
+// 入口
+// ============================================================================
+
+void generate_displacement_map_rgba8888(
+    uint8_t* out,
+    int width,
+    int height,
+    int stride,
+    int mode
+) {
+    // 参数校验
+    if (!out) {
+        LOGE("Invalid parameters: null pointer");
+        return;
+    }
+
+    if (width <= 0 || height <= 0) {
+        LOGE("Invalid dimensions: %dx%d", width, height);
+        return;
+    }
+
+    if (stride < width * 4) {
+        LOGE("Invalid stride: %d (min=%d)", stride, width * 4);
+        return;
+    }
+
+    const DisplacementShape shape = shape_for_mode(mode);
+    const size_t rowBytes = sizeof(float) * static_cast<size_t>(width);
+    const int grain = parallel_rows_grain(width);
+    std::atomic<bool> allocationFailed(false);
+
+    // 第一遍：最大位移量（用于归一化）
+    std::vector<float> slotMax(thread_pool_concurrency(), 0.0f);
+    parallel_for(0, height, grain, [&](int rowBegin, int rowEnd, int slot) {
+        ScratchBuffer rows(rowBytes * 2);
+        if (!rows) {
+            allocationFailed = true;
+            return;
+        }
+        float* dx = rows.as<float>();
+        float* dy = dx + width;
+
+        float localMax = slotMax[slot];
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            displacement_row(shape, width, height, y, dx, dy);
+            for (int x = 0; x < width; ++x) {
+                localMax = std::max(localMax, std::max(fabsf(dx[x]), fabsf(dy[x])));
+            }
+        }
+        slotMax[slot] = localMax;
+    });
+
+    if (allocationFailed) {
+        LOGE("Failed to allocate displacement row buffers: width=%d", width);
+        return;
+    }
+
+    float maxScale = 1.0f;
+    for (float m : slotMax) maxScale = std::max(maxScale, m);
+    const float invMaxScale = 1.0f / maxScale;
+
+    // 第二遍：归一化并写出
+    parallel_for(0, height, grain, [&](int rowBegin, int rowEnd, int) {
+        ScratchBuffer rows(rowBytes * 2);
+        if (!rows) return;  // 第一遍已成功分配同尺寸缓冲，此处不应失败
+        float* dx = rows.as<float>();
+        float* dy = dx + width;
+
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            displacement_row(shape, width, height, y, dx, dy);
+            write_row(dx, dy, out + y * stride, width, height, y, invMaxScale);
+        }
+    });
+
+}
@@ -0,0 +1,57 @@
+/**
+ * displacement_map.h - 位移贴图生成（DisplacementMapGenerator 的原生实现）
+ *
+ * 功能：
+ * 为色差效果生成位移贴图，三种模式与 DisplacementMapGenerator.kt 的片段着色器一致：
+ * - STANDARD：标准圆角矩形扭曲
+ * - POLAR：极坐标径向收缩
+ * - PROMINENT：突出边缘（向外推）
+ *
+ * 算法：
+ * 1. 逐像素计算圆角矩形 SDF → smoothStep → 位移系数，得到原始位移 (dx, dy)
+ * 2. 取全图 |dx|、|dy| 最大值作为归一化系数（不小于 1）
+ * 3. 边缘 2 像素内线性衰减，归一化到 [0, 1] 写入
+ * - 两遍都按行带并行；第二遍重新计算位移而不保存整帧中间结果
+ * - 三种模式都化为 uv' = (uv - 0.5) × k + 0.5，k 只取决于 SDF，
+ *   极坐标模式的 r·cos(θ) / r·sin(θ) 即原坐标，无需 atan2 / cos / sin
+ *
+ * 输出格式（与 chromatic_aberration_rgba8888 的位移贴图读取一致）：
+ * - R = dx，G = dy，B = dy，A = 255（0-255，128 附近为 0）
+ *
+ * 性能：
+ * - NEON 每次处理 4 个像素
+ */
+
+#ifndef DISPLACEMENT_MAP_H
+#define DISPLACEMENT_MAP_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * 位移模式（与 DisplacementMode.kt 的 ordinal 一致）
+ */
+enum DisplacementMapMode {
+    DISPLACEMENT_MODE_STANDARD  = 0,
+    DISPLACEMENT_MODE_POLAR     = 1,
+    DISPLACEMENT_MODE_PROMINENT = 2
+};
+
+/**
+ * 生成位移贴图
+ *
+ * @param out 输出像素（RGBA8888）
+ * @param width 贴图宽度
+ * @param height 贴图高度
+ * @param stride 行跨度（字节数）
+ * @param mode 位移模式（DisplacementMapMode）
+ */
+void generate_displacement_map_rgba8888(
+    uint8_t* out,
+    int width,
+    int height,
+    int stride,
+    int mode
+);
+
+#endif // DISPLACEMENT_MAP_H
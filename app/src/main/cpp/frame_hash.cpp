@@ -0,0 +1,198 @@
+/**
+ * frame_hash.cpp - 帧内容哈希实现
+ *
+ * 实现细节：
+ * - 行带内：累加器跨行保留，每行先处理整 32 字节块，再把行尾像素送入前几个 lane
+ * - 行带收尾：lane 0-3 / 4-7 各按 XXH32 方式合并为 32 位，两半交叉混合后
+ *   再做 XXH32 雪崩，拼成 64 位行带哈希
+ * - 整帧：行带哈希按顺序折叠（XXH64 的 round，初值混入尺寸），XXH64 雪崩收尾
+ */
+
+#include "frame_hash.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <android/log.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FRAME_HASH_NEON 1
+#else
+#define FRAME_HASH_NEON 0
+#endif
+
+#define LOG_TAG "FrameHash"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// XXH32 / XXH64 素数
+static const uint32_t kPrime32_1 = 2654435761u;
+static const uint32_t kPrime32_2 = 2246822519u;
+static const uint32_t kPrime32_3 = 3266489917u;
+static const uint32_t kPrime32_4 = 668265263u;
+static const uint32_t kPrime32_5 = 374761393u;
+static const uint64_t kPrime64_1 = 11400714785074694791ull;
+static const uint64_t kPrime64_2 = 14029467366897019727ull;
+static const uint64_t kPrime64_3 = 1609587929392839161ull;
+static const uint64_t kPrime64_4 = 9650029242287828579ull;
+
+/**
+ * 每个行带的行数（固定，保证结果与线程数无关）
+ */
+static const int kBandRows = 32;
+
+static inline uint32_t rotl32(uint32_t x, int r) {
+    return (x << r) | (x >> (32 - r));
+}
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint32_t hash_round(uint32_t acc, uint32_t word) {
+    return rotl32(acc + word * kPrime32_2, 13) * kPrime32_1;
+}
+
+static inline uint32_t load_word(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * XXH32 雪崩
+ */
+static inline uint32_t avalanche32(uint32_t h) {
+    h ^= h >> 15;
+    h *= kPrime32_2;
+    h ^= h >> 13;
+    h *= kPrime32_3;
+    h ^= h >> 16;
+    return h;
+}
+
+/**
+ * 累加器初值（seed 为行带序号，行带交换位置时结果不同）
+ */
+static void init_lanes(uint32_t acc[8], uint32_t seed) {
+    const uint32_t seedHi = seed ^ kPrime32_5;
+    acc[0] = seed + kPrime32_1 + kPrime32_2;
+    acc[1] = seed + kPrime32_2;
+    acc[2] = seed;
+    acc[3] = seed - kPrime32_1;
+    acc[4] = seedHi + kPrime32_1 + kPrime32_2;
+    acc[5] = seedHi + kPrime32_2;
+    acc[6] = seedHi;
+    acc[7] = seedHi - kPrime32_1;
+}
+
+/**
+ * 累加器 → 64 位行带哈希
+ */
+static uint64_t finalize_lanes(const uint32_t acc[8], uint32_t bytes) {
+    const uint32_t lo = rotl32(acc[0], 1) + rotl32(acc[1], 7) + rotl32(acc[2], 12) + rotl32(acc[3], 18);
+    const uint32_t hi = rotl32(acc[4], 1) + rotl32(acc[5], 7) + rotl32(acc[6], 12) + rotl32(acc[7], 18);
+    const uint32_t outLo = avalanche32(lo + rotl32(hi, 5) + bytes);
+    const uint32_t outHi = avalanche32(hi + rotl32(lo, 11) + bytes * kPrime32_4);
+    return (static_cast<uint64_t>(outHi) << 32) | outLo;
+}
+
+/**
+ * 行尾像素（不足 8 个）依次进入 lane 0..tail-1
+ */
+static inline void hash_tail(uint32_t acc[8], const uint8_t* p, int tail) {
+    for (int i = 0; i < tail; ++i) {
+        acc[i] = hash_round(acc[i], load_word(p + i * 4));
+    }
+}
+
+#if FRAME_HASH_NEON
+static inline uint32x4_t hash_round_neon(uint32x4_t acc, uint32x4_t word) {
+    const uint32x4_t v = vmlaq_u32(acc, word, vdupq_n_u32(kPrime32_2));
+    const uint32x4_t r = vsliq_n_u32(vshrq_n_u32(v, 19), v, 13);   // rotl(v, 13)
+    return vmulq_u32(r, vdupq_n_u32(kPrime32_1));
+}
+#endif
+
+/**
+ * 单个行带的哈希
+ */
+static uint64_t hash_band(const uint8_t* pixels, int width, int rowBegin, int rowEnd, int stride, uint32_t seed) {
+    uint32_t acc[8];
+    init_lanes(acc, seed);
+
+    const int blocks = width / 8;
+    const int tail = width - blocks * 8;
+
+#if FRAME_HASH_NEON
+    uint32x4_t accLo = vld1q_u32(acc);
+    uint32x4_t accHi = vld1q_u32(acc + 4);
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        const uint8_t* row = pixels + static_cast<size_t>(y) * stride;
+        for (int b = 0; b < blocks; ++b) {
+            const uint8_t* p = row + b * 32;
+            accLo = hash_round_neon(accLo, vreinterpretq_u32_u8(vld1q_u8(p)));
+            accHi = hash_round_neon(accHi, vreinterpretq_u32_u8(vld1q_u8(p + 16)));
+        }
+        if (tail > 0) {
+            vst1q_u32(acc, accLo);
+            vst1q_u32(acc + 4, accHi);
+            hash_tail(acc, row + blocks * 32, tail);
+            accLo = vld1q_u32(acc);
+            accHi = vld1q_u32(acc + 4);
+        }
+    }
+    vst1q_u32(acc, accLo);
+    vst1q_u32(acc + 4, accHi);
+#else
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        const uint8_t* row = pixels + static_cast<size_t>(y) * stride;
+        for (int b = 0; b < blocks; ++b) {
+            const uint8_t* p = row + b * 32;
+            for (int i = 0; i < 8; ++i) {
+                acc[i] = hash_round(acc[i], load_word(p + i * 4));
+            }
+        }
+        hash_tail(acc, row + blocks * 32, tail);
+    }
+#endif
+
+    return finalize_lanes(acc, static_cast<uint32_t>(width) * 4 * (rowEnd - rowBegin));
+}
+
+uint64_t frame_hash_rgba8888(
+    const uint8_t* pixels,
+    int width,
+    int height,
+    int stride
+) {
+    if (!pixels || width <= 0 || height <= 0 || stride < width * 4) {
+        LOGE("Invalid parameters: %dx%d, stride=%d", width, height, stride);
+        return 0;
+    }
+
+    const int bands = (height + kBandRows - 1) / kBandRows;
+    std::vector<uint64_t> bandHashes(bands);
+    parallel_for(0, bands, 1, [&](int bandBegin, int bandEnd, int) {
+        for (int band = bandBegin; band < bandEnd; ++band) {
+            const int rowBegin = band * kBandRows;
+            const int rowEnd = std::min(height, rowBegin + kBandRows);
+            bandHashes[band] = hash_band(pixels, width, rowBegin, rowEnd, stride, static_cast<uint32_t>(band));
+        }
+    });
+
+    // 初值混入尺寸：像素字节序列相同、尺寸不同的帧哈希不同
+    uint64_t h = kPrime64_4 ^ (static_cast<uint64_t>(width) << 32 | static_cast<uint32_t>(height));
+    for (int band = 0; band < bands; ++band) {
+        h ^= rotl64(bandHashes[band] * kPrime64_2, 31) * kPrime64_1;
+        h = rotl64(h, 27) * kPrime64_1 + kPrime64_4;
+    }
+    h ^= h >> 33;
+    h *= kPrime64_2;
+    h ^= h >> 29;
+    h *= kPrime64_3;
+    h ^= h >> 32;
+
+    return h != 0 ? h : 1;
+}
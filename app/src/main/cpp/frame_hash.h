@@ -0,0 +1,43 @@
+/**
+ * frame_hash.h - 帧内容哈希（xxHash 风格，按行处理，NEON 加速）
+ *
+ * 背景：
+ * - 视图层原先用 Bitmap.hashCode()（对象身份）判断背景是否变化，
+ *   每帧新捕获的 Bitmap 必然不同，静止背景也会触发整帧重新模糊
+ * - 这里对像素内容求 64 位哈希，作为模糊结果缓存（blur_cache）的键
+ *
+ * 算法：
+ * - 8 个 32 位累加器，每次吃进 32 字节（8 个像素），第 i 个像素进入第 i 个累加器：
+ *   acc = rotl(acc + word × P2, 13) × P1（与 XXH32 的 round 相同）
+ * - 行尾不足 8 个像素的部分依次进入前几个累加器，行跨度中的填充字节不参与
+ * - 每 32 行为一个行带，各行带独立求值（可并行），再按顺序折叠为 64 位结果；
+ *   行带划分固定，结果与线程数无关
+ * - NEON 版本用两个 uint32x4 累加器并行处理 8 个 lane，与标量版本结果逐位相同
+ *
+ * 注意：
+ * - 非加密哈希，只用于缓存命中判断（两帧不同但哈希相同的概率约 2^-64）
+ * - 结果永远不为 0，调用方可用 0 表示“未知 / 不可哈希”
+ */
+
+#ifndef FRAME_HASH_H
+#define FRAME_HASH_H
+
+#include <cstdint>
+
+/**
+ * 计算像素内容哈希
+ *
+ * @param pixels 像素数据（RGBA8888）
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param stride 行跨度（字节数）
+ * @return 64 位哈希（参数非法时为 0）
+ */
+uint64_t frame_hash_rgba8888(
+    const uint8_t* pixels,
+    int width,
+    int height,
+    int stride
+);
+
+#endif // FRAME_HASH_H
@@ -26,10 +26,15 @@
  * - 边界条件采用稳态增益补偿，避免振铃
  * 
  * 时间复杂度：O(W×H)，每像素约 12 次乘法 + 8 次加法（单通道）
- * 空间复杂度：O(max(W,H))，仅需一维工作缓冲
+ * 空间复杂度：O(max(W,H))，仅需一维工作缓冲（纵向按 8 列一块）
  */
 
 #include "gauss_iir.h"
+#include "color_lut.h"
+#include "perf_trace.h"
+#include "pixel_layout.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
 #include <cmath>
 #include <cstring>
 #include <algorithm>
@@ -39,20 +44,6 @@
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-// sRGB ↔ Linear 转换（快速近似）
-static inline float srgb_to_linear(float srgb) {
-    // 精确公式：srgb <= 0.04045 ? srgb/12.92 : pow((srgb+0.055)/1.055, 2.4)
-    // 快速近似：pow(srgb, 2.2)，误差 < 2%
-    return srgb * srgb * (srgb * 0.2 + 0.8f); // 更快的 2.2 次方近似
-}
-
-static inline float linear_to_srgb(float linear) {
-    // 精确公式：linear <= 0.0031308 ? linear*12.92 : 1.055*pow(linear,1/2.4)-0.055
-    // 快速近似：pow(linear, 1/2.2)
-    float x = sqrtf(linear);
-    return x * (1.0f - 0.2f * linear); // 快速 1/2.2 次方近似
-}
-
 // Deriche 系数结构
 struct DericheCoeffs {
     float a0, a1, a2, a3; // 前向/后向系数
@@ -94,203 +85,226 @@ static DericheCoeffs compute_deriche_coeffs(float sigma) {
     return c;
 }
 
+// 纵向批处理的列数：一次行访问读取 8 个相邻像素（32 字节），被整批列复用
+static const int kColumnTile = 8;
+
 /**
- * 一维 IIR 递归滤波（单通道）
+ * 一维 IIR 递归滤波（多通道交错）
+ * 
+ * 第 i 个样本占用 src[i * Lanes .. i * Lanes + Lanes)，各通道相互独立，
+ * 状态保存在定长数组中，内层循环可被编译器自动向量化。
  * 
- * @param src 源数据
+ * @param src 源数据（不能与 dst 重叠：后向递归需要读取原始输入）
  * @param dst 目标数据
- * @param len 数据长度
+ * @param len 样本数
  * @param c 滤波器系数
  */
-static void iir_filter_1d(const float* src, float* dst, int len, const DericheCoeffs& c) {
+template <int Lanes>
+static void iir_filter_1d(const float* __restrict src, float* __restrict dst, int len, const DericheCoeffs& c) {
     if (len <= 0) return;
     
+    float xp1[Lanes], yp1[Lanes], yp2[Lanes];
+    float xn1[Lanes], xn2[Lanes], yn1[Lanes], yn2[Lanes];
+    
     // 前向递归（causal）
-    float yp1 = src[0] * c.coefp; // 稳态初始化
-    float yp2 = yp1;
-    float xp1 = src[0];
-
+    for (int j = 0; j < Lanes; ++j) {
+        xp1[j] = src[j];
+        yp1[j] = src[j] * c.coefp; // 稳态初始化
+        yp2[j] = yp1[j];
+    }
+    
     for (int i = 0; i < len; ++i) {
-        float xc = src[i];
-        float yc = c.a0 * xc + c.a1 * xp1 - c.b1 * yp1 - c.b2 * yp2;
-
-        dst[i] = yc; // 暂存前向结果
-
-        xp1 = xc;
-        yp2 = yp1; yp1 = yc;
+        const float* xc = src + i * Lanes;
+        float* yc = dst + i * Lanes;
+        for (int j = 0; j < Lanes; ++j) {
+            float y = c.a0 * xc[j] + c.a1 * xp1[j] - c.b1 * yp1[j] - c.b2 * yp2[j];
+            yc[j] = y; // 暂存前向结果
+            xp1[j] = xc[j];
+            yp2[j] = yp1[j]; yp1[j] = y;
+        }
     }
     
     // 后向递归（anti-causal）
-    float yn1 = src[len - 1] * c.coefn; // 稳态初始化
-    float yn2 = yn1;
-    float xn1 = src[len - 1];
-    float xn2 = xn1;
+    const float* last = src + (len - 1) * Lanes;
+    for (int j = 0; j < Lanes; ++j) {
+        xn1[j] = last[j];
+        xn2[j] = last[j];
+        yn1[j] = last[j] * c.coefn; // 稳态初始化
+        yn2[j] = yn1[j];
+    }
     
     for (int i = len - 1; i >= 0; --i) {
-        float xc = src[i];
-        float yc = c.a2 * xn1 + c.a3 * xn2 - c.b1 * yn1 - c.b2 * yn2;
-        
-        dst[i] += yc; // 累加后向结果
-        
-        xn2 = xn1; xn1 = xc;
-        yn2 = yn1; yn1 = yc;
+        const float* xc = src + i * Lanes;
+        float* yc = dst + i * Lanes;
+        for (int j = 0; j < Lanes; ++j) {
+            float y = c.a2 * xn1[j] + c.a3 * xn2[j] - c.b1 * yn1[j] - c.b2 * yn2[j];
+            yc[j] += y; // 累加后向结果
+            xn2[j] = xn1[j]; xn1[j] = xc[j];
+            yn2[j] = yn1[j]; yn1[j] = y;
+        }
+    }
+}
+
+/**
+ * 像素 → 浮点（R, G, B, A 顺序），Linear 时查表转换为预乘的线性值（精确 sRGB 曲线）
+ */
+template <bool Linear, typename Layout>
+static inline void load_pixel(const ColorLut& lut, const uint8_t* pixel, float* out) {
+    if (Linear) {
+        const int a = pixel[Layout::A];
+        out[0] = color_lut_to_linear(lut, pixel[Layout::R], a);
+        out[1] = color_lut_to_linear(lut, pixel[Layout::G], a);
+        out[2] = color_lut_to_linear(lut, pixel[Layout::B], a);
+        out[3] = a / 255.0f;
+        return;
     }
+
+    out[0] = pixel[Layout::R] / 255.0f;
+    out[1] = pixel[Layout::G] / 255.0f;
+    out[2] = pixel[Layout::B] / 255.0f;
+    out[3] = pixel[Layout::A] / 255.0f;
+}
+
+/**
+ * 浮点 → 像素，Linear 时先量化 Alpha，再查表转换回预乘 sRGB
+ */
+template <bool Linear, typename Layout>
+static inline void store_pixel(const ColorLut& lut, const float* in, uint8_t* pixel) {
+    // 钳位
+    const float fa = std::max(0.0f, std::min(1.0f, in[3]));
+    const int a = static_cast<int>(fa * 255.0f + 0.5f);
+
+    if (Linear) {
+        pixel[Layout::R] = color_lut_to_srgb8(lut, in[0], a);
+        pixel[Layout::G] = color_lut_to_srgb8(lut, in[1], a);
+        pixel[Layout::B] = color_lut_to_srgb8(lut, in[2], a);
+        pixel[Layout::A] = static_cast<uint8_t>(a);
+        return;
+    }
+
+    // 钳位并转换为 uint8
+    int r = static_cast<int>(std::max(0.0f, std::min(255.0f, in[0] * 255.0f + 0.5f)));
+    int g = static_cast<int>(std::max(0.0f, std::min(255.0f, in[1] * 255.0f + 0.5f)));
+    int b = static_cast<int>(std::max(0.0f, std::min(255.0f, in[2] * 255.0f + 0.5f)));
+    
+    pixel[Layout::R] = static_cast<uint8_t>(r);
+    pixel[Layout::G] = static_cast<uint8_t>(g);
+    pixel[Layout::B] = static_cast<uint8_t>(b);
+    pixel[Layout::A] = static_cast<uint8_t>(a);
 }
 
 /**
  * 横向模糊（处理所有行）
+ * 
+ * @param inBuf  输入缓冲（w × 4 浮点）
+ * @param outBuf 输出缓冲（w × 4 浮点）
  */
+template <bool Linear>
 static void blur_horizontal(
     uint8_t* base,
-    int w, int h, int stride,
+    int w, int rowBegin, int rowEnd, int stride,
     const DericheCoeffs& c,
-    float* buffer,
-    bool doLinear
+    float* inBuf,
+    float* outBuf,
+    TraceSubStages& stages
 ) {
-    for (int y = 0; y < h; ++y) {
+    const ColorLut& lut = color_lut();
+    StageTimer timer;
+    uint64_t convertNs = 0, packNs = 0;
+    
+    for (int y = rowBegin; y < rowEnd; ++y) {
         uint8_t* row = base + y * stride;
         
-        // 加载到浮点缓冲（分离 RGBA 通道）
+        // 加载到浮点缓冲（RGBA 交错）
         for (int x = 0; x < w; ++x) {
-            uint8_t b = row[x * 4 + 0];
-            uint8_t g = row[x * 4 + 1];
-            uint8_t r = row[x * 4 + 2];
-            uint8_t a = row[x * 4 + 3];
-            
-            float fa = a / 255.0f;
-            float fr = r / 255.0f;
-            float fg = g / 255.0f;
-            float fb = b / 255.0f;
-            
-            if (doLinear) {
-                // 去预乘 + sRGB→Linear
-                if (fa > 0.001f) {
-                    fr = srgb_to_linear(fr / fa);
-                    fg = srgb_to_linear(fg / fa);
-                    fb = srgb_to_linear(fb / fa);
-                } else {
-                    fr = fg = fb = 0.0f;
-                }
-            }
-            
-            buffer[x] = fr;
-            buffer[w + x] = fg;
-            buffer[2 * w + x] = fb;
-            buffer[3 * w + x] = fa;
+            load_pixel<Linear, BitmapLayout>(lut, row + x * 4, inBuf + x * 4);
         }
+        convertNs += timer.lap();
         
-        // 对每个通道执行 IIR 滤波
-        iir_filter_1d(buffer, buffer, w, c);                  // R
-        iir_filter_1d(buffer + w, buffer + w, w, c);          // G
-        iir_filter_1d(buffer + 2 * w, buffer + 2 * w, w, c);  // B
-        iir_filter_1d(buffer + 3 * w, buffer + 3 * w, w, c);  // A
+        // 4 个通道一起执行 IIR 滤波
+        iir_filter_1d<4>(inBuf, outBuf, w, c);
+        timer.lap();
         
         // 写回像素
         for (int x = 0; x < w; ++x) {
-            float fr = buffer[x];
-            float fg = buffer[w + x];
-            float fb = buffer[2 * w + x];
-            float fa = buffer[3 * w + x];
-            
-            // 钳位
-            fa = std::max(0.0f, std::min(1.0f, fa));
-            
-            if (doLinear) {
-                // Linear→sRGB + 再预乘
-                fr = linear_to_srgb(fr) * fa;
-                fg = linear_to_srgb(fg) * fa;
-                fb = linear_to_srgb(fb) * fa;
-            }
-            
-            // 钳位并转换为 uint8
-            int r = static_cast<int>(std::max(0.0f, std::min(255.0f, fr * 255.0f + 0.5f)));
-            int g = static_cast<int>(std::max(0.0f, std::min(255.0f, fg * 255.0f + 0.5f)));
-            int b = static_cast<int>(std::max(0.0f, std::min(255.0f, fb * 255.0f + 0.5f)));
-            int a = static_cast<int>(fa * 255.0f + 0.5f);
-            
-            row[x * 4 + 0] = static_cast<uint8_t>(b);
-            row[x * 4 + 1] = static_cast<uint8_t>(g);
-            row[x * 4 + 2] = static_cast<uint8_t>(r);
-            row[x * 4 + 3] = static_cast<uint8_t>(a);
+            store_pixel<Linear, BitmapLayout>(lut, outBuf + x * 4, row + x * 4);
         }
+        packNs += timer.lap();
     }
+    
+    stages.add(convertNs, packNs);
 }
 
 /**
- * 纵向模糊（处理所有列）
+ * 纵向模糊（按列块处理）
+ * 
+ * 每次处理 kColumnTile 个相邻列：逐行读取一段连续像素，
+ * 同一行的缓存行被整块列复用，避免逐列跨 stride 访问造成的缓存缺失。
+ * 
+ * @param inBuf  输入缓冲（h × kColumnTile × 4 浮点）
+ * @param outBuf 输出缓冲（h × kColumnTile × 4 浮点）
  */
+template <bool Linear>
 static void blur_vertical(
     uint8_t* base,
     int w, int h, int stride,
     const DericheCoeffs& c,
-    float* buffer,
-    bool doLinear
+    int tileBegin, int tileEnd,
+    float* inBuf,
+    float* outBuf,
+    TraceSubStages& stages
 ) {
-    for (int x = 0; x < w; ++x) {
-        // 加载列到浮点缓冲
+    const int lanes = kColumnTile * 4;
+    const ColorLut& lut = color_lut();
+    StageTimer timer;
+    uint64_t convertNs = 0, packNs = 0;
+    
+    for (int tile = tileBegin; tile < tileEnd; ++tile) {
+        const int x0 = tile * kColumnTile;
+        const int n = std::min(kColumnTile, w - x0);
+        
+        // 不足一块时，未用列保持为 0（各列独立，不影响结果）
+        if (n < kColumnTile) {
+            memset(inBuf, 0, h * lanes * sizeof(float));
+        }
+        
+        // 加载列块到浮点缓冲
         for (int y = 0; y < h; ++y) {
-            uint8_t* pixel = base + y * stride + x * 4;
-            uint8_t b = pixel[0];
-            uint8_t g = pixel[1];
-            uint8_t r = pixel[2];
-            uint8_t a = pixel[3];
-            
-            float fa = a / 255.0f;
-            float fr = r / 255.0f;
-            float fg = g / 255.0f;
-            float fb = b / 255.0f;
-            
-            if (doLinear) {
-                if (fa > 0.001f) {
-                    fr = srgb_to_linear(fr / fa);
-                    fg = srgb_to_linear(fg / fa);
-                    fb = srgb_to_linear(fb / fa);
-                } else {
-                    fr = fg = fb = 0.0f;
-                }
+            const uint8_t* row = base + y * stride + x0 * 4;
+            float* dst = inBuf + y * lanes;
+            for (int k = 0; k < n; ++k) {
+                load_pixel<Linear, BitmapLayout>(lut, row + k * 4, dst + k * 4);
             }
-            
-            buffer[y] = fr;
-            buffer[h + y] = fg;
-            buffer[2 * h + y] = fb;
-            buffer[3 * h + y] = fa;
         }
+        convertNs += timer.lap();
         
-        // 对每个通道执行 IIR 滤波
-        iir_filter_1d(buffer, buffer, h, c);
-        iir_filter_1d(buffer + h, buffer + h, h, c);
-        iir_filter_1d(buffer + 2 * h, buffer + 2 * h, h, c);
-        iir_filter_1d(buffer + 3 * h, buffer + 3 * h, h, c);
+        // 整块列一起执行 IIR 滤波
+        iir_filter_1d<kColumnTile * 4>(inBuf, outBuf, h, c);
+        timer.lap();
         
-        // 写回列
+        // 写回列块
         for (int y = 0; y < h; ++y) {
-            float fr = buffer[y];
-            float fg = buffer[h + y];
-            float fb = buffer[2 * h + y];
-            float fa = buffer[3 * h + y];
-            
-            fa = std::max(0.0f, std::min(1.0f, fa));
-            
-            if (doLinear) {
-                fr = linear_to_srgb(fr) * fa;
-                fg = linear_to_srgb(fg) * fa;
-                fb = linear_to_srgb(fb) * fa;
+            uint8_t* row = base + y * stride + x0 * 4;
+            const float* src = outBuf + y * lanes;
+            for (int k = 0; k < n; ++k) {
+                store_pixel<Linear, BitmapLayout>(lut, src + k * 4, row + k * 4);
             }
-            
-            int r = static_cast<int>(std::max(0.0f, std::min(255.0f, fr * 255.0f + 0.5f)));
-            int g = static_cast<int>(std::max(0.0f, std::min(255.0f, fg * 255.0f + 0.5f)));
-            int b = static_cast<int>(std::max(0.0f, std::min(255.0f, fb * 255.0f + 0.5f)));
-            int a = static_cast<int>(fa * 255.0f + 0.5f);
-            
-            uint8_t* pixel = base + y * stride + x * 4;
-            pixel[0] = static_cast<uint8_t>(b);
-            pixel[1] = static_cast<uint8_t>(g);
-            pixel[2] = static_cast<uint8_t>(r);
-            pixel[3] = static_cast<uint8_t>(a);
         }
+        packNs += timer.lap();
     }
+    
+    stages.add(convertNs, packNs);
 }
 
+/**
+ * 按 doLinear 选择的行 / 列块内核（编译期展开，热循环内无色彩空间分支）
+ */
+typedef void (*HorizontalKernel)(uint8_t*, int, int, int, int, const DericheCoeffs&, float*, float*, TraceSubStages&);
+typedef void (*VerticalKernel)(uint8_t*, int, int, int, const DericheCoeffs&, int, int, float*, float*, TraceSubStages&);
+
+static const HorizontalKernel kHorizontalKernels[2] = { blur_horizontal<false>, blur_horizontal<true> };
+static const VerticalKernel kVerticalKernels[2] = { blur_vertical<false>, blur_vertical<true> };
+
 // 主入口函数
 void gaussian_iir_rgba8888_inplace(
     uint8_t* base,
@@ -315,21 +329,46 @@ void gaussian_iir_rgba8888_inplace(
         sigma = 50.0f;
     }
     
+    TraceScope total(TRACE_FILTER_IIR, TRACE_STAGE_TOTAL);
+    TraceSubStages stages;
+    
     // 计算滤波器系数
     DericheCoeffs c = compute_deriche_coeffs(sigma);
     
-    // 分配工作缓冲（4 通道 × 最大维度）
-    int maxDim = std::max(w, h);
-    float* buffer = new float[maxDim * 4];
+    // 取用工作缓冲（线程本地内存池；每个线程输入/输出各一份：横向 w × 4，纵向 h × 列块 × 4）
+    const int bufLen = std::max(w * 4, h * kColumnTile * 4);
+    const int threads = thread_pool_concurrency();
+    TraceScope allocScope(TRACE_FILTER_IIR, TRACE_STAGE_ALLOC);
+    ScratchBuffer work(sizeof(float) * bufLen * 2 * threads);
+    allocScope.stop();
+    if (!work) {
+        LOGE("Failed to allocate work buffer: %dx%d", w, h);
+        return;
+    }
+    float* buffer = work.as<float>();
+    const HorizontalKernel horizontal = kHorizontalKernels[doLinear ? 1 : 0];
+    const VerticalKernel vertical = kVerticalKernels[doLinear ? 1 : 0];
     
-    // 横向模糊
-    blur_horizontal(base, w, h, stride, c, buffer, doLinear);
+    // 横向模糊（按行分块并行）
+    {
+        TraceScope scope(TRACE_FILTER_IIR, TRACE_STAGE_HORIZONTAL);
+        parallel_for(0, h, parallel_rows_grain(w), [&](int y0, int y1, int slot) {
+            float* buf = buffer + slot * bufLen * 2;
+            horizontal(base, w, y0, y1, stride, c, buf, buf + bufLen, stages);
+        });
+    }
     
-    // 纵向模糊
-    blur_vertical(base, w, h, stride, c, buffer, doLinear);
+    // 纵向模糊（按列块条带并行）
+    {
+        TraceScope scope(TRACE_FILTER_IIR, TRACE_STAGE_VERTICAL);
+        const int tiles = (w + kColumnTile - 1) / kColumnTile;
+        parallel_for(0, tiles, parallel_rows_grain(h * kColumnTile), [&](int t0, int t1, int slot) {
+            float* buf = buffer + slot * bufLen * 2;
+            vertical(base, w, h, stride, c, t0, t1, buf, buf + bufLen, stages);
+        });
+    }
     
-    // 释放缓冲
-    delete[] buffer;
+    stages.record(TRACE_FILTER_IIR);
 }
 
 // 便捷函数
@@ -0,0 +1,36 @@
+/**
+ * gauss_iir_fp16.cpp - FP16 半精度 IIR 的运行时检测与回退
+ *
+ * 本文件按基线指令集编译（不带 +fp16），可在任何设备上安全执行；
+ * 半精度内核位于 gauss_iir_fp16_kernel.cpp，只在检测通过后调用。
+ */
+
+#include "gauss_iir_fp16.h"
+#include "cpu_features.h"
+#include "gauss_iir.h"
+#include "gauss_iir_neon.h"
+
+bool has_fp16_support() {
+    // 检测见 cpu_features.cpp（HWCAP_ASIMDHP）
+    return gaussian_iir_fp16_kernel_compiled() && cpu_has_features(CPU_FEATURE_FP16);
+}
+
+void gaussian_iir_rgba8888_fp16(
+    uint8_t* base,
+    int w,
+    int h,
+    int stride,
+    float sigma
+) {
+    if (sigma <= 0.1f || w <= 0 || h <= 0 || !base) {
+        return;
+    }
+
+    if (sigma <= kFp16MaxSigma && has_fp16_support()) {
+        gaussian_iir_rgba8888_fp16_kernel(base, w, h, stride, sigma);
+    } else if (has_neon_support()) {
+        gaussian_iir_rgba8888_neon(base, w, h, stride, sigma, false);
+    } else {
+        gaussian_iir_rgba8888_inplace(base, w, h, stride, sigma, false);
+    }
+}
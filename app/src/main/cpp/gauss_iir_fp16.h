@@ -0,0 +1,83 @@
+/**
+ * gauss_iir_fp16.h - IIR 递归高斯模糊 FP16 半精度实现（ARMv8.2-A FP16 算术）
+ *
+ * 优化策略：
+ * - 每个 float16x8_t 寄存器保存 2 个 RGBA 像素（FP32 版本为 1 个），
+ *   横向每次递归 2 行、纵向每个列块 8 列只需 4 个寄存器
+ * - 工作缓冲为 float16，纵向列块缓冲大小为 FP32 版本的一半
+ * - uint8 ↔ fp16 直接转换（vcvtq_f16_u16 / vcvtnq_u16_f16），无需 /255 与量化乘法
+ *
+ * 数值方案：
+ * Deriche 系数直接取 fp16 时，极点 e^-α 接近 1，分母 (1 - e)² 的舍入误差会使直流增益
+ * 明显偏离 1（σ = 24 时误差可达十几个灰阶）。因此按重根极点分解为：
+ *   两级归一化单极点平滑 u += k·(x - u)（直流增益恒为 1，与 k 的舍入无关）
+ *   + 差分形式的分子 y = g·v - g1·(v[n] - v[n-1])（差分项数值小，抵消误差可忽略）
+ * 与 FP32 Deriche 在数学上等价。
+ *
+ * 精度（与 gaussian_iir_rgba8888_neon(..., doLinear = false) 的 8 位输出比较，
+ * 随机噪声 / 阶跃 / 正弦 / 方波测试图）：
+ * - σ ≤ 32：最大误差 2 LSB，约 5-20% 的像素相差 1（FP32 版本与双精度参考之间本身也有 1 LSB 差异）
+ * - σ > 32：递归舍入误差随 σ 增长（σ = 100 时约 4 LSB），自动回退 FP32 NEON 版本
+ * - 只用于非线性模式；线性模式需 sRGB 暗部精度，始终走 FP32
+ *
+ * 兼容性：
+ * - 内核文件 gauss_iir_fp16_kernel.cpp 仅在 arm64-v8a 上以 -march=armv8-a+fp16 编译
+ * - 运行时通过 cpu_features()（getauxval(AT_HWCAP) & HWCAP_ASIMDHP）检测（Cortex-A55/A75 及以后）
+ * - 不支持时 gaussian_iir_rgba8888_fp16 自动回退到 NEON / 标量 FP32 版本
+ */
+
+#ifndef GAUSS_IIR_FP16_H
+#define GAUSS_IIR_FP16_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * FP16 路径的最大 σ（超过时回退 FP32，见文件头精度说明）
+ */
+static const float kFp16MaxSigma = 32.0f;
+
+/**
+ * 检测当前设备是否支持 FP16 向量算术（ARMv8.2-A ASIMDHP）
+ *
+ * @return true 如果 FP16 内核已编译且 CPU 支持
+ */
+bool has_fp16_support();
+
+/**
+ * IIR 递归高斯模糊（FP16 半精度，非线性模式）
+ *
+ * 支持 FP16 且 σ ≤ kFp16MaxSigma 时使用半精度内核，
+ * 否则回退到 gaussian_iir_rgba8888_neon / gaussian_iir_rgba8888_inplace（doLinear = false）
+ *
+ * @param base 像素数据指针（RGBA_8888，预乘 Alpha）
+ * @param w 图像宽度
+ * @param h 图像高度
+ * @param stride 行跨度（字节数）
+ * @param sigma 高斯标准差
+ */
+void gaussian_iir_rgba8888_fp16(
+    uint8_t* base,
+    int w,
+    int h,
+    int stride,
+    float sigma
+);
+
+/**
+ * FP16 内核是否已编译（内部接口：armv8.2-a+fp16 之外的构建返回 false）
+ */
+bool gaussian_iir_fp16_kernel_compiled();
+
+/**
+ * FP16 内核（内部接口：只能在 has_fp16_support() 为 true 时调用，不做回退）
+ */
+void gaussian_iir_rgba8888_fp16_kernel(
+    uint8_t* base,
+    int w,
+    int h,
+    int stride,
+    float sigma
+);
+
+#endif // GAUSS_IIR_FP16_H
@@ -0,0 +1,361 @@
+/**
+ * gauss_iir_fp16_kernel.cpp - IIR 递归高斯模糊 FP16 半精度内核
+ *
+ * 实现细节：
+ * - 本文件在 arm64-v8a 上以 -march=armv8-a+fp16 编译，只能经 gaussian_iir_rgba8888_fp16
+ *   的运行时检测后进入；只加 +fp16 而不用 armv8.2-a，避免头文件内联函数（原子操作等）
+ *   在本文件中生成 LSE 等指令后被链接器合并给基线代码使用
+ * - 横向：每次处理 2 行，寄存器低 4 通道为第 y 行、高 4 通道为第 y+1 行，
+ *   缓冲布局 [x][2 行][RGBA]；vzip/vuzp 完成两行像素的交织与拆分
+ * - 纵向：每次处理 8 个相邻列（4 个 float16x8_t），缓冲布局 [y][8 列][RGBA]
+ * - 递归采用「两级归一化单极点 + 差分分子」形式（推导与精度见 gauss_iir_fp16.h）
+ * - 像素值保持 [0, 255] 标度：uint8 整数在 fp16 中精确表示，打包用 vcvtnq_u16_f16
+ *   （就近舍入，负数饱和为 0）+ vqmovn_u16（饱和到 255）
+ */
+
+#include "gauss_iir_fp16.h"
+#include "perf_trace.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <android/log.h>
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_FP16_VECTOR_ARITHMETIC)
+#include <arm_neon.h>
+#define FP16_AVAILABLE 1
+#else
+#define FP16_AVAILABLE 0
+#endif
+
+#define LOG_TAG "GaussIIR_FP16"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+bool gaussian_iir_fp16_kernel_compiled() {
+    return FP16_AVAILABLE != 0;
+}
+
+#if FP16_AVAILABLE
+
+// 纵向批处理的列数（与 FP32 版本相同，每行读取 32 字节）
+static const int kColumnTile = 8;
+
+/**
+ * 分解形式的滤波系数
+ *
+ * Deriche 因果部分 (a0 + a1·z⁻¹) / (1 - e·z⁻¹)²，反因果部分 (a2·z + a3·z²) / (1 - e·z)²，
+ * 令 d = (1 - e)²：
+ *   因果   = gp·v[n]   - g1·(v[n] - v[n-1])，   gp = (a0 + a1) / d，g1 = a1 / d
+ *   反因果 = gn·w[n+1] + h1·(w[n+2] - w[n+1])，gn = (a2 + a3) / d，h1 = a3 / d
+ * 其中 v / w 为输入经两级 u += k·(x - u)（k = 1 - e）正向 / 反向平滑的结果
+ */
+struct Fp16Coeffs {
+    float k;
+    float gp, g1;
+    float gn, h1;
+};
+
+static Fp16Coeffs compute_fp16_coeffs(float sigma) {
+    Fp16Coeffs c;
+
+    double alpha = 1.695 / sigma;
+    double ema = exp(-alpha);
+    double ema2 = ema * ema;
+
+    double norm = (1.0 - ema) * (1.0 - ema) / (1.0 + 2.0 * alpha * ema - ema2);
+    double a0 = norm;
+    double a1 = norm * ema * (alpha - 1.0);
+    double a2 = norm * ema * (alpha + 1.0);
+    double a3 = -norm * ema2;
+    double d = (1.0 - ema) * (1.0 - ema);
+
+    c.k = static_cast<float>(1.0 - ema);
+    c.gp = static_cast<float>((a0 + a1) / d);
+    c.g1 = static_cast<float>(a1 / d);
+    c.gn = static_cast<float>((a2 + a3) / d);
+    c.h1 = static_cast<float>(a3 / d);
+
+    return c;
+}
+
+/**
+ * 一维 IIR 递归滤波（FP16）
+ *
+ * 每个样本包含 Vectors 个 float16x8_t（每个 2 像素），各通道递归相互独立。
+ * 边界按稳态初始化（等价于边界像素无限延拓），与 FP32 版本一致。
+ *
+ * 注意：src 与 dst 不能重叠，后向递归需要读取原始输入
+ */
+template <int Vectors>
+static void iir_filter_1d_fp16(const float16_t* src, float16_t* dst, int len, const Fp16Coeffs& c) {
+    if (len <= 0) return;
+
+    const int step = Vectors * 8;
+
+    const float16x8_t vk = vdupq_n_f16(static_cast<float16_t>(c.k));
+    const float16x8_t vgp = vdupq_n_f16(static_cast<float16_t>(c.gp));
+    const float16x8_t vg1 = vdupq_n_f16(static_cast<float16_t>(c.g1));
+    const float16x8_t vgn = vdupq_n_f16(static_cast<float16_t>(c.gn));
+    const float16x8_t vh1 = vdupq_n_f16(static_cast<float16_t>(c.h1));
+
+    // 前向（causal）
+    float16x8_t u[Vectors], v[Vectors], vp[Vectors];
+    for (int k = 0; k < Vectors; ++k) {
+        u[k] = vld1q_f16(src + k * 8);
+        v[k] = u[k];
+        vp[k] = u[k];
+    }
+
+    for (int i = 0; i < len; ++i) {
+        const float16_t* xs = src + i * step;
+        float16_t* ys = dst + i * step;
+        for (int k = 0; k < Vectors; ++k) {
+            const float16x8_t x = vld1q_f16(xs + k * 8);
+            u[k] = vfmaq_f16(u[k], vk, vsubq_f16(x, u[k]));
+            v[k] = vfmaq_f16(v[k], vk, vsubq_f16(u[k], v[k]));
+
+            float16x8_t y = vmulq_f16(vgp, v[k]);
+            y = vfmsq_f16(y, vg1, vsubq_f16(v[k], vp[k]));
+            vst1q_f16(ys + k * 8, y);
+
+            vp[k] = v[k];
+        }
+    }
+
+    // 后向（anti-causal）：w1 = w[n+1]，w2 = w[n+2]
+    float16x8_t w1[Vectors], w2[Vectors];
+    const float16_t* last = src + (len - 1) * step;
+    for (int k = 0; k < Vectors; ++k) {
+        u[k] = vld1q_f16(last + k * 8);
+        v[k] = u[k];
+        w1[k] = u[k];
+        w2[k] = u[k];
+    }
+
+    for (int i = len - 1; i >= 0; --i) {
+        const float16_t* xs = src + i * step;
+        float16_t* ys = dst + i * step;
+        for (int k = 0; k < Vectors; ++k) {
+            float16x8_t y = vmulq_f16(vgn, w1[k]);
+            y = vfmaq_f16(y, vh1, vsubq_f16(w2[k], w1[k]));
+
+            // 累加前向和后向结果
+            vst1q_f16(ys + k * 8, vaddq_f16(vld1q_f16(ys + k * 8), y));
+
+            const float16x8_t x = vld1q_f16(xs + k * 8);
+            u[k] = vfmaq_f16(u[k], vk, vsubq_f16(x, u[k]));
+            v[k] = vfmaq_f16(v[k], vk, vsubq_f16(u[k], v[k]));
+            w2[k] = w1[k];
+            w1[k] = v[k];
+        }
+    }
+}
+
+/**
+ * 2 个 RGBA8888 像素（8 字节）→ float16x8_t
+ */
+static inline float16x8_t unpack2_fp16(uint8x8_t px) {
+    return vcvtq_f16_u16(vmovl_u8(px));
+}
+
+/**
+ * float16x8_t → 2 个 RGBA8888 像素（就近舍入 + 饱和）
+ */
+static inline uint8x8_t pack2_fp16(float16x8_t v) {
+    return vqmovn_u16(vcvtnq_u16_f16(v));
+}
+
+static inline uint32x2_t load_pixel_pair(const uint8_t* a, const uint8_t* b) {
+    uint32_t pa, pb;
+    memcpy(&pa, a, 4);
+    memcpy(&pb, b, 4);
+    return vset_lane_u32(pb, vdup_n_u32(pa), 1);
+}
+
+/**
+ * 横向模糊：每次 2 行（行数为奇数时末行与自身配对，只写回一次）
+ */
+static void blur_horizontal_fp16(
+    uint8_t* base,
+    int w,
+    int h,
+    int pairBegin,
+    int pairEnd,
+    int stride,
+    const Fp16Coeffs& c,
+    float16_t* inBuf,
+    float16_t* outBuf,
+    TraceSubStages& stages
+) {
+    StageTimer timer;
+    uint64_t convertNs = 0, packNs = 0;
+
+    for (int pair = pairBegin; pair < pairEnd; ++pair) {
+        const int y = pair * 2;
+        uint8_t* rowA = base + y * stride;
+        uint8_t* rowB = (y + 1 < h) ? rowA + stride : rowA;
+
+        // 两行交织：[A(x), B(x)] [A(x+1), B(x+1)]
+        int x = 0;
+        for (; x + 2 <= w; x += 2) {
+            const uint32x2x2_t z = vzip_u32(vreinterpret_u32_u8(vld1_u8(rowA + x * 4)),
+                                            vreinterpret_u32_u8(vld1_u8(rowB + x * 4)));
+            vst1q_f16(inBuf + x * 8, unpack2_fp16(vreinterpret_u8_u32(z.val[0])));
+            vst1q_f16(inBuf + x * 8 + 8, unpack2_fp16(vreinterpret_u8_u32(z.val[1])));
+        }
+        if (x < w) {
+            const uint32x2_t ab = load_pixel_pair(rowA + x * 4, rowB + x * 4);
+            vst1q_f16(inBuf + x * 8, unpack2_fp16(vreinterpret_u8_u32(ab)));
+        }
+        convertNs += timer.lap();
+
+        iir_filter_1d_fp16<1>(inBuf, outBuf, w, c);
+        timer.lap();
+
+        // 拆分回两行
+        x = 0;
+        for (; x + 2 <= w; x += 2) {
+            const uint32x2x2_t z = vuzp_u32(vreinterpret_u32_u8(pack2_fp16(vld1q_f16(outBuf + x * 8))),
+                                            vreinterpret_u32_u8(pack2_fp16(vld1q_f16(outBuf + x * 8 + 8))));
+            vst1_u8(rowA + x * 4, vreinterpret_u8_u32(z.val[0]));
+            if (rowB != rowA) vst1_u8(rowB + x * 4, vreinterpret_u8_u32(z.val[1]));
+        }
+        if (x < w) {
+            const uint32x2_t ab = vreinterpret_u32_u8(pack2_fp16(vld1q_f16(outBuf + x * 8)));
+            const uint32_t pa = vget_lane_u32(ab, 0);
+            const uint32_t pb = vget_lane_u32(ab, 1);
+            memcpy(rowA + x * 4, &pa, 4);
+            if (rowB != rowA) memcpy(rowB + x * 4, &pb, 4);
+        }
+        packNs += timer.lap();
+    }
+
+    stages.add(convertNs, packNs);
+}
+
+/**
+ * 纵向模糊：每次 kColumnTile 个相邻列（不足一块时未用列保持为 0）
+ */
+static void blur_vertical_fp16(
+    uint8_t* base,
+    int w,
+    int h,
+    int stride,
+    const Fp16Coeffs& c,
+    int tileBegin,
+    int tileEnd,
+    float16_t* inBuf,
+    float16_t* outBuf,
+    TraceSubStages& stages
+) {
+    const int step = kColumnTile * 4;
+    StageTimer timer;
+    uint64_t convertNs = 0, packNs = 0;
+
+    for (int tile = tileBegin; tile < tileEnd; ++tile) {
+        const int x0 = tile * kColumnTile;
+        const int n = std::min(kColumnTile, w - x0);
+        const size_t bytes = static_cast<size_t>(n) * 4;
+
+        for (int y = 0; y < h; ++y) {
+            const uint8_t* src = base + y * stride + x0 * 4;
+            uint8x16_t lo, hi;
+            if (n == kColumnTile) {
+                lo = vld1q_u8(src);
+                hi = vld1q_u8(src + 16);
+            } else {
+                uint8_t tmp[32] = {0};
+                memcpy(tmp, src, bytes);
+                lo = vld1q_u8(tmp);
+                hi = vld1q_u8(tmp + 16);
+            }
+            float16_t* dst = inBuf + y * step;
+            vst1q_f16(dst, unpack2_fp16(vget_low_u8(lo)));
+            vst1q_f16(dst + 8, unpack2_fp16(vget_high_u8(lo)));
+            vst1q_f16(dst + 16, unpack2_fp16(vget_low_u8(hi)));
+            vst1q_f16(dst + 24, unpack2_fp16(vget_high_u8(hi)));
+        }
+        convertNs += timer.lap();
+
+        iir_filter_1d_fp16<kColumnTile / 2>(inBuf, outBuf, h, c);
+        timer.lap();
+
+        for (int y = 0; y < h; ++y) {
+            const float16_t* src = outBuf + y * step;
+            const uint8x16_t lo = vcombine_u8(pack2_fp16(vld1q_f16(src)), pack2_fp16(vld1q_f16(src + 8)));
+            const uint8x16_t hi = vcombine_u8(pack2_fp16(vld1q_f16(src + 16)), pack2_fp16(vld1q_f16(src + 24)));
+            uint8_t* dst = base + y * stride + x0 * 4;
+            if (n == kColumnTile) {
+                vst1q_u8(dst, lo);
+                vst1q_u8(dst + 16, hi);
+            } else {
+                uint8_t tmp[32];
+                vst1q_u8(tmp, lo);
+                vst1q_u8(tmp + 16, hi);
+                memcpy(dst, tmp, bytes);
+            }
+        }
+        packNs += timer.lap();
+    }
+
+    stages.add(convertNs, packNs);
+}
+
+#endif // FP16_AVAILABLE
+
+void gaussian_iir_rgba8888_fp16_kernel(
+    uint8_t* base,
+    int w,
+    int h,
+    int stride,
+    float sigma
+) {
+#if FP16_AVAILABLE
+    if (sigma <= 0.1f || w <= 0 || h <= 0 || !base) {
+        return;
+    }
+
+    TraceScope total(TRACE_FILTER_IIR_FP16, TRACE_STAGE_TOTAL);
+    TraceSubStages stages;
+
+    const Fp16Coeffs c = compute_fp16_coeffs(sigma);
+
+    // 每个线程输入/输出各一份：横向 w × 2 行 × 4，纵向 h × 列块 × 4（单位 float16）
+    const int bufLen = std::max(w * 8, h * kColumnTile * 4);
+    const int threads = thread_pool_concurrency();
+    TraceScope allocScope(TRACE_FILTER_IIR_FP16, TRACE_STAGE_ALLOC);
+    ScratchBuffer work(sizeof(float16_t) * bufLen * 2 * threads);
+    allocScope.stop();
+    if (!work) {
+        LOGE("Failed to allocate work buffer: %dx%d", w, h);
+        return;
+    }
+    float16_t* workBuf = work.as<float16_t>();
+
+    // 横向：按行对分块
+    {
+        TraceScope scope(TRACE_FILTER_IIR_FP16, TRACE_STAGE_HORIZONTAL);
+        const int pairs = (h + 1) / 2;
+        parallel_for(0, pairs, parallel_rows_grain(w * 2), [&](int p0, int p1, int slot) {
+            float16_t* buf = workBuf + slot * bufLen * 2;
+            blur_horizontal_fp16(base, w, h, p0, p1, stride, c, buf, buf + bufLen, stages);
+        });
+    }
+
+    // 纵向：按列块条带分块
+    {
+        TraceScope scope(TRACE_FILTER_IIR_FP16, TRACE_STAGE_VERTICAL);
+        const int tiles = (w + kColumnTile - 1) / kColumnTile;
+        parallel_for(0, tiles, parallel_rows_grain(h * kColumnTile), [&](int t0, int t1, int slot) {
+            float16_t* buf = workBuf + slot * bufLen * 2;
+            blur_vertical_fp16(base, w, h, stride, c, t0, t1, buf, buf + bufLen, stages);
+        });
+    }
+
+    stages.record(TRACE_FILTER_IIR_FP16);
+#else
+    LOGE("FP16 kernel not available at compile time");
+#endif
+}
@@ -4,14 +4,30 @@
  * 实现细节：
  * - 使用 ARM NEON intrinsics (arm_neon.h)
  * - 向量化处理 RGBA 4 个通道
+ * - uint8 ↔ float 转换全程向量化：vld4_u8 解交错、vmovl 拓宽、
+ *   钳位后 vmovn 窄化 + vst4_u8 写回；线性模式的 sRGB 曲线查表（color_lut.h）
  * - 优化内存访问和寄存器使用
  * 
  * 编译要求：
  * - ARMv7: -mfpu=neon -mfloat-abi=softfp
  * - ARMv8: -march=armv8-a (默认支持 NEON)
+ *
+ * 运行时分派：
+ * - gaussian_iir_rgba8888_neon 是向量 IIR 的统一入口：ARM 上走本文件的 NEON 内核，
+ *   x86 上按 cpu_features() 选择 gauss_iir_x86.cpp 的 AVX2 / SSE4.1 内核，
+ *   都不可用时回退标量版本
  */
 
 #include "gauss_iir_neon.h"
+#include "gauss_iir.h"
+#include "gauss_iir_x86.h"
+#include "color_lut.h"
+#include "cpu_features.h"
+#include "color_matrix.h"
+#include "perf_trace.h"
+#include "pixel_layout.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
 #include <cmath>
 #include <cstring>
 #include <algorithm>
@@ -29,25 +45,7 @@
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-// sRGB ↔ Linear 转换（向量化版本）
 #if NEON_AVAILABLE
-static inline float32x4_t srgb_to_linear_neon(float32x4_t srgb) {
-    // 快速近似：srgb^2.2 ≈ srgb * srgb * (srgb * 0.2 + 0.8)
-    float32x4_t srgb2 = vmulq_f32(srgb, srgb);
-    float32x4_t factor = vmlaq_n_f32(vdupq_n_f32(0.8f), srgb, 0.2f);
-    return vmulq_f32(srgb2, factor);
-}
-
-static inline float32x4_t linear_to_srgb_neon(float32x4_t linear) {
-    // 快速近似：linear^(1/2.2) ≈ sqrt(linear) * (1 - 0.2 * linear)
-    // 使用倒数平方根近似来计算 sqrt
-    float32x4_t rsqrt = vrsqrteq_f32(linear);  // 快速倒数平方根估计
-    rsqrt = vmulq_f32(rsqrt, vrsqrtsq_f32(vmulq_f32(linear, rsqrt), rsqrt));  // Newton-Raphson 迭代
-    float32x4_t sqrt_linear = vmulq_f32(linear, rsqrt);  // sqrt(x) = x * rsqrt(x)
-    float32x4_t factor = vmlsq_n_f32(vdupq_n_f32(1.0f), linear, 0.2f);
-    return vmulq_f32(sqrt_linear, factor);
-}
-#endif
 
 // Deriche 系数结构（与标量版本相同）
 struct DericheCoeffs {
@@ -79,233 +77,378 @@ static DericheCoeffs compute_deriche_coeffs(float sigma) {
     return c;
 }
 
-#if NEON_AVAILABLE
+// 纵向批处理的列数：每行一次读取 8 个相邻像素（32 字节），整块列共享同一批行访问
+static const int kColumnTile = 8;
 
 /**
  * 一维 IIR 递归滤波（NEON 向量化版本）
  * 
- * 处理 4 个通道（RGBA），使用 NEON 并行计算
+ * 每个样本包含 Columns 个像素（每像素一个 float32x4_t，即 RGBA 4 个通道），
+ * 各像素的递归状态相互独立：Columns = 1 用于横向，Columns = kColumnTile 用于纵向列块。
+ * 
+ * 注意：src 与 dst 不能重叠，后向递归需要读取原始输入
  */
+template <int Columns>
 static void iir_filter_1d_neon(const float* src, float* dst, int len, const DericheCoeffs& c) {
     if (len <= 0) return;
     
+    const int step = Columns * 4;
+    
     // 加载系数到 NEON 寄存器
-    float32x4_t va0 = vdupq_n_f32(c.a0);
-    float32x4_t va1 = vdupq_n_f32(c.a1);
-    float32x4_t va2 = vdupq_n_f32(c.a2);
-    float32x4_t va3 = vdupq_n_f32(c.a3);
-    float32x4_t vb1 = vdupq_n_f32(c.b1);
-    float32x4_t vb2 = vdupq_n_f32(c.b2);
-    float32x4_t vcoefp = vdupq_n_f32(c.coefp);
-    float32x4_t vcoefn = vdupq_n_f32(c.coefn);
+    const float32x4_t va0 = vdupq_n_f32(c.a0);
+    const float32x4_t va1 = vdupq_n_f32(c.a1);
+    const float32x4_t va2 = vdupq_n_f32(c.a2);
+    const float32x4_t va3 = vdupq_n_f32(c.a3);
+    const float32x4_t vb1 = vdupq_n_f32(c.b1);
+    const float32x4_t vb2 = vdupq_n_f32(c.b2);
+    const float32x4_t vcoefp = vdupq_n_f32(c.coefp);
+    const float32x4_t vcoefn = vdupq_n_f32(c.coefn);
     
     // 前向递归（causal）
-    float32x4_t vxp1 = vld1q_f32(src);
-    float32x4_t vyp1 = vmulq_f32(vxp1, vcoefp);
-    float32x4_t vyp2 = vyp1;
+    float32x4_t vxp1[Columns], vyp1[Columns], vyp2[Columns];
+    for (int k = 0; k < Columns; ++k) {
+        vxp1[k] = vld1q_f32(src + k * 4);
+        vyp1[k] = vmulq_f32(vxp1[k], vcoefp);
+        vyp2[k] = vyp1[k];
+    }
     
     for (int i = 0; i < len; ++i) {
-        float32x4_t vxc = vld1q_f32(src + i * 4);
-        
-        // yc = a0*xc + a1*xp1 - b1*yp1 - b2*yp2
-        float32x4_t vyc = vmulq_f32(va0, vxc);
-        vyc = vmlaq_f32(vyc, va1, vxp1);
-        vyc = vmlsq_f32(vyc, vb1, vyp1);
-        vyc = vmlsq_f32(vyc, vb2, vyp2);
-        
-        vst1q_f32(dst + i * 4, vyc);
-        
-        vxp1 = vxc;
-        vyp2 = vyp1;
-        vyp1 = vyc;
+        const float* xs = src + i * step;
+        float* ys = dst + i * step;
+        for (int k = 0; k < Columns; ++k) {
+            float32x4_t vxc = vld1q_f32(xs + k * 4);
+            
+            // yc = a0*xc + a1*xp1 - b1*yp1 - b2*yp2
+            float32x4_t vyc = vmulq_f32(va0, vxc);
+            vyc = vmlaq_f32(vyc, va1, vxp1[k]);
+            vyc = vmlsq_f32(vyc, vb1, vyp1[k]);
+            vyc = vmlsq_f32(vyc, vb2, vyp2[k]);
+            
+            vst1q_f32(ys + k * 4, vyc);
+            
+            vxp1[k] = vxc;
+            vyp2[k] = vyp1[k];
+            vyp1[k] = vyc;
+        }
     }
     
     // 后向递归（anti-causal）
-    float32x4_t vxn1 = vld1q_f32(src + (len - 1) * 4);
-    float32x4_t vxn2 = vxn1;  // 初始化 xn2
-    float32x4_t vyn1 = vmulq_f32(vxn1, vcoefn);
-    float32x4_t vyn2 = vyn1;
-
+    float32x4_t vxn1[Columns], vxn2[Columns], vyn1[Columns], vyn2[Columns];
+    const float* last = src + (len - 1) * step;
+    for (int k = 0; k < Columns; ++k) {
+        vxn1[k] = vld1q_f32(last + k * 4);
+        vxn2[k] = vxn1[k];
+        vyn1[k] = vmulq_f32(vxn1[k], vcoefn);
+        vyn2[k] = vyn1[k];
+    }
+    
     for (int i = len - 1; i >= 0; --i) {
-        float32x4_t vxc = vld1q_f32(src + i * 4);
+        const float* xs = src + i * step;
+        float* ys = dst + i * step;
+        for (int k = 0; k < Columns; ++k) {
+            float32x4_t vxc = vld1q_f32(xs + k * 4);
+            
+            // yc = a2*xn1 + a3*xn2 - b1*yn1 - b2*yn2
+            float32x4_t vyc = vmulq_f32(va2, vxn1[k]);
+            vyc = vmlaq_f32(vyc, va3, vxn2[k]);
+            vyc = vmlsq_f32(vyc, vb1, vyn1[k]);
+            vyc = vmlsq_f32(vyc, vb2, vyn2[k]);
+            
+            // 累加前向和后向结果
+            vst1q_f32(ys + k * 4, vaddq_f32(vld1q_f32(ys + k * 4), vyc));
+            
+            vxn2[k] = vxn1[k];
+            vxn1[k] = vxc;
+            vyn2[k] = vyn1[k];
+            vyn1[k] = vyc;
+        }
+    }
+}
+
+/**
+ * float [0,1] → uint32（钳位 + 四舍五入）
+ */
+static inline uint32x4_t quantize4_neon(float32x4_t v) {
+    v = vmaxq_f32(vminq_f32(v, vdupq_n_f32(1.0f)), vdupq_n_f32(0.0f));
+    return vcvtq_u32_f32(vmlaq_n_f32(vdupq_n_f32(0.5f), v, 255.0f));
+}
+
+/**
+ * 8 个 RGBA8888 像素 → 交错 float（每像素 4 个 float，按字节顺序）
+ *
+ * vld4_u8 解交错 → vmovl_u8/vmovl_u16 拓宽 → vcvtq_f32_u32（Linear 时颜色通道查表转为预乘线性值）
+ * → vst4q_f32 交错写回
+ */
+template <bool Linear>
+static inline void unpack8_neon(const ColorLut& lut, const uint8_t* src, float* dst) {
+    const float32x4_t vinv255 = vdupq_n_f32(1.0f / 255.0f);
+    uint8x8x4_t in = vld4_u8(src);
+
+    uint32x4_t intLo[4], intHi[4];
+    for (int k = 0; k < 4; ++k) {
+        uint16x8_t w16 = vmovl_u8(in.val[k]);
+        intLo[k] = vmovl_u16(vget_low_u16(w16));
+        intHi[k] = vmovl_u16(vget_high_u16(w16));
+    }
 
-        // yc = a2*xn1 + a3*xn2 - b1*yn1 - b2*yn2
-        float32x4_t vyc = vmulq_f32(va2, vxn1);
-        vyc = vmlaq_f32(vyc, va3, vxn2);
-        vyc = vmlsq_f32(vyc, vb1, vyn1);
-        vyc = vmlsq_f32(vyc, vb2, vyn2);
+    float32x4x4_t lo, hi;
+    for (int k = 0; k < 4; ++k) {
+        if (Linear && k != BitmapLayout::A) {
+            lo.val[k] = color_lut_to_linear4_neon(lut, intLo[k], intLo[BitmapLayout::A]);
+            hi.val[k] = color_lut_to_linear4_neon(lut, intHi[k], intHi[BitmapLayout::A]);
+        } else {
+            lo.val[k] = vmulq_f32(vcvtq_f32_u32(intLo[k]), vinv255);
+            hi.val[k] = vmulq_f32(vcvtq_f32_u32(intHi[k]), vinv255);
+        }
+    }
 
-        // 累加前向和后向结果
-        float32x4_t vsum = vaddq_f32(vld1q_f32(dst + i * 4), vyc);
-        vst1q_f32(dst + i * 4, vsum);
+    vst4q_f32(dst, lo);
+    vst4q_f32(dst + 16, hi);
+}
 
-        vxn2 = vxn1;
-        vxn1 = vxc;
-        vyn2 = vyn1;
-        vyn1 = vyc;
+/**
+ * 交错 float → 8 个 RGBA8888 像素（unpack8_neon 的逆过程）
+ *
+ * vld4q_f32 解交错 → 钳位量化（Linear 时先量化 Alpha，颜色通道按量化后的 Alpha 查表还原）
+ * → vmovn 窄化 → vst4_u8 交错写回
+ *
+ * Matrix 时在打包前套用颜色矩阵：非线性模式直接作用于浮点结果；
+ * 线性模式矩阵定义在 sRGB 空间，作用于查表还原后的寄存器值
+ */
+template <bool Linear, bool Matrix>
+static inline void pack8_neon(const ColorLut& lut, const ColorMatrix* cm, const float* src, uint8_t* dst) {
+    float32x4x4_t lo = vld4q_f32(src);
+    float32x4x4_t hi = vld4q_f32(src + 16);
+
+    if (Matrix && !Linear) {
+        color_matrix_apply4_neon(*cm, lo);
+        color_matrix_apply4_neon(*cm, hi);
+    }
+
+    const uint32x4_t alphaLo = quantize4_neon(lo.val[BitmapLayout::A]);
+    const uint32x4_t alphaHi = quantize4_neon(hi.val[BitmapLayout::A]);
+
+    uint8x8x4_t out;
+    for (int k = 0; k < 4; ++k) {
+        uint32x4_t qLo, qHi;
+        if (k == BitmapLayout::A) {
+            qLo = alphaLo;
+            qHi = alphaHi;
+        } else if (Linear) {
+            qLo = color_lut_to_srgb4_neon(lut, lo.val[k], alphaLo);
+            qHi = color_lut_to_srgb4_neon(lut, hi.val[k], alphaHi);
+        } else {
+            qLo = quantize4_neon(lo.val[k]);
+            qHi = quantize4_neon(hi.val[k]);
+        }
+        out.val[k] = vmovn_u16(vcombine_u16(vmovn_u32(qLo), vmovn_u32(qHi)));
+    }
+    if (Matrix && Linear) {
+        color_matrix_apply8_neon(*cm, out);
+    }
+    vst4_u8(dst, out);
+}
+
+/**
+ * 连续 n 个像素 uint8 → 交错 float
+ *
+ * 尾部不足 8 像素时借助栈上临时缓冲区补齐，仍走向量路径
+ */
+template <bool Linear>
+static void pixels_to_float_neon(const ColorLut& lut, const uint8_t* src, float* dst, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        unpack8_neon<Linear>(lut, src + i * 4, dst + i * 4);
+    }
+    if (i < n) {
+        const int rem = n - i;
+        uint8_t tmpIn[32] = {0};
+        float tmpOut[32];
+        memcpy(tmpIn, src + i * 4, rem * 4);
+        unpack8_neon<Linear>(lut, tmpIn, tmpOut);
+        memcpy(dst + i * 4, tmpOut, rem * 4 * sizeof(float));
+    }
+}
+
+/**
+ * 交错 float → 连续 n 个像素 uint8（Matrix 时 cm 非空）
+ */
+template <bool Linear, bool Matrix>
+static void float_to_pixels_neon(const ColorLut& lut, const ColorMatrix* cm, const float* src, uint8_t* dst, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        pack8_neon<Linear, Matrix>(lut, cm, src + i * 4, dst + i * 4);
+    }
+    if (i < n) {
+        const int rem = n - i;
+        float tmpIn[32] = {0};
+        uint8_t tmpOut[32];
+        memcpy(tmpIn, src + i * 4, rem * 4 * sizeof(float));
+        pack8_neon<Linear, Matrix>(lut, cm, tmpIn, tmpOut);
+        memcpy(dst + i * 4, tmpOut, rem * 4);
     }
 }
 
 /**
  * 横向模糊（NEON 优化）
+ *
+ * 转换、滤波、打包全程向量化，行内像素连续可直接批量处理
  */
+template <bool Linear>
 static void blur_horizontal_neon(
     uint8_t* base,
     int w,
-    int h,
+    int rowBegin,
+    int rowEnd,
     int stride,
     const DericheCoeffs& c,
-    float* rowBuf,
-    bool doLinear
+    float* inBuf,
+    float* outBuf,
+    TraceSubStages& stages
 ) {
-    const float inv255 = 1.0f / 255.0f;
+    const ColorLut& lut = color_lut();
+    StageTimer timer;
+    uint64_t convertNs = 0, packNs = 0;
     
-    for (int y = 0; y < h; ++y) {
+    for (int y = rowBegin; y < rowEnd; ++y) {
         uint8_t* row = base + y * stride;
         
         // uint8 → float，可选色彩空间转换
-        for (int x = 0; x < w; ++x) {
-            uint32_t px = reinterpret_cast<uint32_t*>(row)[x];
-            float a = ((px >> 24) & 0xFF) * inv255;
-            float r = ((px >> 16) & 0xFF) * inv255;
-            float g = ((px >> 8) & 0xFF) * inv255;
-            float b = (px & 0xFF) * inv255;
-            
-            if (doLinear && a > 1e-5f) {
-                float invA = 1.0f / a;
-                r *= invA; g *= invA; b *= invA;
-                
-                float32x4_t vrgb = {r, g, b, 0.0f};
-                vrgb = srgb_to_linear_neon(vrgb);
-                r = vgetq_lane_f32(vrgb, 0);
-                g = vgetq_lane_f32(vrgb, 1);
-                b = vgetq_lane_f32(vrgb, 2);
-                
-                r *= a; g *= a; b *= a;
-            }
-            
-            rowBuf[x * 4 + 0] = r;
-            rowBuf[x * 4 + 1] = g;
-            rowBuf[x * 4 + 2] = b;
-            rowBuf[x * 4 + 3] = a;
-        }
+        pixels_to_float_neon<Linear>(lut, row, inBuf, w);
+        convertNs += timer.lap();
         
         // IIR 滤波（NEON 向量化）
-        iir_filter_1d_neon(rowBuf, rowBuf, w, c);
+        iir_filter_1d_neon<1>(inBuf, outBuf, w, c);
+        timer.lap();
         
         // float → uint8，可选色彩空间转换
-        for (int x = 0; x < w; ++x) {
-            float r = rowBuf[x * 4 + 0];
-            float g = rowBuf[x * 4 + 1];
-            float b = rowBuf[x * 4 + 2];
-            float a = rowBuf[x * 4 + 3];
-            
-            if (doLinear && a > 1e-5f) {
-                float invA = 1.0f / a;
-                r *= invA; g *= invA; b *= invA;
-                
-                float32x4_t vrgb = {r, g, b, 0.0f};
-                vrgb = linear_to_srgb_neon(vrgb);
-                r = vgetq_lane_f32(vrgb, 0);
-                g = vgetq_lane_f32(vrgb, 1);
-                b = vgetq_lane_f32(vrgb, 2);
-                
-                r *= a; g *= a; b *= a;
-            }
-            
-            r = std::max(0.0f, std::min(1.0f, r));
-            g = std::max(0.0f, std::min(1.0f, g));
-            b = std::max(0.0f, std::min(1.0f, b));
-            a = std::max(0.0f, std::min(1.0f, a));
-            
-            uint32_t px = (static_cast<uint32_t>(a * 255.0f + 0.5f) << 24) |
-                          (static_cast<uint32_t>(r * 255.0f + 0.5f) << 16) |
-                          (static_cast<uint32_t>(g * 255.0f + 0.5f) << 8) |
-                          static_cast<uint32_t>(b * 255.0f + 0.5f);
-            reinterpret_cast<uint32_t*>(row)[x] = px;
-        }
+        float_to_pixels_neon<Linear, false>(lut, nullptr, outBuf, row, w);
+        packNs += timer.lap();
     }
+    
+    stages.add(convertNs, packNs);
 }
 
 /**
- * 纵向模糊（NEON 优化）
+ * 纵向模糊（NEON 优化，按列块处理）
+ *
+ * 每次处理 kColumnTile 个相邻列：逐行把一段连续像素转换进 [y][列][RGBA] 缓冲，
+ * 同一行的缓存行被整块列复用，避免逐列跨 stride 读取带来的缓存缺失。
+ * 纵向为最后一遍，颜色矩阵（Matrix）在这里的打包阶段套用。
  */
+template <bool Linear, bool Matrix>
 static void blur_vertical_neon(
     uint8_t* base,
     int w,
     int h,
     int stride,
     const DericheCoeffs& c,
-    float* colBuf,
-    bool doLinear
+    const ColorMatrix* cm,
+    int tileBegin,
+    int tileEnd,
+    float* inBuf,
+    float* outBuf,
+    TraceSubStages& stages
 ) {
-    const float inv255 = 1.0f / 255.0f;
+    const int step = kColumnTile * 4;
+    const ColorLut& lut = color_lut();
+    StageTimer timer;
+    uint64_t convertNs = 0, packNs = 0;
     
-    for (int x = 0; x < w; ++x) {
+    for (int tile = tileBegin; tile < tileEnd; ++tile) {
+        const int x0 = tile * kColumnTile;
+        const int n = std::min(kColumnTile, w - x0);
+        
+        // 不足一块时，未用列保持为 0（各列独立，不影响结果）
+        if (n < kColumnTile) {
+            memset(inBuf, 0, h * step * sizeof(float));
+        }
+        
         // uint8 → float
         for (int y = 0; y < h; ++y) {
-            uint8_t* row = base + y * stride;
-            uint32_t px = reinterpret_cast<uint32_t*>(row)[x];
-            float a = ((px >> 24) & 0xFF) * inv255;
-            float r = ((px >> 16) & 0xFF) * inv255;
-            float g = ((px >> 8) & 0xFF) * inv255;
-            float b = (px & 0xFF) * inv255;
-            
-            if (doLinear && a > 1e-5f) {
-                float invA = 1.0f / a;
-                r *= invA; g *= invA; b *= invA;
-                
-                float32x4_t vrgb = {r, g, b, 0.0f};
-                vrgb = srgb_to_linear_neon(vrgb);
-                r = vgetq_lane_f32(vrgb, 0);
-                g = vgetq_lane_f32(vrgb, 1);
-                b = vgetq_lane_f32(vrgb, 2);
-                
-                r *= a; g *= a; b *= a;
-            }
-            
-            colBuf[y * 4 + 0] = r;
-            colBuf[y * 4 + 1] = g;
-            colBuf[y * 4 + 2] = b;
-            colBuf[y * 4 + 3] = a;
+            pixels_to_float_neon<Linear>(lut, base + y * stride + x0 * 4, inBuf + y * step, n);
         }
+        convertNs += timer.lap();
         
-        // IIR 滤波（NEON 向量化）
-        iir_filter_1d_neon(colBuf, colBuf, h, c);
+        // IIR 滤波（整块列一起递归）
+        iir_filter_1d_neon<kColumnTile>(inBuf, outBuf, h, c);
+        timer.lap();
         
         // float → uint8
         for (int y = 0; y < h; ++y) {
-            float r = colBuf[y * 4 + 0];
-            float g = colBuf[y * 4 + 1];
-            float b = colBuf[y * 4 + 2];
-            float a = colBuf[y * 4 + 3];
-            
-            if (doLinear && a > 1e-5f) {
-                float invA = 1.0f / a;
-                r *= invA; g *= invA; b *= invA;
-                
-                float32x4_t vrgb = {r, g, b, 0.0f};
-                vrgb = linear_to_srgb_neon(vrgb);
-                r = vgetq_lane_f32(vrgb, 0);
-                g = vgetq_lane_f32(vrgb, 1);
-                b = vgetq_lane_f32(vrgb, 2);
-                
-                r *= a; g *= a; b *= a;
-            }
-            
-            r = std::max(0.0f, std::min(1.0f, r));
-            g = std::max(0.0f, std::min(1.0f, g));
-            b = std::max(0.0f, std::min(1.0f, b));
-            a = std::max(0.0f, std::min(1.0f, a));
-            
-            uint8_t* row = base + y * stride;
-            uint32_t px = (static_cast<uint32_t>(a * 255.0f + 0.5f) << 24) |
-                          (static_cast<uint32_t>(r * 255.0f + 0.5f) << 16) |
-                          (static_cast<uint32_t>(g * 255.0f + 0.5f) << 8) |
-                          static_cast<uint32_t>(b * 255.0f + 0.5f);
-            reinterpret_cast<uint32_t*>(row)[x] = px;
+            float_to_pixels_neon<Linear, Matrix>(lut, cm, outBuf + y * step, base + y * stride + x0 * 4, n);
         }
+        packNs += timer.lap();
+    }
+    
+    stages.add(convertNs, packNs);
+}
+
+/**
+ * 按 doLinear（与是否有颜色矩阵）选择的行 / 列块内核（编译期展开，热循环内无色彩空间分支）
+ */
+typedef void (*HorizontalKernelNeon)(uint8_t*, int, int, int, int, const DericheCoeffs&, float*, float*, TraceSubStages&);
+typedef void (*VerticalKernelNeon)(uint8_t*, int, int, int, const DericheCoeffs&, const ColorMatrix*, int, int, float*, float*, TraceSubStages&);
+
+static const HorizontalKernelNeon kHorizontalKernelsNeon[2] = {
+    blur_horizontal_neon<false>, blur_horizontal_neon<true>
+};
+static const VerticalKernelNeon kVerticalKernelsNeon[2][2] = {
+    { blur_vertical_neon<false, false>, blur_vertical_neon<false, true> },
+    { blur_vertical_neon<true, false>, blur_vertical_neon<true, true> }
+};
+
+/**
+ * NEON 内核（调用方已检查参数与 σ）
+ */
+static void gaussian_iir_neon_kernel(
+    uint8_t* base,
+    int w,
+    int h,
+    int stride,
+    float sigma,
+    bool doLinear,
+    const ColorMatrix* colorMatrix
+) {
+    TraceScope total(TRACE_FILTER_IIR_NEON, TRACE_STAGE_TOTAL);
+    TraceSubStages stages;
+    
+    DericheCoeffs c = compute_deriche_coeffs(sigma);
+    
+    // 每个线程输入/输出各一份：横向 w × 4，纵向 h × 列块 × 4
+    const int bufLen = std::max(w * 4, h * kColumnTile * 4);
+    const int threads = thread_pool_concurrency();
+    TraceScope allocScope(TRACE_FILTER_IIR_NEON, TRACE_STAGE_ALLOC);
+    ScratchBuffer work(sizeof(float) * bufLen * 2 * threads);
+    allocScope.stop();
+    if (!work) {
+        LOGE("Failed to allocate work buffer: %dx%d", w, h);
+        return;
+    }
+    float* workBuf = work.as<float>();
+    const HorizontalKernelNeon horizontal = kHorizontalKernelsNeon[doLinear ? 1 : 0];
+    const VerticalKernelNeon vertical = kVerticalKernelsNeon[doLinear ? 1 : 0][colorMatrix ? 1 : 0];
+    
+    // 横向：按行分块
+    {
+        TraceScope scope(TRACE_FILTER_IIR_NEON, TRACE_STAGE_HORIZONTAL);
+        parallel_for(0, h, parallel_rows_grain(w), [&](int y0, int y1, int slot) {
+            float* buf = workBuf + slot * bufLen * 2;
+            horizontal(base, w, y0, y1, stride, c, buf, buf + bufLen, stages);
+        });
     }
+    
+    // 纵向：按列块条带分块
+    {
+        TraceScope scope(TRACE_FILTER_IIR_NEON, TRACE_STAGE_VERTICAL);
+        const int tiles = (w + kColumnTile - 1) / kColumnTile;
+        parallel_for(0, tiles, parallel_rows_grain(h * kColumnTile), [&](int t0, int t1, int slot) {
+            float* buf = workBuf + slot * bufLen * 2;
+            vertical(base, w, h, stride, c, colorMatrix, t0, t1, buf, buf + bufLen, stages);
+        });
+    }
+    
+    stages.record(TRACE_FILTER_IIR_NEON);
 }
 
 #endif // NEON_AVAILABLE
@@ -314,11 +457,11 @@ static void blur_vertical_neon(
 
 bool has_neon_support() {
 #if NEON_AVAILABLE
-    // 编译时检测：如果编译了 NEON 代码，则设备必然支持 NEON
-    // 因为 Android 构建系统会为不同 ABI 生成不同的库
-    return true;
+    return cpu_has_features(CPU_FEATURE_NEON);
 #else
-    return false;
+    // x86：SSE4.1 / AVX2 内核同样经 gaussian_iir_rgba8888_neon 进入
+    return gaussian_iir_x86_kernels_compiled() &&
+           (cpu_features() & (CPU_FEATURE_SSE41 | CPU_FEATURE_AVX2)) != 0;
 #endif
 }
 
@@ -328,27 +471,40 @@ void gaussian_iir_rgba8888_neon(
     int h,
     int stride,
     float sigma,
-    bool doLinear
+    bool doLinear,
+    const ColorMatrix* colorMatrix
 ) {
-#if NEON_AVAILABLE
-    if (sigma <= 0.1f || w <= 0 || h <= 0 || !base) {
+    if (w <= 0 || h <= 0 || !base) {
+        return;
+    }
+    if (sigma <= 0.1f) {
+        // 不模糊时仍需套用颜色矩阵
+        if (colorMatrix) color_matrix_rgba8888_inplace(base, w, h, stride, *colorMatrix);
         return;
     }
     
-    DericheCoeffs c = compute_deriche_coeffs(sigma);
-    
-    int maxDim = std::max(w, h);
-    float* workBuf = new float[maxDim * 4];
-    
-    blur_horizontal_neon(base, w, h, stride, c, workBuf, doLinear);
-    blur_vertical_neon(base, w, h, stride, c, workBuf, doLinear);
-    
-    delete[] workBuf;
-    
-    LOGD("NEON blur: %dx%d, sigma=%.2f, linear=%d", w, h, sigma, doLinear);
+    // 后端选择：NEON；x86 上 AVX2 > SSE4.1
+#if NEON_AVAILABLE
+    if (cpu_has_features(CPU_FEATURE_NEON)) {
+        gaussian_iir_neon_kernel(base, w, h, stride, sigma, doLinear, colorMatrix);
+        return;
+    }
 #else
-    LOGE("NEON not available at compile time");
+    if (gaussian_iir_x86_kernels_compiled()) {
+        if (cpu_has_features(CPU_FEATURE_AVX2)) {
+            gaussian_iir_rgba8888_avx2_kernel(base, w, h, stride, sigma, doLinear, colorMatrix);
+            return;
+        }
+        if (cpu_has_features(CPU_FEATURE_SSE41)) {
+            gaussian_iir_rgba8888_sse41_kernel(base, w, h, stride, sigma, doLinear, colorMatrix);
+            return;
+        }
+    }
 #endif
+    
+    // 无可用向量后端（或已通过 cpu_features_set_disabled 屏蔽）：标量回退
+    gaussian_iir_rgba8888_inplace(base, w, h, stride, sigma, doLinear);
+    if (colorMatrix) color_matrix_rgba8888_inplace(base, w, h, stride, *colorMatrix);
 }
 
 void gaussian_iir_rgba8888_neon_fast(
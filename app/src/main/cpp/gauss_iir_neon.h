@@ -12,11 +12,14 @@
  *   1. SIMD 并行处理 4 个通道
  *   2. 减少循环开销
  *   3. 更好的指令流水线利用
+ *   4. uint8 ↔ float 转换、预乘/线性化、钳位打包全部向量化（每次 8 像素），
+ *      doLinear=true 时不再退化为逐像素标量处理
  * 
  * 兼容性：
  * - ARMv7 (armeabi-v7a): 需要 NEON 支持（大部分设备支持）
  * - ARMv8 (arm64-v8a): 默认支持 NEON
- * - 运行时检测：使用 android_getCpuFeatures() 检测 NEON 支持
+ * - 运行时检测：cpu_features()（getauxval / CPUID，见 cpu_features.h）
+ * - x86 / x86_64：同一入口分派到 SSE4.1 / AVX2 内核（gauss_iir_x86.h）
  * 
  * 使用建议：
  * - 优先使用 NEON 版本（如果硬件支持）
@@ -30,10 +33,15 @@
 #include <cstdint>
 #include <cstddef>
 
+struct ColorMatrix;
+
 /**
- * 检测当前设备是否支持 NEON
+ * 检测当前设备是否有向量 IIR 后端
+ * 
+ * 历史名称：ARM 上为 NEON；x86 上为 SSE4.1 / AVX2（同样通过 gaussian_iir_rgba8888_neon 调用）。
+ * 受 cpu_features_set_disabled() 影响
  * 
- * @return true 如果支持 NEON，false 否则
+ * @return true 如果 gaussian_iir_rgba8888_neon 会走向量内核，false 否则
  */
 bool has_neon_support();
 
@@ -46,11 +54,12 @@ bool has_neon_support();
  * @param stride 行跨度（字节数）
  * @param sigma 高斯标准差
  * @param doLinear 是否在线性色彩空间处理
+ * @param colorMatrix 可选颜色矩阵（见 color_matrix.h），在最后一遍的打包阶段套用；
+ *                    nullptr 表示不套用。线性模式下矩阵作用于 sRGB 值
  * 
  * 注意：
- * - 仅在支持 NEON 的设备上调用
- * - 调用前应使用 has_neon_support() 检测
- * - 如果不支持 NEON，应回退到标量版本
+ * - 后端按 cpu_features() 选择：NEON；x86 上 AVX2 > SSE4.1
+ * - 没有可用的向量后端时回退到标量版本（gaussian_iir_rgba8888_inplace + 单独一遍颜色矩阵）
  */
 void gaussian_iir_rgba8888_neon(
     uint8_t* base,
@@ -58,7 +67,8 @@ void gaussian_iir_rgba8888_neon(
     int h,
     int stride,
     float sigma,
-    bool doLinear
+    bool doLinear,
+    const ColorMatrix* colorMatrix = nullptr
 );
 
 /**
@@ -0,0 +1,467 @@
+/**
+ * gauss_iir_stream.cpp - 流式 IIR 高斯模糊实现
+ *
+ * 行状态（行号均为图像坐标，pulled ≤ done ≤ pushed）：
+ * - [pulled, done)：纵向已完成，等待取走
+ * - [done, pushed)：只做了横向，等待凑齐一块 + 向下看的 L 行
+ * - 两段共用一个 ringRows 行的环形缓冲（第 y 行位于 y % ringRows），纵向结果原位写回
+ *
+ * 纵向块 [b0, b1)，向下看到 e = min(height, b1 + L)：
+ * - 列块（kColumnTile 列）读入 [b0, e) 行，反因果 pass 从 e - 1 行以稳态初始化向上递推，
+ *   只保留 [b0, b1) 的结果
+ * - 因果 pass 从上一块末尾保存的状态（xp1, yp1, yp2）继续，两者相加写回
+ * - 块大小 B = clamp(2L, 32, 256)：反因果 pass 的重复计算比例为 (B + L) / B
+ *
+ * 横向 pass 与 gaussian_iir_rgba8888_inplace 完全相同（同一 Deriche 系数、稳态边界、uint8 中间结果）
+ */
+
+#include "gauss_iir_stream.h"
+#include "color_lut.h"
+#include "pixel_layout.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <android/log.h>
+
+#define LOG_TAG "GaussIIRStream"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// Deriche 系数结构（与 gauss_iir.cpp 相同）
+struct DericheCoeffs {
+    float a0, a1, a2, a3; // 前向/后向系数
+    float b1, b2;         // 递归系数
+    float coefp, coefn;   // 边界增益补偿
+};
+
+/**
+ * 计算 Deriche IIR 滤波器系数（与 gauss_iir.cpp 相同）
+ */
+static DericheCoeffs compute_deriche_coeffs(float sigma) {
+    DericheCoeffs c;
+
+    double alpha = 1.695 / sigma;
+    double ema = exp(-alpha);
+    double ema2 = ema * ema;
+
+    c.b1 = static_cast<float>(-2.0 * ema);
+    c.b2 = static_cast<float>(ema2);
+
+    double k = (1.0 - ema) * (1.0 - ema) / (1.0 + 2.0 * alpha * ema - ema2);
+
+    c.a0 = static_cast<float>(k);
+    c.a1 = static_cast<float>(k * ema * (alpha - 1.0));
+    c.a2 = static_cast<float>(k * ema * (alpha + 1.0));
+    c.a3 = static_cast<float>(-k * ema2);
+
+    c.coefp = static_cast<float>((c.a0 + c.a1) / (1.0 + c.b1 + c.b2));
+    c.coefn = static_cast<float>((c.a2 + c.a3) / (1.0 + c.b1 + c.b2));
+
+    return c;
+}
+
+// 纵向列块：一次行访问读取 8 个相邻像素（32 字节）
+static const int kColumnTile = 8;
+static const int kTileLanes = kColumnTile * 4;
+
+// 块大小范围（行）
+static const int kMinBlockRows = 32;
+static const int kMaxBlockRows = 256;
+
+// 反因果 pass 向下看的行数 L = ⌈kσ⌉（与 glass_blur_support 的 4σ / 6σ 一致）：
+// 线性模式下截断误差经 sRGB 编码在暗部放大约 12.92 倍，4σ 会差出 8 LSB，需取 6σ
+static const float kLookaheadSigmas = 4.0f;
+static const float kLinearLookaheadSigmas = 6.0f;
+
+struct GaussianIIRStream {
+    int width = 0;
+    int height = 0;
+    bool linear = false;
+    bool passthrough = false;   // σ ≤ 0.1：原样输出
+    DericheCoeffs c;
+    int lookahead = 0;          // L：反因果 pass 向下看的行数
+    int blockRows = 0;          // B
+    int ringRows = 0;           // 环形缓冲行数 min(height, B + L)
+    int tiles = 0;              // 列块数
+
+    std::vector<uint8_t> ring;  // ringRows × width × 4
+    std::vector<float> causal;  // 每个列块 xp1 / yp1 / yp2 各 kTileLanes
+
+    int pushed = 0;
+    int done = 0;
+    int pulled = 0;
+};
+
+static inline uint8_t* ring_row(GaussianIIRStream* s, int y) {
+    return s->ring.data() + static_cast<size_t>(y % s->ringRows) * s->width * 4;
+}
+
+/**
+ * 一维 IIR 递归滤波（与 gauss_iir.cpp 的 iir_filter_1d 相同，用于横向 pass）
+ */
+template <int Lanes>
+static void iir_filter_1d(const float* __restrict src, float* __restrict dst, int len, const DericheCoeffs& c) {
+    if (len <= 0) return;
+
+    float xp1[Lanes], yp1[Lanes], yp2[Lanes];
+    float xn1[Lanes], xn2[Lanes], yn1[Lanes], yn2[Lanes];
+
+    for (int j = 0; j < Lanes; ++j) {
+        xp1[j] = src[j];
+        yp1[j] = src[j] * c.coefp;
+        yp2[j] = yp1[j];
+    }
+
+    for (int i = 0; i < len; ++i) {
+        const float* xc = src + i * Lanes;
+        float* yc = dst + i * Lanes;
+        for (int j = 0; j < Lanes; ++j) {
+            float y = c.a0 * xc[j] + c.a1 * xp1[j] - c.b1 * yp1[j] - c.b2 * yp2[j];
+            yc[j] = y;
+            xp1[j] = xc[j];
+            yp2[j] = yp1[j]; yp1[j] = y;
+        }
+    }
+
+    const float* last = src + (len - 1) * Lanes;
+    for (int j = 0; j < Lanes; ++j) {
+        xn1[j] = last[j];
+        xn2[j] = last[j];
+        yn1[j] = last[j] * c.coefn;
+        yn2[j] = yn1[j];
+    }
+
+    for (int i = len - 1; i >= 0; --i) {
+        const float* xc = src + i * Lanes;
+        float* yc = dst + i * Lanes;
+        for (int j = 0; j < Lanes; ++j) {
+            float y = c.a2 * xn1[j] + c.a3 * xn2[j] - c.b1 * yn1[j] - c.b2 * yn2[j];
+            yc[j] += y;
+            xn2[j] = xn1[j]; xn1[j] = xc[j];
+            yn2[j] = yn1[j]; yn1[j] = y;
+        }
+    }
+}
+
+/**
+ * 像素 → 浮点（与 gauss_iir.cpp 相同）
+ */
+template <bool Linear, typename Layout>
+static inline void load_pixel(const ColorLut& lut, const uint8_t* pixel, float* out) {
+    if (Linear) {
+        const int a = pixel[Layout::A];
+        out[0] = color_lut_to_linear(lut, pixel[Layout::R], a);
+        out[1] = color_lut_to_linear(lut, pixel[Layout::G], a);
+        out[2] = color_lut_to_linear(lut, pixel[Layout::B], a);
+        out[3] = a / 255.0f;
+        return;
+    }
+
+    out[0] = pixel[Layout::R] / 255.0f;
+    out[1] = pixel[Layout::G] / 255.0f;
+    out[2] = pixel[Layout::B] / 255.0f;
+    out[3] = pixel[Layout::A] / 255.0f;
+}
+
+/**
+ * 浮点 → 像素（与 gauss_iir.cpp 相同）
+ */
+template <bool Linear, typename Layout>
+static inline void store_pixel(const ColorLut& lut, const float* in, uint8_t* pixel) {
+    const float fa = std::max(0.0f, std::min(1.0f, in[3]));
+    const int a = static_cast<int>(fa * 255.0f + 0.5f);
+
+    if (Linear) {
+        pixel[Layout::R] = color_lut_to_srgb8(lut, in[0], a);
+        pixel[Layout::G] = color_lut_to_srgb8(lut, in[1], a);
+        pixel[Layout::B] = color_lut_to_srgb8(lut, in[2], a);
+        pixel[Layout::A] = static_cast<uint8_t>(a);
+        return;
+    }
+
+    int r = static_cast<int>(std::max(0.0f, std::min(255.0f, in[0] * 255.0f + 0.5f)));
+    int g = static_cast<int>(std::max(0.0f, std::min(255.0f, in[1] * 255.0f + 0.5f)));
+    int b = static_cast<int>(std::max(0.0f, std::min(255.0f, in[2] * 255.0f + 0.5f)));
+
+    pixel[Layout::R] = static_cast<uint8_t>(r);
+    pixel[Layout::G] = static_cast<uint8_t>(g);
+    pixel[Layout::B] = static_cast<uint8_t>(b);
+    pixel[Layout::A] = static_cast<uint8_t>(a);
+}
+
+/**
+ * 横向模糊输入行 [i0, i1)，写入环形缓冲第 first + i 行
+ *
+ * @param inBuf  输入缓冲（w × 4 浮点）
+ * @param outBuf 输出缓冲（w × 4 浮点）
+ */
+template <bool Linear>
+static void filter_rows(
+    GaussianIIRStream* s,
+    const uint8_t* rows, int stride,
+    int first, int i0, int i1,
+    float* inBuf, float* outBuf
+) {
+    const ColorLut& lut = color_lut();
+    const int w = s->width;
+
+    for (int i = i0; i < i1; ++i) {
+        const uint8_t* src = rows + static_cast<size_t>(i) * stride;
+        uint8_t* dst = ring_row(s, first + i);
+
+        for (int x = 0; x < w; ++x) {
+            load_pixel<Linear, BitmapLayout>(lut, src + x * 4, inBuf + x * 4);
+        }
+        iir_filter_1d<4>(inBuf, outBuf, w, s->c);
+        for (int x = 0; x < w; ++x) {
+            store_pixel<Linear, BitmapLayout>(lut, outBuf + x * 4, dst + x * 4);
+        }
+    }
+}
+
+/**
+ * 纵向模糊块 [b0, b1)（列块 [t0, t1)），反因果 pass 向下看到 e 行
+ *
+ * @param tileBuf 列块输入（(e - b0) × kTileLanes 浮点）
+ * @param antiBuf 列块输出（(b1 - b0) × kTileLanes 浮点）
+ */
+template <bool Linear>
+static void filter_block(
+    GaussianIIRStream* s,
+    int b0, int b1, int e,
+    int t0, int t1,
+    float* tileBuf, float* antiBuf
+) {
+    const ColorLut& lut = color_lut();
+    const DericheCoeffs& c = s->c;
+    const int rows = e - b0;
+
+    for (int tile = t0; tile < t1; ++tile) {
+        const int x0 = tile * kColumnTile;
+        const int n = std::min(kColumnTile, s->width - x0);
+
+        // 不足一块时，未用列保持为 0（各列独立，不影响结果）
+        if (n < kColumnTile) {
+            memset(tileBuf, 0, rows * kTileLanes * sizeof(float));
+        }
+        for (int y = b0; y < e; ++y) {
+            const uint8_t* row = ring_row(s, y) + x0 * 4;
+            float* dst = tileBuf + (y - b0) * kTileLanes;
+            for (int k = 0; k < n; ++k) {
+                load_pixel<Linear, BitmapLayout>(lut, row + k * 4, dst + k * 4);
+            }
+        }
+
+        // 反因果 pass：e - 1 行稳态初始化（e 为图像底边时与整帧版本相同）
+        float xn1[kTileLanes], xn2[kTileLanes], yn1[kTileLanes], yn2[kTileLanes];
+        const float* last = tileBuf + (rows - 1) * kTileLanes;
+        for (int j = 0; j < kTileLanes; ++j) {
+            xn1[j] = last[j];
+            xn2[j] = last[j];
+            yn1[j] = last[j] * c.coefn;
+            yn2[j] = yn1[j];
+        }
+
+        // 向下看的行只用于推进状态
+        for (int i = rows - 1; i >= b1 - b0; --i) {
+            const float* xc = tileBuf + i * kTileLanes;
+            for (int j = 0; j < kTileLanes; ++j) {
+                float y = c.a2 * xn1[j] + c.a3 * xn2[j] - c.b1 * yn1[j] - c.b2 * yn2[j];
+                xn2[j] = xn1[j]; xn1[j] = xc[j];
+                yn2[j] = yn1[j]; yn1[j] = y;
+            }
+        }
+        for (int i = b1 - b0 - 1; i >= 0; --i) {
+            const float* xc = tileBuf + i * kTileLanes;
+            float* yc = antiBuf + i * kTileLanes;
+            for (int j = 0; j < kTileLanes; ++j) {
+                float y = c.a2 * xn1[j] + c.a3 * xn2[j] - c.b1 * yn1[j] - c.b2 * yn2[j];
+                yc[j] = y;
+                xn2[j] = xn1[j]; xn1[j] = xc[j];
+                yn2[j] = yn1[j]; yn1[j] = y;
+            }
+        }
+
+        // 因果 pass：状态跨块延续，第一块以第 0 行稳态初始化
+        float* xp1 = s->causal.data() + static_cast<size_t>(tile) * 3 * kTileLanes;
+        float* yp1 = xp1 + kTileLanes;
+        float* yp2 = yp1 + kTileLanes;
+        if (b0 == 0) {
+            for (int j = 0; j < kTileLanes; ++j) {
+                xp1[j] = tileBuf[j];
+                yp1[j] = tileBuf[j] * c.coefp;
+                yp2[j] = yp1[j];
+            }
+        }
+        for (int i = 0; i < b1 - b0; ++i) {
+            const float* xc = tileBuf + i * kTileLanes;
+            float* yc = antiBuf + i * kTileLanes;
+            for (int j = 0; j < kTileLanes; ++j) {
+                float y = c.a0 * xc[j] + c.a1 * xp1[j] - c.b1 * yp1[j] - c.b2 * yp2[j];
+                yc[j] += y;
+                xp1[j] = xc[j];
+                yp2[j] = yp1[j]; yp1[j] = y;
+            }
+        }
+
+        // 原位写回（[b0, b1) 行的横向结果已读入 tileBuf，不再需要）
+        for (int y = b0; y < b1; ++y) {
+            uint8_t* row = ring_row(s, y) + x0 * 4;
+            const float* src = antiBuf + (y - b0) * kTileLanes;
+            for (int k = 0; k < n; ++k) {
+                store_pixel<Linear, BitmapLayout>(lut, src + k * 4, row + k * 4);
+            }
+        }
+    }
+}
+
+typedef void (*RowsKernel)(GaussianIIRStream*, const uint8_t*, int, int, int, int, float*, float*);
+typedef void (*BlockKernel)(GaussianIIRStream*, int, int, int, int, int, float*, float*);
+
+static const RowsKernel kRowsKernels[2] = { filter_rows<false>, filter_rows<true> };
+static const BlockKernel kBlockKernels[2] = { filter_block<false>, filter_block<true> };
+
+/**
+ * 纵向处理所有已凑齐向下看行数的块
+ */
+static void process_ready_blocks(GaussianIIRStream* s) {
+    while (s->done < s->height) {
+        const int b0 = s->done;
+        const int b1 = std::min(s->height, b0 + s->blockRows);
+        const int e = std::min(s->height, b1 + s->lookahead);
+        if (s->pushed < e) return;
+
+        if (!s->passthrough) {
+            // 每个线程：列块输入 (e - b0) 行 + 输出 (b1 - b0) 行
+            const int bufLen = (s->ringRows + s->blockRows) * kTileLanes;
+            const int threads = thread_pool_concurrency();
+            ScratchBuffer work(sizeof(float) * bufLen * threads);
+            if (!work) {
+                LOGE("Failed to allocate block buffer: %d rows", e - b0);
+                return;
+            }
+            float* buffer = work.as<float>();
+            const BlockKernel kernel = kBlockKernels[s->linear ? 1 : 0];
+            parallel_for(0, s->tiles, parallel_rows_grain((e - b0) * kColumnTile), [&](int t0, int t1, int slot) {
+                float* buf = buffer + slot * bufLen;
+                kernel(s, b0, b1, e, t0, t1, buf, buf + s->ringRows * kTileLanes);
+            });
+        }
+        s->done = b1;
+    }
+}
+
+GaussianIIRStream* gaussian_iir_stream_create(int width, int height, float sigma, bool doLinear) {
+    if (width <= 0 || height <= 0) {
+        LOGE("Invalid stream size: %dx%d", width, height);
+        return nullptr;
+    }
+
+    GaussianIIRStream* s = new GaussianIIRStream();
+    s->width = width;
+    s->height = height;
+    s->linear = doLinear;
+    s->passthrough = sigma <= 0.1f;
+
+    if (sigma > 50.0f) {
+        LOGD("Sigma %.2f too large, clamping to 50.0", sigma);
+        sigma = 50.0f;
+    }
+
+    if (s->passthrough) {
+        s->lookahead = 0;
+        s->blockRows = kMinBlockRows;
+    } else {
+        s->c = compute_deriche_coeffs(sigma);
+        const float sigmas = doLinear ? kLinearLookaheadSigmas : kLookaheadSigmas;
+        s->lookahead = static_cast<int>(std::ceil(sigmas * sigma));
+        s->blockRows = std::max(kMinBlockRows, std::min(kMaxBlockRows, 2 * s->lookahead));
+    }
+    s->ringRows = std::min(height, s->blockRows + s->lookahead);
+    s->tiles = (width + kColumnTile - 1) / kColumnTile;
+
+    s->ring.resize(static_cast<size_t>(s->ringRows) * width * 4);
+    if (!s->passthrough) {
+        s->causal.assign(static_cast<size_t>(s->tiles) * 3 * kTileLanes, 0.0f);
+    }
+
+    LOGD("Stream %dx%d sigma=%.2f: block=%d, lookahead=%d, ring=%d rows (%zu bytes)",
+         width, height, sigma, s->blockRows, s->lookahead, s->ringRows,
+         gaussian_iir_stream_memory_bytes(s));
+    return s;
+}
+
+void gaussian_iir_stream_destroy(GaussianIIRStream* stream) {
+    delete stream;
+}
+
+int gaussian_iir_stream_push(GaussianIIRStream* stream, const uint8_t* rows, int stride, int count) {
+    if (!stream || !rows || count <= 0) return 0;
+    if (stride < stream->width * 4) {
+        LOGE("Invalid push stride: %d (width %d)", stride, stream->width);
+        return 0;
+    }
+
+    GaussianIIRStream* s = stream;
+    int accepted = 0;
+    while (accepted < count && s->pushed < s->height) {
+        const int space = s->ringRows - (s->pushed - s->pulled);
+        const int n = std::min(std::min(count - accepted, space), s->height - s->pushed);
+        if (n <= 0) break;
+
+        const uint8_t* src = rows + static_cast<size_t>(accepted) * stride;
+        const int first = s->pushed;
+        if (s->passthrough) {
+            for (int i = 0; i < n; ++i) {
+                memcpy(ring_row(s, first + i), src + static_cast<size_t>(i) * stride, s->width * 4);
+            }
+        } else {
+            const int bufLen = s->width * 4;
+            const int threads = thread_pool_concurrency();
+            ScratchBuffer work(sizeof(float) * bufLen * 2 * threads);
+            if (!work) {
+                LOGE("Failed to allocate row buffer: width=%d", s->width);
+                break;
+            }
+            float* buffer = work.as<float>();
+            const RowsKernel kernel = kRowsKernels[s->linear ? 1 : 0];
+            parallel_for(0, n, parallel_rows_grain(s->width), [&](int i0, int i1, int slot) {
+                float* buf = buffer + slot * bufLen * 2;
+                kernel(s, src, stride, first, i0, i1, buf, buf + bufLen);
+            });
+        }
+
+        s->pushed += n;
+        accepted += n;
+        process_ready_blocks(s);
+    }
+    return accepted;
+}
+
+int gaussian_iir_stream_pull(GaussianIIRStream* stream, uint8_t* dst, int stride, int count) {
+    if (!stream || !dst || count <= 0) return 0;
+    if (stride < stream->width * 4) {
+        LOGE("Invalid pull stride: %d (width %d)", stride, stream->width);
+        return 0;
+    }
+
+    GaussianIIRStream* s = stream;
+    const int n = std::min(count, s->done - s->pulled);
+    for (int i = 0; i < n; ++i) {
+        memcpy(dst + static_cast<size_t>(i) * stride, ring_row(s, s->pulled + i), s->width * 4);
+    }
+    s->pulled += n;
+    return n;
+}
+
+int gaussian_iir_stream_available(const GaussianIIRStream* stream) {
+    return stream ? stream->done - stream->pulled : 0;
+}
+
+size_t gaussian_iir_stream_memory_bytes(const GaussianIIRStream* stream) {
+    if (!stream) return 0;
+    return stream->ring.size() + stream->causal.size() * sizeof(float);
+}
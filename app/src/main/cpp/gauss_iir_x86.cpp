@@ -0,0 +1,739 @@
+/**
+ * gauss_iir_x86.cpp - IIR 递归高斯模糊 x86 SIMD 内核（SSE4.1 / AVX2）
+ *
+ * 实现细节：
+ * - 本文件按基线指令集编译，只有内核函数带 target 属性；只能经
+ *   gaussian_iir_rgba8888_neon 的运行时检测后进入
+ * - SSE4.1：与 NEON 版本逐项对应（iir_filter_1d_sse41<Columns>，横向 1 列、纵向 kColumnTile 列）
+ * - AVX2：横向每次处理 2 行，寄存器低 128 位为第 y 行、高 128 位为第 y+1 行
+ *   （与 FP16 内核相同的行对布局）；纵向 8 列 = 4 个 __m256
+ * - 线性模式查表、颜色矩阵为逐像素标量（见 gauss_iir_x86.h）：
+ *   非线性模式矩阵作用于浮点结果（原位改写输出缓冲），线性模式作用于打包后的字节
+ */
+
+#include "gauss_iir_x86.h"
+#include "color_lut.h"
+#include "color_matrix.h"
+#include "perf_trace.h"
+#include "pixel_layout.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <android/log.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#define IIR_X86_AVAILABLE 1
+#define X86_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define X86_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define IIR_X86_AVAILABLE 0
+#endif
+
+#define LOG_TAG "GaussIIR_X86"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+bool gaussian_iir_x86_kernels_compiled() {
+    return IIR_X86_AVAILABLE != 0;
+}
+
+#if IIR_X86_AVAILABLE
+
+// Deriche 系数结构（与标量 / NEON 版本相同）
+struct DericheCoeffs {
+    float a0, a1, a2, a3;
+    float b1, b2;
+    float coefp, coefn;
+};
+
+static DericheCoeffs compute_deriche_coeffs(float sigma) {
+    DericheCoeffs c;
+
+    double alpha = 1.695 / sigma;
+    double ema = exp(-alpha);
+    double ema2 = ema * ema;
+
+    c.b1 = static_cast<float>(-2.0 * ema);
+    c.b2 = static_cast<float>(ema2);
+
+    double k = (1.0 - ema) * (1.0 - ema) / (1.0 + 2.0 * alpha * ema - ema2);
+
+    c.a0 = static_cast<float>(k);
+    c.a1 = static_cast<float>(k * ema * (alpha - 1.0));
+    c.a2 = static_cast<float>(k * ema * (alpha + 1.0));
+    c.a3 = static_cast<float>(-k * ema2);
+
+    c.coefp = static_cast<float>((c.a0 + c.a1) / (1.0 + c.b1 + c.b2));
+    c.coefn = static_cast<float>((c.a2 + c.a3) / (1.0 + c.b1 + c.b2));
+
+    return c;
+}
+
+// 纵向批处理的列数（与 NEON 版本相同，每行读取 32 字节）
+static const int kColumnTile = 8;
+
+// ============================================================================
+// 标量辅助（线性模式查表、颜色矩阵）
+// ============================================================================
+
+static inline int quantize_unit(float v) {
+    return static_cast<int>(std::max(0.0f, std::min(1.0f, v)) * 255.0f + 0.5f);
+}
+
+/**
+ * 1 个预乘 sRGB 像素 → 预乘线性值（Alpha 保持线性比例）
+ */
+static inline void unpack_linear_pixel(const ColorLut& lut, const uint8_t* src, float* dst) {
+    const int a = src[BitmapLayout::A];
+    for (int k = 0; k < 4; ++k) {
+        dst[k] = (k == BitmapLayout::A) ? a * (1.0f / 255.0f) : color_lut_to_linear(lut, src[k], a);
+    }
+}
+
+/**
+ * 1 个预乘线性值像素 → 预乘 sRGB 字节（先量化 Alpha，颜色按量化后的 Alpha 还原）
+ */
+static inline void pack_linear_pixel(const ColorLut& lut, const float* src, uint8_t* dst) {
+    const int a = quantize_unit(src[BitmapLayout::A]);
+    for (int k = 0; k < 4; ++k) {
+        dst[k] = (k == BitmapLayout::A) ? static_cast<uint8_t>(a) : color_lut_to_srgb8(lut, src[k], a);
+    }
+}
+
+/**
+ * 对 n 个交错浮点像素原位套用颜色矩阵
+ */
+static inline void apply_matrix_floats(const ColorMatrix& cm, float* px, int n) {
+    for (int i = 0; i < n; ++i) {
+        float* p = px + i * 4;
+        color_matrix_apply(cm, p[BitmapLayout::R], p[BitmapLayout::G], p[BitmapLayout::B], p[BitmapLayout::A]);
+    }
+}
+
+// ============================================================================
+// SSE4.1：每个 __m128 一个像素
+// ============================================================================
+
+/**
+ * 一维 IIR 递归滤波（SSE4.1 版本，每个样本 Columns 个像素，各像素递归独立）
+ *
+ * 注意：src 与 dst 不能重叠，后向递归需要读取原始输入
+ */
+template <int Columns>
+X86_TARGET_SSE41 static void iir_filter_1d_sse41(const float* src, float* dst, int len, const DericheCoeffs& c) {
+    if (len <= 0) return;
+
+    const int step = Columns * 4;
+    const __m128 va0 = _mm_set1_ps(c.a0);
+    const __m128 va1 = _mm_set1_ps(c.a1);
+    const __m128 va2 = _mm_set1_ps(c.a2);
+    const __m128 va3 = _mm_set1_ps(c.a3);
+    const __m128 vb1 = _mm_set1_ps(c.b1);
+    const __m128 vb2 = _mm_set1_ps(c.b2);
+    const __m128 vcoefp = _mm_set1_ps(c.coefp);
+    const __m128 vcoefn = _mm_set1_ps(c.coefn);
+
+    // 前向递归（causal）
+    __m128 vxp1[Columns], vyp1[Columns], vyp2[Columns];
+    for (int k = 0; k < Columns; ++k) {
+        vxp1[k] = _mm_loadu_ps(src + k * 4);
+        vyp1[k] = _mm_mul_ps(vxp1[k], vcoefp);
+        vyp2[k] = vyp1[k];
+    }
+
+    for (int i = 0; i < len; ++i) {
+        const float* xs = src + i * step;
+        float* ys = dst + i * step;
+        for (int k = 0; k < Columns; ++k) {
+            const __m128 vxc = _mm_loadu_ps(xs + k * 4);
+
+            // yc = a0*xc + a1*xp1 - b1*yp1 - b2*yp2
+            __m128 vyc = _mm_mul_ps(va0, vxc);
+            vyc = _mm_add_ps(vyc, _mm_mul_ps(va1, vxp1[k]));
+            vyc = _mm_sub_ps(vyc, _mm_mul_ps(vb1, vyp1[k]));
+            vyc = _mm_sub_ps(vyc, _mm_mul_ps(vb2, vyp2[k]));
+
+            _mm_storeu_ps(ys + k * 4, vyc);
+
+            vxp1[k] = vxc;
+            vyp2[k] = vyp1[k];
+            vyp1[k] = vyc;
+        }
+    }
+
+    // 后向递归（anti-causal）
+    __m128 vxn1[Columns], vxn2[Columns], vyn1[Columns], vyn2[Columns];
+    const float* last = src + (len - 1) * step;
+    for (int k = 0; k < Columns; ++k) {
+        vxn1[k] = _mm_loadu_ps(last + k * 4);
+        vxn2[k] = vxn1[k];
+        vyn1[k] = _mm_mul_ps(vxn1[k], vcoefn);
+        vyn2[k] = vyn1[k];
+    }
+
+    for (int i = len - 1; i >= 0; --i) {
+        const float* xs = src + i * step;
+        float* ys = dst + i * step;
+        for (int k = 0; k < Columns; ++k) {
+            const __m128 vxc = _mm_loadu_ps(xs + k * 4);
+
+            // yc = a2*xn1 + a3*xn2 - b1*yn1 - b2*yn2
+            __m128 vyc = _mm_mul_ps(va2, vxn1[k]);
+            vyc = _mm_add_ps(vyc, _mm_mul_ps(va3, vxn2[k]));
+            vyc = _mm_sub_ps(vyc, _mm_mul_ps(vb1, vyn1[k]));
+            vyc = _mm_sub_ps(vyc, _mm_mul_ps(vb2, vyn2[k]));
+
+            // 累加前向和后向结果
+            _mm_storeu_ps(ys + k * 4, _mm_add_ps(_mm_loadu_ps(ys + k * 4), vyc));
+
+            vxn2[k] = vxn1[k];
+            vxn1[k] = vxc;
+            vyn2[k] = vyn1[k];
+            vyn1[k] = vyc;
+        }
+    }
+}
+
+/**
+ * float [0,1] → int32（钳位 + 四舍五入）
+ */
+X86_TARGET_SSE41 static inline __m128i quantize4_sse41(__m128 v) {
+    v = _mm_max_ps(_mm_min_ps(v, _mm_set1_ps(1.0f)), _mm_setzero_ps());
+    return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+}
+
+/**
+ * 连续 n 个像素 uint8 → 交错 float（非线性模式每次 4 像素）
+ */
+template <bool Linear>
+X86_TARGET_SSE41 static void pixels_to_float_sse41(const ColorLut& lut, const uint8_t* src, float* dst, int n) {
+    if (Linear) {
+        for (int i = 0; i < n; ++i) unpack_linear_pixel(lut, src + i * 4, dst + i * 4);
+        return;
+    }
+
+    const __m128 vinv255 = _mm_set1_ps(1.0f / 255.0f);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        _mm_storeu_ps(dst + i * 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(v)), vinv255));
+        _mm_storeu_ps(dst + i * 4 + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 4))), vinv255));
+        _mm_storeu_ps(dst + i * 4 + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 8))), vinv255));
+        _mm_storeu_ps(dst + i * 4 + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 12))), vinv255));
+    }
+    for (; i < n; ++i) {
+        int32_t px;
+        memcpy(&px, src + i * 4, 4);
+        _mm_storeu_ps(dst + i * 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(px))), vinv255));
+    }
+}
+
+/**
+ * 交错 float → 连续 n 个像素 uint8（Matrix 时 cm 非空；非线性模式会原位改写 src）
+ */
+template <bool Linear, bool Matrix>
+X86_TARGET_SSE41 static void float_to_pixels_sse41(const ColorLut& lut, const ColorMatrix* cm, float* src, uint8_t* dst, int n) {
+    if (Linear) {
+        for (int i = 0; i < n; ++i) pack_linear_pixel(lut, src + i * 4, dst + i * 4);
+        if (Matrix) color_matrix_rgba8888_row(*cm, dst, dst, n);
+        return;
+    }
+    if (Matrix) apply_matrix_floats(*cm, src, n);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i q0 = quantize4_sse41(_mm_loadu_ps(src + i * 4));
+        const __m128i q1 = quantize4_sse41(_mm_loadu_ps(src + i * 4 + 4));
+        const __m128i q2 = quantize4_sse41(_mm_loadu_ps(src + i * 4 + 8));
+        const __m128i q3 = quantize4_sse41(_mm_loadu_ps(src + i * 4 + 12));
+        const __m128i p = _mm_packus_epi16(_mm_packus_epi32(q0, q1), _mm_packus_epi32(q2, q3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), p);
+    }
+    for (; i < n; ++i) {
+        const __m128i q = quantize4_sse41(_mm_loadu_ps(src + i * 4));
+        const __m128i p16 = _mm_packus_epi32(q, q);
+        const int32_t px = _mm_cvtsi128_si32(_mm_packus_epi16(p16, p16));
+        memcpy(dst + i * 4, &px, 4);
+    }
+}
+
+/**
+ * 横向模糊（SSE4.1，处理 [rowBegin, rowEnd) 行）
+ */
+template <bool Linear>
+X86_TARGET_SSE41 static void blur_horizontal_sse41(
+    uint8_t* base,
+    int w,
+    int rowBegin,
+    int rowEnd,
+    int stride,
+    const DericheCoeffs& c,
+    float* inBuf,
+    float* outBuf,
+    TraceSubStages& stages
+) {
+    const ColorLut& lut = color_lut();
+    StageTimer timer;
+    uint64_t convertNs = 0, packNs = 0;
+
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        uint8_t* row = base + y * stride;
+
+        pixels_to_float_sse41<Linear>(lut, row, inBuf, w);
+        convertNs += timer.lap();
+
+        iir_filter_1d_sse41<1>(inBuf, outBuf, w, c);
+        timer.lap();
+
+        float_to_pixels_sse41<Linear, false>(lut, nullptr, outBuf, row, w);
+        packNs += timer.lap();
+    }
+
+    stages.add(convertNs, packNs);
+}
+
+/**
+ * 纵向模糊（SSE4.1，按列块处理；颜色矩阵在这里的打包阶段套用）
+ */
+template <bool Linear, bool Matrix>
+X86_TARGET_SSE41 static void blur_vertical_sse41(
+    uint8_t* base,
+    int w,
+    int h,
+    int stride,
+    const DericheCoeffs& c,
+    const ColorMatrix* cm,
+    int tileBegin,
+    int tileEnd,
+    float* inBuf,
+    float* outBuf,
+    TraceSubStages& stages
+) {
+    const int step = kColumnTile * 4;
+    const ColorLut& lut = color_lut();
+    StageTimer timer;
+    uint64_t convertNs = 0, packNs = 0;
+
+    for (int tile = tileBegin; tile < tileEnd; ++tile) {
+        const int x0 = tile * kColumnTile;
+        const int n = std::min(kColumnTile, w - x0);
+
+        // 不足一块时，未用列保持为 0（各列独立，不影响结果）
+        if (n < kColumnTile) {
+            memset(inBuf, 0, h * step * sizeof(float));
+        }
+
+        for (int y = 0; y < h; ++y) {
+            pixels_to_float_sse41<Linear>(lut, base + y * stride + x0 * 4, inBuf + y * step, n);
+        }
+        convertNs += timer.lap();
+
+        iir_filter_1d_sse41<kColumnTile>(inBuf, outBuf, h, c);
+        timer.lap();
+
+        for (int y = 0; y < h; ++y) {
+            float_to_pixels_sse41<Linear, Matrix>(lut, cm, outBuf + y * step, base + y * stride + x0 * 4, n);
+        }
+        packNs += timer.lap();
+    }
+
+    stages.add(convertNs, packNs);
+}
+
+// ============================================================================
+// AVX2：每个 __m256 两个像素
+// ============================================================================
+
+/**
+ * 一维 IIR 递归滤波（AVX2 + FMA 版本，每个样本 Lanes 个 __m256，即 2 × Lanes 个像素）
+ *
+ * 注意：src 与 dst 不能重叠
+ */
+template <int Lanes>
+X86_TARGET_AVX2 static void iir_filter_1d_avx2(const float* src, float* dst, int len, const DericheCoeffs& c) {
+    if (len <= 0) return;
+
+    const int step = Lanes * 8;
+    const __m256 va0 = _mm256_set1_ps(c.a0);
+    const __m256 va1 = _mm256_set1_ps(c.a1);
+    const __m256 va2 = _mm256_set1_ps(c.a2);
+    const __m256 va3 = _mm256_set1_ps(c.a3);
+    const __m256 vb1 = _mm256_set1_ps(c.b1);
+    const __m256 vb2 = _mm256_set1_ps(c.b2);
+    const __m256 vcoefp = _mm256_set1_ps(c.coefp);
+    const __m256 vcoefn = _mm256_set1_ps(c.coefn);
+
+    // 前向递归（causal）
+    __m256 vxp1[Lanes], vyp1[Lanes], vyp2[Lanes];
+    for (int k = 0; k < Lanes; ++k) {
+        vxp1[k] = _mm256_loadu_ps(src + k * 8);
+        vyp1[k] = _mm256_mul_ps(vxp1[k], vcoefp);
+        vyp2[k] = vyp1[k];
+    }
+
+    for (int i = 0; i < len; ++i) {
+        const float* xs = src + i * step;
+        float* ys = dst + i * step;
+        for (int k = 0; k < Lanes; ++k) {
+            const __m256 vxc = _mm256_loadu_ps(xs + k * 8);
+
+            __m256 vyc = _mm256_mul_ps(va0, vxc);
+            vyc = _mm256_fmadd_ps(va1, vxp1[k], vyc);
+            vyc = _mm256_fnmadd_ps(vb1, vyp1[k], vyc);
+            vyc = _mm256_fnmadd_ps(vb2, vyp2[k], vyc);
+
+            _mm256_storeu_ps(ys + k * 8, vyc);
+
+            vxp1[k] = vxc;
+            vyp2[k] = vyp1[k];
+            vyp1[k] = vyc;
+        }
+    }
+
+    // 后向递归（anti-causal）
+    __m256 vxn1[Lanes], vxn2[Lanes], vyn1[Lanes], vyn2[Lanes];
+    const float* last = src + (len - 1) * step;
+    for (int k = 0; k < Lanes; ++k) {
+        vxn1[k] = _mm256_loadu_ps(last + k * 8);
+        vxn2[k] = vxn1[k];
+        vyn1[k] = _mm256_mul_ps(vxn1[k], vcoefn);
+        vyn2[k] = vyn1[k];
+    }
+
+    for (int i = len - 1; i >= 0; --i) {
+        const float* xs = src + i * step;
+        float* ys = dst + i * step;
+        for (int k = 0; k < Lanes; ++k) {
+            const __m256 vxc = _mm256_loadu_ps(xs + k * 8);
+
+            __m256 vyc = _mm256_mul_ps(va2, vxn1[k]);
+            vyc = _mm256_fmadd_ps(va3, vxn2[k], vyc);
+            vyc = _mm256_fnmadd_ps(vb1, vyn1[k], vyc);
+            vyc = _mm256_fnmadd_ps(vb2, vyn2[k], vyc);
+
+            _mm256_storeu_ps(ys + k * 8, _mm256_add_ps(_mm256_loadu_ps(ys + k * 8), vyc));
+
+            vxn2[k] = vxn1[k];
+            vxn1[k] = vxc;
+            vyn2[k] = vyn1[k];
+            vyn1[k] = vyc;
+        }
+    }
+}
+
+/**
+ * 2 个像素（低 / 高 32 位）uint8 → 8 个 float
+ */
+X86_TARGET_AVX2 static inline __m256 unpack2_avx2(__m128i px) {
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(px)), _mm256_set1_ps(1.0f / 255.0f));
+}
+
+/**
+ * 8 个 float → 2 个像素（结果的低 / 高 32 位，即 [0] / [1] 两个 dword）
+ */
+X86_TARGET_AVX2 static inline __m128i pack2_avx2(__m256 v) {
+    v = _mm256_max_ps(_mm256_min_ps(v, _mm256_set1_ps(1.0f)), _mm256_setzero_ps());
+    const __m256i q = _mm256_cvttps_epi32(_mm256_fmadd_ps(v, _mm256_set1_ps(255.0f), _mm256_set1_ps(0.5f)));
+    const __m128i p16 = _mm_packus_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+    return _mm_packus_epi16(p16, p16);
+}
+
+/**
+ * 连续 n 个像素 uint8 → 交错 float（非线性模式每次 2 像素）
+ */
+template <bool Linear>
+X86_TARGET_AVX2 static void pixels_to_float_avx2(const ColorLut& lut, const uint8_t* src, float* dst, int n) {
+    if (Linear) {
+        for (int i = 0; i < n; ++i) unpack_linear_pixel(lut, src + i * 4, dst + i * 4);
+        return;
+    }
+
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm256_storeu_ps(dst + i * 4, unpack2_avx2(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i * 4))));
+    }
+    if (i < n) {
+        int32_t px;
+        memcpy(&px, src + i * 4, 4);
+        _mm_storeu_ps(dst + i * 4, _mm256_castps256_ps128(unpack2_avx2(_mm_cvtsi32_si128(px))));
+    }
+}
+
+/**
+ * 交错 float → 连续 n 个像素 uint8（Matrix 时 cm 非空；非线性模式会原位改写 src）
+ */
+template <bool Linear, bool Matrix>
+X86_TARGET_AVX2 static void float_to_pixels_avx2(const ColorLut& lut, const ColorMatrix* cm, float* src, uint8_t* dst, int n) {
+    if (Linear) {
+        for (int i = 0; i < n; ++i) pack_linear_pixel(lut, src + i * 4, dst + i * 4);
+        if (Matrix) color_matrix_rgba8888_row(*cm, dst, dst, n);
+        return;
+    }
+    if (Matrix) apply_matrix_floats(*cm, src, n);
+
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i * 4), pack2_avx2(_mm256_loadu_ps(src + i * 4)));
+    }
+    if (i < n) {
+        const __m256 v = _mm256_castps128_ps256(_mm_loadu_ps(src + i * 4));
+        const int32_t px = _mm_cvtsi128_si32(pack2_avx2(v));
+        memcpy(dst + i * 4, &px, 4);
+    }
+}
+
+/**
+ * 横向模糊（AVX2，处理 [pairBegin, pairEnd) 行对；高度为奇数时最后一对的第二行重复第一行，不写回）
+ *
+ * 缓冲布局 [x][2 行][RGBA]
+ */
+template <bool Linear>
+X86_TARGET_AVX2 static void blur_horizontal_avx2(
+    uint8_t* base,
+    int w,
+    int h,
+    int pairBegin,
+    int pairEnd,
+    int stride,
+    const DericheCoeffs& c,
+    float* inBuf,
+    float* outBuf,
+    TraceSubStages& stages
+) {
+    const ColorLut& lut = color_lut();
+    StageTimer timer;
+    uint64_t convertNs = 0, packNs = 0;
+
+    for (int pair = pairBegin; pair < pairEnd; ++pair) {
+        const int y0 = pair * 2;
+        const bool hasSecond = y0 + 1 < h;
+        uint8_t* row0 = base + y0 * stride;
+        uint8_t* row1 = hasSecond ? row0 + stride : row0;
+
+        for (int x = 0; x < w; ++x) {
+            if (Linear) {
+                unpack_linear_pixel(lut, row0 + x * 4, inBuf + x * 8);
+                unpack_linear_pixel(lut, row1 + x * 4, inBuf + x * 8 + 4);
+            } else {
+                int32_t p0, p1;
+                memcpy(&p0, row0 + x * 4, 4);
+                memcpy(&p1, row1 + x * 4, 4);
+                const __m128i px = _mm_unpacklo_epi32(_mm_cvtsi32_si128(p0), _mm_cvtsi32_si128(p1));
+                _mm256_storeu_ps(inBuf + x * 8, unpack2_avx2(px));
+            }
+        }
+        convertNs += timer.lap();
+
+        iir_filter_1d_avx2<1>(inBuf, outBuf, w, c);
+        timer.lap();
+
+        for (int x = 0; x < w; ++x) {
+            if (Linear) {
+                pack_linear_pixel(lut, outBuf + x * 8, row0 + x * 4);
+                if (hasSecond) pack_linear_pixel(lut, outBuf + x * 8 + 4, row1 + x * 4);
+            } else {
+                const __m128i p = pack2_avx2(_mm256_loadu_ps(outBuf + x * 8));
+                const int32_t p0 = _mm_cvtsi128_si32(p);
+                memcpy(row0 + x * 4, &p0, 4);
+                if (hasSecond) {
+                    const int32_t p1 = _mm_extract_epi32(p, 1);
+                    memcpy(row1 + x * 4, &p1, 4);
+                }
+            }
+        }
+        packNs += timer.lap();
+    }
+
+    stages.add(convertNs, packNs);
+}
+
+/**
+ * 纵向模糊（AVX2，按列块处理；颜色矩阵在这里的打包阶段套用）
+ */
+template <bool Linear, bool Matrix>
+X86_TARGET_AVX2 static void blur_vertical_avx2(
+    uint8_t* base,
+    int w,
+    int h,
+    int stride,
+    const DericheCoeffs& c,
+    const ColorMatrix* cm,
+    int tileBegin,
+    int tileEnd,
+    float* inBuf,
+    float* outBuf,
+    TraceSubStages& stages
+) {
+    const int step = kColumnTile * 4;
+    const ColorLut& lut = color_lut();
+    StageTimer timer;
+    uint64_t convertNs = 0, packNs = 0;
+
+    for (int tile = tileBegin; tile < tileEnd; ++tile) {
+        const int x0 = tile * kColumnTile;
+        const int n = std::min(kColumnTile, w - x0);
+
+        if (n < kColumnTile) {
+            memset(inBuf, 0, h * step * sizeof(float));
+        }
+
+        for (int y = 0; y < h; ++y) {
+            pixels_to_float_avx2<Linear>(lut, base + y * stride + x0 * 4, inBuf + y * step, n);
+        }
+        convertNs += timer.lap();
+
+        iir_filter_1d_avx2<kColumnTile / 2>(inBuf, outBuf, h, c);
+        timer.lap();
+
+        for (int y = 0; y < h; ++y) {
+            float_to_pixels_avx2<Linear, Matrix>(lut, cm, outBuf + y * step, base + y * stride + x0 * 4, n);
+        }
+        packNs += timer.lap();
+    }
+
+    stages.add(convertNs, packNs);
+}
+
+/**
+ * 按 doLinear（与是否有颜色矩阵）选择的行 / 列块内核
+ */
+typedef void (*HorizontalKernelSse41)(uint8_t*, int, int, int, int, const DericheCoeffs&, float*, float*, TraceSubStages&);
+typedef void (*HorizontalKernelAvx2)(uint8_t*, int, int, int, int, int, const DericheCoeffs&, float*, float*, TraceSubStages&);
+typedef void (*VerticalKernelX86)(uint8_t*, int, int, int, const DericheCoeffs&, const ColorMatrix*, int, int, float*, float*, TraceSubStages&);
+
+static const HorizontalKernelSse41 kHorizontalKernelsSse41[2] = {
+    blur_horizontal_sse41<false>, blur_horizontal_sse41<true>
+};
+static const VerticalKernelX86 kVerticalKernelsSse41[2][2] = {
+    { blur_vertical_sse41<false, false>, blur_vertical_sse41<false, true> },
+    { blur_vertical_sse41<true, false>, blur_vertical_sse41<true, true> }
+};
+static const HorizontalKernelAvx2 kHorizontalKernelsAvx2[2] = {
+    blur_horizontal_avx2<false>, blur_horizontal_avx2<true>
+};
+static const VerticalKernelX86 kVerticalKernelsAvx2[2][2] = {
+    { blur_vertical_avx2<false, false>, blur_vertical_avx2<false, true> },
+    { blur_vertical_avx2<true, false>, blur_vertical_avx2<true, true> }
+};
+
+#endif // IIR_X86_AVAILABLE
+
+void gaussian_iir_rgba8888_sse41_kernel(
+    uint8_t* base,
+    int w,
+    int h,
+    int stride,
+    float sigma,
+    bool doLinear,
+    const ColorMatrix* colorMatrix
+) {
+#if IIR_X86_AVAILABLE
+    if (sigma <= 0.1f || w <= 0 || h <= 0 || !base) {
+        return;
+    }
+
+    TraceScope total(TRACE_FILTER_IIR_NEON, TRACE_STAGE_TOTAL);
+    TraceSubStages stages;
+
+    const DericheCoeffs c = compute_deriche_coeffs(sigma);
+
+    // 每个线程输入/输出各一份：横向 w × 4，纵向 h × 列块 × 4
+    const int bufLen = std::max(w * 4, h * kColumnTile * 4);
+    const int threads = thread_pool_concurrency();
+    TraceScope allocScope(TRACE_FILTER_IIR_NEON, TRACE_STAGE_ALLOC);
+    ScratchBuffer work(sizeof(float) * bufLen * 2 * threads);
+    allocScope.stop();
+    if (!work) {
+        LOGE("Failed to allocate work buffer: %dx%d", w, h);
+        return;
+    }
+    float* workBuf = work.as<float>();
+    const HorizontalKernelSse41 horizontal = kHorizontalKernelsSse41[doLinear ? 1 : 0];
+    const VerticalKernelX86 vertical = kVerticalKernelsSse41[doLinear ? 1 : 0][colorMatrix ? 1 : 0];
+
+    // 横向：按行分块
+    {
+        TraceScope scope(TRACE_FILTER_IIR_NEON, TRACE_STAGE_HORIZONTAL);
+        parallel_for(0, h, parallel_rows_grain(w), [&](int y0, int y1, int slot) {
+            float* buf = workBuf + slot * bufLen * 2;
+            horizontal(base, w, y0, y1, stride, c, buf, buf + bufLen, stages);
+        });
+    }
+
+    // 纵向：按列块条带分块
+    {
+        TraceScope scope(TRACE_FILTER_IIR_NEON, TRACE_STAGE_VERTICAL);
+        const int tiles = (w + kColumnTile - 1) / kColumnTile;
+        parallel_for(0, tiles, parallel_rows_grain(h * kColumnTile), [&](int t0, int t1, int slot) {
+            float* buf = workBuf + slot * bufLen * 2;
+            vertical(base, w, h, stride, c, colorMatrix, t0, t1, buf, buf + bufLen, stages);
+        });
+    }
+
+    stages.record(TRACE_FILTER_IIR_NEON);
+#else
+    LOGE("x86 kernels not available at compile time");
+#endif
+}
+
+void gaussian_iir_rgba8888_avx2_kernel(
+    uint8_t* base,
+    int w,
+    int h,
+    int stride,
+    float sigma,
+    bool doLinear,
+    const ColorMatrix* colorMatrix
+) {
+#if IIR_X86_AVAILABLE
+    if (sigma <= 0.1f || w <= 0 || h <= 0 || !base) {
+        return;
+    }
+
+    TraceScope total(TRACE_FILTER_IIR_NEON, TRACE_STAGE_TOTAL);
+    TraceSubStages stages;
+
+    const DericheCoeffs c = compute_deriche_coeffs(sigma);
+
+    // 每个线程输入/输出各一份：横向 w × 2 行 × 4，纵向 h × 列块 × 4
+    const int bufLen = std::max(w * 8, h * kColumnTile * 4);
+    const int threads = thread_pool_concurrency();
+    TraceScope allocScope(TRACE_FILTER_IIR_NEON, TRACE_STAGE_ALLOC);
+    ScratchBuffer work(sizeof(float) * bufLen * 2 * threads);
+    allocScope.stop();
+    if (!work) {
+        LOGE("Failed to allocate work buffer: %dx%d", w, h);
+        return;
+    }
+    float* workBuf = work.as<float>();
+    const HorizontalKernelAvx2 horizontal = kHorizontalKernelsAvx2[doLinear ? 1 : 0];
+    const VerticalKernelX86 vertical = kVerticalKernelsAvx2[doLinear ? 1 : 0][colorMatrix ? 1 : 0];
+
+    // 横向：按行对分块
+    {
+        TraceScope scope(TRACE_FILTER_IIR_NEON, TRACE_STAGE_HORIZONTAL);
+        const int pairs = (h + 1) / 2;
+        parallel_for(0, pairs, parallel_rows_grain(w * 2), [&](int p0, int p1, int slot) {
+            float* buf = workBuf + slot * bufLen * 2;
+            horizontal(base, w, h, p0, p1, stride, c, buf, buf + bufLen, stages);
+        });
+    }
+
+    // 纵向：按列块条带分块
+    {
+        TraceScope scope(TRACE_FILTER_IIR_NEON, TRACE_STAGE_VERTICAL);
+        const int tiles = (w + kColumnTile - 1) / kColumnTile;
+        parallel_for(0, tiles, parallel_rows_grain(h * kColumnTile), [&](int t0, int t1, int slot) {
+            float* buf = workBuf + slot * bufLen * 2;
+            vertical(base, w, h, stride, c, colorMatrix, t0, t1, buf, buf + bufLen, stages);
+        });
+    }
+
+    stages.record(TRACE_FILTER_IIR_NEON);
+#else
+    LOGE("x86 kernels not available at compile time");
+#endif
+}
@@ -0,0 +1,65 @@
+/**
+ * gauss_iir_x86.h - IIR 递归高斯模糊 x86 SIMD 实现（SSE4.1 / AVX2）
+ *
+ * 优化策略（与 NEON 版本相同的数据布局与递归形式）：
+ * - SSE4.1：每个 __m128 保存 1 个 RGBA 像素；横向逐行递归，纵向每个列块 8 列
+ * - AVX2：每个 __m256 保存 2 个 RGBA 像素；横向每次递归 2 行（缓冲布局 [x][2 行][RGBA]），
+ *   纵向列块 8 列只需 4 个寄存器；递归用 FMA
+ * - uint8 ↔ float：_mm_cvtepu8_epi32 拓宽，打包为 +0.5 截断（与 NEON 的 vcvtq_u32_f32 一致）
+ *   后 packus 饱和窄化
+ *
+ * 与 NEON 版本的差异：
+ * - x86 没有 vld4 式的解交错加载，线性模式的 sRGB 查表与颜色矩阵逐像素标量处理
+ *   （仍在同一遍打包内完成，不增加整帧读写）
+ * - AVX2 的 FMA 只做一次舍入，与 SSE4.1 / NEON 结果相差不超过 1 LSB
+ *
+ * 兼容性：
+ * - 内核函数以 __attribute__((target(...))) 单独启用指令集，文件本身按基线编译，
+ *   头文件中的内联函数不会带上 AVX2 指令被链接器合并给基线代码使用
+ * - 运行时由 gaussian_iir_rgba8888_neon 按 cpu_features() 选择（AVX2 > SSE4.1 > 标量）
+ */
+
+#ifndef GAUSS_IIR_X86_H
+#define GAUSS_IIR_X86_H
+
+#include <cstdint>
+#include <cstddef>
+
+struct ColorMatrix;
+
+/**
+ * x86 内核是否已编译（内部接口：非 x86 构建返回 false）
+ */
+bool gaussian_iir_x86_kernels_compiled();
+
+/**
+ * SSE4.1 内核（内部接口：只能在 cpu_has_features(CPU_FEATURE_SSE41) 为 true 时调用）
+ *
+ * 参数与 gaussian_iir_rgba8888_neon 相同；调用方已处理 σ ≤ 0.1 的情况
+ */
+void gaussian_iir_rgba8888_sse41_kernel(
+    uint8_t* base,
+    int w,
+    int h,
+    int stride,
+    float sigma,
+    bool doLinear,
+    const ColorMatrix* colorMatrix
+);
+
+/**
+ * AVX2 内核（内部接口：只能在 cpu_has_features(CPU_FEATURE_AVX2) 为 true 时调用）
+ *
+ * 参数与 gaussian_iir_rgba8888_neon 相同；调用方已处理 σ ≤ 0.1 的情况
+ */
+void gaussian_iir_rgba8888_avx2_kernel(
+    uint8_t* base,
+    int w,
+    int h,
+    int stride,
+    float sigma,
+    bool doLinear,
+    const ColorMatrix* colorMatrix
+);
+
+#endif // GAUSS_IIR_X86_H
@@ -0,0 +1,637 @@
+/**
+ * glass_pipeline.cpp - 玻璃效果融合管线实现
+ *
+ * 实现细节：
+ * - 各阶段复用现有滤波器（IIR / Box3 / 色差 / 色散），它们内部已按行带 / 列条带并行
+ * - 模糊为整帧全局操作，中间结果须保留整帧：使用一块临时缓冲（行跨度 = width × 4），
+ *   复制阶段按行带并行处理
+ * - 饱和度构造为颜色矩阵（color_matrix.h），融合进 Box3 / IIR 的打包阶段，不单独读写一遍
+ * - 效果阶段从临时缓冲读取、写入 result，两者不重叠，可完全并行
+ * - 增量模式：模糊在子图临时缓冲上进行（滤波器本身不感知区域），
+ *   只把子图中心的有效部分写回模糊缓存；效果阶段使用 *_region 版本
+ * - 整帧模糊先按背景内容哈希查找 blur_cache，命中时只复制一次，跳过模糊与饱和度
+ * - 批量区域模糊：输入区域贪心合并为若干块，每块一块临时缓冲；块间并行时块内滤波器退化为串行
+ *   （线程池嵌套调用），因此只在块尺寸相近时按块并行
+ * - 遮罩：模糊直接在整帧缓冲的子图上原位进行（子图外的像素不读不写），
+ *   结果缓存的键带遮罩摘要，遮罩不同的帧不会命中只有部分区域有效的缓存
+ */
+
+#include "glass_pipeline.h"
+#include "gauss_iir.h"
+#include "gauss_iir_neon.h"
+#include "gauss_iir_fp16.h"
+#include "boxblur.h"
+#include "pyramid_blur.h"
+#include "color_matrix.h"
+#include "chromatic_aberration.h"
+#include "blur_cache.h"
+#include "blur_tuner.h"
+#include "frame_hash.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <android/log.h>
+
+#define LOG_TAG "GlassPipeline"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+/**
+ * 按行复制像素（行跨度可不同）
+ */
+static void copy_rows(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride, int width, int height) {
+    parallel_for(0, height, parallel_rows_grain(width), [&](int rowBegin, int rowEnd, int) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            memcpy(dst + y * dstStride, src + y * srcStride, width * 4);
+        }
+    });
+}
+
+/**
+ * 增量模式下重算区域超过整帧该比例时，改为整帧处理
+ */
+static const float kRegionFullFrameRatio = 0.6f;
+
+/**
+ * 解析实际模糊方式（SMART 按整帧尺寸选择，增量子图与整帧保持一致）
+ */
+static int resolve_blur_mode(const GlassPipelineParams& p, int width, int height) {
+    if (p.blurMode == GLASS_BLUR_NONE || p.sigma <= 0.1f) return GLASS_BLUR_NONE;
+
+    if (p.blurMode == GLASS_BLUR_SMART) {
+        // 与 NativeGauss.smartBlur 共用交叉点表（blur_tuner.h）
+        switch (blur_tuner_select(width, height, p.sigma, p.highQuality)) {
+            case BLUR_TUNER_BOX3: return GLASS_BLUR_BOX3;
+            case BLUR_TUNER_PYRAMID: return GLASS_BLUR_PYRAMID;
+            default: return GLASS_BLUR_IIR;
+        }
+    }
+    return p.blurMode;
+}
+
+/**
+ * IIR 模糊支撑半径（σ 的倍数，见 glass_blur_support）
+ */
+static const float kIirSupportSigmas = 4.0f;
+
+/**
+ * 线性色彩空间 IIR 的支撑半径（σ 的倍数）：sRGB 编码在暗部放大截断误差，需要更宽的支撑
+ */
+static const float kIirLinearSupportSigmas = 6.0f;
+
+/**
+ * σ 转换为 Box3 半径：radius ≈ σ × 1.2
+ */
+static int box3_radius(float sigma) {
+    return std::max(1, static_cast<int>(sigma * 1.2f));
+}
+
+/**
+ * 模糊 + 饱和度阶段（原位）
+ *
+ * 饱和度矩阵在 Box3 / FP32 IIR 的最终打包阶段融合套用，不再单独读写一遍；
+ * 无模糊与金字塔模糊无法融合，之后整幅套用一遍（color_matrix_rgba8888_inplace）。
+ * FP16 内核不支持矩阵：有饱和度时改用融合的 FP32 版本，省下的整帧读写比半精度算术更划算
+ *
+ * @param mode resolve_blur_mode 的结果
+ */
+static void apply_blur(uint8_t* base, int width, int height, int stride, const GlassPipelineParams& p, int mode) {
+    ColorMatrix saturation;
+    const ColorMatrix* cm = nullptr;
+    if (p.saturation != 1.0f) {
+        saturation = color_matrix_saturation(p.saturation);
+        cm = &saturation;
+    }
+
+    if (mode == GLASS_BLUR_BOX3) {
+        box3_rgba8888_inplace(base, width, height, stride, box3_radius(p.sigma), cm);
+        return;
+    }
+    if (mode == GLASS_BLUR_IIR) {
+        if (!cm && !p.highQuality && has_fp16_support()) {
+            // 非线性模式优先半精度（σ 超出 FP16 范围时内部回退 FP32）
+            gaussian_iir_rgba8888_fp16(base, width, height, stride, p.sigma);
+        } else {
+            // 按 cpu_features 选择 NEON / AVX2 / SSE4.1，无向量后端时内部回退标量版本
+            gaussian_iir_rgba8888_neon(base, width, height, stride, p.sigma, p.highQuality, cm);
+        }
+        return;
+    }
+    if (mode == GLASS_BLUR_PYRAMID) {
+        pyramid_blur_rgba8888_inplace(base, width, height, stride, p.sigma);
+    }
+    if (cm) {
+        color_matrix_rgba8888_inplace(base, width, height, stride, *cm);
+    }
+}
+
+/**
+ * 可见区域遮罩（params.maskRadius ≥ 0 时启用，见 glass_pipeline.h）
+ */
+struct PipelineMask {
+    std::vector<RowSpan> visible;   // result 需要输出的像素
+    std::vector<RowSpan> needed;    // 模糊结果中会被读取的像素（visible 外扩效果采样偏移）
+    DamageRect visibleBounds;
+    DamageRect neededBounds;
+    uint32_t digest = 0;            // 遮罩摘要（blur_cache 键，启用时非 0）
+
+    bool active() const { return !visible.empty(); }
+};
+
+/**
+ * 按参数生成遮罩（未启用时保持空）
+ */
+static void build_pipeline_mask(const GlassPipelineParams& p, int width, int height, PipelineMask* mask) {
+    if (!(p.maskRadius >= 0.0f)) return;
+
+    const DamageRect rect = p.maskRect.empty() ? damage_rect_full(width, height) : p.maskRect;
+    const int reach = glass_effect_reach(p, width, height);
+
+    mask->visible.resize(height);
+    mask->needed.resize(height);
+    row_spans_rounded_rect(rect, p.maskRadius, width, height, mask->visible.data());
+    row_spans_dilate(mask->visible.data(), height, width, reach, mask->needed.data());
+    mask->visibleBounds = row_spans_bounds(mask->visible.data(), height);
+    mask->neededBounds = row_spans_bounds(mask->needed.data(), height);
+
+    // FNV-1a：遮罩的全部输入（矩形、半径、外扩量）
+    uint32_t radiusBits;
+    memcpy(&radiusBits, &p.maskRadius, sizeof(radiusBits));
+    const uint32_t fields[6] = {
+        static_cast<uint32_t>(rect.left), static_cast<uint32_t>(rect.top),
+        static_cast<uint32_t>(rect.right), static_cast<uint32_t>(rect.bottom),
+        radiusBits, static_cast<uint32_t>(reach)
+    };
+    uint32_t digest = 2166136261u;
+    for (uint32_t f : fields) {
+        digest = (digest ^ f) * 16777619u;
+    }
+    mask->digest = digest | 1u;
+}
+
+/**
+ * 整帧 模糊 + 饱和度 阶段：backdrop → dst
+ *
+ * 有模糊且结果缓存开启时，以背景内容哈希与参数为键：命中则直接复制缓存结果，
+ * 未命中则正常计算后存入缓存（只有饱和度时计算很便宜，不缓存）
+ *
+ * 启用遮罩时只保证 mask.needed 内的结果：模糊与饱和度在 dst 中 needed 包围矩形外扩支撑半径的子图上进行
+ *
+ * @param mode resolve_blur_mode 的结果
+ */
+static void blur_stage_full(
+    const uint8_t* backdrop,
+    int backdropStride,
+    uint8_t* dst,
+    int dstStride,
+    int width,
+    int height,
+    const GlassPipelineParams& p,
+    int mode,
+    const PipelineMask& mask
+) {
+    BlurCacheKey key;
+    const bool useCache = mode != GLASS_BLUR_NONE && blur_cache_enabled();
+    if (useCache) {
+        key.hash = frame_hash_rgba8888(backdrop, width, height, backdropStride);
+        key.width = width;
+        key.height = height;
+        key.method = mode;
+        key.variant = (mode == GLASS_BLUR_IIR && p.highQuality) ? 1 : 0;
+        key.sigma = p.sigma;
+        key.saturation = p.saturation;
+        key.mask = mask.digest;
+        if (blur_cache_lookup(key, dst, dstStride)) return;
+    }
+
+    if (mask.active()) {
+        // 子图按支撑半径外扩，包围矩形内的结果与整帧模糊一致（误差见 glass_blur_support）
+        DamageRect input = damage_rect_expand(mask.neededBounds, glass_blur_support(p, width, height), width, height);
+        if (input.area() > static_cast<int64_t>(kRegionFullFrameRatio * width * height)) {
+            input = damage_rect_full(width, height);
+        }
+        if (!input.empty()) {
+            const size_t inputOffset = static_cast<size_t>(input.top) * dstStride + input.left * 4;
+            copy_rows(backdrop + static_cast<size_t>(input.top) * backdropStride + input.left * 4, backdropStride,
+                      dst + inputOffset, dstStride, input.width(), input.height());
+            apply_blur(dst + inputOffset, input.width(), input.height(), dstStride, p, mode);
+        }
+    } else {
+        copy_rows(backdrop, backdropStride, dst, dstStride, width, height);
+        apply_blur(dst, width, height, dstStride, p, mode);
+    }
+
+    if (useCache) {
+        blur_cache_store(key, dst, dstStride);
+    }
+}
+
+/**
+ * 效果阶段：从 source 读取，只写入 result 的 rect 区域（spans 非空时再与可见区间求交）
+ */
+static void apply_effect(
+    const uint8_t* source,
+    int sourceStride,
+    uint8_t* result,
+    int resultStride,
+    int width,
+    int height,
+    const GlassPipelineParams& params,
+    const DamageRect& rect,
+    const RowSpan* spans
+) {
+    if (params.effect == GLASS_EFFECT_ABERRATION) {
+        chromatic_aberration_rgba8888_region(
+            source, params.displacement, result,
+            width, height,
+            sourceStride, params.displacementStride, resultStride,
+            params.intensity, params.scale,
+            params.redOffset, params.greenOffset, params.blueOffset,
+            params.useBilinear,
+            rect,
+            spans
+        );
+    } else if (params.effect == GLASS_EFFECT_DISPERSION) {
+        chromatic_dispersion_rgba8888_region(
+            source, params.edgeDistance, params.normalMap, result,
+            width, height,
+            sourceStride, params.edgeDistanceStride, params.normalMapStride, resultStride,
+            params.refThickness, params.refFactor, params.refDispersion, params.dpr,
+            params.useBilinear,
+            rect,
+            spans
+        );
+    }
+}
+
+/**
+ * 管线公共参数校验
+ */
+static bool validate_pipeline(
+    const uint8_t* backdrop,
+    int backdropStride,
+    const uint8_t* result,
+    int resultStride,
+    int width,
+    int height,
+    const GlassPipelineParams& params
+) {
+    if (!backdrop || !result) {
+        LOGE("Invalid parameters: null pointer");
+        return false;
+    }
+
+    if (width <= 0 || height <= 0) {
+        LOGE("Invalid dimensions: %dx%d", width, height);
+        return false;
+    }
+
+    if (backdropStride < width * 4 || resultStride < width * 4) {
+        LOGE("Invalid stride: backdrop=%d, result=%d, min=%d", backdropStride, resultStride, width * 4);
+        return false;
+    }
+
+    if (params.effect == GLASS_EFFECT_ABERRATION && !params.displacement) {
+        LOGE("Aberration requires a displacement map");
+        return false;
+    }
+
+    if (params.effect == GLASS_EFFECT_DISPERSION && !params.edgeDistance) {
+        LOGE("Dispersion requires an edge distance map");
+        return false;
+    }
+
+    return true;
+}
+
+void render_glass_pipeline(
+    const uint8_t* backdrop,
+    int backdropStride,
+    uint8_t* result,
+    int resultStride,
+    int width,
+    int height,
+    const GlassPipelineParams& params
+) {
+    if (!validate_pipeline(backdrop, backdropStride, result, resultStride, width, height, params)) {
+        return;
+    }
+
+    const bool hasBlur = params.blurMode != GLASS_BLUR_NONE && params.sigma > 0.1f;
+    const bool hasSaturation = params.saturation != 1.0f;
+
+    PipelineMask mask;
+    build_pipeline_mask(params, width, height, &mask);
+
+    // 无效果阶段：直接在 result 上原位处理
+    if (params.effect == GLASS_EFFECT_NONE) {
+        blur_stage_full(backdrop, backdropStride, result, resultStride, width, height, params,
+                        resolve_blur_mode(params, width, height), mask);
+        return;
+    }
+
+    // 效果阶段的输入：有模糊 / 饱和度时为临时整帧缓冲，否则直接读取 backdrop
+    const uint8_t* effectSource = backdrop;
+    int effectStride = backdropStride;
+
+    const int frameStride = width * 4;
+    ScratchBuffer frame((hasBlur || hasSaturation) ? static_cast<size_t>(frameStride) * height : 0);
+    if (hasBlur || hasSaturation) {
+        if (!frame) {
+            LOGE("Failed to allocate pipeline frame: %dx%d", width, height);
+            return;
+        }
+        uint8_t* blurred = frame.as<uint8_t>();
+        blur_stage_full(backdrop, backdropStride, blurred, frameStride, width, height, params,
+                        resolve_blur_mode(params, width, height), mask);
+        effectSource = blurred;
+        effectStride = frameStride;
+    }
+
+    apply_effect(effectSource, effectStride, result, resultStride, width, height, params,
+                 damage_rect_full(width, height), mask.active() ? mask.visible.data() : nullptr);
+}
+
+int glass_blur_support(const GlassPipelineParams& params, int width, int height) {
+    const int mode = resolve_blur_mode(params, width, height);
+    if (mode == GLASS_BLUR_NONE) return 0;
+    if (mode == GLASS_BLUR_BOX3) {
+        // box3_rgba8888_inplace 内部把半径钳位到 50
+        return 3 * std::min(box3_radius(params.sigma), 50);
+    }
+    if (mode == GLASS_BLUR_PYRAMID) {
+        // 降采样网格以整帧左上角为原点，子图上的结果与整帧不同：支撑取整帧尺寸，强制整帧处理
+        return std::max(width, height);
+    }
+    // Deriche 响应 (1 + α|x|)·e^(-α|x|)（α ≈ 1.695/σ）的拖尾比真高斯重：
+    // 单侧 kσ 外的权重为 e^(-αkσ)·(2 + αkσ) / 4，4σ 时约 0.25%。
+    // sRGB 模式全对比度边缘处误差约 0.6 LSB / 轴，增量与整帧结果相差不超过 2 LSB；
+    // 线性模式在线性光下模糊，编码回 sRGB 时暗部斜率为 12.92，同一截断误差放大到约 8 LSB，
+    // 取 6σ（权重约 0.012%，暗部约 0.4 LSB / 轴）后同样不超过 2 LSB
+    const float sigmas = params.highQuality ? kIirLinearSupportSigmas : kIirSupportSigmas;
+    return static_cast<int>(std::ceil(sigmas * params.sigma));
+}
+
+int glass_effect_reach(const GlassPipelineParams& params, int width, int height) {
+    if (params.effect == GLASS_EFFECT_ABERRATION) {
+        return chromatic_aberration_reach(params.scale, params.redOffset, params.greenOffset, params.blueOffset);
+    }
+    if (params.effect == GLASS_EFFECT_DISPERSION) {
+        return chromatic_dispersion_reach(width, height, params.refThickness, params.refFactor,
+                                          params.refDispersion, params.dpr);
+    }
+    return 0;
+}
+
+void render_glass_pipeline_region(
+    const uint8_t* backdrop,
+    int backdropStride,
+    uint8_t* blurred,
+    int blurredStride,
+    uint8_t* result,
+    int resultStride,
+    int width,
+    int height,
+    const GlassPipelineParams& params,
+    const DamageRect& damage,
+    DamageRect* updated
+) {
+    if (updated) *updated = DamageRect();
+
+    if (!validate_pipeline(backdrop, backdropStride, result, resultStride, width, height, params)) {
+        return;
+    }
+
+    // 无效果阶段时 result 就是模糊缓存
+    const bool hasEffect = params.effect != GLASS_EFFECT_NONE;
+    uint8_t* cache = hasEffect ? blurred : result;
+    const int cacheStride = hasEffect ? blurredStride : resultStride;
+    if (!cache || cacheStride < width * 4 || cache == backdrop || (hasEffect && cache == result)) {
+        LOGE("Region pipeline requires a separate blurred cache: %p, stride=%d", cache, cacheStride);
+        return;
+    }
+
+    const DamageRect full = damage_rect_full(width, height);
+    const DamageRect dirty = damage_rect_expand(damage, 0, width, height);
+    if (dirty.empty()) return;
+
+    PipelineMask mask;
+    build_pipeline_mask(params, width, height, &mask);
+
+    // B：模糊结果变化的区域（遮罩下只取会被读取的部分）；I：计算 B 所需的输入区域
+    const int mode = resolve_blur_mode(params, width, height);
+    const int support = glass_blur_support(params, width, height);
+    DamageRect blurRect = damage_rect_expand(dirty, support, width, height);
+    if (mask.active()) {
+        blurRect = damage_rect_intersect(blurRect, mask.neededBounds);
+        if (blurRect.empty()) return;
+    }
+    DamageRect inputRect = damage_rect_expand(blurRect, support, width, height);
+    if (inputRect.area() > static_cast<int64_t>(kRegionFullFrameRatio * width * height)) {
+        blurRect = full;
+        inputRect = full;
+    }
+
+    if (inputRect == full) {
+        blur_stage_full(backdrop, backdropStride, cache, cacheStride, width, height, params, mode, mask);
+        if (mask.active()) blurRect = mask.neededBounds;
+    } else {
+        // 在子图上模糊，只写回中心的 B 区域
+        const int tileWidth = inputRect.width();
+        const int tileHeight = inputRect.height();
+        const int tileStride = tileWidth * 4;
+        ScratchBuffer tile(static_cast<size_t>(tileStride) * tileHeight);
+        if (!tile) {
+            LOGE("Failed to allocate region tile: %dx%d", tileWidth, tileHeight);
+            return;
+        }
+        uint8_t* tilePixels = tile.as<uint8_t>();
+        copy_rows(backdrop + inputRect.top * backdropStride + inputRect.left * 4, backdropStride,
+                  tilePixels, tileStride, tileWidth, tileHeight);
+        apply_blur(tilePixels, tileWidth, tileHeight, tileStride, params, mode);
+
+        const uint8_t* tileBlur = tilePixels + (blurRect.top - inputRect.top) * tileStride +
+                                  (blurRect.left - inputRect.left) * 4;
+        copy_rows(tileBlur, tileStride, cache + blurRect.top * cacheStride + blurRect.left * 4, cacheStride,
+                  blurRect.width(), blurRect.height());
+    }
+
+    if (!hasEffect) {
+        if (updated) *updated = mask.active() ? damage_rect_intersect(blurRect, mask.visibleBounds) : blurRect;
+        return;
+    }
+
+    DamageRect effectRect = blurRect == full
+        ? full
+        : damage_rect_expand(blurRect, glass_effect_reach(params, width, height), width, height);
+    if (mask.active()) {
+        effectRect = damage_rect_intersect(effectRect, mask.visibleBounds);
+    }
+    apply_effect(cache, cacheStride, result, resultStride, width, height, params, effectRect,
+                 mask.active() ? mask.visible.data() : nullptr);
+    if (updated) *updated = effectRect;
+}
+
+/**
+ * 批量区域模糊的一个合并块
+ */
+struct BlurRegionBlock {
+    DamageRect input;           // 模糊输入区域（成员矩形按支撑半径扩展后的包围矩形）
+    std::vector<int> members;   // 块内矩形下标
+};
+
+/**
+ * 两个矩形是否相交（半开区间）
+ */
+static bool rects_intersect(const DamageRect& a, const DamageRect& b) {
+    return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+}
+
+/**
+ * 贪心合并：成员矩形相交（输出可能重叠，须在同一块内按顺序写入）、
+ * 或合并后的输入区域面积不超过两者之和时合并，直到不能再合并
+ */
+static void merge_blur_blocks(std::vector<BlurRegionBlock>& blocks, const DamageRect* rects) {
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < blocks.size() && !merged; ++i) {
+            for (size_t j = i + 1; j < blocks.size() && !merged; ++j) {
+                const DamageRect u = damage_rect_union(blocks[i].input, blocks[j].input);
+                bool overlap = u.area() <= blocks[i].input.area() + blocks[j].input.area();
+                for (size_t a = 0; a < blocks[i].members.size() && !overlap; ++a) {
+                    for (size_t b = 0; b < blocks[j].members.size() && !overlap; ++b) {
+                        overlap = rects_intersect(rects[blocks[i].members[a]], rects[blocks[j].members[b]]);
+                    }
+                }
+                if (!overlap) continue;
+
+                blocks[i].input = u;
+                blocks[i].members.insert(blocks[i].members.end(), blocks[j].members.begin(), blocks[j].members.end());
+                blocks.erase(blocks.begin() + j);
+                merged = true;
+            }
+        }
+    }
+}
+
+/**
+ * 处理一个合并块：复制输入区域 → 模糊 + 饱和度 → 写出各成员
+ *
+ * @return 是否成功（临时缓冲分配失败时为 false）
+ */
+static bool blur_region_block(
+    const uint8_t* backdrop,
+    int backdropStride,
+    const GlassPipelineParams& params,
+    int mode,
+    const BlurRegionBlock& block,
+    const DamageRect* rects,
+    uint8_t* const* outputs,
+    const int* outputStrides
+) {
+    const DamageRect& input = block.input;
+    const int tileWidth = input.width();
+    const int tileHeight = input.height();
+    const int tileStride = tileWidth * 4;
+    ScratchBuffer tile(static_cast<size_t>(tileStride) * tileHeight);
+    if (!tile) {
+        LOGE("Failed to allocate region block: %dx%d", tileWidth, tileHeight);
+        return false;
+    }
+    uint8_t* tilePixels = tile.as<uint8_t>();
+    copy_rows(backdrop + input.top * backdropStride + input.left * 4, backdropStride,
+              tilePixels, tileStride, tileWidth, tileHeight);
+    apply_blur(tilePixels, tileWidth, tileHeight, tileStride, params, mode);
+
+    for (int index : block.members) {
+        const DamageRect& r = rects[index];
+        copy_rows(tilePixels + (r.top - input.top) * tileStride + (r.left - input.left) * 4, tileStride,
+                  outputs[index], outputStrides[index], r.width(), r.height());
+    }
+    return true;
+}
+
+int render_glass_blur_regions(
+    const uint8_t* backdrop,
+    int backdropStride,
+    int width,
+    int height,
+    const GlassPipelineParams& params,
+    const DamageRect* rects,
+    int count,
+    uint8_t* const* outputs,
+    const int* outputStrides
+) {
+    if (!backdrop || width <= 0 || height <= 0 || backdropStride < width * 4 ||
+        count < 0 || (count > 0 && (!rects || !outputs || !outputStrides))) {
+        LOGE("Blur regions: invalid parameters (%dx%d, stride=%d, count=%d)", width, height, backdropStride, count);
+        return -1;
+    }
+
+    const DamageRect full = damage_rect_full(width, height);
+    const int mode = resolve_blur_mode(params, width, height);
+    const int support = glass_blur_support(params, width, height);
+
+    std::vector<BlurRegionBlock> blocks;
+    for (int i = 0; i < count; ++i) {
+        const DamageRect& r = rects[i];
+        if (!outputs[i]) continue;
+        if (r.empty() || r.left < 0 || r.top < 0 || r.right > width || r.bottom > height ||
+            outputStrides[i] < r.width() * 4) {
+            LOGE("Blur regions: skip rect %d [%d, %d, %d, %d], stride=%d",
+                 i, r.left, r.top, r.right, r.bottom, outputStrides[i]);
+            continue;
+        }
+        BlurRegionBlock block;
+        block.input = damage_rect_expand(r, support, width, height);
+        block.members.push_back(i);
+        blocks.push_back(block);
+    }
+    if (blocks.empty()) return 0;
+
+    merge_blur_blocks(blocks, rects);
+
+    // 合并后仍覆盖大半帧：整帧模糊一次更省（块之间的重复支撑区域更多）
+    int64_t totalArea = 0;
+    int64_t maxArea = 0;
+    for (const BlurRegionBlock& block : blocks) {
+        totalArea += block.input.area();
+        maxArea = std::max(maxArea, block.input.area());
+    }
+    if (blocks.size() > 1 && totalArea > static_cast<int64_t>(kRegionFullFrameRatio * width * height)) {
+        for (size_t i = 1; i < blocks.size(); ++i) {
+            blocks[0].members.insert(blocks[0].members.end(), blocks[i].members.begin(), blocks[i].members.end());
+        }
+        blocks.resize(1);
+        blocks[0].input = full;
+        totalArea = maxArea = full.area();
+    }
+
+    const int blockCount = static_cast<int>(blocks.size());
+    bool ok = true;
+    if (blockCount > 1 && maxArea * 2 <= totalArea) {
+        // 块尺寸相近：按块并行（块内滤波器在工作线程上串行执行）
+        std::vector<char> blockOk(blockCount, 1);
+        parallel_for(0, blockCount, 1, [&](int blockBegin, int blockEnd, int) {
+            for (int b = blockBegin; b < blockEnd; ++b) {
+                blockOk[b] = blur_region_block(backdrop, backdropStride, params, mode, blocks[b],
+                                               rects, outputs, outputStrides);
+            }
+        });
+        for (char v : blockOk) ok = ok && v;
+    } else {
+        // 单块或某一块占主导：逐块处理，块内滤波器自身并行
+        for (const BlurRegionBlock& block : blocks) {
+            ok = blur_region_block(backdrop, backdropStride, params, mode, block,
+                                   rects, outputs, outputStrides) && ok;
+        }
+    }
+
+    LOGD("Blur regions: %d rects -> %d blocks (%lld px of %d)", count, blockCount,
+         static_cast<long long>(totalArea), width * height);
+    return ok ? blockCount : -1;
+}
@@ -0,0 +1,219 @@
+/**
+ * glass_pipeline.h - 玻璃效果融合管线（模糊 → 饱和度 → 色差 / 色散）
+ *
+ * 背景：
+ * - Kotlin 层逐个调用模糊、色差、色散 JNI，每一步都要锁定 / 解锁 Bitmap，
+ *   并生成一张整帧中间 Bitmap（外加一次 blurred.copy）
+ * - 这里把整条链路放到一次原生调用中完成，中间结果只存在于临时缓冲池
+ *
+ * 数据流：
+ *   backdrop ──复制──▶ 临时整帧缓冲 ──模糊 + 饱和度(原位)──▶ ──色差/色散──▶ result
+ * - 饱和度以颜色矩阵融合进模糊的最终打包阶段（color_matrix.h），只有无法融合的模糊方式才单独套用一遍
+ * - 无效果阶段时直接在 result 上原位模糊，不占用临时缓冲
+ * - 既无模糊也无饱和度时，效果阶段直接读取 backdrop
+ * - 临时缓冲来自 scratch_arena，跨帧复用，不产生 Java 堆分配
+ * - 整帧模糊结果按背景内容哈希存入 blur_cache：相同背景、相同参数再次渲染时跳过模糊与饱和度
+ *
+ * 增量模式（render_glass_pipeline_region）：
+ * - 调用方保留上一帧的模糊结果（blurred）与最终结果（result），只传入背景变化矩形 D
+ * - 模糊只重算 B = D 外扩模糊支撑半径 S（IIR 4σ，Box3 3r）的区域，
+ *   输入取 B 再外扩 S 的区域，使 B 内的结果不受子图边界影响
+ * - 色差 / 色散只重算 B 外扩最大采样偏移的区域
+ * - 重算区域超过整帧 60% 时退化为整帧处理（子图复制与边界外扩不再划算）
+ *
+ * 可见区域遮罩（maskRadius ≥ 0，对应 LiquidGlassView 的圆角 clipPath）：
+ * - 遮罩转换为逐行可见区间（row_spans.h）；色差 / 色散只处理区间内的像素
+ * - 模糊结果只需覆盖可见区间外扩效果采样偏移的部分：模糊只处理其包围矩形外扩支撑半径的子图
+ *   （捕获边距、遮罩外的行列不再参与滤波）。递归滤波按整行 / 整列运行，包围矩形内的四角仍会被模糊
+ * - 遮罩外的 result 像素内容未定义（可能保留旧值，也可能是未完成的中间结果），须由调用方裁剪掉
+ *
+ * 线程安全：
+ * - 与各单独滤波器相同：不要对同一块内存并发调用
+ */
+
+#ifndef GLASS_PIPELINE_H
+#define GLASS_PIPELINE_H
+
+#include <cstdint>
+#include <cstddef>
+#include "damage_rect.h"
+#include "row_spans.h"
+
+/**
+ * 模糊方式（与 NativeGlassPipeline.kt 中的常量保持一致）
+ */
+enum GlassBlurMode {
+    GLASS_BLUR_NONE  = 0,  // 不模糊
+    GLASS_BLUR_IIR   = 1,  // IIR 递归高斯（非线性模式优先 FP16，其次 NEON 版本）
+    GLASS_BLUR_BOX3  = 2,  // 三次盒式模糊（radius = σ × 1.2）
+    GLASS_BLUR_SMART = 3,  // 智能选择（与 NativeGauss.smartBlur 共用 blur_tuner 交叉点表）
+    GLASS_BLUR_PYRAMID = 4 // 多级降采样金字塔（大半径；非线性模式，忽略 highQuality）
+};
+
+/**
+ * 效果阶段（色差与色散互斥）
+ */
+enum GlassEffect {
+    GLASS_EFFECT_NONE       = 0,
+    GLASS_EFFECT_ABERRATION = 1,
+    GLASS_EFFECT_DISPERSION = 2
+};
+
+/**
+ * 管线参数
+ *
+ * 各字段含义与对应单独滤波器的参数相同：
+ * - 模糊：gaussian_iir_rgba8888_inplace / box3_rgba8888_inplace
+ * - 色差：chromatic_aberration_rgba8888（offset 已由调用方乘以 intensity）
+ * - 色散：chromatic_dispersion_rgba8888
+ */
+struct GlassPipelineParams {
+    // 模糊
+    int blurMode = GLASS_BLUR_NONE;
+    float sigma = 0.0f;
+    bool highQuality = false;       // IIR 线性色彩空间
+
+    // 饱和度（1.0 = 原始，1.4 = 增强 40%；与 ColorMatrix.setSaturation 相同系数）
+    float saturation = 1.0f;
+
+    // 效果
+    int effect = GLASS_EFFECT_NONE;
+    bool useBilinear = true;
+
+    // 色差
+    const uint8_t* displacement = nullptr;
+    int displacementStride = 0;
+    float intensity = 0.0f;
+    float scale = 0.0f;
+    float redOffset = 0.0f;
+    float greenOffset = -0.05f;
+    float blueOffset = -0.1f;
+
+    // 色散
+    const uint8_t* edgeDistance = nullptr;
+    int edgeDistanceStride = 0;
+    const uint8_t* normalMap = nullptr;   // 可选，nullptr 使用径向法线
+    int normalMapStride = 0;
+    float refThickness = 100.0f;
+    float refFactor = 1.5f;
+    float refDispersion = 7.0f;
+    float dpr = 1.0f;
+
+    // 可见区域遮罩（圆角矩形）：maskRadius < 0 表示不遮罩；maskRect 为空时取整帧
+    DamageRect maskRect;
+    float maskRadius = -1.0f;
+};
+
+/**
+ * 执行玻璃效果管线
+ *
+ * @param backdrop 背景像素（RGBA8888，只读）
+ * @param backdropStride 背景行跨度（字节数）
+ * @param result 结果像素（RGBA8888，与 backdrop 尺寸相同，不能与 backdrop 重叠）
+ * @param resultStride 结果行跨度（字节数）
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param params 管线参数（效果所需贴图必须与 backdrop 尺寸相同）
+ */
+void render_glass_pipeline(
+    const uint8_t* backdrop,
+    int backdropStride,
+    uint8_t* result,
+    int resultStride,
+    int width,
+    int height,
+    const GlassPipelineParams& params
+);
+
+/**
+ * 模糊支撑半径（像素）：输出像素只依赖输入中距离不超过该值的像素
+ *
+ * - IIR：ceil(4σ)，线性色彩空间（highQuality）为 ceil(6σ)
+ *   （Deriche 响应拖尾较重，sRGB 编码又在暗部放大截断误差；两种模式下增量结果与整帧相差均不超过 2 LSB）
+ * - Box3：3 × radius（三次盒式的精确支撑，增量结果与整帧逐位一致）
+ * - 金字塔：max(width, height)（层级网格与整帧对齐，子图结果不同，增量模式退化为整帧）
+ * - 无模糊：0
+ *
+ * @param params 管线参数
+ * @param width 整帧宽度（SMART 模式按整帧尺寸选择方式）
+ * @param height 整帧高度
+ */
+int glass_blur_support(const GlassPipelineParams& params, int width, int height);
+
+/**
+ * 效果阶段的最大采样偏移（像素，无效果时为 0）
+ */
+int glass_effect_reach(const GlassPipelineParams& params, int width, int height);
+
+/**
+ * 执行玻璃效果管线（增量版本）
+ *
+ * 前提：blurred / result 中保存着上一帧相同参数下的输出，且当前 backdrop 与上一帧
+ * 只在 damage 区域内不同。damage 为整帧时等价于 render_glass_pipeline，并同时填充 blurred
+ * （首帧或参数变化时这样调用即可建立缓存）
+ *
+ * @param backdrop 背景像素（RGBA8888，只读）
+ * @param backdropStride 背景行跨度（字节数）
+ * @param blurred 模糊 + 饱和度结果缓存（与 backdrop 尺寸相同，跨帧保留）；
+ *                无效果阶段时 result 本身就是模糊结果，可传 nullptr
+ * @param blurredStride 缓存行跨度（字节数）
+ * @param result 结果像素（跨帧保留）
+ * @param resultStride 结果行跨度（字节数）
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param params 管线参数
+ * @param damage 背景变化区域（自动裁剪；空矩形时不做任何处理）
+ * @param updated 输出 result 中实际重写的区域（可为 nullptr）
+ */
+void render_glass_pipeline_region(
+    const uint8_t* backdrop,
+    int backdropStride,
+    uint8_t* blurred,
+    int blurredStride,
+    uint8_t* result,
+    int resultStride,
+    int width,
+    int height,
+    const GlassPipelineParams& params,
+    const DamageRect& damage,
+    DamageRect* updated = nullptr
+);
+
+/**
+ * 批量区域模糊：同一张背景上的多个矩形（如多张玻璃卡片）共用一次模糊
+ *
+ * 流程：
+ * 1. 每个矩形按模糊支撑半径（glass_blur_support）扩展为所需输入区域
+ * 2. 矩形相交、或合并后面积不超过两者之和的输入区域合并为一块，重叠部分只模糊一次
+ * 3. 每块复制到临时缓冲、执行模糊 + 饱和度，再把块内各矩形复制到各自输出；
+ *    多块尺寸相近时按块在线程池上并行，否则块内滤波器自身并行
+ * 4. 合并后总面积超过整帧的 60% 时退化为整帧模糊一次（与增量管线相同的阈值）
+ *
+ * 只执行模糊与饱和度阶段（params.effect 与遮罩被忽略）；每个矩形的结果与整帧模糊后裁剪一致：
+ * IIR 在 sRGB 与线性模式下均相差不超过 2 LSB（线性模式支撑取 6σ），Box3 逐位一致（见 glass_blur_support）
+ *
+ * @param backdrop 背景像素（RGBA8888，只读）
+ * @param backdropStride 背景行跨度（字节数）
+ * @param width 背景宽度
+ * @param height 背景高度
+ * @param params 管线参数（使用 blurMode / sigma / highQuality / saturation）
+ * @param rects 输出矩形（整帧坐标，必须位于背景范围内且非空，否则跳过）
+ * @param count 矩形数量
+ * @param outputs 每个矩形的输出起点（矩形尺寸；可以指向整帧缓冲中对应位置作为"视图"，
+ *                也可以是独立缓冲；nullptr 表示跳过该矩形）。输出不能与 backdrop 重叠
+ * @param outputStrides 每个输出的行跨度（字节数）
+ * @return 实际模糊的块数（参数无效时为 -1）
+ */
+int render_glass_blur_regions(
+    const uint8_t* backdrop,
+    int backdropStride,
+    int width,
+    int height,
+    const GlassPipelineParams& params,
+    const DamageRect* rects,
+    int count,
+    uint8_t* const* outputs,
+    const int* outputStrides
+);
+
+#endif // GLASS_PIPELINE_H
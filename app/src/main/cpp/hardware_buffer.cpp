@@ -0,0 +1,221 @@
+/**
+ * hardware_buffer.cpp - AHardwareBuffer 零拷贝输入 / 输出实现
+ *
+ * 实现细节：
+ * - 所需的 API 26 函数在首次使用时用 dlopen / dlsym 解析一次，之后只读访问函数指针表
+ * - 类型与常量直接取自 NDK 头文件（不受 minSdk 限制），只有函数调用走函数指针
+ * - 捕获帧：AImageReader_acquireLatestImageAsync 返回获取栅栏，交给 AHardwareBuffer_lock 等待，
+ *   UI 线程不必为 GPU 绘制完成而阻塞在 Java 层
+ */
+
+#include "hardware_buffer.h"
+#include <dlfcn.h>
+#include <mutex>
+#include <unistd.h>
+#include <android/native_window.h>
+#include <media/NdkImageReader.h>
+#include <android/log.h>
+
+#define LOG_TAG "HardwareBuffer"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+/**
+ * 运行时解析的 NDK 函数（API 26+）
+ */
+struct HardwareBufferApi {
+    // libandroid.so
+    AHardwareBuffer* (*fromHardwareBuffer)(JNIEnv*, jobject);
+    void (*describe)(const AHardwareBuffer*, AHardwareBuffer_Desc*);
+    int (*lock)(AHardwareBuffer*, uint64_t, int32_t, const ARect*, void**);
+    int (*unlock)(AHardwareBuffer*, int32_t*);
+    jobject (*windowToSurface)(JNIEnv*, ANativeWindow*);
+
+    // libmediandk.so
+    media_status_t (*readerNewWithUsage)(int32_t, int32_t, int32_t, uint64_t, int32_t, AImageReader**);
+    void (*readerDelete)(AImageReader*);
+    media_status_t (*readerGetWindow)(AImageReader*, ANativeWindow**);
+    media_status_t (*readerAcquireLatestAsync)(AImageReader*, AImage**, int*);
+    media_status_t (*imageGetHardwareBuffer)(const AImage*, AHardwareBuffer**);
+    void (*imageDelete)(AImage*);
+
+    bool bufferReady;
+    bool captureReady;
+};
+
+template <typename T>
+static bool resolve(void* lib, const char* name, T* fn) {
+    *fn = lib ? reinterpret_cast<T>(dlsym(lib, name)) : nullptr;
+    return *fn != nullptr;
+}
+
+static const HardwareBufferApi& get_api() {
+    static HardwareBufferApi api = {};
+    static std::once_flag once;
+    std::call_once(once, [] {
+        // 两个库在 API 26+ 的进程中均已加载，dlopen 只增加引用计数；有意不 dlclose
+        void* android = dlopen("libandroid.so", RTLD_NOW);
+        void* media = dlopen("libmediandk.so", RTLD_NOW);
+
+        api.bufferReady =
+            resolve(android, "AHardwareBuffer_fromHardwareBuffer", &api.fromHardwareBuffer) &
+            resolve(android, "AHardwareBuffer_describe", &api.describe) &
+            resolve(android, "AHardwareBuffer_lock", &api.lock) &
+            resolve(android, "AHardwareBuffer_unlock", &api.unlock);
+
+        api.captureReady = api.bufferReady &
+            resolve(android, "ANativeWindow_toSurface", &api.windowToSurface) &
+            resolve(media, "AImageReader_newWithUsage", &api.readerNewWithUsage) &
+            resolve(media, "AImageReader_delete", &api.readerDelete) &
+            resolve(media, "AImageReader_getWindow", &api.readerGetWindow) &
+            resolve(media, "AImageReader_acquireLatestImageAsync", &api.readerAcquireLatestAsync) &
+            resolve(media, "AImage_getHardwareBuffer", &api.imageGetHardwareBuffer) &
+            resolve(media, "AImage_delete", &api.imageDelete);
+
+        LOGD("AHardwareBuffer %s, AImageReader capture %s",
+             api.bufferReady ? "available" : "unavailable",
+             api.captureReady ? "available" : "unavailable");
+    });
+    return api;
+}
+
+bool hardware_buffer_supported() {
+    return get_api().bufferReady;
+}
+
+bool hardware_capture_supported() {
+    return get_api().captureReady;
+}
+
+AHardwareBuffer* hardware_buffer_from_java(JNIEnv* env, jobject hardwareBuffer) {
+    const HardwareBufferApi& api = get_api();
+    if (!api.bufferReady || hardwareBuffer == nullptr) return nullptr;
+    return api.fromHardwareBuffer(env, hardwareBuffer);
+}
+
+bool hardware_buffer_lock(AHardwareBuffer* buffer, uint64_t usage, int fence, MappedHardwareBuffer* out) {
+    const HardwareBufferApi& api = get_api();
+    *out = MappedHardwareBuffer();
+    if (!api.bufferReady || buffer == nullptr) {
+        if (fence >= 0) close(fence);
+        return false;
+    }
+
+    AHardwareBuffer_Desc desc;
+    api.describe(buffer, &desc);
+    if ((desc.format != AHARDWAREBUFFER_FORMAT_R8G8B8A8_UNORM &&
+         desc.format != AHARDWAREBUFFER_FORMAT_R8G8B8X8_UNORM) || desc.layers != 1) {
+        LOGE("Unsupported hardware buffer: format=%u layers=%u", desc.format, desc.layers);
+        if (fence >= 0) close(fence);
+        return false;
+    }
+
+    void* pixels = nullptr;
+    const int ret = api.lock(buffer, usage, fence, nullptr, &pixels);
+    if (ret != 0 || pixels == nullptr) {
+        LOGE("AHardwareBuffer_lock failed: %d", ret);
+        return false;
+    }
+
+    out->buffer = buffer;
+    out->pixels = static_cast<uint8_t*>(pixels);
+    out->width = static_cast<int>(desc.width);
+    out->height = static_cast<int>(desc.height);
+    out->stride = static_cast<int>(desc.stride) * 4;    // desc.stride 以像素计
+    return true;
+}
+
+void hardware_buffer_unlock(MappedHardwareBuffer* mapped) {
+    if (mapped == nullptr || mapped->buffer == nullptr) return;
+    // fence 传 nullptr：等待 CPU 写入完成后再返回，GPU 随后可直接采样
+    get_api().unlock(mapped->buffer, nullptr);
+    *mapped = MappedHardwareBuffer();
+}
+
+struct HardwareCapture {
+    AImageReader* reader = nullptr;
+    ANativeWindow* window = nullptr;    // 归 reader 所有
+    AImage* image = nullptr;            // 当前持有的帧
+    MappedHardwareBuffer mapped;
+};
+
+HardwareCapture* hardware_capture_create(int width, int height) {
+    const HardwareBufferApi& api = get_api();
+    if (!api.captureReady || width <= 0 || height <= 0) return nullptr;
+
+    // 3 帧：本次绘制 1 帧 + 原生持有 1 帧 + 余量
+    const uint64_t usage = AHARDWAREBUFFER_USAGE_GPU_COLOR_OUTPUT | AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN;
+    AImageReader* reader = nullptr;
+    media_status_t status = api.readerNewWithUsage(width, height, AIMAGE_FORMAT_RGBA_8888, usage, 3, &reader);
+    if (status != AMEDIA_OK || reader == nullptr) {
+        LOGE("AImageReader_newWithUsage failed: %d (%dx%d)", status, width, height);
+        return nullptr;
+    }
+
+    ANativeWindow* window = nullptr;
+    status = api.readerGetWindow(reader, &window);
+    if (status != AMEDIA_OK || window == nullptr) {
+        LOGE("AImageReader_getWindow failed: %d", status);
+        api.readerDelete(reader);
+        return nullptr;
+    }
+
+    HardwareCapture* capture = new HardwareCapture();
+    capture->reader = reader;
+    capture->window = window;
+    return capture;
+}
+
+void hardware_capture_release(HardwareCapture* capture) {
+    if (capture == nullptr || capture->image == nullptr) return;
+    hardware_buffer_unlock(&capture->mapped);
+    get_api().imageDelete(capture->image);
+    capture->image = nullptr;
+}
+
+void hardware_capture_destroy(HardwareCapture* capture) {
+    if (capture == nullptr) return;
+    hardware_capture_release(capture);
+    get_api().readerDelete(capture->reader);
+    delete capture;
+}
+
+jobject hardware_capture_surface(JNIEnv* env, HardwareCapture* capture) {
+    if (capture == nullptr) return nullptr;
+    return get_api().windowToSurface(env, capture->window);
+}
+
+bool hardware_capture_acquire(HardwareCapture* capture, MappedHardwareBuffer* out) {
+    *out = MappedHardwareBuffer();
+    if (capture == nullptr) return false;
+    const HardwareBufferApi& api = get_api();
+
+    AImage* image = nullptr;
+    int fence = -1;
+    media_status_t status = api.readerAcquireLatestAsync(capture->reader, &image, &fence);
+    if (status != AMEDIA_OK || image == nullptr) {
+        // AMEDIA_IMGREADER_NO_BUFFER_AVAILABLE：Surface 上还没有新绘制的帧
+        return false;
+    }
+
+    // 新帧到达后才归还上一帧（没有新帧时上一帧依然有效，由调用方决定是否复用）
+    hardware_capture_release(capture);
+
+    AHardwareBuffer* buffer = nullptr;
+    status = api.imageGetHardwareBuffer(image, &buffer);
+    if (status != AMEDIA_OK || buffer == nullptr) {
+        LOGE("AImage_getHardwareBuffer failed: %d", status);
+        if (fence >= 0) close(fence);
+        api.imageDelete(image);
+        return false;
+    }
+
+    if (!hardware_buffer_lock(buffer, AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN, fence, &capture->mapped)) {
+        api.imageDelete(image);
+        return false;
+    }
+
+    capture->image = image;
+    *out = capture->mapped;
+    return true;
+}
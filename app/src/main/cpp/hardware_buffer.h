@@ -0,0 +1,110 @@
+/**
+ * hardware_buffer.h - AHardwareBuffer 零拷贝输入 / 输出
+ *
+ * 背景：
+ * - 所有原生入口都经过 lock_bitmap → AndroidBitmap_lockPixels，只能处理软件 Bitmap
+ * - 背景捕获先把父视图画进一张新的软件 Bitmap，处理完的结果绘制时还要再上传一次纹理：
+ *   每帧两次整帧复制 + 一次纹理上传
+ *
+ * 方案：
+ * - 捕获：AImageReader（GPU_COLOR_OUTPUT | CPU_READ）提供 Surface，Kotlin 层用
+ *   lockHardwareCanvas 把父视图画进去；原生侧取最新一帧的 AHardwareBuffer，
+ *   按获取栅栏（acquire fence）等待 GPU 写完后直接映射读取
+ * - 输出：结果写入 GPU_SAMPLED_IMAGE | CPU_WRITE 的 HardwareBuffer，
+ *   Kotlin 层用 Bitmap.wrapHardwareBuffer 包装成 HARDWARE Bitmap，绘制时 GPU 直接采样
+ *
+ * 兼容性：
+ * - AHardwareBuffer / AImageReader 接口从 API 26 开始提供，应用 minSdk 更低，
+ *   因此运行时通过 dlsym 从 libandroid.so / libmediandk.so 解析；不可用时各函数返回失败，
+ *   调用方回退到 Bitmap 路径
+ *
+ * 线程安全：
+ * - 同一个 HardwareCapture 不要并发使用；不同 AHardwareBuffer 可在不同线程映射
+ */
+
+#ifndef HARDWARE_BUFFER_H
+#define HARDWARE_BUFFER_H
+
+#include <jni.h>
+#include <cstdint>
+#include <android/hardware_buffer.h>
+
+struct HardwareCapture;
+
+/**
+ * 已映射到 CPU 的 RGBA8888 缓冲
+ */
+struct MappedHardwareBuffer {
+    AHardwareBuffer* buffer = nullptr;
+    uint8_t* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    int stride = 0;      // 行跨度（字节数）
+};
+
+/**
+ * 当前设备是否支持 AHardwareBuffer 映射（API 26+，首次调用时解析符号）
+ */
+bool hardware_buffer_supported();
+
+/**
+ * 当前设备是否支持 AImageReader 捕获
+ */
+bool hardware_capture_supported();
+
+/**
+ * 从 android.hardware.HardwareBuffer 取得 AHardwareBuffer（不增加引用计数）
+ *
+ * @return 失败（不支持或对象为空）时返回 nullptr
+ */
+AHardwareBuffer* hardware_buffer_from_java(JNIEnv* env, jobject hardwareBuffer);
+
+/**
+ * 映射 AHardwareBuffer 到 CPU
+ *
+ * @param buffer 缓冲（格式须为 R8G8B8A8_UNORM 或 R8G8B8X8_UNORM，单层）
+ * @param usage CPU 访问方式（AHARDWAREBUFFER_USAGE_CPU_READ_* / CPU_WRITE_* 组合）
+ * @param fence 映射前要等待的栅栏 fd（-1 = 不等待）；所有权转移给本函数
+ * @param out 输出：映射结果
+ * @return 是否成功
+ */
+bool hardware_buffer_lock(AHardwareBuffer* buffer, uint64_t usage, int fence, MappedHardwareBuffer* out);
+
+/**
+ * 解除映射（等待 CPU 写入对 GPU 可见后返回）
+ */
+void hardware_buffer_unlock(MappedHardwareBuffer* mapped);
+
+/**
+ * 创建捕获器（AImageReader，最多同时持有 3 帧）
+ *
+ * @return 捕获器；不支持或创建失败时返回 nullptr
+ */
+HardwareCapture* hardware_capture_create(int width, int height);
+
+/**
+ * 释放捕获器（同时释放尚未归还的帧）
+ */
+void hardware_capture_destroy(HardwareCapture* capture);
+
+/**
+ * 捕获器的输入 Surface（Java 对象，局部引用）
+ */
+jobject hardware_capture_surface(JNIEnv* env, HardwareCapture* capture);
+
+/**
+ * 取最新一帧并映射为只读（等待 GPU 写完）
+ *
+ * 上一次 acquire 的帧在本次调用中归还给 AImageReader
+ *
+ * @param out 输出：映射结果，有效期到下一次 acquire / release / destroy
+ * @return false 表示没有新帧或映射失败
+ */
+bool hardware_capture_acquire(HardwareCapture* capture, MappedHardwareBuffer* out);
+
+/**
+ * 归还当前帧（解除映射并交还 AImageReader）
+ */
+void hardware_capture_release(HardwareCapture* capture);
+
+#endif // HARDWARE_BUFFER_H
@@ -23,10 +23,30 @@
 #include <android/bitmap.h>
 #include <android/log.h>
 #include <cstring>
+#include <algorithm>
+#include <vector>
 #include "gauss_iir.h"
 #include "gauss_iir_neon.h"
+#include "cpu_features.h"
+#include "gauss_iir_fp16.h"
+#include "gauss_iir_stream.h"
 #include "boxblur.h"
 #include "chromatic_aberration.h"
+#include "color_matrix.h"
+#include "glass_pipeline.h"
+#include "damage_rect.h"
+#include "blur_cache.h"
+#include "blur_tuner.h"
+#include "frame_hash.h"
+#include "hardware_buffer.h"
+#include "pyramid_blur.h"
+#include "render_queue.h"
+#include "resampler.h"
+#include "sdf_generator.h"
+#include "displacement_map.h"
+#include "perf_trace.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
 
 #define LOG_TAG "NativeGauss"
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
@@ -90,6 +110,40 @@ static bool lock_bitmap(
     return true;
 }
 
+/**
+ * 辅助函数：读取可选的颜色矩阵参数
+ *
+ * @param matrix android.graphics.ColorMatrix 数组（20 个元素），null 表示不套用
+ * @param out 输出：预处理后的矩阵
+ * @param has 输出：是否提供了矩阵
+ * @return true 成功，false 失败（已抛出异常）
+ */
+static bool read_color_matrix(
+    JNIEnv* env,
+    jfloatArray matrix,
+    ColorMatrix* out,
+    bool* has
+) {
+    *has = false;
+    if (matrix == nullptr) {
+        return true;
+    }
+
+    const jsize length = env->GetArrayLength(matrix);
+    if (length != 20) {
+        LOGE("Color matrix must have 20 elements, got: %d", length);
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "Color matrix must have 20 elements");
+        return false;
+    }
+
+    float values[20];
+    env->GetFloatArrayRegion(matrix, 0, 20, values);
+    *out = color_matrix_from_android(values);
+    *has = true;
+    return true;
+}
+
 /**
  * JNI: gaussianIIRInplace
  */
@@ -110,9 +164,6 @@ Java_com_example_blur_NativeGauss_gaussianIIRInplace(
     }
     
     // 调用底层算法
-    LOGD("gaussianIIRInplace: %dx%d, sigma=%.2f, linear=%d, stride=%d",
-         info.width, info.height, sigma, linear, info.stride);
-    
     gaussian_iir_rgba8888_inplace(
         static_cast<uint8_t*>(pixels),
         static_cast<int>(info.width),
@@ -128,6 +179,8 @@ Java_com_example_blur_NativeGauss_gaussianIIRInplace(
 
 /**
  * JNI: gaussianIIRNeonInplace
+ *
+ * @param colorMatrix 可选颜色矩阵（20 个元素，null 表示不套用），在最终打包前融合套用
  */
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_blur_NativeGauss_gaussianIIRNeonInplace(
@@ -135,8 +188,15 @@ Java_com_example_blur_NativeGauss_gaussianIIRNeonInplace(
     jobject /* this */,
     jobject bitmap,
     jfloat sigma,
-    jboolean linear
+    jboolean linear,
+    jfloatArray colorMatrix
 ) {
+    ColorMatrix cm;
+    bool hasMatrix = false;
+    if (!read_color_matrix(env, colorMatrix, &cm, &hasMatrix)) {
+        return;
+    }
+
     AndroidBitmapInfo info;
     void* pixels = nullptr;
 
@@ -146,22 +206,63 @@ Java_com_example_blur_NativeGauss_gaussianIIRNeonInplace(
     }
 
     // 调用 NEON 优化版本
-    LOGD("gaussianIIRNeonInplace: %dx%d, sigma=%.2f, linear=%d, stride=%d",
-         info.width, info.height, sigma, linear, info.stride);
-
     gaussian_iir_rgba8888_neon(
         static_cast<uint8_t*>(pixels),
         static_cast<int>(info.width),
         static_cast<int>(info.height),
         static_cast<int>(info.stride),
         sigma,
-        linear
+        linear,
+        hasMatrix ? &cm : nullptr
+    );
+
+    // 解锁 Bitmap
+    AndroidBitmap_unlockPixels(env, bitmap);
+}
+
+/**
+ * JNI: gaussianIIRFp16Inplace
+ *
+ * 半精度 IIR（非线性模式）；设备不支持 FP16 或 σ 超出范围时自动回退 FP32
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_blur_NativeGauss_gaussianIIRFp16Inplace(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject bitmap,
+    jfloat sigma
+) {
+    AndroidBitmapInfo info;
+    void* pixels = nullptr;
+
+    // 锁定 Bitmap
+    if (!lock_bitmap(env, bitmap, &info, &pixels)) {
+        return;
+    }
+
+    gaussian_iir_rgba8888_fp16(
+        static_cast<uint8_t*>(pixels),
+        static_cast<int>(info.width),
+        static_cast<int>(info.height),
+        static_cast<int>(info.stride),
+        sigma
     );
 
     // 解锁 Bitmap
     AndroidBitmap_unlockPixels(env, bitmap);
 }
 
+/**
+ * JNI: hasFp16Support
+ */
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_blur_NativeGauss_hasFp16Support(
+    JNIEnv* env,
+    jobject /* this */
+) {
+    return has_fp16_support();
+}
+
 /**
  * JNI: hasNeonSupport
  */
@@ -173,16 +274,270 @@ Java_com_example_blur_NativeGauss_hasNeonSupport(
     return has_neon_support();
 }
 
+/**
+ * JNI: cpuFeatures
+ *
+ * 当前可用的 CPU 特性（CpuFeature 位的组合，已去掉禁用掩码）
+ */
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_blur_NativeGauss_cpuFeatures(
+    JNIEnv* env,
+    jobject /* this */
+) {
+    return static_cast<jint>(cpu_features());
+}
+
+/**
+ * JNI: describeCpuFeatures
+ *
+ * 特性位的可读描述（如 "neon fp16 dotprod"）
+ */
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_example_blur_NativeGauss_describeCpuFeatures(
+    JNIEnv* env,
+    jobject /* this */,
+    jint features
+) {
+    char desc[64];
+    cpu_features_describe(static_cast<uint32_t>(features), desc, sizeof(desc));
+    return env->NewStringUTF(desc);
+}
+
+/**
+ * JNI: setCpuFeaturesDisabled
+ *
+ * 屏蔽部分 CPU 特性（测试 / 对比各后端；0 表示全部启用）
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_blur_NativeGauss_setCpuFeaturesDisabled(
+    JNIEnv* env,
+    jobject /* this */,
+    jint mask
+) {
+    cpu_features_set_disabled(static_cast<uint32_t>(mask));
+}
+
+/**
+ * 交叉点表 → jbyteArray
+ */
+static jbyteArray export_tuner_table(JNIEnv* env) {
+    uint8_t table[kTunerTableBytes];
+    const size_t size = blur_tuner_export(table, sizeof(table));
+    jbyteArray result = env->NewByteArray(static_cast<jsize>(size));
+    if (result) {
+        env->SetByteArrayRegion(result, 0, static_cast<jsize>(size), reinterpret_cast<const jbyte*>(table));
+    }
+    return result;
+}
+
+/**
+ * JNI: selectSmartMethod
+ *
+ * 按交叉点表选择智能模糊方法（BlurTunerMethod）
+ */
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_blur_NativeGauss_selectSmartMethod(
+    JNIEnv* env,
+    jobject /* this */,
+    jint width,
+    jint height,
+    jfloat sigma,
+    jboolean highQuality
+) {
+    return blur_tuner_select(width, height, sigma, highQuality);
+}
+
+/**
+ * JNI: calibrateSmartBlur
+ *
+ * 实测校准交叉点表（耗时数百毫秒，应在后台线程调用），返回导出的表
+ */
+extern "C" JNIEXPORT jbyteArray JNICALL
+Java_com_example_blur_NativeGauss_calibrateSmartBlur(
+    JNIEnv* env,
+    jobject /* this */,
+    jint budgetMs
+) {
+    blur_tuner_calibrate(budgetMs);
+    return export_tuner_table(env);
+}
+
+/**
+ * JNI: exportSmartBlurTable
+ */
+extern "C" JNIEXPORT jbyteArray JNICALL
+Java_com_example_blur_NativeGauss_exportSmartBlurTable(
+    JNIEnv* env,
+    jobject /* this */
+) {
+    return export_tuner_table(env);
+}
+
+/**
+ * JNI: importSmartBlurTable
+ *
+ * @return false 如果表的版本或内容不匹配（保持当前表）
+ */
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_blur_NativeGauss_importSmartBlurTable(
+    JNIEnv* env,
+    jobject /* this */,
+    jbyteArray table
+) {
+    if (table == nullptr) {
+        return JNI_FALSE;
+    }
+    const jsize length = env->GetArrayLength(table);
+    if (static_cast<size_t>(length) != kTunerTableBytes) {
+        LOGE("Tuner table must have %zu bytes, got: %d", kTunerTableBytes, length);
+        return JNI_FALSE;
+    }
+
+    uint8_t data[kTunerTableBytes];
+    env->GetByteArrayRegion(table, 0, length, reinterpret_cast<jbyte*>(data));
+    return blur_tuner_import(data, kTunerTableBytes) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * JNI: resetSmartBlurTable
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_blur_NativeGauss_resetSmartBlurTable(
+    JNIEnv* env,
+    jobject /* this */
+) {
+    blur_tuner_reset();
+}
+
+/**
+ * JNI: isSmartBlurCalibrated
+ */
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_blur_NativeGauss_isSmartBlurCalibrated(
+    JNIEnv* env,
+    jobject /* this */
+) {
+    return blur_tuner_calibrated() ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * JNI: prewarmScratch
+ *
+ * 按帧尺寸预热当前线程的临时缓冲池（应在执行滤波的同一线程调用）：
+ * - 2 块整帧缓冲（单次盒式模糊 / 降采样缓冲）
+ * - 1 块 IIR 工作缓冲（每个并行线程一份）
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_blur_NativeGauss_prewarmScratch(
+    JNIEnv* env,
+    jobject /* this */,
+    jint width,
+    jint height
+) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    const size_t frameBytes = static_cast<size_t>(width) * height * 4;
+    scratch_arena_prewarm(frameBytes, 2);
+
+    // 与 gaussian_iir_rgba8888_* 的工作缓冲大小一致（纵向列块 8 列）
+    const size_t iirLen = std::max(static_cast<size_t>(width) * 4, static_cast<size_t>(height) * 8 * 4);
+    scratch_arena_prewarm(sizeof(float) * iirLen * 2 * thread_pool_concurrency(), 1);
+}
+
+/**
+ * JNI: releaseScratch
+ *
+ * 释放所有线程临时缓冲池中的空闲缓冲与色散径向法线表（onTrimMemory / 页面销毁时调用）
+ *
+ * @return 释放的字节数
+ */
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_blur_NativeGauss_releaseScratch(
+    JNIEnv* env,
+    jobject /* this */
+) {
+    return static_cast<jlong>(scratch_arena_trim() + chromatic_dispersion_release_cache());
+}
+
+/**
+ * JNI: getStatsRaw
+ *
+ * 分阶段性能统计快照，每个条目 7 个 long 依次为：
+ * filter, stage, count, totalNs, maxNs, p50Ns, p99Ns（只包含 count > 0 的条目）
+ */
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_blur_NativeGauss_getStatsRaw(
+    JNIEnv* env,
+    jobject /* this */
+) {
+    const int kFields = 7;
+    PerfStageStats entries[TRACE_FILTER_COUNT * TRACE_STAGE_COUNT];
+    const int n = perf_trace_snapshot(entries, TRACE_FILTER_COUNT * TRACE_STAGE_COUNT);
+
+    jlong flat[TRACE_FILTER_COUNT * TRACE_STAGE_COUNT * kFields];
+    for (int i = 0; i < n; ++i) {
+        jlong* dst = flat + i * kFields;
+        dst[0] = entries[i].filter;
+        dst[1] = entries[i].stage;
+        dst[2] = static_cast<jlong>(entries[i].count);
+        dst[3] = static_cast<jlong>(entries[i].totalNs);
+        dst[4] = static_cast<jlong>(entries[i].maxNs);
+        dst[5] = static_cast<jlong>(entries[i].p50Ns);
+        dst[6] = static_cast<jlong>(entries[i].p99Ns);
+    }
+
+    jlongArray result = env->NewLongArray(n * kFields);
+    if (!result) {
+        return nullptr; // OutOfMemoryError 已抛出
+    }
+    env->SetLongArrayRegion(result, 0, n * kFields, flat);
+    return result;
+}
+
+/**
+ * JNI: resetStats
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_blur_NativeGauss_resetStats(
+    JNIEnv* env,
+    jobject /* this */
+) {
+    perf_trace_reset();
+}
+
+/**
+ * JNI: setStatsEnabled
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_blur_NativeGauss_setStatsEnabled(
+    JNIEnv* env,
+    jobject /* this */,
+    jboolean enabled
+) {
+    perf_trace_set_enabled(enabled);
+}
+
 /**
  * JNI: box3Inplace
+ *
+ * @param colorMatrix 可选颜色矩阵（20 个元素，null 表示不套用），在最后一遍写回时融合套用
  */
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_blur_NativeGauss_box3Inplace(
     JNIEnv* env,
     jobject /* this */,
     jobject bitmap,
-    jint radius
+    jint radius,
+    jfloatArray colorMatrix
 ) {
+    ColorMatrix cm;
+    bool hasMatrix = false;
+    if (!read_color_matrix(env, colorMatrix, &cm, &hasMatrix)) {
+        return;
+    }
+
     AndroidBitmapInfo info;
     void* pixels = nullptr;
 
@@ -192,15 +547,54 @@ Java_com_example_blur_NativeGauss_box3Inplace(
     }
 
     // 调用底层算法
-    LOGD("box3Inplace: %dx%d, radius=%d, stride=%d",
-         info.width, info.height, radius, info.stride);
-
     box3_rgba8888_inplace(
         static_cast<uint8_t*>(pixels),
         static_cast<int>(info.width),
         static_cast<int>(info.height),
         static_cast<int>(info.stride),
-        radius
+        radius,
+        hasMatrix ? &cm : nullptr
+    );
+
+    // 解锁 Bitmap
+    AndroidBitmap_unlockPixels(env, bitmap);
+}
+
+/**
+ * JNI: colorMatrixInplace
+ *
+ * 单独套用颜色矩阵（用于无法融合的滤波路径）
+ *
+ * @param bitmap 待处理位图（ARGB_8888，mutable）
+ * @param colorMatrix android.graphics.ColorMatrix 数组（20 个元素）
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_blur_NativeGauss_colorMatrixInplace(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject bitmap,
+    jfloatArray colorMatrix
+) {
+    ColorMatrix cm;
+    bool hasMatrix = false;
+    if (!read_color_matrix(env, colorMatrix, &cm, &hasMatrix) || !hasMatrix) {
+        return;
+    }
+
+    AndroidBitmapInfo info;
+    void* pixels = nullptr;
+
+    // 锁定 Bitmap
+    if (!lock_bitmap(env, bitmap, &info, &pixels)) {
+        return; // 异常已在 lock_bitmap 中抛出
+    }
+
+    color_matrix_rgba8888_inplace(
+        static_cast<uint8_t*>(pixels),
+        static_cast<int>(info.width),
+        static_cast<int>(info.height),
+        static_cast<int>(info.stride),
+        cm
     );
 
     // 解锁 Bitmap
@@ -216,6 +610,7 @@ Java_com_example_blur_NativeGauss_box3Inplace(
  * @param bitmap 待处理位图（ARGB_8888，mutable）
  * @param radius 模糊半径（0-25）
  * @param downscale 降采样比例（0.01-1.0，推荐 0.5）
+ * @param colorMatrix 可选颜色矩阵（20 个元素，null 表示不套用），作用于降采样小图
  */
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_blur_NativeGauss_advancedBoxBlurInplace(
@@ -223,8 +618,15 @@ Java_com_example_blur_NativeGauss_advancedBoxBlurInplace(
     jobject /* this */,
     jobject bitmap,
     jfloat radius,
-    jfloat downscale
+    jfloat downscale,
+    jfloatArray colorMatrix
 ) {
+    ColorMatrix cm;
+    bool hasMatrix = false;
+    if (!read_color_matrix(env, colorMatrix, &cm, &hasMatrix)) {
+        return;
+    }
+
     AndroidBitmapInfo info;
     void* pixels = nullptr;
 
@@ -234,9 +636,6 @@ Java_com_example_blur_NativeGauss_advancedBoxBlurInplace(
     }
 
     // 调用底层算法（原位处理，src 和 dst 相同）
-    LOGD("advancedBoxBlurInplace: %dx%d, radius=%.2f, downscale=%.2f, stride=%d",
-         info.width, info.height, radius, downscale, info.stride);
-
     advanced_box_blur_rgba8888(
         static_cast<uint8_t*>(pixels),  // src
         static_cast<uint8_t*>(pixels),  // dst (same as src)
@@ -244,7 +643,8 @@ Java_com_example_blur_NativeGauss_advancedBoxBlurInplace(
         static_cast<int>(info.height),
         static_cast<int>(info.stride),
         radius,
-        downscale
+        downscale,
+        hasMatrix ? &cm : nullptr
     );
 
     // 解锁 Bitmap
@@ -260,6 +660,7 @@ Java_com_example_blur_NativeGauss_advancedBoxBlurInplace(
  * @param bitmap 待处理位图（ARGB_8888，mutable）
  * @param radius 模糊半径（0-25）
  * @param downscale 降采样比例（0.01-1.0，推荐 0.5）
+ * @param colorMatrix 可选颜色矩阵（20 个元素，null 表示不套用），作用于降采样小图
  */
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_blur_NativeGauss_advancedBoxBlurInplaceHQ(
@@ -267,8 +668,15 @@ Java_com_example_blur_NativeGauss_advancedBoxBlurInplaceHQ(
     jobject /* this */,
     jobject bitmap,
     jfloat radius,
-    jfloat downscale
+    jfloat downscale,
+    jfloatArray colorMatrix
 ) {
+    ColorMatrix cm;
+    bool hasMatrix = false;
+    if (!read_color_matrix(env, colorMatrix, &cm, &hasMatrix)) {
+        return;
+    }
+
     AndroidBitmapInfo info;
     void* pixels = nullptr;
 
@@ -278,9 +686,6 @@ Java_com_example_blur_NativeGauss_advancedBoxBlurInplaceHQ(
     }
 
     // 调用底层算法（原位处理，src 和 dst 相同）
-    LOGD("advancedBoxBlurInplaceHQ: %dx%d, radius=%.2f, downscale=%.2f, stride=%d",
-         info.width, info.height, radius, downscale, info.stride);
-
     advanced_box_blur_rgba8888_hq(
         static_cast<uint8_t*>(pixels),  // src
         static_cast<uint8_t*>(pixels),  // dst (same as src)
@@ -288,7 +693,8 @@ Java_com_example_blur_NativeGauss_advancedBoxBlurInplaceHQ(
         static_cast<int>(info.height),
         static_cast<int>(info.stride),
         radius,
-        downscale
+        downscale,
+        hasMatrix ? &cm : nullptr
     );
 
     // 解锁 Bitmap
@@ -296,33 +702,69 @@ Java_com_example_blur_NativeGauss_advancedBoxBlurInplaceHQ(
 }
 
 /**
- * JNI: chromaticAberrationInplace
+ * JNI: pyramidBlurInplace
  *
- * 应用色差效果（Chromatic Aberration）
+ * 多级降采样金字塔模糊（大半径，耗时基本与 σ 无关）
  *
- * @param source 源图像 Bitmap
- * @param displacement 位移贴图 Bitmap
- * @param result 结果图像 Bitmap（可以与 source 相同）
- * @param intensity 色差强度（0-10，推荐 2.0）
- * @param scale 位移缩放系数（推荐 70.0）
- * @param redOffset 红色通道偏移量（默认 0.0）
- * @param greenOffset 绿色通道偏移量（默认 -0.05）
- * @param blueOffset 蓝色通道偏移量（默认 -0.1）
- * @param useBilinear 是否使用双线性插值（默认 true）
+ * @param bitmap 待处理位图（ARGB_8888，mutable）
+ * @param sigma 等效高斯标准差（原图像素）
  */
 extern "C" JNIEXPORT void JNICALL
-Java_com_example_liquidglass_NativeChromaticAberration_chromaticAberrationInplace(
+Java_com_example_blur_NativeGauss_pyramidBlurInplace(
     JNIEnv* env,
     jobject /* this */,
-    jobject source,
-    jobject displacement,
-    jobject result,
-    jfloat intensity,
-    jfloat scale,
-    jfloat redOffset,
-    jfloat greenOffset,
-    jfloat blueOffset,
-    jboolean useBilinear
+    jobject bitmap,
+    jfloat sigma
+) {
+    AndroidBitmapInfo info;
+    void* pixels = nullptr;
+
+    // 锁定 Bitmap
+    if (!lock_bitmap(env, bitmap, &info, &pixels)) {
+        return; // 异常已在 lock_bitmap 中抛出
+    }
+
+    // 调用底层算法
+    pyramid_blur_rgba8888_inplace(
+        static_cast<uint8_t*>(pixels),
+        static_cast<int>(info.width),
+        static_cast<int>(info.height),
+        static_cast<int>(info.stride),
+        sigma
+    );
+
+    // 解锁 Bitmap
+    AndroidBitmap_unlockPixels(env, bitmap);
+}
+
+/**
+ * JNI: chromaticAberrationInplace
+ *
+ * 应用色差效果（Chromatic Aberration）
+ *
+ * @param source 源图像 Bitmap
+ * @param displacement 位移贴图 Bitmap
+ * @param result 结果图像 Bitmap（可以与 source 相同）
+ * @param intensity 色差强度（0-10，推荐 2.0）
+ * @param scale 位移缩放系数（推荐 70.0）
+ * @param redOffset 红色通道偏移量（默认 0.0）
+ * @param greenOffset 绿色通道偏移量（默认 -0.05）
+ * @param blueOffset 蓝色通道偏移量（默认 -0.1）
+ * @param useBilinear 是否使用双线性插值（默认 true）
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_liquidglass_NativeChromaticAberration_chromaticAberrationInplace(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject source,
+    jobject displacement,
+    jobject result,
+    jfloat intensity,
+    jfloat scale,
+    jfloat redOffset,
+    jfloat greenOffset,
+    jfloat blueOffset,
+    jboolean useBilinear
 ) {
     AndroidBitmapInfo sourceInfo, displacementInfo, resultInfo;
     void* sourcePixels = nullptr;
@@ -367,9 +809,6 @@ Java_com_example_liquidglass_NativeChromaticAberration_chromaticAberrationInplac
     }
 
     // 调用底层算法
-    LOGD("chromaticAberrationInplace: %dx%d, intensity=%.2f, scale=%.2f, offsets=(%.3f, %.3f, %.3f), useBilinear=%d",
-         sourceInfo.width, sourceInfo.height, intensity, scale, redOffset, greenOffset, blueOffset, useBilinear);
-
     chromatic_aberration_rgba8888(
         static_cast<const uint8_t*>(sourcePixels),
         static_cast<const uint8_t*>(displacementPixels),
@@ -393,6 +832,98 @@ Java_com_example_liquidglass_NativeChromaticAberration_chromaticAberrationInplac
     AndroidBitmap_unlockPixels(env, result);
 }
 
+/**
+ * JNI: edgeDistortion
+ *
+ * 应用边缘扭曲效果（按位移贴图整体移动采样位置）
+ *
+ * @param source 源图像 Bitmap
+ * @param displacement 位移贴图 Bitmap
+ * @param result 结果图像 Bitmap（不能与 source 相同）
+ * @param scale 位移缩放系数（负值为反向位移）
+ * @param fadeWidth 边缘淡化宽度（像素，0 表示不淡化）
+ * @param useBilinear 是否使用双线性插值
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_liquidglass_NativeChromaticAberration_edgeDistortion(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject source,
+    jobject displacement,
+    jobject result,
+    jfloat scale,
+    jint fadeWidth,
+    jboolean useBilinear
+) {
+    if (env->IsSameObject(source, result)) {
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "Result bitmap must differ from source");
+        return;
+    }
+
+    AndroidBitmapInfo sourceInfo, displacementInfo, resultInfo;
+    void* sourcePixels = nullptr;
+    void* displacementPixels = nullptr;
+    void* resultPixels = nullptr;
+
+    // 锁定源图像
+    if (!lock_bitmap(env, source, &sourceInfo, &sourcePixels)) {
+        return;
+    }
+
+    // 锁定位移贴图
+    if (!lock_bitmap(env, displacement, &displacementInfo, &displacementPixels)) {
+        AndroidBitmap_unlockPixels(env, source);
+        return;
+    }
+
+    // 锁定结果图像
+    if (!lock_bitmap(env, result, &resultInfo, &resultPixels)) {
+        AndroidBitmap_unlockPixels(env, source);
+        AndroidBitmap_unlockPixels(env, displacement);
+        return;
+    }
+
+    // 验证尺寸一致性
+    if (sourceInfo.width != displacementInfo.width ||
+        sourceInfo.height != displacementInfo.height ||
+        sourceInfo.width != resultInfo.width ||
+        sourceInfo.height != resultInfo.height) {
+        LOGE("Bitmap size mismatch: source=%dx%d, displacement=%dx%d, result=%dx%d",
+             sourceInfo.width, sourceInfo.height,
+             displacementInfo.width, displacementInfo.height,
+             resultInfo.width, resultInfo.height);
+
+        AndroidBitmap_unlockPixels(env, source);
+        AndroidBitmap_unlockPixels(env, displacement);
+        AndroidBitmap_unlockPixels(env, result);
+
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "Source, displacement, and result bitmaps must have the same dimensions");
+        return;
+    }
+
+    // 调用底层算法
+    edge_distortion_rgba8888(
+        static_cast<const uint8_t*>(sourcePixels),
+        static_cast<const uint8_t*>(displacementPixels),
+        static_cast<uint8_t*>(resultPixels),
+        static_cast<int>(sourceInfo.width),
+        static_cast<int>(sourceInfo.height),
+        static_cast<int>(sourceInfo.stride),
+        static_cast<int>(displacementInfo.stride),
+        static_cast<int>(resultInfo.stride),
+        scale,
+        fadeWidth,
+        useBilinear
+    );
+
+    // 解锁所有 Bitmap
+    AndroidBitmap_unlockPixels(env, source);
+    AndroidBitmap_unlockPixels(env, displacement);
+    AndroidBitmap_unlockPixels(env, result);
+}
+
 /**
  * JNI: chromaticDispersionInplace
  *
@@ -500,9 +1031,6 @@ Java_com_example_liquidglass_NativeChromaticDispersion_chromaticDispersionInplac
     }
 
     // 调用底层算法
-    LOGD("chromaticDispersionInplace: %dx%d, refThickness=%.2f, refFactor=%.2f, refDispersion=%.2f, dpr=%.2f, useBilinear=%d",
-         sourceInfo.width, sourceInfo.height, refThickness, refFactor, refDispersion, dpr, useBilinear);
-
     chromatic_dispersion_rgba8888(
         static_cast<const uint8_t*>(sourcePixels),
         static_cast<const uint8_t*>(edgeDistancePixels),
@@ -530,3 +1058,1471 @@ Java_com_example_liquidglass_NativeChromaticDispersion_chromaticDispersionInplac
     AndroidBitmap_unlockPixels(env, result);
 }
 
+/**
+ * JNI: NativeChromaticDispersion.releaseCache
+ *
+ * 释放色散的径向法线缓存表（视图销毁时调用）
+ *
+ * @return 释放的字节数
+ */
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_liquidglass_NativeChromaticDispersion_releaseCache(
+    JNIEnv* env,
+    jobject /* this */
+) {
+    return static_cast<jlong>(chromatic_dispersion_release_cache());
+}
+
+
+/**
+ * 管线调用中已锁定的 Bitmap：析构时统一解锁，避免各提前返回分支重复 unlock
+ */
+struct PipelineBitmapLocks {
+    JNIEnv* env;
+    std::vector<jobject> bitmaps;
+
+    explicit PipelineBitmapLocks(JNIEnv* e) : env(e) {}
+
+    ~PipelineBitmapLocks() {
+        for (size_t i = bitmaps.size(); i-- > 0;) {
+            AndroidBitmap_unlockPixels(env, bitmaps[i]);
+        }
+    }
+
+    /**
+     * 锁定并登记；bitmap 为 null 时视为成功且不输出像素
+     */
+    bool lock(jobject bitmap, AndroidBitmapInfo* info, void** pixels) {
+        *pixels = nullptr;
+        if (bitmap == nullptr) return true;
+        if (!lock_bitmap(env, bitmap, info, pixels)) return false;
+        bitmaps.push_back(bitmap);
+        return true;
+    }
+};
+
+/**
+ * 锁定当前效果需要的贴图，校验尺寸（须为 width × height）并写入 params 的贴图字段
+ *
+ * @return 是否成功（失败时已抛出异常）
+ */
+static bool lock_effect_maps(
+    JNIEnv* env,
+    PipelineBitmapLocks& locks,
+    jint effect,
+    jobject displacement,
+    jobject edgeDistance,
+    jobject normalMap,
+    uint32_t width,
+    uint32_t height,
+    GlassPipelineParams* params
+) {
+    AndroidBitmapInfo displacementInfo, edgeDistanceInfo, normalMapInfo;
+    void* displacementPixels = nullptr;
+    void* edgeDistancePixels = nullptr;
+    void* normalMapPixels = nullptr;
+
+    if (effect == GLASS_EFFECT_ABERRATION) {
+        if (!locks.lock(displacement, &displacementInfo, &displacementPixels)) return false;
+    } else if (effect == GLASS_EFFECT_DISPERSION) {
+        if (!locks.lock(edgeDistance, &edgeDistanceInfo, &edgeDistancePixels) ||
+            !locks.lock(normalMap, &normalMapInfo, &normalMapPixels)) {
+            return false;
+        }
+    }
+
+    bool sizeMismatch = false;
+    if (displacementPixels) sizeMismatch |= displacementInfo.width != width || displacementInfo.height != height;
+    if (edgeDistancePixels) sizeMismatch |= edgeDistanceInfo.width != width || edgeDistanceInfo.height != height;
+    if (normalMapPixels) sizeMismatch |= normalMapInfo.width != width || normalMapInfo.height != height;
+
+    if (sizeMismatch) {
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "All pipeline bitmaps must have the same dimensions");
+        return false;
+    }
+
+    if ((effect == GLASS_EFFECT_ABERRATION && !displacementPixels) ||
+        (effect == GLASS_EFFECT_DISPERSION && !edgeDistancePixels)) {
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "Effect map is required for the selected effect");
+        return false;
+    }
+
+    params->displacement = static_cast<const uint8_t*>(displacementPixels);
+    params->displacementStride = displacementPixels ? static_cast<int>(displacementInfo.stride) : 0;
+    params->edgeDistance = static_cast<const uint8_t*>(edgeDistancePixels);
+    params->edgeDistanceStride = edgeDistancePixels ? static_cast<int>(edgeDistanceInfo.stride) : 0;
+    params->normalMap = static_cast<const uint8_t*>(normalMapPixels);
+    params->normalMapStride = normalMapPixels ? static_cast<int>(normalMapInfo.stride) : 0;
+    return true;
+}
+
+/**
+ * 管线 JNI 公共实现：锁定 Bitmap、校验尺寸、组装参数
+ *
+ * @param blurred 模糊缓存（仅增量版本使用，整帧版本传 null）
+ * @param damage 背景变化区域（nullptr = 整帧版本 render_glass_pipeline）
+ * @param maskRect / maskRadius 可见区域遮罩（maskRadius < 0 不遮罩）
+ */
+static void run_glass_pipeline(
+    JNIEnv* env,
+    jobject backdrop,
+    jobject displacement,
+    jobject edgeDistance,
+    jobject normalMap,
+    jobject blurred,
+    jobject result,
+    const DamageRect* damage,
+    jint blurMode,
+    jfloat sigma,
+    jboolean highQuality,
+    jfloat saturation,
+    jint effect,
+    jfloat scale,
+    jfloat redOffset,
+    jfloat greenOffset,
+    jfloat blueOffset,
+    jfloat refThickness,
+    jfloat refFactor,
+    jfloat refDispersion,
+    jfloat dpr,
+    jboolean useBilinear,
+    const DamageRect& maskRect,
+    jfloat maskRadius
+) {
+    AndroidBitmapInfo backdropInfo, resultInfo, blurredInfo;
+    void* backdropPixels = nullptr;
+    void* resultPixels = nullptr;
+    void* blurredPixels = nullptr;
+
+    if (env->IsSameObject(backdrop, result) ||
+        (blurred != nullptr && (env->IsSameObject(blurred, backdrop) || env->IsSameObject(blurred, result)))) {
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "Backdrop, blurred and result must be different bitmaps");
+        return;
+    }
+
+    PipelineBitmapLocks locks(env);
+    if (!locks.lock(backdrop, &backdropInfo, &backdropPixels) ||
+        !locks.lock(result, &resultInfo, &resultPixels)) {
+        return; // 异常已在 lock_bitmap 中抛出
+    }
+
+    // 增量版本：有效果阶段时需要模糊缓存（无效果时 result 即缓存）
+    if (damage && effect != GLASS_EFFECT_NONE) {
+        if (blurred == nullptr) {
+            jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+            env->ThrowNew(exClass, "Blurred cache bitmap is required when an effect is enabled");
+            return;
+        }
+        if (!locks.lock(blurred, &blurredInfo, &blurredPixels)) return;
+    }
+
+    // 验证尺寸一致性
+    const uint32_t w = backdropInfo.width;
+    const uint32_t h = backdropInfo.height;
+    bool sizeMismatch = resultInfo.width != w || resultInfo.height != h;
+    if (blurredPixels) sizeMismatch |= blurredInfo.width != w || blurredInfo.height != h;
+
+    if (sizeMismatch) {
+        LOGE("renderGlassPipeline: bitmap size mismatch (backdrop=%dx%d, result=%dx%d)",
+             w, h, resultInfo.width, resultInfo.height);
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "All pipeline bitmaps must have the same dimensions");
+        return;
+    }
+
+    // 只锁定当前效果需要的贴图（尺寸校验与参数填写在 lock_effect_maps 中完成）
+    GlassPipelineParams params;
+    if (!lock_effect_maps(env, locks, effect, displacement, edgeDistance, normalMap, w, h, &params)) return;
+
+    params.blurMode = blurMode;
+    params.sigma = sigma;
+    params.highQuality = highQuality;
+    params.saturation = saturation;
+    params.effect = effect;
+    params.useBilinear = useBilinear;
+    params.scale = scale;
+    params.redOffset = redOffset;
+    params.greenOffset = greenOffset;
+    params.blueOffset = blueOffset;
+    params.refThickness = refThickness;
+    params.refFactor = refFactor;
+    params.refDispersion = refDispersion;
+    params.dpr = dpr;
+    params.maskRect = maskRect;
+    params.maskRadius = maskRadius;
+
+    if (damage) {
+        render_glass_pipeline_region(
+            static_cast<const uint8_t*>(backdropPixels),
+            static_cast<int>(backdropInfo.stride),
+            static_cast<uint8_t*>(blurredPixels),
+            blurredPixels ? static_cast<int>(blurredInfo.stride) : 0,
+            static_cast<uint8_t*>(resultPixels),
+            static_cast<int>(resultInfo.stride),
+            static_cast<int>(w),
+            static_cast<int>(h),
+            params,
+            *damage
+        );
+    } else {
+        render_glass_pipeline(
+            static_cast<const uint8_t*>(backdropPixels),
+            static_cast<int>(backdropInfo.stride),
+            static_cast<uint8_t*>(resultPixels),
+            static_cast<int>(resultInfo.stride),
+            static_cast<int>(w),
+            static_cast<int>(h),
+            params
+        );
+    }
+}
+
+/**
+ * JNI: renderGlassPipeline
+ *
+ * 一次调用完成 模糊 → 饱和度 → 色差 / 色散，中间结果保存在原生临时缓冲中，
+ * 不产生中间 Bitmap
+ *
+ * @param backdrop 背景 Bitmap（只读）
+ * @param displacement 位移贴图（色差效果必需，否则可为 null）
+ * @param edgeDistance 边缘距离贴图（色散效果必需，否则可为 null）
+ * @param normalMap 法线贴图（可选，色散使用；null 使用径向法线）
+ * @param result 结果 Bitmap（与 backdrop 尺寸相同，不能是同一个 Bitmap）
+ * @param blurMode 模糊方式（GlassBlurMode）
+ * @param sigma 高斯标准差
+ * @param highQuality IIR 是否在线性色彩空间处理
+ * @param saturation 饱和度系数（1.0 = 原始）
+ * @param effect 效果阶段（GlassEffect）
+ * @param scale 色差位移缩放系数
+ * @param redOffset / greenOffset / blueOffset 色差通道偏移（已乘以强度）
+ * @param refThickness / refFactor / refDispersion / dpr 色散参数
+ * @param useBilinear 是否使用双线性插值
+ * @param maskLeft / maskTop / maskRight / maskBottom 可见圆角矩形（空矩形 = 整帧）
+ * @param maskRadius 可见区域圆角半径（< 0 不遮罩；遮罩外的 result 像素内容未定义）
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_renderGlassPipeline(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject backdrop,
+    jobject displacement,
+    jobject edgeDistance,
+    jobject normalMap,
+    jobject result,
+    jint blurMode,
+    jfloat sigma,
+    jboolean highQuality,
+    jfloat saturation,
+    jint effect,
+    jfloat scale,
+    jfloat redOffset,
+    jfloat greenOffset,
+    jfloat blueOffset,
+    jfloat refThickness,
+    jfloat refFactor,
+    jfloat refDispersion,
+    jfloat dpr,
+    jboolean useBilinear,
+    jint maskLeft,
+    jint maskTop,
+    jint maskRight,
+    jint maskBottom,
+    jfloat maskRadius
+) {
+    DamageRect mask;
+    mask.left = maskLeft;
+    mask.top = maskTop;
+    mask.right = maskRight;
+    mask.bottom = maskBottom;
+
+    run_glass_pipeline(
+        env, backdrop, displacement, edgeDistance, normalMap, nullptr, result, nullptr,
+        blurMode, sigma, highQuality, saturation,
+        effect, scale, redOffset, greenOffset, blueOffset,
+        refThickness, refFactor, refDispersion, dpr,
+        useBilinear, mask, maskRadius
+    );
+}
+
+/**
+ * JNI: renderGlassPipelineRegion
+ *
+ * 增量版本：blurred / result 保存上一帧输出，只重算背景变化区域附近的像素
+ * （见 glass_pipeline.h 中 render_glass_pipeline_region 的说明）
+ *
+ * @param blurred 模糊缓存 Bitmap（有效果阶段时必需，跨帧保留）
+ * @param damageLeft / damageTop / damageRight / damageBottom 背景变化区域（半开区间）
+ * 其余参数同 renderGlassPipeline（遮罩不变时增量结果才有效）
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_renderGlassPipelineRegion(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject backdrop,
+    jobject displacement,
+    jobject edgeDistance,
+    jobject normalMap,
+    jobject blurred,
+    jobject result,
+    jint damageLeft,
+    jint damageTop,
+    jint damageRight,
+    jint damageBottom,
+    jint blurMode,
+    jfloat sigma,
+    jboolean highQuality,
+    jfloat saturation,
+    jint effect,
+    jfloat scale,
+    jfloat redOffset,
+    jfloat greenOffset,
+    jfloat blueOffset,
+    jfloat refThickness,
+    jfloat refFactor,
+    jfloat refDispersion,
+    jfloat dpr,
+    jboolean useBilinear,
+    jint maskLeft,
+    jint maskTop,
+    jint maskRight,
+    jint maskBottom,
+    jfloat maskRadius
+) {
+    DamageRect damage;
+    damage.left = damageLeft;
+    damage.top = damageTop;
+    damage.right = damageRight;
+    damage.bottom = damageBottom;
+
+    DamageRect mask;
+    mask.left = maskLeft;
+    mask.top = maskTop;
+    mask.right = maskRight;
+    mask.bottom = maskBottom;
+
+    run_glass_pipeline(
+        env, backdrop, displacement, edgeDistance, normalMap, blurred, result, &damage,
+        blurMode, sigma, highQuality, saturation,
+        effect, scale, redOffset, greenOffset, blueOffset,
+        refThickness, refFactor, refDispersion, dpr,
+        useBilinear, mask, maskRadius
+    );
+}
+
+/**
+ * 批量区域模糊 JNI 公共实现
+ *
+ * @param rects 矩形数组 [left, top, right, bottom] × n（整帧坐标）
+ * @param outputs 每个矩形一张输出 Bitmap（尺寸为矩形尺寸，元素可为 null）；与 frame 二选一
+ * @param frame 整帧输出 Bitmap（与 backdrop 尺寸相同，各矩形写入对应位置）
+ * @return 实际模糊的块数（失败时为 -1，已抛出异常或记录日志）
+ */
+static jint run_blur_regions(
+    JNIEnv* env,
+    jobject backdrop,
+    jintArray rects,
+    jobjectArray outputs,
+    jobject frame,
+    jint blurMode,
+    jfloat sigma,
+    jboolean highQuality,
+    jfloat saturation
+) {
+    const jsize rawLength = rects ? env->GetArrayLength(rects) : 0;
+    const int count = rawLength / 4;
+    if (rects == nullptr || rawLength % 4 != 0 ||
+        (outputs != nullptr && env->GetArrayLength(outputs) != count)) {
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "Rects must be [left, top, right, bottom] x n with one output per rect");
+        return -1;
+    }
+    if ((outputs == nullptr) == (frame == nullptr) ||
+        (frame != nullptr && env->IsSameObject(frame, backdrop))) {
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "Exactly one of outputs / frame is required, and it must differ from backdrop");
+        return -1;
+    }
+
+    std::vector<jint> raw(rawLength);
+    env->GetIntArrayRegion(rects, 0, rawLength, raw.data());
+    std::vector<DamageRect> regions(count);
+    for (int i = 0; i < count; ++i) {
+        regions[i].left = raw[i * 4];
+        regions[i].top = raw[i * 4 + 1];
+        regions[i].right = raw[i * 4 + 2];
+        regions[i].bottom = raw[i * 4 + 3];
+    }
+
+    AndroidBitmapInfo backdropInfo, frameInfo;
+    void* backdropPixels = nullptr;
+    void* framePixels = nullptr;
+    PipelineBitmapLocks locks(env);
+    if (!locks.lock(backdrop, &backdropInfo, &backdropPixels) || !backdropPixels ||
+        !locks.lock(frame, &frameInfo, &framePixels)) {
+        return -1; // 异常已在 lock_bitmap 中抛出
+    }
+
+    std::vector<uint8_t*> outPixels(count, nullptr);
+    std::vector<int> outStrides(count, 0);
+    if (framePixels) {
+        if (frameInfo.width != backdropInfo.width || frameInfo.height != backdropInfo.height) {
+            jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+            env->ThrowNew(exClass, "Frame bitmap must have the same dimensions as backdrop");
+            return -1;
+        }
+        // 整帧输出：每个矩形的输出即 frame 中的对应位置（视图）
+        for (int i = 0; i < count; ++i) {
+            const DamageRect& r = regions[i];
+            if (r.empty() || r.left < 0 || r.top < 0) continue;
+            outPixels[i] = static_cast<uint8_t*>(framePixels) + r.top * frameInfo.stride + r.left * 4;
+            outStrides[i] = static_cast<int>(frameInfo.stride);
+        }
+    } else {
+        for (int i = 0; i < count; ++i) {
+            jobject output = env->GetObjectArrayElement(outputs, i);
+            if (output == nullptr) continue;
+            if (env->IsSameObject(output, backdrop)) {
+                jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+                env->ThrowNew(exClass, "Output bitmaps must differ from backdrop");
+                return -1;
+            }
+
+            AndroidBitmapInfo info;
+            void* pixels = nullptr;
+            if (!locks.lock(output, &info, &pixels)) return -1;
+            if (static_cast<int>(info.width) != regions[i].width() ||
+                static_cast<int>(info.height) != regions[i].height()) {
+                LOGE("blurRegions: output %d is %dx%d, rect is %dx%d",
+                     i, info.width, info.height, regions[i].width(), regions[i].height());
+                jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+                env->ThrowNew(exClass, "Each output bitmap must match its rect size");
+                return -1;
+            }
+            outPixels[i] = static_cast<uint8_t*>(pixels);
+            outStrides[i] = static_cast<int>(info.stride);
+        }
+    }
+
+    GlassPipelineParams params;
+    params.blurMode = blurMode;
+    params.sigma = sigma;
+    params.highQuality = highQuality;
+    params.saturation = saturation;
+
+    return render_glass_blur_regions(
+        static_cast<const uint8_t*>(backdropPixels),
+        static_cast<int>(backdropInfo.stride),
+        static_cast<int>(backdropInfo.width),
+        static_cast<int>(backdropInfo.height),
+        params,
+        regions.data(),
+        count,
+        outPixels.data(),
+        outStrides.data()
+    );
+}
+
+/**
+ * JNI: blurRegionsRaw
+ *
+ * 批量区域模糊：每个矩形输出到独立 Bitmap（副本）
+ *
+ * @param backdrop 整帧背景
+ * @param rects [left, top, right, bottom] × n
+ * @param outputs 每个矩形的输出 Bitmap（尺寸 = 矩形尺寸，可为 null 跳过）
+ * @return 实际模糊的块数
+ */
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_blurRegionsRaw(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject backdrop,
+    jintArray rects,
+    jobjectArray outputs,
+    jint blurMode,
+    jfloat sigma,
+    jboolean highQuality,
+    jfloat saturation
+) {
+    return run_blur_regions(env, backdrop, rects, outputs, nullptr, blurMode, sigma, highQuality, saturation);
+}
+
+/**
+ * JNI: blurRegionsIntoFrameRaw
+ *
+ * 批量区域模糊：各矩形写入整帧 Bitmap 的对应位置（矩形以外保持不变）
+ *
+ * @param backdrop 整帧背景
+ * @param rects [left, top, right, bottom] × n
+ * @param frame 整帧输出 Bitmap（与 backdrop 尺寸相同）
+ * @return 实际模糊的块数
+ */
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_blurRegionsIntoFrameRaw(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject backdrop,
+    jintArray rects,
+    jobject frame,
+    jint blurMode,
+    jfloat sigma,
+    jboolean highQuality,
+    jfloat saturation
+) {
+    return run_blur_regions(env, backdrop, rects, nullptr, frame, blurMode, sigma, highQuality, saturation);
+}
+
+/**
+ * JNI: computeDamageRaw
+ *
+ * 比较两帧背景，返回变化区域 [left, top, right, bottom]（半开区间）
+ *
+ * @param previous 上一帧 Bitmap
+ * @param current 当前帧 Bitmap（与 previous 尺寸相同）
+ * @return 变化区域；两帧相同时返回 null
+ */
+extern "C" JNIEXPORT jintArray JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_computeDamageRaw(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject previous,
+    jobject current
+) {
+    AndroidBitmapInfo previousInfo, currentInfo;
+    void* previousPixels = nullptr;
+    void* currentPixels = nullptr;
+
+    PipelineBitmapLocks locks(env);
+    if (!locks.lock(previous, &previousInfo, &previousPixels) ||
+        !locks.lock(current, &currentInfo, &currentPixels)) {
+        return nullptr; // 异常已在 lock_bitmap 中抛出
+    }
+
+    if (previousInfo.width != currentInfo.width || previousInfo.height != currentInfo.height) {
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "Previous and current bitmaps must have the same dimensions");
+        return nullptr;
+    }
+
+    DamageRect damage;
+    if (!compute_damage_rect(
+            static_cast<const uint8_t*>(previousPixels),
+            static_cast<int>(previousInfo.stride),
+            static_cast<const uint8_t*>(currentPixels),
+            static_cast<int>(currentInfo.stride),
+            static_cast<int>(currentInfo.width),
+            static_cast<int>(currentInfo.height),
+            &damage)) {
+        return nullptr;
+    }
+
+    const jint raw[4] = { damage.left, damage.top, damage.right, damage.bottom };
+    jintArray out = env->NewIntArray(4);
+    if (out == nullptr) return nullptr;
+    env->SetIntArrayRegion(out, 0, 4, raw);
+    return out;
+}
+
+/**
+ * JNI: hashBitmap
+ *
+ * 像素内容的 64 位哈希（xxHash 风格，NEON 加速；行跨度填充不参与）
+ *
+ * @param bitmap ARGB_8888 Bitmap（只读）
+ * @return 哈希值（永不为 0）；异常时返回 0
+ */
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_hashBitmap(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject bitmap
+) {
+    AndroidBitmapInfo info;
+    void* pixels = nullptr;
+
+    PipelineBitmapLocks locks(env);
+    if (!locks.lock(bitmap, &info, &pixels) || !pixels) {
+        return 0; // 异常已在 lock_bitmap 中抛出（Kotlin 侧参数非空）
+    }
+
+    return static_cast<jlong>(frame_hash_rgba8888(
+        static_cast<const uint8_t*>(pixels),
+        static_cast<int>(info.width),
+        static_cast<int>(info.height),
+        static_cast<int>(info.stride)));
+}
+
+/**
+ * 由 JNI 参数构造模糊结果缓存键
+ */
+static BlurCacheKey make_blur_cache_key(
+    jlong hash, jint width, jint height, jint method, jint variant, jfloat sigma, jfloat saturation
+) {
+    BlurCacheKey key;
+    key.hash = static_cast<uint64_t>(hash);
+    key.width = width;
+    key.height = height;
+    key.method = method;
+    key.variant = variant;
+    key.sigma = sigma;
+    key.saturation = saturation;
+    return key;
+}
+
+/**
+ * JNI: blurCacheContains
+ *
+ * 是否缓存了对应结果（不复制；用于命中前避免分配目标 Bitmap）
+ */
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_blurCacheContains(
+    JNIEnv* env,
+    jobject /* this */,
+    jlong hash,
+    jint width,
+    jint height,
+    jint method,
+    jint variant,
+    jfloat sigma,
+    jfloat saturation
+) {
+    return blur_cache_contains(make_blur_cache_key(hash, width, height, method, variant, sigma, saturation));
+}
+
+/**
+ * JNI: blurCacheLookup
+ *
+ * 查找缓存结果并复制到 destination（键中的尺寸取 destination 的尺寸）
+ *
+ * @return true 如果命中
+ */
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_blurCacheLookup(
+    JNIEnv* env,
+    jobject /* this */,
+    jlong hash,
+    jint method,
+    jint variant,
+    jfloat sigma,
+    jfloat saturation,
+    jobject destination
+) {
+    AndroidBitmapInfo info;
+    void* pixels = nullptr;
+
+    PipelineBitmapLocks locks(env);
+    if (!locks.lock(destination, &info, &pixels) || !pixels) {
+        return JNI_FALSE; // 异常已在 lock_bitmap 中抛出（Kotlin 侧参数非空）
+    }
+
+    const BlurCacheKey key = make_blur_cache_key(
+        hash, static_cast<jint>(info.width), static_cast<jint>(info.height), method, variant, sigma, saturation);
+    return blur_cache_lookup(key, static_cast<uint8_t*>(pixels), static_cast<int>(info.stride));
+}
+
+/**
+ * JNI: blurCacheStore
+ *
+ * 保存模糊结果（键中的尺寸取 source 的尺寸）
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_blurCacheStore(
+    JNIEnv* env,
+    jobject /* this */,
+    jlong hash,
+    jint method,
+    jint variant,
+    jfloat sigma,
+    jfloat saturation,
+    jobject source
+) {
+    AndroidBitmapInfo info;
+    void* pixels = nullptr;
+
+    PipelineBitmapLocks locks(env);
+    if (!locks.lock(source, &info, &pixels) || !pixels) {
+        return; // 异常已在 lock_bitmap 中抛出（Kotlin 侧参数非空）
+    }
+
+    const BlurCacheKey key = make_blur_cache_key(
+        hash, static_cast<jint>(info.width), static_cast<jint>(info.height), method, variant, sigma, saturation);
+    blur_cache_store(key, static_cast<const uint8_t*>(pixels), static_cast<int>(info.stride));
+}
+
+/**
+ * JNI: setBlurCacheCapacity
+ *
+ * @param entries 最大条目数（0 = 关闭）
+ * @param maxBytes 总字节数上限
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_setBlurCacheCapacity(
+    JNIEnv* env,
+    jobject /* this */,
+    jint entries,
+    jlong maxBytes
+) {
+    blur_cache_set_capacity(entries, static_cast<size_t>(std::max<jlong>(0, maxBytes)));
+}
+
+/**
+ * JNI: clearBlurCache
+ *
+ * @return 释放的字节数
+ */
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_clearBlurCache(
+    JNIEnv* env,
+    jobject /* this */
+) {
+    return static_cast<jlong>(blur_cache_clear());
+}
+
+/**
+ * JNI: blurCacheStatsRaw
+ *
+ * @return [hits, misses, entries, bytes]
+ */
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_blurCacheStatsRaw(
+    JNIEnv* env,
+    jobject /* this */
+) {
+    const BlurCacheStats stats = blur_cache_stats();
+    const jlong raw[4] = {
+        static_cast<jlong>(stats.hits),
+        static_cast<jlong>(stats.misses),
+        static_cast<jlong>(stats.entries),
+        static_cast<jlong>(stats.bytes)
+    };
+    jlongArray out = env->NewLongArray(4);
+    if (out == nullptr) return nullptr;
+    env->SetLongArrayRegion(out, 0, 4, raw);
+    return out;
+}
+
+/**
+ * JNI: generateEdgeMaps
+ *
+ * 从源图像 Alpha 通道生成边缘距离贴图与法线贴图（精确欧氏距离变换，一次遍历）
+ *
+ * @param source 源图像 Bitmap（只读，只使用 Alpha）
+ * @param edgeDistance 输出边缘距离贴图（与 source 尺寸相同）
+ * @param normalMap 输出法线贴图（可为 null，不生成）
+ * @param alphaThreshold Alpha 低于此值视为透明（推荐 10）
+ * @param maxDistance 归一化距离（<= 0 时使用半对角线长度）
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_liquidglass_NativeChromaticDispersion_generateEdgeMaps(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject source,
+    jobject edgeDistance,
+    jobject normalMap,
+    jint alphaThreshold,
+    jfloat maxDistance
+) {
+    AndroidBitmapInfo sourceInfo, edgeDistanceInfo, normalMapInfo;
+    void* sourcePixels = nullptr;
+    void* edgeDistancePixels = nullptr;
+    void* normalMapPixels = nullptr;
+
+    PipelineBitmapLocks locks(env);
+    if (!locks.lock(source, &sourceInfo, &sourcePixels) ||
+        !locks.lock(edgeDistance, &edgeDistanceInfo, &edgeDistancePixels) ||
+        !locks.lock(normalMap, &normalMapInfo, &normalMapPixels)) {
+        return; // 异常已在 lock_bitmap 中抛出
+    }
+
+    // 验证尺寸一致性
+    const uint32_t w = sourceInfo.width;
+    const uint32_t h = sourceInfo.height;
+    bool sizeMismatch = edgeDistanceInfo.width != w || edgeDistanceInfo.height != h;
+    if (normalMapPixels) sizeMismatch |= normalMapInfo.width != w || normalMapInfo.height != h;
+
+    if (sizeMismatch) {
+        LOGE("generateEdgeMaps: bitmap size mismatch (source=%dx%d, edgeDistance=%dx%d)",
+             w, h, edgeDistanceInfo.width, edgeDistanceInfo.height);
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "Source, edgeDistance, and normalMap bitmaps must have the same dimensions");
+        return;
+    }
+
+    generate_edge_maps_from_alpha(
+        static_cast<const uint8_t*>(sourcePixels),
+        static_cast<int>(sourceInfo.stride),
+        static_cast<uint8_t*>(edgeDistancePixels),
+        static_cast<int>(edgeDistanceInfo.stride),
+        static_cast<uint8_t*>(normalMapPixels),
+        normalMapPixels ? static_cast<int>(normalMapInfo.stride) : 0,
+        static_cast<int>(w),
+        static_cast<int>(h),
+        alphaThreshold,
+        maxDistance
+    );
+}
+
+/**
+ * JNI: generateDisplacementMap
+ *
+ * 生成位移贴图（DisplacementMapGenerator 三种模式的原生实现），直接写入 Bitmap
+ *
+ * @param bitmap 输出 Bitmap（ARGB_8888, mutable）
+ * @param mode 位移模式（DisplacementMode.ordinal）
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_liquidglass_NativeDisplacementMap_generateDisplacementMap(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject bitmap,
+    jint mode
+) {
+    AndroidBitmapInfo info;
+    void* pixels = nullptr;
+
+    // 锁定 Bitmap
+    if (!lock_bitmap(env, bitmap, &info, &pixels)) {
+        return; // 异常已在 lock_bitmap 中抛出
+    }
+
+    generate_displacement_map_rgba8888(
+        static_cast<uint8_t*>(pixels),
+        static_cast<int>(info.width),
+        static_cast<int>(info.height),
+        static_cast<int>(info.stride),
+        mode
+    );
+
+    // 解锁 Bitmap
+    AndroidBitmap_unlockPixels(env, bitmap);
+}
+
+/**
+ * JNI: resizeBilinear
+ *
+ * 双线性缩放（查找表 + 8.8 定点），替代 Bitmap.createScaledBitmap 的降采样 / 上采样
+ *
+ * @param source 源图像 Bitmap（只读）
+ * @param destination 目标 Bitmap（ARGB_8888, mutable，尺寸即目标尺寸，不能与 source 相同）
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_blur_NativeGauss_resizeBilinear(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject source,
+    jobject destination
+) {
+    if (source == nullptr || destination == nullptr || env->IsSameObject(source, destination)) {
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "Source and destination must be different non-null bitmaps");
+        return;
+    }
+
+    AndroidBitmapInfo sourceInfo, destinationInfo;
+    void* sourcePixels = nullptr;
+    void* destinationPixels = nullptr;
+
+    PipelineBitmapLocks locks(env);
+    if (!locks.lock(source, &sourceInfo, &sourcePixels) ||
+        !locks.lock(destination, &destinationInfo, &destinationPixels)) {
+        return; // 异常已在 lock_bitmap 中抛出
+    }
+
+    resize_bilinear_rgba8888(
+        static_cast<const uint8_t*>(sourcePixels),
+        static_cast<int>(sourceInfo.width),
+        static_cast<int>(sourceInfo.height),
+        static_cast<int>(sourceInfo.stride),
+        static_cast<uint8_t*>(destinationPixels),
+        static_cast<int>(destinationInfo.width),
+        static_cast<int>(destinationInfo.height),
+        static_cast<int>(destinationInfo.stride)
+    );
+}
+
+/**
+ * JNI: AsyncRenderer.nativeCreate
+ *
+ * 创建原生渲染队列（启动调度线程）
+ *
+ * @return 队列句柄；失败时返回 0
+ */
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_liquidglass_AsyncRenderer_nativeCreate(
+    JNIEnv* /* env */,
+    jclass /* clazz */
+) {
+    return reinterpret_cast<jlong>(render_queue_create());
+}
+
+/**
+ * JNI: AsyncRenderer.nativeDestroy
+ *
+ * 停止渲染队列（不等待进行中的渲染）
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_liquidglass_AsyncRenderer_nativeDestroy(
+    JNIEnv* /* env */,
+    jclass /* clazz */,
+    jlong handle
+) {
+    render_queue_destroy(reinterpret_cast<RenderQueue*>(handle));
+}
+
+/**
+ * JNI: AsyncRenderer.nativeSubmit
+ *
+ * 复制背景与当前效果所需贴图，发布为最新渲染请求（不等待渲染）
+ *
+ * 参数含义同 NativeGlassPipeline.renderGlassPipeline
+ *
+ * @return 请求序号；参数无效时返回 0
+ */
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_liquidglass_AsyncRenderer_nativeSubmit(
+    JNIEnv* env,
+    jclass /* clazz */,
+    jlong handle,
+    jobject backdrop,
+    jobject displacement,
+    jobject edgeDistance,
+    jobject normalMap,
+    jint blurMode,
+    jfloat sigma,
+    jboolean highQuality,
+    jfloat saturation,
+    jint effect,
+    jfloat scale,
+    jfloat redOffset,
+    jfloat greenOffset,
+    jfloat blueOffset,
+    jfloat refThickness,
+    jfloat refFactor,
+    jfloat refDispersion,
+    jfloat dpr,
+    jboolean useBilinear
+) {
+    RenderQueue* queue = reinterpret_cast<RenderQueue*>(handle);
+    if (queue == nullptr) {
+        jclass exClass = env->FindClass("java/lang/IllegalStateException");
+        env->ThrowNew(exClass, "Render queue has been released");
+        return 0;
+    }
+
+    AndroidBitmapInfo backdropInfo;
+    void* backdropPixels = nullptr;
+
+    PipelineBitmapLocks locks(env);
+    if (!locks.lock(backdrop, &backdropInfo, &backdropPixels)) return 0;
+
+    const uint32_t w = backdropInfo.width;
+    const uint32_t h = backdropInfo.height;
+
+    GlassPipelineParams params;
+    if (!lock_effect_maps(env, locks, effect, displacement, edgeDistance, normalMap, w, h, &params)) return 0;
+
+    params.blurMode = blurMode;
+    params.sigma = sigma;
+    params.highQuality = highQuality;
+    params.saturation = saturation;
+    params.effect = effect;
+    params.useBilinear = useBilinear;
+    params.scale = scale;
+    params.redOffset = redOffset;
+    params.greenOffset = greenOffset;
+    params.blueOffset = blueOffset;
+    params.refThickness = refThickness;
+    params.refFactor = refFactor;
+    params.refDispersion = refDispersion;
+    params.dpr = dpr;
+
+    return static_cast<jlong>(render_queue_submit(
+        queue,
+        static_cast<const uint8_t*>(backdropPixels),
+        static_cast<int>(backdropInfo.stride),
+        static_cast<int>(w),
+        static_cast<int>(h),
+        params
+    ));
+}
+
+/**
+ * JNI: AsyncRenderer.nativeAcquire
+ *
+ * 取最新完成帧并复制到 result（不等待）
+ *
+ * @param result 结果 Bitmap（ARGB_8888, mutable）
+ * @return 取走帧的请求序号：> 0 已复制；< 0 尺寸与 result 不一致已丢弃（取绝对值）；0 没有新帧
+ */
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_liquidglass_AsyncRenderer_nativeAcquire(
+    JNIEnv* env,
+    jclass /* clazz */,
+    jlong handle,
+    jobject result
+) {
+    RenderQueue* queue = reinterpret_cast<RenderQueue*>(handle);
+    if (queue == nullptr) {
+        jclass exClass = env->FindClass("java/lang/IllegalStateException");
+        env->ThrowNew(exClass, "Render queue has been released");
+        return 0;
+    }
+
+    AndroidBitmapInfo info;
+    void* pixels = nullptr;
+    if (!lock_bitmap(env, result, &info, &pixels)) {
+        return 0; // 异常已在 lock_bitmap 中抛出
+    }
+
+    bool copied = false;
+    const uint64_t sequence = render_queue_acquire(
+        queue,
+        static_cast<uint8_t*>(pixels),
+        static_cast<int>(info.stride),
+        static_cast<int>(info.width),
+        static_cast<int>(info.height),
+        &copied
+    );
+
+    AndroidBitmap_unlockPixels(env, result);
+    return copied ? static_cast<jlong>(sequence) : -static_cast<jlong>(sequence);
+}
+
+/**
+ * JNI: AsyncRenderer.nativeStats
+ *
+ * @return [submitted, coalesced, rendered, dropped, presented, lastRenderNs]
+ */
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_liquidglass_AsyncRenderer_nativeStats(
+    JNIEnv* env,
+    jclass /* clazz */,
+    jlong handle
+) {
+    RenderQueueStats stats = {};
+    render_queue_stats(reinterpret_cast<const RenderQueue*>(handle), &stats);
+
+    const jlong values[6] = {
+        static_cast<jlong>(stats.submitted),
+        static_cast<jlong>(stats.coalesced),
+        static_cast<jlong>(stats.rendered),
+        static_cast<jlong>(stats.dropped),
+        static_cast<jlong>(stats.presented),
+        static_cast<jlong>(stats.lastRenderNs)
+    };
+    jlongArray array = env->NewLongArray(6);
+    if (array == nullptr) return nullptr;
+    env->SetLongArrayRegion(array, 0, 6, values);
+    return array;
+}
+
+/**
+ * JNI: StreamingGaussianBlur.nativeCreate
+ *
+ * @return 流句柄；参数无效时返回 0
+ */
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_blur_StreamingGaussianBlur_nativeCreate(
+    JNIEnv* /* env */,
+    jclass /* clazz */,
+    jint width,
+    jint height,
+    jfloat sigma,
+    jboolean highQuality
+) {
+    return reinterpret_cast<jlong>(gaussian_iir_stream_create(width, height, sigma, highQuality));
+}
+
+/**
+ * JNI: StreamingGaussianBlur.nativeDestroy
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_blur_StreamingGaussianBlur_nativeDestroy(
+    JNIEnv* /* env */,
+    jclass /* clazz */,
+    jlong handle
+) {
+    gaussian_iir_stream_destroy(reinterpret_cast<GaussianIIRStream*>(handle));
+}
+
+/**
+ * 辅助函数：锁定流的行条带 Bitmap，并校验行范围 [firstRow, firstRow + rowCount)
+ *
+ * @return 第 firstRow 行的像素指针；失败时返回 nullptr（已抛出异常，Bitmap 未锁定）
+ */
+static uint8_t* lock_stream_rows(
+    JNIEnv* env,
+    jlong handle,
+    jobject bitmap,
+    jint firstRow,
+    jint rowCount,
+    AndroidBitmapInfo* info
+) {
+    if (handle == 0) {
+        jclass exClass = env->FindClass("java/lang/IllegalStateException");
+        env->ThrowNew(exClass, "Streaming blur has been released");
+        return nullptr;
+    }
+
+    void* pixels = nullptr;
+    if (!lock_bitmap(env, bitmap, info, &pixels)) {
+        return nullptr; // 异常已在 lock_bitmap 中抛出
+    }
+
+    if (firstRow < 0 || rowCount < 0 || firstRow > static_cast<jint>(info->height) - rowCount) {
+        LOGE("Invalid strip rows: first=%d, count=%d, height=%d", firstRow, rowCount, info->height);
+        AndroidBitmap_unlockPixels(env, bitmap);
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "Row range exceeds bitmap height");
+        return nullptr;
+    }
+
+    return static_cast<uint8_t*>(pixels) + static_cast<size_t>(firstRow) * info->stride;
+}
+
+/**
+ * JNI: StreamingGaussianBlur.nativePush
+ *
+ * @return 接受的行数（输出未取走、环形缓冲已满时可能少于 rowCount）
+ */
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_blur_StreamingGaussianBlur_nativePush(
+    JNIEnv* env,
+    jclass /* clazz */,
+    jlong handle,
+    jobject strip,
+    jint firstRow,
+    jint rowCount
+) {
+    AndroidBitmapInfo info;
+    const uint8_t* rows = lock_stream_rows(env, handle, strip, firstRow, rowCount, &info);
+    if (rows == nullptr) return 0;
+
+    const int accepted = gaussian_iir_stream_push(
+        reinterpret_cast<GaussianIIRStream*>(handle), rows, info.stride, rowCount);
+
+    AndroidBitmap_unlockPixels(env, strip);
+    return accepted;
+}
+
+/**
+ * JNI: StreamingGaussianBlur.nativePull
+ *
+ * @return 写入 out 的行数
+ */
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_blur_StreamingGaussianBlur_nativePull(
+    JNIEnv* env,
+    jclass /* clazz */,
+    jlong handle,
+    jobject out,
+    jint firstRow,
+    jint rowCount
+) {
+    AndroidBitmapInfo info;
+    uint8_t* rows = lock_stream_rows(env, handle, out, firstRow, rowCount, &info);
+    if (rows == nullptr) return 0;
+
+    const int pulled = gaussian_iir_stream_pull(
+        reinterpret_cast<GaussianIIRStream*>(handle), rows, info.stride, rowCount);
+
+    AndroidBitmap_unlockPixels(env, out);
+    return pulled;
+}
+
+/**
+ * JNI: StreamingGaussianBlur.nativeAvailable
+ */
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_blur_StreamingGaussianBlur_nativeAvailable(
+    JNIEnv* /* env */,
+    jclass /* clazz */,
+    jlong handle
+) {
+    return gaussian_iir_stream_available(reinterpret_cast<const GaussianIIRStream*>(handle));
+}
+
+/**
+ * JNI: StreamingGaussianBlur.nativeMemoryBytes
+ */
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_blur_StreamingGaussianBlur_nativeMemoryBytes(
+    JNIEnv* /* env */,
+    jclass /* clazz */,
+    jlong handle
+) {
+    return static_cast<jlong>(gaussian_iir_stream_memory_bytes(reinterpret_cast<const GaussianIIRStream*>(handle)));
+}
+
+/**
+ * HardwareBuffer 管线公共实现：映射结果缓冲（CPU 写）、锁定贴图、组装参数后整帧渲染
+ *
+ * @param backdrop 已映射的背景缓冲
+ * @param result 结果 android.hardware.HardwareBuffer（与背景尺寸相同，不能是同一个缓冲）
+ * @return 是否已渲染（失败时已抛出异常）
+ */
+static bool run_glass_pipeline_hardware(
+    JNIEnv* env,
+    const MappedHardwareBuffer& backdrop,
+    jobject displacement,
+    jobject edgeDistance,
+    jobject normalMap,
+    jobject result,
+    jint blurMode,
+    jfloat sigma,
+    jboolean highQuality,
+    jfloat saturation,
+    jint effect,
+    jfloat scale,
+    jfloat redOffset,
+    jfloat greenOffset,
+    jfloat blueOffset,
+    jfloat refThickness,
+    jfloat refFactor,
+    jfloat refDispersion,
+    jfloat dpr,
+    jboolean useBilinear
+) {
+    AHardwareBuffer* resultBuffer = hardware_buffer_from_java(env, result);
+    if (resultBuffer == nullptr || resultBuffer == backdrop.buffer) {
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "Result must be a HardwareBuffer different from the backdrop");
+        return false;
+    }
+
+    const uint32_t w = static_cast<uint32_t>(backdrop.width);
+    const uint32_t h = static_cast<uint32_t>(backdrop.height);
+
+    PipelineBitmapLocks locks(env);
+    GlassPipelineParams params;
+    if (!lock_effect_maps(env, locks, effect, displacement, edgeDistance, normalMap, w, h, &params)) return false;
+
+    params.blurMode = blurMode;
+    params.sigma = sigma;
+    params.highQuality = highQuality;
+    params.saturation = saturation;
+    params.effect = effect;
+    params.useBilinear = useBilinear;
+    params.scale = scale;
+    params.redOffset = redOffset;
+    params.greenOffset = greenOffset;
+    params.blueOffset = blueOffset;
+    params.refThickness = refThickness;
+    params.refFactor = refFactor;
+    params.refDispersion = refDispersion;
+    params.dpr = dpr;
+
+    MappedHardwareBuffer output;
+    if (!hardware_buffer_lock(resultBuffer, AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN, -1, &output)) {
+        jclass exClass = env->FindClass("java/lang/IllegalStateException");
+        env->ThrowNew(exClass, "Failed to map result HardwareBuffer (requires RGBA_8888 and USAGE_CPU_WRITE_*)");
+        return false;
+    }
+
+    if (output.width != backdrop.width || output.height != backdrop.height) {
+        LOGE("renderGlassPipelineHardwareBuffer: size mismatch (backdrop=%dx%d, result=%dx%d)",
+             backdrop.width, backdrop.height, output.width, output.height);
+        hardware_buffer_unlock(&output);
+        jclass exClass = env->FindClass("java/lang/IllegalArgumentException");
+        env->ThrowNew(exClass, "Backdrop and result buffers must have the same dimensions");
+        return false;
+    }
+
+    render_glass_pipeline(
+        backdrop.pixels,
+        backdrop.stride,
+        output.pixels,
+        output.stride,
+        backdrop.width,
+        backdrop.height,
+        params
+    );
+
+    hardware_buffer_unlock(&output);
+    return true;
+}
+
+/**
+ * JNI: NativeGlassPipeline.isHardwareBufferSupported
+ *
+ * @return 设备是否支持 AHardwareBuffer 映射（API 26+）
+ */
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_isHardwareBufferSupported(
+    JNIEnv* /* env */,
+    jobject /* this */
+) {
+    return hardware_buffer_supported() ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * JNI: renderGlassPipelineHardwareBuffer
+ *
+ * 同 renderGlassPipeline，但背景与结果是 HardwareBuffer：原地映射读写，不经过软件 Bitmap
+ *
+ * @param backdrop 背景（RGBA_8888，需带 USAGE_CPU_READ_*）
+ * @param result 结果（RGBA_8888，需带 USAGE_CPU_WRITE_*；带 USAGE_GPU_SAMPLED_IMAGE 时可直接包装显示）
+ * 其余参数同 renderGlassPipeline（贴图仍为 Bitmap，与背景尺寸相同）
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_liquidglass_NativeGlassPipeline_renderGlassPipelineHardwareBuffer(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject backdrop,
+    jobject displacement,
+    jobject edgeDistance,
+    jobject normalMap,
+    jobject result,
+    jint blurMode,
+    jfloat sigma,
+    jboolean highQuality,
+    jfloat saturation,
+    jint effect,
+    jfloat scale,
+    jfloat redOffset,
+    jfloat greenOffset,
+    jfloat blueOffset,
+    jfloat refThickness,
+    jfloat refFactor,
+    jfloat refDispersion,
+    jfloat dpr,
+    jboolean useBilinear
+) {
+    AHardwareBuffer* backdropBuffer = hardware_buffer_from_java(env, backdrop);
+    if (backdropBuffer == nullptr) {
+        jclass exClass = env->FindClass("java/lang/UnsupportedOperationException");
+        env->ThrowNew(exClass, "AHardwareBuffer is not available on this device");
+        return;
+    }
+
+    MappedHardwareBuffer input;
+    if (!hardware_buffer_lock(backdropBuffer, AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN, -1, &input)) {
+        jclass exClass = env->FindClass("java/lang/IllegalStateException");
+        env->ThrowNew(exClass, "Failed to map backdrop HardwareBuffer (requires RGBA_8888 and USAGE_CPU_READ_*)");
+        return;
+    }
+
+    run_glass_pipeline_hardware(
+        env, input, displacement, edgeDistance, normalMap, result,
+        blurMode, sigma, highQuality, saturation,
+        effect, scale, redOffset, greenOffset, blueOffset,
+        refThickness, refFactor, refDispersion, dpr,
+        useBilinear
+    );
+
+    hardware_buffer_unlock(&input);
+}
+
+/**
+ * JNI: HardwareBufferRenderer.isSupported
+ *
+ * @return 设备是否支持零拷贝捕获（AImageReader + AHardwareBuffer，API 26+）
+ */
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_liquidglass_HardwareBufferRenderer_isSupported(
+    JNIEnv* /* env */,
+    jclass /* clazz */
+) {
+    return hardware_capture_supported() ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * JNI: HardwareBufferRenderer.nativeCreate
+ *
+ * @return 捕获器句柄；不支持或创建失败时返回 0
+ */
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_liquidglass_HardwareBufferRenderer_nativeCreate(
+    JNIEnv* /* env */,
+    jclass /* clazz */,
+    jint width,
+    jint height
+) {
+    return reinterpret_cast<jlong>(hardware_capture_create(width, height));
+}
+
+/**
+ * JNI: HardwareBufferRenderer.nativeDestroy
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_liquidglass_HardwareBufferRenderer_nativeDestroy(
+    JNIEnv* /* env */,
+    jclass /* clazz */,
+    jlong handle
+) {
+    hardware_capture_destroy(reinterpret_cast<HardwareCapture*>(handle));
+}
+
+/**
+ * JNI: HardwareBufferRenderer.nativeGetSurface
+ *
+ * @return 捕获器的输入 Surface（Kotlin 层通过 lockHardwareCanvas 绘制）
+ */
+extern "C" JNIEXPORT jobject JNICALL
+Java_com_example_liquidglass_HardwareBufferRenderer_nativeGetSurface(
+    JNIEnv* env,
+    jclass /* clazz */,
+    jlong handle
+) {
+    return hardware_capture_surface(env, reinterpret_cast<HardwareCapture*>(handle));
+}
+
+/**
+ * JNI: HardwareBufferRenderer.nativeRender
+ *
+ * 取捕获 Surface 上最新绘制完成的一帧作为背景（等待 GPU 栅栏后直接映射），
+ * 渲染到 result；没有新帧时立即返回
+ *
+ * 参数含义同 renderGlassPipelineHardwareBuffer
+ *
+ * @return true 已渲染新帧；false 没有新帧（result 保持不变）
+ */
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_liquidglass_HardwareBufferRenderer_nativeRender(
+    JNIEnv* env,
+    jclass /* clazz */,
+    jlong handle,
+    jobject displacement,
+    jobject edgeDistance,
+    jobject normalMap,
+    jobject result,
+    jint blurMode,
+    jfloat sigma,
+    jboolean highQuality,
+    jfloat saturation,
+    jint effect,
+    jfloat scale,
+    jfloat redOffset,
+    jfloat greenOffset,
+    jfloat blueOffset,
+    jfloat refThickness,
+    jfloat refFactor,
+    jfloat refDispersion,
+    jfloat dpr,
+    jboolean useBilinear
+) {
+    HardwareCapture* capture = reinterpret_cast<HardwareCapture*>(handle);
+    if (capture == nullptr) {
+        jclass exClass = env->FindClass("java/lang/IllegalStateException");
+        env->ThrowNew(exClass, "Hardware capture has been released");
+        return JNI_FALSE;
+    }
+
+    MappedHardwareBuffer input;
+    if (!hardware_capture_acquire(capture, &input)) return JNI_FALSE;
+
+    const bool rendered = run_glass_pipeline_hardware(
+        env, input, displacement, edgeDistance, normalMap, result,
+        blurMode, sigma, highQuality, saturation,
+        effect, scale, redOffset, greenOffset, blueOffset,
+        refThickness, refFactor, refDispersion, dpr,
+        useBilinear
+    );
+
+    // 立即归还：AImageReader 只有 3 帧，帧内容已被管线读取完毕
+    hardware_capture_release(capture);
+    return rendered ? JNI_TRUE : JNI_FALSE;
+}
@@ -0,0 +1,200 @@
+/**
+ * perf_trace.cpp - 分阶段性能计数实现
+ *
+ * 实现细节：
+ * - 累计计数：每个 (滤波器, 阶段) 三个 std::atomic<uint64_t>（次数 / 总耗时 / 最大耗时），
+ *   最大值用 CAS 更新
+ * - 环形缓冲：1024 个 std::atomic<uint64_t> 槽位，写入位置由 fetch_add 领取；
+ *   每个样本打包为一个 64 位值，读写都是单次原子操作，无需加锁：
+ *     [63:56] 滤波器 + 1（0 表示空槽） [55:48] 阶段 [47:0] 纳秒
+ * - ATrace：首次使用时 dlopen("libandroid.so") 取得 ATrace_beginSection /
+ *   ATrace_endSection / ATrace_isEnabled（API 23+），取不到时所有区段调用为空操作
+ */
+
+#include "perf_trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <vector>
+#include <dlfcn.h>
+#include <android/log.h>
+
+#define LOG_TAG "PerfTrace"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// 环形缓冲容量（2 的幂）
+static const uint32_t kRingSize = 1024;
+
+// 样本打包
+static const int kFilterShift = 56;
+static const int kStageShift = 48;
+static const uint64_t kNsMask = (1ull << kStageShift) - 1;
+
+struct StageCounter {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> totalNs{0};
+    std::atomic<uint64_t> maxNs{0};
+};
+
+static std::atomic<bool> g_enabled{true};
+static StageCounter g_counters[TRACE_FILTER_COUNT][TRACE_STAGE_COUNT];
+static std::atomic<uint64_t> g_ring[kRingSize];
+static std::atomic<uint32_t> g_ringHead{0};
+
+static const char* const kFilterNames[TRACE_FILTER_COUNT] = {
+    "IIR", "IIR_NEON", "IIR_FP16", "Box3", "BoxSingle", "AdvancedBox", "AdvancedBoxHQ", "Aberration", "Dispersion", "Pyramid", "Resample", "Distortion"
+};
+
+static const char* const kStageNames[TRACE_STAGE_COUNT] = {
+    "total", "alloc", "convert", "horizontal", "vertical", "pack", "setup", "sample"
+};
+
+// ============================================================================
+// ATrace
+// ============================================================================
+
+typedef void (*ATraceBeginSectionFn)(const char*);
+typedef void (*ATraceEndSectionFn)();
+typedef bool (*ATraceIsEnabledFn)();
+
+struct ATraceApi {
+    ATraceBeginSectionFn beginSection = nullptr;
+    ATraceEndSectionFn endSection = nullptr;
+    ATraceIsEnabledFn isEnabled = nullptr;
+};
+
+static const ATraceApi& atrace_api() {
+    static const ATraceApi api = []() {
+        ATraceApi a;
+        void* lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+        if (lib) {
+            a.beginSection = reinterpret_cast<ATraceBeginSectionFn>(dlsym(lib, "ATrace_beginSection"));
+            a.endSection = reinterpret_cast<ATraceEndSectionFn>(dlsym(lib, "ATrace_endSection"));
+            a.isEnabled = reinterpret_cast<ATraceIsEnabledFn>(dlsym(lib, "ATrace_isEnabled"));
+        }
+        if (!a.beginSection || !a.endSection || !a.isEnabled) {
+            a = ATraceApi();
+            LOGD("ATrace not available, systrace sections disabled");
+        }
+        return a;
+    }();
+    return api;
+}
+
+bool perf_trace_atrace_enabled() {
+    const ATraceApi& api = atrace_api();
+    return api.isEnabled && api.isEnabled();
+}
+
+void perf_trace_begin_section(int filter, int stage) {
+    const ATraceApi& api = atrace_api();
+    if (!api.beginSection) return;
+    char name[48];
+    snprintf(name, sizeof(name), "%s.%s",
+             (filter >= 0 && filter < TRACE_FILTER_COUNT) ? kFilterNames[filter] : "?",
+             (stage >= 0 && stage < TRACE_STAGE_COUNT) ? kStageNames[stage] : "?");
+    api.beginSection(name);
+}
+
+void perf_trace_end_section() {
+    const ATraceApi& api = atrace_api();
+    if (api.endSection) api.endSection();
+}
+
+// ============================================================================
+// 计数
+// ============================================================================
+
+uint64_t perf_trace_now_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+bool perf_trace_enabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void perf_trace_set_enabled(bool enabled) {
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void perf_trace_record(int filter, int stage, uint64_t ns) {
+    if (filter < 0 || filter >= TRACE_FILTER_COUNT || stage < 0 || stage >= TRACE_STAGE_COUNT) return;
+    if (!perf_trace_enabled()) return;
+
+    StageCounter& counter = g_counters[filter][stage];
+    counter.count.fetch_add(1, std::memory_order_relaxed);
+    counter.totalNs.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t prevMax = counter.maxNs.load(std::memory_order_relaxed);
+    while (ns > prevMax && !counter.maxNs.compare_exchange_weak(prevMax, ns, std::memory_order_relaxed)) {
+    }
+
+    const uint64_t packed = (static_cast<uint64_t>(filter + 1) << kFilterShift) |
+                            (static_cast<uint64_t>(stage) << kStageShift) |
+                            std::min(ns, kNsMask);
+    const uint32_t index = g_ringHead.fetch_add(1, std::memory_order_relaxed) & (kRingSize - 1);
+    g_ring[index].store(packed, std::memory_order_relaxed);
+}
+
+void perf_trace_reset() {
+    for (auto& row : g_counters) {
+        for (auto& counter : row) {
+            counter.count.store(0, std::memory_order_relaxed);
+            counter.totalNs.store(0, std::memory_order_relaxed);
+            counter.maxNs.store(0, std::memory_order_relaxed);
+        }
+    }
+    for (auto& slot : g_ring) {
+        slot.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * 排序后样本的百分位（最近秩法）
+ */
+static uint64_t percentile(const std::vector<uint64_t>& sorted, double q) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(q * sorted.size());
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+int perf_trace_snapshot(PerfStageStats* out, int maxEntries) {
+    if (!out || maxEntries <= 0) return 0;
+
+    // 环形缓冲快照（并发写入时可能混入少量新样本，不影响统计意义）
+    std::vector<uint64_t> ring(kRingSize);
+    for (uint32_t i = 0; i < kRingSize; ++i) {
+        ring[i] = g_ring[i].load(std::memory_order_relaxed);
+    }
+
+    int written = 0;
+    std::vector<uint64_t> samples;
+    for (int f = 0; f < TRACE_FILTER_COUNT && written < maxEntries; ++f) {
+        for (int s = 0; s < TRACE_STAGE_COUNT && written < maxEntries; ++s) {
+            const StageCounter& counter = g_counters[f][s];
+            const uint64_t count = counter.count.load(std::memory_order_relaxed);
+            if (count == 0) continue;
+
+            const uint64_t key = (static_cast<uint64_t>(f + 1) << kFilterShift) |
+                                 (static_cast<uint64_t>(s) << kStageShift);
+            samples.clear();
+            for (uint64_t packed : ring) {
+                if ((packed & ~kNsMask) == key) samples.push_back(packed & kNsMask);
+            }
+            std::sort(samples.begin(), samples.end());
+
+            PerfStageStats& entry = out[written++];
+            entry.filter = f;
+            entry.stage = s;
+            entry.count = count;
+            entry.totalNs = counter.totalNs.load(std::memory_order_relaxed);
+            entry.maxNs = counter.maxNs.load(std::memory_order_relaxed);
+            entry.p50Ns = percentile(samples, 0.5);
+            entry.p99Ns = percentile(samples, 0.99);
+        }
+    }
+    return written;
+}
@@ -0,0 +1,200 @@
+/**
+ * perf_trace.h - 原生滤波器分阶段性能计数 + systrace / Perfetto 区段
+ *
+ * 功能：
+ * 1. ATrace 区段：抓取 systrace / Perfetto 时可看到 "IIR_NEON.horizontal" 等区段
+ *    （通过 dlsym 从 libandroid.so 取得 ATrace_* 函数，API < 23 时自动跳过）
+ * 2. 分阶段计数：每个 (滤波器, 阶段) 累计调用次数、总耗时、最大耗时（纳秒，原子计数）
+ * 3. 最近样本环形缓冲：无锁写入，读取时计算 p50 / p99
+ *
+ * 计时口径：
+ * - TraceScope 记录的是墙钟时间（total / alloc / horizontal / vertical / setup / sample）
+ * - convert / pack 在并行块内部累计，是各线程耗时之和（可能大于墙钟时间），
+ *   已包含在对应 horizontal / vertical 阶段中
+ *
+ * 开销：
+ * - 每个阶段两次 clock_gettime（vDSO，约 20-50 ns）+ 几次原子加
+ * - perf_trace_set_enabled(false) 后只剩一次原子读
+ *
+ * 使用方式：
+ *   TraceScope total(TRACE_FILTER_IIR, TRACE_STAGE_TOTAL);
+ *   { TraceScope s(TRACE_FILTER_IIR, TRACE_STAGE_HORIZONTAL); ... }
+ */
+
+#ifndef PERF_TRACE_H
+#define PERF_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * 滤波器（与 NativeGauss.kt 中的 STATS_FILTER_NAMES 顺序一致）
+ */
+enum TraceFilter {
+    TRACE_FILTER_IIR = 0,              // gaussian_iir_rgba8888_inplace
+    TRACE_FILTER_IIR_NEON,             // gaussian_iir_rgba8888_neon（x86 上含 SSE4.1 / AVX2 内核）
+    TRACE_FILTER_IIR_FP16,             // gaussian_iir_rgba8888_fp16_kernel
+    TRACE_FILTER_BOX3,                 // box3_rgba8888_inplace
+    TRACE_FILTER_BOX_SINGLE,           // box_blur_single_pass
+    TRACE_FILTER_ADVANCED_BOX,         // advanced_box_blur_rgba8888
+    TRACE_FILTER_ADVANCED_BOX_HQ,      // advanced_box_blur_rgba8888_hq
+    TRACE_FILTER_ABERRATION,           // chromatic_aberration_rgba8888
+    TRACE_FILTER_DISPERSION,           // chromatic_dispersion_rgba8888
+    TRACE_FILTER_PYRAMID,              // pyramid_blur_rgba8888_inplace
+    TRACE_FILTER_RESAMPLE,             // resize_bilinear_rgba8888
+    TRACE_FILTER_DISTORTION,           // edge_distortion_rgba8888
+    TRACE_FILTER_COUNT
+};
+
+/**
+ * 阶段（与 NativeGauss.kt 中的 STATS_STAGE_NAMES 顺序一致）
+ */
+enum TraceStage {
+    TRACE_STAGE_TOTAL = 0,     // 整次调用
+    TRACE_STAGE_ALLOC,         // 临时缓冲取用
+    TRACE_STAGE_CONVERT,       // 像素 → 工作格式（uint8 → float / sRGB → Linear / 降采样）
+    TRACE_STAGE_HORIZONTAL,    // 横向 pass
+    TRACE_STAGE_VERTICAL,      // 纵向 pass
+    TRACE_STAGE_PACK,          // 工作格式 → 像素（float → uint8 / 上采样）
+    TRACE_STAGE_SETUP,         // 查找表 / 法线表准备
+    TRACE_STAGE_SAMPLE,        // 逐像素采样（色差 / 色散）
+    TRACE_STAGE_COUNT
+};
+
+/**
+ * 单个 (滤波器, 阶段) 的统计快照
+ */
+struct PerfStageStats {
+    int filter;
+    int stage;
+    uint64_t count;
+    uint64_t totalNs;
+    uint64_t maxNs;
+    uint64_t p50Ns;     // 最近样本中位数（环形缓冲内无样本时为 0）
+    uint64_t p99Ns;     // 最近样本 p99
+};
+
+/**
+ * 单调时钟（纳秒）
+ */
+uint64_t perf_trace_now_ns();
+
+/**
+ * 是否收集统计（默认开启）
+ */
+bool perf_trace_enabled();
+
+/**
+ * 开启 / 关闭统计收集（ATrace 区段只由系统抓取开关控制）
+ */
+void perf_trace_set_enabled(bool enabled);
+
+/**
+ * 记录一次阶段耗时
+ */
+void perf_trace_record(int filter, int stage, uint64_t ns);
+
+/**
+ * 清空所有计数与环形缓冲
+ */
+void perf_trace_reset();
+
+/**
+ * 读取统计快照（只输出 count > 0 的条目）
+ *
+ * @param out 输出数组
+ * @param maxEntries out 容量（最多 TRACE_FILTER_COUNT × TRACE_STAGE_COUNT）
+ * @return 写入的条目数
+ */
+int perf_trace_snapshot(PerfStageStats* out, int maxEntries);
+
+/**
+ * ATrace 区段（系统未在抓取时为空操作）
+ */
+void perf_trace_begin_section(int filter, int stage);
+void perf_trace_end_section();
+bool perf_trace_atrace_enabled();
+
+/**
+ * 阶段作用域（RAII）：构造时开始 ATrace 区段并计时，析构时（或 stop()）结束并记录
+ */
+class TraceScope {
+public:
+    TraceScope(int filter, int stage)
+        : filter_(filter), stage_(stage),
+          atrace_(perf_trace_atrace_enabled()),
+          start_(perf_trace_enabled() ? perf_trace_now_ns() : 0) {
+        if (atrace_) perf_trace_begin_section(filter, stage);
+    }
+
+    ~TraceScope() { stop(); }
+
+    /**
+     * 提前结束（用于作用域内还需继续使用的资源，如临时缓冲取用）；重复调用无效
+     */
+    void stop() {
+        if (start_ != 0) perf_trace_record(filter_, stage_, perf_trace_now_ns() - start_);
+        if (atrace_) perf_trace_end_section();
+        start_ = 0;
+        atrace_ = false;
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    int filter_;
+    int stage_;
+    bool atrace_;
+    uint64_t start_;
+};
+
+/**
+ * 分段计时器：在并行块内部累计 convert / pack 等子阶段耗时
+ *
+ * 未启用统计时 lap() 恒为 0，不读时钟
+ */
+class StageTimer {
+public:
+    StageTimer() : enabled_(perf_trace_enabled()), last_(enabled_ ? perf_trace_now_ns() : 0) {}
+
+    bool enabled() const { return enabled_; }
+
+    /**
+     * 返回距上次打点的纳秒数，并重新打点
+     */
+    uint64_t lap() {
+        if (!enabled_) return 0;
+        const uint64_t now = perf_trace_now_ns();
+        const uint64_t elapsed = now - last_;
+        last_ = now;
+        return elapsed;
+    }
+
+private:
+    bool enabled_;
+    uint64_t last_;
+};
+
+/**
+ * 一次调用内各线程累计的 convert / pack 耗时（调用结束时各记录一次）
+ */
+struct TraceSubStages {
+    std::atomic<uint64_t> convertNs{0};
+    std::atomic<uint64_t> packNs{0};
+
+    void add(uint64_t convert, uint64_t pack) {
+        if (convert) convertNs.fetch_add(convert, std::memory_order_relaxed);
+        if (pack) packNs.fetch_add(pack, std::memory_order_relaxed);
+    }
+
+    void record(int filter) const {
+        const uint64_t convert = convertNs.load(std::memory_order_relaxed);
+        const uint64_t pack = packNs.load(std::memory_order_relaxed);
+        if (convert) perf_trace_record(filter, TRACE_STAGE_CONVERT, convert);
+        if (pack) perf_trace_record(filter, TRACE_STAGE_PACK, pack);
+    }
+};
+
+#endif // PERF_TRACE_H
@@ -0,0 +1,51 @@
+/**
+ * pixel_layout.h - 像素通道顺序（编译期布局策略）
+ *
+ * 背景：
+ * - ANDROID_BITMAP_FORMAT_RGBA_8888 在内存中按字节 R, G, B, A 排列（预乘 Alpha）；
+ *   Java 层 getPixel() 返回的 ARGB int 只是小端机器上同一块内存的另一种读法
+ * - 早期代码按 "BGRA" 注释，通道下标在各滤波器内手工换算，色差 / 色散的红蓝偏移因此对调
+ *
+ * 用法：
+ * - 内核以布局类型为模板参数，通道下标为编译期常量（零运行期开销）
+ *   template <typename Layout> void kernel(...) { px[Layout::R] ...; px[Layout::A] ...; }
+ * - 需要按通道序号循环时使用 Layout::channel(i)（i = 0 / 1 / 2 对应 R / G / B）
+ * - Android Bitmap 使用 BitmapLayout；BGRA 仅供其他来源（如 AHardwareBuffer / 相机）复用内核
+ */
+
+#ifndef PIXEL_LAYOUT_H
+#define PIXEL_LAYOUT_H
+
+/**
+ * RGBA 字节顺序（Android ARGB_8888 Bitmap 的内存布局）
+ */
+struct LayoutRGBA {
+    static constexpr int R = 0;
+    static constexpr int G = 1;
+    static constexpr int B = 2;
+    static constexpr int A = 3;
+
+    /**
+     * 颜色通道 i（0 = R, 1 = G, 2 = B）的字节下标
+     */
+    static constexpr int channel(int i) { return i == 0 ? R : (i == 1 ? G : B); }
+};
+
+/**
+ * BGRA 字节顺序
+ */
+struct LayoutBGRA {
+    static constexpr int R = 2;
+    static constexpr int G = 1;
+    static constexpr int B = 0;
+    static constexpr int A = 3;
+
+    static constexpr int channel(int i) { return i == 0 ? R : (i == 1 ? G : B); }
+};
+
+/**
+ * Android Bitmap（ARGB_8888）的布局
+ */
+using BitmapLayout = LayoutRGBA;
+
+#endif // PIXEL_LAYOUT_H
@@ -0,0 +1,336 @@
+/**
+ * pyramid_blur.cpp - 多级降采样金字塔模糊实现
+ *
+ * 实现细节：
+ * - 层级尺寸：w[k+1] = (w[k] + 1) / 2，所有层级（不含原图）放在一块临时缓冲中
+ * - 降采样：输出行 j 读取源行 2j-1 .. 2j+2（钳位），纵向权重 1:3:3:1 合并到 uint16 行缓冲，
+ *   行缓冲左右各补一个复制像素，横向无需钳位分支；总和最大 64 × 255，uint16 不溢出
+ * - 上采样：输出行 y 读取源行 y/2 及其上 / 下邻行，纵向 3:1 合并，横向 3:1 生成偶 / 奇两个像素
+ * - 上采样直接覆盖上一级的降采样结果（该级已不再需要），最后一级写回原图
+ */
+
+#include "pyramid_blur.h"
+#include "gauss_iir.h"
+#include "gauss_iir_neon.h"
+#include "gauss_iir_fp16.h"
+#include "perf_trace.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <android/log.h>
+
+// NEON intrinsics
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PYRAMID_NEON 1
+#else
+#define PYRAMID_NEON 0
+#endif
+
+#define LOG_TAG "PyramidBlur"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// 最多层数（2^8 = 256 倍降采样已远超实际需要）
+static const int kMaxLevels = 8;
+
+// 最小一级的宽高下限
+static const int kMinLevelSize = 8;
+
+// 最小一级剩余 IIR 的 σ 下限（更小时 Deriche 近似变差，且该级不再值得继续降采样）
+static const float kMinResidualSigma = 1.5f;
+
+// 每层（降采样 + 上采样）在该层源像素单位下引入的方差
+// （按阶跃响应拟合到 gauss_iir 的实际核宽，使同一 σ 下两者的模糊程度一致）
+static const float kLevelVariance = 1.10f;
+
+/**
+ * 金字塔层级（k = 0 为原图）
+ */
+struct PyramidLevel {
+    uint8_t* pixels;
+    int width;
+    int height;
+    int stride;
+};
+
+int pyramid_blur_levels(int w, int h, float sigma) {
+    int levels = 0;
+    int lw = w;
+    int lh = h;
+    while (levels < kMaxLevels) {
+        const int nw = (lw + 1) / 2;
+        const int nh = (lh + 1) / 2;
+        const float residual = sigma / static_cast<float>(1 << (levels + 1));
+        if (nw < kMinLevelSize || nh < kMinLevelSize || residual < kMinResidualSigma) break;
+        lw = nw;
+        lh = nh;
+        ++levels;
+    }
+    return levels;
+}
+
+/**
+ * 金字塔自身的等效方差（原图像素²）：第 k 层贡献 kLevelVariance × 4^k
+ */
+static float pyramid_variance(int levels) {
+    float variance = 0.0f;
+    float scale = 1.0f;
+    for (int k = 0; k < levels; ++k) {
+        variance += kLevelVariance * scale;
+        scale *= 4.0f;
+    }
+    return variance;
+}
+
+// ============================================================================
+// 降采样：[1 3 3 1] ⊗ [1 3 3 1] / 64
+// ============================================================================
+
+/**
+ * 纵向合并 4 行：out = r0 + 3 × (r1 + r2) + r3（uint16，每像素 4 通道）
+ */
+static void down_combine_rows(
+    const uint8_t* r0, const uint8_t* r1, const uint8_t* r2, const uint8_t* r3,
+    uint16_t* out, int width
+) {
+    const int bytes = width * 4;
+    int i = 0;
+#if PYRAMID_NEON
+    for (; i + 16 <= bytes; i += 16) {
+        const uint8x16_t a = vld1q_u8(r0 + i);
+        const uint8x16_t b = vld1q_u8(r1 + i);
+        const uint8x16_t c = vld1q_u8(r2 + i);
+        const uint8x16_t d = vld1q_u8(r3 + i);
+        uint16x8_t lo = vaddl_u8(vget_low_u8(a), vget_low_u8(d));
+        uint16x8_t hi = vaddl_u8(vget_high_u8(a), vget_high_u8(d));
+        lo = vmlaq_n_u16(lo, vaddl_u8(vget_low_u8(b), vget_low_u8(c)), 3);
+        hi = vmlaq_n_u16(hi, vaddl_u8(vget_high_u8(b), vget_high_u8(c)), 3);
+        vst1q_u16(out + i, lo);
+        vst1q_u16(out + i + 8, hi);
+    }
+#endif
+    for (; i < bytes; ++i) {
+        out[i] = static_cast<uint16_t>(r0[i] + 3 * (r1[i] + r2[i]) + r3[i]);
+    }
+}
+
+/**
+ * 横向 2× 抽取：dst[x] = (c[2x-1] + 3 × (c[2x] + c[2x+1]) + c[2x+2] + 32) / 64
+ *
+ * @param c 纵向合并后的行缓冲（c[-1]、c[srcWidth]、c[srcWidth+1] 已补为边界像素）
+ */
+static void down_decimate_row(const uint16_t* c, uint8_t* dst, int dstWidth) {
+    int x = 0;
+#if PYRAMID_NEON
+    // 每次输出 2 个像素：L0 = c[2x-1..2x], L1 = c[2x+1..2x+2], L2 = c[2x+3..2x+4]
+    for (; x + 2 <= dstWidth; x += 2) {
+        const uint16x8_t l0 = vld1q_u16(c + (2 * x - 1) * 4);
+        const uint16x8_t l1 = vld1q_u16(c + (2 * x + 1) * 4);
+        const uint16x8_t l2 = vld1q_u16(c + (2 * x + 3) * 4);
+        const uint16x8_t outer = vaddq_u16(vcombine_u16(vget_low_u16(l0), vget_low_u16(l1)),
+                                           vcombine_u16(vget_high_u16(l1), vget_high_u16(l2)));
+        const uint16x8_t inner = vaddq_u16(vcombine_u16(vget_high_u16(l0), vget_high_u16(l1)),
+                                           vcombine_u16(vget_low_u16(l1), vget_low_u16(l2)));
+        vst1_u8(dst + x * 4, vrshrn_n_u16(vmlaq_n_u16(outer, inner, 3), 6));
+    }
+#endif
+    for (; x < dstWidth; ++x) {
+        const uint16_t* p = c + (2 * x - 1) * 4;
+        for (int ch = 0; ch < 4; ++ch) {
+            const uint32_t sum = p[ch] + 3u * (p[4 + ch] + p[8 + ch]) + p[12 + ch];
+            dst[x * 4 + ch] = static_cast<uint8_t>((sum + 32u) >> 6);
+        }
+    }
+}
+
+/**
+ * 降采样一级（src → dst，dst 尺寸为 src 的一半向上取整）
+ *
+ * @param rowBuffers 每个线程一段行缓冲（rowPitch 个 uint16）
+ */
+static void downsample_level(const PyramidLevel& src, const PyramidLevel& dst, uint16_t* rowBuffers, int rowPitch) {
+    parallel_for(0, dst.height, parallel_rows_grain(src.width * 2), [&](int rowBegin, int rowEnd, int slot) {
+        // 左侧补 1 个像素，右侧补 2 个像素
+        uint16_t* c = rowBuffers + static_cast<size_t>(slot) * rowPitch + 4;
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            const uint8_t* rows[4];
+            for (int k = 0; k < 4; ++k) {
+                const int sy = std::max(0, std::min(src.height - 1, 2 * y - 1 + k));
+                rows[k] = src.pixels + static_cast<size_t>(sy) * src.stride;
+            }
+            down_combine_rows(rows[0], rows[1], rows[2], rows[3], c, src.width);
+
+            memcpy(c - 4, c, 4 * sizeof(uint16_t));
+            memcpy(c + src.width * 4, c + (src.width - 1) * 4, 4 * sizeof(uint16_t));
+            memcpy(c + (src.width + 1) * 4, c + (src.width - 1) * 4, 4 * sizeof(uint16_t));
+
+            down_decimate_row(c, dst.pixels + static_cast<size_t>(y) * dst.stride, dst.width);
+        }
+    });
+}
+
+// ============================================================================
+// 上采样：双线性 2×，权重 [1 3] / 4
+// ============================================================================
+
+/**
+ * 纵向合并 2 行：out = 3 × near + far
+ */
+static void up_combine_rows(const uint8_t* nearRow, const uint8_t* farRow, uint16_t* out, int width) {
+    const int bytes = width * 4;
+    int i = 0;
+#if PYRAMID_NEON
+    for (; i + 16 <= bytes; i += 16) {
+        const uint8x16_t n = vld1q_u8(nearRow + i);
+        const uint8x16_t f = vld1q_u8(farRow + i);
+        vst1q_u16(out + i, vmlaq_n_u16(vmovl_u8(vget_low_u8(f)), vmovl_u8(vget_low_u8(n)), 3));
+        vst1q_u16(out + i + 8, vmlaq_n_u16(vmovl_u8(vget_high_u8(f)), vmovl_u8(vget_high_u8(n)), 3));
+    }
+#endif
+    for (; i < bytes; ++i) {
+        out[i] = static_cast<uint16_t>(3 * nearRow[i] + farRow[i]);
+    }
+}
+
+/**
+ * 横向 2× 插值：dst[2x] = (3v[x] + v[x-1] + 8) / 16，dst[2x+1] = (3v[x] + v[x+1] + 8) / 16
+ *
+ * @param v 纵向合并后的行缓冲（v[-1]、v[srcWidth] 已补为边界像素）
+ */
+static void up_expand_row(const uint16_t* v, uint8_t* dst, int dstWidth) {
+    int x = 0;
+#if PYRAMID_NEON
+    // 每个源像素输出 2 个像素：X = v[x-1..x], Y = v[x..x+1]
+    for (; 2 * x + 2 <= dstWidth; ++x) {
+        const uint16x8_t a = vld1q_u16(v + (x - 1) * 4);
+        const uint16x8_t b = vld1q_u16(v + x * 4);
+        const uint16x8_t edge = vcombine_u16(vget_low_u16(a), vget_high_u16(b));
+        const uint16x8_t center = vcombine_u16(vget_high_u16(a), vget_low_u16(b));
+        vst1_u8(dst + 2 * x * 4, vrshrn_n_u16(vmlaq_n_u16(edge, center, 3), 4));
+    }
+#endif
+    for (; 2 * x < dstWidth; ++x) {
+        const uint16_t* p = v + x * 4;
+        for (int ch = 0; ch < 4; ++ch) {
+            dst[2 * x * 4 + ch] = static_cast<uint8_t>((3u * p[ch] + p[ch - 4] + 8u) >> 4);
+            if (2 * x + 1 < dstWidth) {
+                dst[(2 * x + 1) * 4 + ch] = static_cast<uint8_t>((3u * p[ch] + p[ch + 4] + 8u) >> 4);
+            }
+        }
+    }
+}
+
+/**
+ * 上采样一级（src → dst，src 尺寸为 dst 的一半向上取整）
+ */
+static void upsample_level(const PyramidLevel& src, const PyramidLevel& dst, uint16_t* rowBuffers, int rowPitch) {
+    parallel_for(0, dst.height, parallel_rows_grain(dst.width), [&](int rowBegin, int rowEnd, int slot) {
+        uint16_t* v = rowBuffers + static_cast<size_t>(slot) * rowPitch + 4;
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            // 输出行 y 位于源行 (y - 0.5) / 2：偶数行偏向上一行，奇数行偏向下一行
+            const int sy = y >> 1;
+            const int fy = (y & 1) ? std::min(src.height - 1, sy + 1) : std::max(0, sy - 1);
+            up_combine_rows(src.pixels + static_cast<size_t>(sy) * src.stride,
+                            src.pixels + static_cast<size_t>(fy) * src.stride, v, src.width);
+
+            memcpy(v - 4, v, 4 * sizeof(uint16_t));
+            memcpy(v + src.width * 4, v + (src.width - 1) * 4, 4 * sizeof(uint16_t));
+
+            up_expand_row(v, dst.pixels + static_cast<size_t>(y) * dst.stride, dst.width);
+        }
+    });
+}
+
+/**
+ * 剩余模糊（非线性模式 IIR，优先 FP16 / NEON）
+ */
+static void residual_blur(uint8_t* base, int w, int h, int stride, float sigma) {
+    if (sigma <= 0.1f) return;
+    if (has_fp16_support()) {
+        gaussian_iir_rgba8888_fp16(base, w, h, stride, sigma);
+    } else if (has_neon_support()) {
+        gaussian_iir_rgba8888_neon(base, w, h, stride, sigma, false);
+    } else {
+        gaussian_iir_rgba8888_inplace(base, w, h, stride, sigma, false);
+    }
+}
+
+void pyramid_blur_rgba8888_inplace(
+    uint8_t* base,
+    int w,
+    int h,
+    int stride,
+    float sigma
+) {
+    // 参数校验
+    if (!base || w <= 0 || h <= 0 || stride < w * 4) {
+        LOGE("Invalid parameters: base=%p, w=%d, h=%d, stride=%d", base, w, h, stride);
+        return;
+    }
+
+    if (sigma <= 0.1f) {
+        return;
+    }
+
+    const int levels = pyramid_blur_levels(w, h, sigma);
+    if (levels == 0) {
+        residual_blur(base, w, h, stride, sigma);
+        return;
+    }
+
+    TraceScope total(TRACE_FILTER_PYRAMID, TRACE_STAGE_TOTAL);
+
+    // 层级布局（k = 0 为原图）
+    PyramidLevel pyramid[kMaxLevels + 1];
+    pyramid[0] = { base, w, h, stride };
+    size_t levelBytes = 0;
+    for (int k = 1; k <= levels; ++k) {
+        pyramid[k].width = (pyramid[k - 1].width + 1) / 2;
+        pyramid[k].height = (pyramid[k - 1].height + 1) / 2;
+        pyramid[k].stride = pyramid[k].width * 4;
+        levelBytes += static_cast<size_t>(pyramid[k].stride) * pyramid[k].height;
+    }
+
+    // 每个线程一段行缓冲：原图宽度 + 左 1 / 右 2 个补边像素
+    const int rowPitch = (w + 3) * 4;
+    const int threads = thread_pool_concurrency();
+    TraceScope allocScope(TRACE_FILTER_PYRAMID, TRACE_STAGE_ALLOC);
+    ScratchBuffer levelBuf(levelBytes);
+    ScratchBuffer rowBuf(static_cast<size_t>(rowPitch) * threads * sizeof(uint16_t));
+    allocScope.stop();
+    if (!levelBuf || !rowBuf) {
+        LOGE("Failed to allocate pyramid buffers: %dx%d, levels=%d", w, h, levels);
+        return;
+    }
+
+    uint8_t* cursor = levelBuf.as<uint8_t>();
+    for (int k = 1; k <= levels; ++k) {
+        pyramid[k].pixels = cursor;
+        cursor += static_cast<size_t>(pyramid[k].stride) * pyramid[k].height;
+    }
+    uint16_t* rows = rowBuf.as<uint16_t>();
+
+    // 1. 逐级降采样
+    TraceScope down(TRACE_FILTER_PYRAMID, TRACE_STAGE_CONVERT);
+    for (int k = 0; k < levels; ++k) {
+        downsample_level(pyramid[k], pyramid[k + 1], rows, rowPitch);
+    }
+    down.stop();
+
+    // 2. 最小一级补足剩余模糊
+    const float residualVariance = sigma * sigma - pyramid_variance(levels);
+    if (residualVariance > 0.0f) {
+        const PyramidLevel& top = pyramid[levels];
+        residual_blur(top.pixels, top.width, top.height, top.stride,
+                      std::sqrt(residualVariance) / static_cast<float>(1 << levels));
+    }
+
+    // 3. 逐级上采样回原图
+    TraceScope up(TRACE_FILTER_PYRAMID, TRACE_STAGE_PACK);
+    for (int k = levels; k > 0; --k) {
+        upsample_level(pyramid[k], pyramid[k - 1], rows, rowPitch);
+    }
+}
@@ -0,0 +1,297 @@
+/**
+ * render_queue.cpp - 玻璃效果异步渲染队列实现
+ *
+ * 实现细节：
+ * - 输入、输出各一个三缓冲邮箱：latest 原子变量保存“已发布槽下标 | 新数据标记”，
+ *   生产者写完自己的槽后与之交换，消费者有新数据时把自己的槽与之交换（单生产者 / 单消费者）
+ * - 生产者交换出的旧值带新数据标记，说明消费者还没取走上一次发布 → 被覆盖（合并 / 丢帧）
+ * - 调度线程在 POSIX 信号量上休眠：sem_post 不加锁、不阻塞，适合 UI 线程调用；
+ *   多次提交只对应一次渲染时，多余的唤醒检查到没有新请求后继续休眠
+ * - 槽内缓冲为紧凑排列（stride = width × 4），尺寸不变时跨帧复用，不重新分配
+ */
+
+#include "render_queue.h"
+#include "perf_trace.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include <pthread.h>
+#include <semaphore.h>
+#include <android/log.h>
+
+#define LOG_TAG "RenderQueue"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+/**
+ * 三缓冲邮箱的槽下标交换（单生产者 / 单消费者，无锁）
+ *
+ * 三个槽始终分别属于生产者、邮箱（已发布）与消费者，任一方都不会等待另一方
+ */
+class TripleBufferIndex {
+public:
+    int write_index() const { return write_; }
+    int read_index() const { return read_; }
+
+    /**
+     * 发布生产者的槽，换回一个空闲槽
+     *
+     * @return true 表示覆盖了消费者尚未取走的上一次发布
+     */
+    bool publish() {
+        const uint32_t prev = latest_.exchange(static_cast<uint32_t>(write_) | kFresh, std::memory_order_acq_rel);
+        write_ = static_cast<int>(prev & kIndexMask);
+        return (prev & kFresh) != 0;
+    }
+
+    /**
+     * 消费者取最新发布的槽
+     *
+     * @return false 表示自上次取用后没有新发布，读槽保持不变
+     */
+    bool acquire() {
+        if ((latest_.load(std::memory_order_acquire) & kFresh) == 0) return false;
+        const uint32_t prev = latest_.exchange(static_cast<uint32_t>(read_), std::memory_order_acq_rel);
+        read_ = static_cast<int>(prev & kIndexMask);
+        return true;
+    }
+
+private:
+    static const uint32_t kIndexMask = 3;
+    static const uint32_t kFresh = 4;
+
+    int write_ = 0;                      // 仅生产者访问
+    std::atomic<uint32_t> latest_{1};
+    int read_ = 2;                       // 仅消费者访问
+};
+
+/**
+ * 输入槽：一次渲染请求的完整快照
+ */
+struct RenderInputSlot {
+    std::vector<uint8_t> backdrop;
+    std::vector<uint8_t> displacement;
+    std::vector<uint8_t> edgeDistance;
+    std::vector<uint8_t> normalMap;
+    int width = 0;
+    int height = 0;
+    GlassPipelineParams params;      // 贴图指针指向本槽的缓冲
+    uint64_t sequence = 0;
+};
+
+/**
+ * 输出槽：一帧渲染结果
+ */
+struct RenderOutputSlot {
+    std::vector<uint8_t> pixels;
+    int width = 0;
+    int height = 0;
+    uint64_t sequence = 0;
+};
+
+struct RenderQueue {
+    RenderInputSlot inputs[3];
+    RenderOutputSlot outputs[3];
+    TripleBufferIndex inputIndex;    // 生产者：UI 线程，消费者：调度线程
+    TripleBufferIndex outputIndex;   // 生产者：调度线程，消费者：UI 线程
+
+    sem_t wake;
+    pthread_t thread;
+    std::atomic<bool> stopping{false};
+
+    uint64_t nextSequence = 1;       // 仅 UI 线程访问
+
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> coalesced{0};
+    std::atomic<uint64_t> rendered{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> presented{0};
+    std::atomic<uint64_t> lastRenderNs{0};
+};
+
+/**
+ * 把一张贴图紧凑复制进槽缓冲；src 为空时清空缓冲并返回 nullptr
+ */
+static const uint8_t* copy_plane(std::vector<uint8_t>& dst, const uint8_t* src, int stride, int width, int height) {
+    if (src == nullptr) {
+        dst.clear();
+        return nullptr;
+    }
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    dst.resize(rowBytes * height);
+    if (stride == static_cast<int>(rowBytes)) {
+        memcpy(dst.data(), src, rowBytes * height);
+    } else {
+        for (int y = 0; y < height; ++y) {
+            memcpy(dst.data() + rowBytes * y, src + static_cast<size_t>(stride) * y, rowBytes);
+        }
+    }
+    return dst.data();
+}
+
+/**
+ * 渲染一个输入槽到输出槽
+ */
+static void render_slot(const RenderInputSlot& in, RenderOutputSlot& out) {
+    const size_t rowBytes = static_cast<size_t>(in.width) * 4;
+    out.pixels.resize(rowBytes * in.height);
+    out.width = in.width;
+    out.height = in.height;
+    out.sequence = in.sequence;
+
+    render_glass_pipeline(
+        in.backdrop.data(), static_cast<int>(rowBytes),
+        out.pixels.data(), static_cast<int>(rowBytes),
+        in.width, in.height,
+        in.params
+    );
+}
+
+/**
+ * 调度线程：休眠等待请求，每次只渲染最新的一个
+ */
+static void* render_queue_thread(void* arg) {
+    RenderQueue* queue = static_cast<RenderQueue*>(arg);
+    pthread_setname_np(pthread_self(), "nativegauss-rq");
+
+    for (;;) {
+        while (sem_wait(&queue->wake) != 0 && errno == EINTR) {
+        }
+        if (queue->stopping.load(std::memory_order_acquire)) break;
+
+        // 多余的唤醒（请求已被之前的一次渲染合并）
+        if (!queue->inputIndex.acquire()) continue;
+
+        const RenderInputSlot& in = queue->inputs[queue->inputIndex.read_index()];
+        RenderOutputSlot& out = queue->outputs[queue->outputIndex.write_index()];
+
+        const uint64_t start = perf_trace_now_ns();
+        render_slot(in, out);
+        queue->lastRenderNs.store(perf_trace_now_ns() - start, std::memory_order_relaxed);
+        queue->rendered.fetch_add(1, std::memory_order_relaxed);
+
+        if (queue->outputIndex.publish()) {
+            queue->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    sem_destroy(&queue->wake);
+    delete queue;
+    LOGD("Render queue stopped");
+    return nullptr;
+}
+
+RenderQueue* render_queue_create() {
+    RenderQueue* queue = new RenderQueue();
+    if (sem_init(&queue->wake, 0, 0) != 0) {
+        LOGE("Failed to create render queue semaphore: errno=%d", errno);
+        delete queue;
+        return nullptr;
+    }
+
+    const int err = pthread_create(&queue->thread, nullptr, render_queue_thread, queue);
+    if (err != 0) {
+        LOGE("Failed to start render queue thread: %d", err);
+        sem_destroy(&queue->wake);
+        delete queue;
+        return nullptr;
+    }
+    pthread_detach(queue->thread);
+
+    LOGD("Render queue started");
+    return queue;
+}
+
+void render_queue_destroy(RenderQueue* queue) {
+    if (!queue) return;
+    queue->stopping.store(true, std::memory_order_release);
+    sem_post(&queue->wake);
+}
+
+uint64_t render_queue_submit(
+    RenderQueue* queue,
+    const uint8_t* backdrop,
+    int backdropStride,
+    int width,
+    int height,
+    const GlassPipelineParams& params
+) {
+    // 参数校验
+    if (!queue || !backdrop || width <= 0 || height <= 0 || backdropStride < width * 4) {
+        LOGE("Invalid parameters: queue=%p backdrop=%p %dx%d stride=%d",
+             queue, backdrop, width, height, backdropStride);
+        return 0;
+    }
+    if ((params.effect == GLASS_EFFECT_ABERRATION && !params.displacement) ||
+        (params.effect == GLASS_EFFECT_DISPERSION && !params.edgeDistance)) {
+        LOGE("Effect map is required for effect %d", params.effect);
+        return 0;
+    }
+
+    RenderInputSlot& slot = queue->inputs[queue->inputIndex.write_index()];
+    slot.width = width;
+    slot.height = height;
+    slot.sequence = queue->nextSequence++;
+    slot.params = params;
+
+    copy_plane(slot.backdrop, backdrop, backdropStride, width, height);
+
+    // 只复制当前效果需要的贴图
+    const bool aberration = params.effect == GLASS_EFFECT_ABERRATION;
+    const bool dispersion = params.effect == GLASS_EFFECT_DISPERSION;
+    slot.params.displacement = copy_plane(slot.displacement, aberration ? params.displacement : nullptr,
+                                          params.displacementStride, width, height);
+    slot.params.displacementStride = width * 4;
+    slot.params.edgeDistance = copy_plane(slot.edgeDistance, dispersion ? params.edgeDistance : nullptr,
+                                          params.edgeDistanceStride, width, height);
+    slot.params.edgeDistanceStride = width * 4;
+    slot.params.normalMap = copy_plane(slot.normalMap, dispersion ? params.normalMap : nullptr,
+                                       params.normalMapStride, width, height);
+    slot.params.normalMapStride = width * 4;
+
+    queue->submitted.fetch_add(1, std::memory_order_relaxed);
+    if (queue->inputIndex.publish()) {
+        queue->coalesced.fetch_add(1, std::memory_order_relaxed);
+    }
+    sem_post(&queue->wake);
+    return slot.sequence;
+}
+
+uint64_t render_queue_acquire(
+    RenderQueue* queue,
+    uint8_t* dst,
+    int dstStride,
+    int width,
+    int height,
+    bool* copied
+) {
+    if (copied) *copied = false;
+    if (!queue || !dst || dstStride < width * 4) return 0;
+    if (!queue->outputIndex.acquire()) return 0;
+
+    // 读槽此后归 UI 线程所有，直到下一次 acquire
+    const RenderOutputSlot& frame = queue->outputs[queue->outputIndex.read_index()];
+    if (frame.width != width || frame.height != height) {
+        LOGD("Discarding %dx%d frame for %dx%d target", frame.width, frame.height, width, height);
+        return frame.sequence;
+    }
+
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    for (int y = 0; y < height; ++y) {
+        memcpy(dst + static_cast<size_t>(dstStride) * y, frame.pixels.data() + rowBytes * y, rowBytes);
+    }
+    queue->presented.fetch_add(1, std::memory_order_relaxed);
+    if (copied) *copied = true;
+    return frame.sequence;
+}
+
+void render_queue_stats(const RenderQueue* queue, RenderQueueStats* stats) {
+    if (!queue || !stats) return;
+    stats->submitted = queue->submitted.load(std::memory_order_relaxed);
+    stats->coalesced = queue->coalesced.load(std::memory_order_relaxed);
+    stats->rendered = queue->rendered.load(std::memory_order_relaxed);
+    stats->dropped = queue->dropped.load(std::memory_order_relaxed);
+    stats->presented = queue->presented.load(std::memory_order_relaxed);
+    stats->lastRenderNs = queue->lastRenderNs.load(std::memory_order_relaxed);
+}
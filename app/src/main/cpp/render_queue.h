@@ -0,0 +1,105 @@
+/**
+ * render_queue.h - 玻璃效果异步渲染队列（最新请求优先，三缓冲输出）
+ *
+ * 背景：
+ * - AsyncRenderer 原本用一个 Kotlin 线程逐阶段回调 JNI，帧以 Bitmap 形式来回传递
+ * - 同步渲染时 onTouchEvent 触发的每次重绘都在 UI 线程跑完整条管线，参数变化越快积压越多
+ *
+ * 设计：
+ * - 提交：UI 线程把背景 / 贴图 / 参数复制进空闲输入槽，以一次原子交换发布为“最新请求”，
+ *   不加锁、不等待；渲染线程尚未取走的旧请求被直接覆盖（合并），只渲染最新的一个
+ * - 渲染：一个常驻原生调度线程取最新请求执行 render_glass_pipeline，
+ *   管线内部各阶段照常通过 parallel_for 分发到共享线程池（调度线程作为 0 号线程参与）
+ * - 输出：三缓冲（渲染线程写 1 个、已发布 1 个、UI 持有 1 个），UI 线程随时取最新完成帧，
+ *   渲染线程永远有空闲槽可写，双方都不会等待对方
+ *
+ * 为什么不直接把渲染投递为线程池任务：
+ * - 线程池内嵌套 parallel_for 会降级为串行，整条管线只能单线程执行
+ *
+ * 线程安全：
+ * - render_queue_submit / render_queue_acquire 须来自同一个线程（通常为 UI 线程）
+ * - render_queue_destroy 不等待进行中的渲染：调度线程完成当前帧后自行释放队列
+ */
+
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstdint>
+#include "glass_pipeline.h"
+
+struct RenderQueue;
+
+/**
+ * 队列统计（自创建起累计）
+ */
+struct RenderQueueStats {
+    uint64_t submitted;     // 提交的请求数
+    uint64_t coalesced;     // 渲染前被更新请求覆盖的请求数
+    uint64_t rendered;      // 完成渲染的帧数
+    uint64_t dropped;       // 渲染完成但被更新帧覆盖、从未被取走的帧数
+    uint64_t presented;     // 被 UI 取走的帧数
+    uint64_t lastRenderNs;  // 最近一帧的渲染耗时（纳秒）
+};
+
+/**
+ * 创建渲染队列并启动调度线程
+ *
+ * @return 队列句柄；线程创建失败时返回 nullptr
+ */
+RenderQueue* render_queue_create();
+
+/**
+ * 停止并释放渲染队列（不阻塞）
+ *
+ * 调用后不得再使用句柄；进行中的渲染完成后由调度线程释放全部缓冲
+ */
+void render_queue_destroy(RenderQueue* queue);
+
+/**
+ * 提交渲染请求（复制输入，立即返回）
+ *
+ * @param queue 队列句柄
+ * @param backdrop 背景像素（RGBA8888）
+ * @param backdropStride 背景行跨度（字节数）
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param params 管线参数；其中的贴图指针（与背景尺寸相同）在本调用内被复制，返回后即可释放
+ * @return 请求序号（从 1 递增）；参数无效时返回 0
+ */
+uint64_t render_queue_submit(
+    RenderQueue* queue,
+    const uint8_t* backdrop,
+    int backdropStride,
+    int width,
+    int height,
+    const GlassPipelineParams& params
+);
+
+/**
+ * 取最新完成帧（不阻塞）
+ *
+ * 有新帧时取走并复制到 dst（尺寸不一致时丢弃该帧、不复制）；没有新帧时什么也不做
+ *
+ * @param queue 队列句柄
+ * @param dst 目标像素（RGBA8888）
+ * @param dstStride 目标行跨度（字节数）
+ * @param width 目标宽度
+ * @param height 目标高度
+ * @param copied 输出：是否已复制到 dst（可为 nullptr）
+ * @return 取走帧对应的请求序号；没有新帧时返回 0
+ */
+uint64_t render_queue_acquire(
+    RenderQueue* queue,
+    uint8_t* dst,
+    int dstStride,
+    int width,
+    int height,
+    bool* copied
+);
+
+/**
+ * 读取队列统计
+ */
+void render_queue_stats(const RenderQueue* queue, RenderQueueStats* stats);
+
+#endif // RENDER_QUEUE_H
@@ -0,0 +1,195 @@
+/**
+ * resampler.cpp - 定点双线性缩放实现
+ *
+ * 实现细节：
+ * - 查找表：每列两个源像素字节偏移 + 按 4 通道展开的权重，每行两个源行号 + 权重
+ * - 权重四舍五入到 1/256；取整为 256 时改为下一像素、权重 0，保证权重可用 uint8 表示
+ * - (a << 8) + (b - a) × w 在 uint16 上按模运算，最终结果 a × (256 - w) + b × w ≤ 65280，不会溢出
+ */
+
+#include "resampler.h"
+#include "perf_trace.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <android/log.h>
+
+// NEON intrinsics
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RESAMPLER_NEON 1
+#else
+#define RESAMPLER_NEON 0
+#endif
+
+#define LOG_TAG "Resampler"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+/**
+ * 计算一个方向的源索引与权重
+ *
+ * @param first 输出：较近的源索引
+ * @param second 输出：较远的源索引（钳位到 srcSize - 1）
+ * @param weights 输出：second 的权重（0-255），每个索引重复 repeat 次
+ */
+static void build_axis(int srcSize, int dstSize, int* first, int* second, uint8_t* weights, int repeat) {
+    const float scale = static_cast<float>(srcSize) / dstSize;
+    for (int i = 0; i < dstSize; ++i) {
+        float pos = (i + 0.5f) * scale - 0.5f;
+        pos = std::max(0.0f, std::min(pos, srcSize - 1.0f));
+
+        int i0 = static_cast<int>(pos);
+        int w = static_cast<int>((pos - i0) * 256.0f + 0.5f);
+        if (w >= 256) {
+            ++i0;
+            w = 0;
+        }
+
+        first[i] = i0;
+        second[i] = std::min(i0 + 1, srcSize - 1);
+        memset(weights + i * repeat, w, repeat);
+    }
+}
+
+/**
+ * 纵向混合两行：out = (r0 × (256 - w) + r1 × w + 128) >> 8
+ */
+static void blend_rows(const uint8_t* r0, const uint8_t* r1, uint8_t* out, int bytes, uint8_t w) {
+    int i = 0;
+#if RESAMPLER_NEON
+    const uint8x8_t vw = vdup_n_u8(w);
+    for (; i + 16 <= bytes; i += 16) {
+        const uint8x16_t a = vld1q_u8(r0 + i);
+        const uint8x16_t b = vld1q_u8(r1 + i);
+        uint16x8_t lo = vshll_n_u8(vget_low_u8(a), 8);
+        uint16x8_t hi = vshll_n_u8(vget_high_u8(a), 8);
+        lo = vmlsl_u8(vmlal_u8(lo, vget_low_u8(b), vw), vget_low_u8(a), vw);
+        hi = vmlsl_u8(vmlal_u8(hi, vget_high_u8(b), vw), vget_high_u8(a), vw);
+        vst1q_u8(out + i, vcombine_u8(vrshrn_n_u16(lo, 8), vrshrn_n_u16(hi, 8)));
+    }
+#endif
+    for (; i < bytes; ++i) {
+        out[i] = static_cast<uint8_t>((r0[i] * (256 - w) + r1[i] * w + 128) >> 8);
+    }
+}
+
+/**
+ * 横向按列表插值一行
+ *
+ * @param offsets0 较近源像素的字节偏移
+ * @param offsets1 较远源像素的字节偏移
+ * @param weights 按 4 通道展开的权重
+ */
+static void interpolate_row(
+    const uint8_t* row, uint8_t* out, int dstWidth,
+    const int* offsets0, const int* offsets1, const uint8_t* weights
+) {
+    int x = 0;
+#if RESAMPLER_NEON
+    for (; x + 4 <= dstWidth; x += 4) {
+        uint8_t p0[16];
+        uint8_t p1[16];
+        for (int k = 0; k < 4; ++k) {
+            memcpy(p0 + k * 4, row + offsets0[x + k], 4);
+            memcpy(p1 + k * 4, row + offsets1[x + k], 4);
+        }
+        const uint8x16_t a = vld1q_u8(p0);
+        const uint8x16_t b = vld1q_u8(p1);
+        const uint8x16_t w = vld1q_u8(weights + x * 4);
+        uint16x8_t lo = vshll_n_u8(vget_low_u8(a), 8);
+        uint16x8_t hi = vshll_n_u8(vget_high_u8(a), 8);
+        lo = vmlsl_u8(vmlal_u8(lo, vget_low_u8(b), vget_low_u8(w)), vget_low_u8(a), vget_low_u8(w));
+        hi = vmlsl_u8(vmlal_u8(hi, vget_high_u8(b), vget_high_u8(w)), vget_high_u8(a), vget_high_u8(w));
+        vst1q_u8(out + x * 4, vcombine_u8(vrshrn_n_u16(lo, 8), vrshrn_n_u16(hi, 8)));
+    }
+#endif
+    for (; x < dstWidth; ++x) {
+        const uint8_t* a = row + offsets0[x];
+        const uint8_t* b = row + offsets1[x];
+        const int w = weights[x * 4];
+        for (int c = 0; c < 4; ++c) {
+            out[x * 4 + c] = static_cast<uint8_t>((a[c] * (256 - w) + b[c] * w + 128) >> 8);
+        }
+    }
+}
+
+void resize_bilinear_rgba8888(
+    const uint8_t* src,
+    int srcWidth,
+    int srcHeight,
+    int srcStride,
+    uint8_t* dst,
+    int dstWidth,
+    int dstHeight,
+    int dstStride
+) {
+    // 参数校验
+    if (!src || !dst || srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 || dstHeight <= 0 ||
+        srcStride < srcWidth * 4 || dstStride < dstWidth * 4) {
+        LOGE("Invalid parameters: src=%p %dx%d stride=%d, dst=%p %dx%d stride=%d",
+             src, srcWidth, srcHeight, srcStride, dst, dstWidth, dstHeight, dstStride);
+        return;
+    }
+
+    // 尺寸相同：逐行复制
+    if (srcWidth == dstWidth && srcHeight == dstHeight) {
+        parallel_for(0, dstHeight, parallel_rows_grain(dstWidth), [&](int rowBegin, int rowEnd, int) {
+            for (int y = rowBegin; y < rowEnd; ++y) {
+                memcpy(dst + static_cast<size_t>(y) * dstStride, src + static_cast<size_t>(y) * srcStride,
+                       dstWidth * 4);
+            }
+        });
+        return;
+    }
+
+    TraceScope total(TRACE_FILTER_RESAMPLE, TRACE_STAGE_TOTAL);
+
+    // 查找表：列偏移 ×2、行号 ×2（int），列权重 ×4、行权重（uint8）
+    const size_t tableInts = static_cast<size_t>(dstWidth) * 2 + static_cast<size_t>(dstHeight) * 2;
+    const size_t tableBytes = tableInts * sizeof(int) + static_cast<size_t>(dstWidth) * 4 + dstHeight;
+    const size_t rowPitch = static_cast<size_t>(srcWidth) * 4;
+    const int threads = thread_pool_concurrency();
+
+    TraceScope allocScope(TRACE_FILTER_RESAMPLE, TRACE_STAGE_ALLOC);
+    ScratchBuffer tableBuf(tableBytes);
+    ScratchBuffer rowBuf(rowPitch * threads);
+    allocScope.stop();
+    if (!tableBuf || !rowBuf) {
+        LOGE("Failed to allocate resampler buffers: %dx%d -> %dx%d", srcWidth, srcHeight, dstWidth, dstHeight);
+        return;
+    }
+
+    int* colOffsets0 = tableBuf.as<int>();
+    int* colOffsets1 = colOffsets0 + dstWidth;
+    int* rows0 = colOffsets1 + dstWidth;
+    int* rows1 = rows0 + dstHeight;
+    uint8_t* colWeights = reinterpret_cast<uint8_t*>(rows1 + dstHeight);
+    uint8_t* rowWeights = colWeights + static_cast<size_t>(dstWidth) * 4;
+
+    {
+        TraceScope scope(TRACE_FILTER_RESAMPLE, TRACE_STAGE_SETUP);
+        build_axis(srcWidth, dstWidth, colOffsets0, colOffsets1, colWeights, 4);
+        for (int x = 0; x < dstWidth; ++x) {
+            colOffsets0[x] *= 4;
+            colOffsets1[x] *= 4;
+        }
+        build_axis(srcHeight, dstHeight, rows0, rows1, rowWeights, 1);
+    }
+
+    uint8_t* rowBuffers = rowBuf.as<uint8_t>();
+    parallel_for(0, dstHeight, parallel_rows_grain(dstWidth), [&](int rowBegin, int rowEnd, int slot) {
+        uint8_t* blended = rowBuffers + rowPitch * slot;
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            const uint8_t* r0 = src + static_cast<size_t>(rows0[y]) * srcStride;
+            const uint8_t* row = r0;
+            if (rowWeights[y] != 0) {
+                blend_rows(r0, src + static_cast<size_t>(rows1[y]) * srcStride, blended, srcWidth * 4, rowWeights[y]);
+                row = blended;
+            }
+            interpolate_row(row, dst + static_cast<size_t>(y) * dstStride, dstWidth,
+                            colOffsets0, colOffsets1, colWeights);
+        }
+    });
+}
@@ -0,0 +1,55 @@
+/**
+ * resampler.h - 定点双线性缩放（RGBA8888）
+ *
+ * 背景：
+ * - boxblur.cpp 原有的 downsample_bilinear 每个像素每个通道都要重新计算浮点坐标与权重，
+ *   advanced_box_blur_rgba8888_hq 因此比最近邻版本慢数倍
+ * - Kotlin 层的色差 / 色散降采样路径依赖 Bitmap.createScaledBitmap / Canvas，每次都要经过 Skia
+ *
+ * 算法：
+ * - 坐标映射与原实现相同：src = (dst + 0.5) × scale - 0.5，钳位到 [0, size - 1]
+ * - 每列 / 每行的源索引与 8 位权重（1/256 精度）只在开始时计算一次
+ * - 可分离两步：先按行权重把两行源像素纵向混合为一行（权重为 0 时直接引用源行），
+ *   再按列表横向混合；两步均为 (a << 8) + (b - a) × w 的 8.8 定点运算
+ * - 与浮点版本相比最大误差 2 LSB（权重量化与纵向中间结果取整各约 0.5-1 LSB）
+ *
+ * 性能特性：
+ * - NEON：纵向每次 16 字节，横向每次 4 个像素（查表取像素，权重表已按通道展开）
+ * - 按输出行并行（共享线程池），查找表与行缓冲来自 scratch_arena
+ * - 预乘 Alpha：线性加权，预乘格式保持合法
+ */
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * 双线性缩放（RGBA8888 格式，放大 / 缩小均可）
+ *
+ * @param src 源像素数据（RGBA_8888）
+ * @param srcWidth 源宽度
+ * @param srcHeight 源高度
+ * @param srcStride 源行跨度（字节数）
+ * @param dst 目标像素数据（RGBA_8888，不能与 src 重叠）
+ * @param dstWidth 目标宽度
+ * @param dstHeight 目标高度
+ * @param dstStride 目标行跨度（字节数）
+ *
+ * 注意事项：
+ * - 尺寸相同时直接逐行复制
+ * - 非线程安全，不要对同一块目标内存并发调用
+ */
+void resize_bilinear_rgba8888(
+    const uint8_t* src,
+    int srcWidth,
+    int srcHeight,
+    int srcStride,
+    uint8_t* dst,
+    int dstWidth,
+    int dstHeight,
+    int dstStride
+);
+
+#endif // RESAMPLER_H
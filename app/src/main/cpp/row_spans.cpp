@@ -0,0 +1,110 @@
+/**
+ * row_spans.cpp - 逐行可见区间实现
+ *
+ * 实现细节：
+ * - 圆角行：到圆心的纵向距离 dy 取离矩形中心较近的像素边，
+ *   缩进 = r - sqrt(r² - dy²) 向下取整，保证部分覆盖的像素不被剔除
+ * - 膨胀：滑动窗口内 left 的最小值 / right 的最大值，用单调队列 O(height) 求出
+ */
+
+#include "row_spans.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+void row_spans_rounded_rect(const DamageRect& rect, float radius, int width, int height, RowSpan* spans) {
+    if (!spans || height <= 0) return;
+
+    for (int y = 0; y < height; ++y) {
+        spans[y] = RowSpan();
+    }
+    if (rect.empty() || width <= 0) return;
+
+    // 圆角按未裁剪的矩形计算（矩形超出图像时，圆角可能整个落在图像外）
+    const float halfExtent = 0.5f * static_cast<float>(std::min(rect.width(), rect.height()));
+    const float r = std::max(0.0f, std::min(radius, halfExtent));
+    const float cornerTop = static_cast<float>(rect.top) + r;
+    const float cornerBottom = static_cast<float>(rect.bottom) - r;
+
+    const int rowBegin = std::max(0, rect.top);
+    const int rowEnd = std::min(height, rect.bottom);
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        float dy = 0.0f;
+        if (static_cast<float>(y + 1) < cornerTop) {
+            dy = cornerTop - static_cast<float>(y + 1);
+        } else if (static_cast<float>(y) > cornerBottom) {
+            dy = static_cast<float>(y) - cornerBottom;
+        }
+        const int inset = static_cast<int>(r - std::sqrt(std::max(0.0f, r * r - dy * dy)));
+
+        RowSpan s;
+        s.left = std::max(0, rect.left + inset);
+        s.right = std::min(width, rect.right - inset);
+        spans[y] = s;
+    }
+}
+
+void row_spans_dilate(const RowSpan* spans, int height, int width, int margin, RowSpan* out) {
+    if (!spans || !out || height <= 0) return;
+
+    if (margin <= 0) {
+        std::copy(spans, spans + height, out);
+        return;
+    }
+
+    // 单调队列（行下标）：minQueue 中 left 递增，maxQueue 中 right 递减；每行最多入队一次
+    std::vector<int> minQueue(height);
+    std::vector<int> maxQueue(height);
+    int minHead = 0, minTail = 0;
+    int maxHead = 0, maxTail = 0;
+    int next = 0;
+
+    for (int y = 0; y < height; ++y) {
+        const int last = std::min(height - 1, y + margin);
+        for (; next <= last; ++next) {
+            if (spans[next].empty()) continue;
+            while (minTail > minHead && spans[minQueue[minTail - 1]].left >= spans[next].left) --minTail;
+            minQueue[minTail++] = next;
+            while (maxTail > maxHead && spans[maxQueue[maxTail - 1]].right <= spans[next].right) --maxTail;
+            maxQueue[maxTail++] = next;
+        }
+
+        const int first = y - margin;
+        while (minHead < minTail && minQueue[minHead] < first) ++minHead;
+        while (maxHead < maxTail && maxQueue[maxHead] < first) ++maxHead;
+
+        // 两个队列同时为空：窗口内没有非空行
+        RowSpan s;
+        if (minHead < minTail) {
+            s.left = std::max(0, spans[minQueue[minHead]].left - margin);
+            s.right = std::min(width, spans[maxQueue[maxHead]].right + margin);
+        }
+        out[y] = s;
+    }
+}
+
+DamageRect row_spans_bounds(const RowSpan* spans, int height) {
+    DamageRect bounds;
+    if (!spans) return bounds;
+
+    for (int y = 0; y < height; ++y) {
+        if (spans[y].empty()) continue;
+        DamageRect row;
+        row.left = spans[y].left;
+        row.top = y;
+        row.right = spans[y].right;
+        row.bottom = y + 1;
+        bounds = damage_rect_union(bounds, row);
+    }
+    return bounds;
+}
+
+int64_t row_spans_area(const RowSpan* spans, int height) {
+    int64_t area = 0;
+    if (!spans) return area;
+
+    for (int y = 0; y < height; ++y) {
+        area += spans[y].width();
+    }
+    return area;
+}
@@ -0,0 +1,82 @@
+/**
+ * row_spans.h - 逐行可见区间（圆角矩形遮罩）
+ *
+ * 背景：
+ * - LiquidGlassView 用圆角矩形 clipPath 裁剪输出，四角与边距内的像素最终不可见，
+ *   但各滤波器原先仍处理整张矩形位图
+ * - 圆角矩形每一行的可见部分是一个连续区间，用每行一个 [left, right) 即可精确描述，
+ *   逐像素效果按区间处理即可跳过不可见像素
+ *
+ * 约定：
+ * - spans[y] 为第 y 行的可见区间（半开区间，像素坐标），right <= left 表示整行不可见
+ * - 数组长度等于图像高度
+ * - 部分覆盖的像素（抗锯齿边缘）算作可见
+ */
+
+#ifndef ROW_SPANS_H
+#define ROW_SPANS_H
+
+#include <cstdint>
+#include <cstddef>
+#include "damage_rect.h"
+
+/**
+ * 一行的可见区间（半开区间）
+ */
+struct RowSpan {
+    int left = 0;
+    int right = 0;
+
+    bool empty() const { return right <= left; }
+    int width() const { return empty() ? 0 : right - left; }
+};
+
+/**
+ * 区间与 [left, right) 的交集
+ */
+inline RowSpan row_span_clip(const RowSpan& s, int left, int right) {
+    RowSpan c;
+    c.left = std::max(s.left, left);
+    c.right = std::min(s.right, right);
+    return c;
+}
+
+/**
+ * 生成圆角矩形的逐行可见区间
+ *
+ * 圆角半径钳位到 min(矩形宽, 矩形高) / 2（与 Canvas.drawRoundRect 相同）；
+ * 每行按离矩形中心较近的像素边计算，部分覆盖的像素也算作可见
+ *
+ * @param rect 圆角矩形（像素坐标，自动裁剪到图像范围）
+ * @param radius 圆角半径（像素，≤ 0 为普通矩形）
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param spans 输出（height 项）
+ */
+void row_spans_rounded_rect(const DamageRect& rect, float radius, int width, int height, RowSpan* spans);
+
+/**
+ * 区间膨胀：输出行 y 覆盖输入中 |dy| ≤ margin 各行区间的包围区间，再左右扩展 margin
+ *
+ * 即按 (2·margin + 1)² 方形邻域膨胀后每行的包围区间；用于求效果采样会读取的像素
+ * （圆角矩形膨胀后每行仍是连续区间，包围区间是精确结果）
+ *
+ * @param spans 输入（height 项）
+ * @param height 图像高度
+ * @param width 图像宽度（输出裁剪到 [0, width)）
+ * @param margin 膨胀半径（像素，≤ 0 时原样复制）
+ * @param out 输出（height 项，不能与 spans 重叠）
+ */
+void row_spans_dilate(const RowSpan* spans, int height, int width, int margin, RowSpan* out);
+
+/**
+ * 所有非空区间的包围矩形（全部为空时返回空矩形）
+ */
+DamageRect row_spans_bounds(const RowSpan* spans, int height);
+
+/**
+ * 可见像素总数
+ */
+int64_t row_spans_area(const RowSpan* spans, int height);
+
+#endif // ROW_SPANS_H
@@ -0,0 +1,190 @@
+/**
+ * scratch_arena.cpp - 按尺寸分级的线程本地内存池实现
+ *
+ * 实现细节：
+ * - 每级空闲链表最多缓存 kMaxCachedPerClass 块，超出的直接释放，避免池无限增长
+ * - 超过最大分级的请求不进池，直接分配/释放
+ * - 每个内存池自带互斥锁：正常路径只有所属线程访问（无竞争），
+ *   trim 时其他线程加锁清理
+ * - 线程退出时自动注销并释放其内存池
+ */
+
+#include "scratch_arena.h"
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+#include <android/log.h>
+
+#define LOG_TAG "ScratchArena"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const int kMinClassShift = 12;      // 最小分级 4 KB
+static const int kNumClasses = 18;         // 最大分级 4 KB << 17 = 512 MB
+static const int kMaxCachedPerClass = 4;   // 每级最多缓存块数
+static const size_t kAlignment = 64;       // 缓存行对齐
+
+struct ScratchArena {
+    std::mutex mutex;
+    std::vector<void*> freeLists[kNumClasses];
+    size_t cachedBytes = 0;
+};
+
+static size_t class_bytes(int sizeClass) {
+    return static_cast<size_t>(1) << (kMinClassShift + sizeClass);
+}
+
+/**
+ * 计算分级：返回能容纳 bytes 的最小级别，超出最大分级返回 -1
+ */
+static int size_class_for(size_t bytes) {
+    for (int c = 0; c < kNumClasses; ++c) {
+        if (bytes <= class_bytes(c)) return c;
+    }
+    return -1;
+}
+
+static void* aligned_alloc_bytes(size_t bytes) {
+    void* p = nullptr;
+    if (posix_memalign(&p, kAlignment, bytes) != 0) {
+        return nullptr;
+    }
+    return p;
+}
+
+/**
+ * 释放内存池中的全部空闲缓冲（调用方持有 arena->mutex）
+ */
+static size_t release_cached_locked(ScratchArena* arena) {
+    size_t released = arena->cachedBytes;
+    for (int c = 0; c < kNumClasses; ++c) {
+        for (void* p : arena->freeLists[c]) {
+            free(p);
+        }
+        arena->freeLists[c].clear();
+    }
+    arena->cachedBytes = 0;
+    return released;
+}
+
+// 全局登记表：trim 时遍历所有线程的内存池
+static std::mutex g_registryMutex;
+static std::vector<ScratchArena*>& registry() {
+    static std::vector<ScratchArena*>* arenas = new std::vector<ScratchArena*>();
+    return *arenas;
+}
+
+/**
+ * 线程本地内存池的所有者：首次使用时创建并登记，线程退出时注销并释放
+ */
+struct ArenaOwner {
+    ScratchArena* arena;
+
+    ArenaOwner() : arena(new ScratchArena()) {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        registry().push_back(arena);
+    }
+
+    ~ArenaOwner() {
+        {
+            std::lock_guard<std::mutex> lock(g_registryMutex);
+            auto& arenas = registry();
+            arenas.erase(std::remove(arenas.begin(), arenas.end(), arena), arenas.end());
+        }
+        {
+            std::lock_guard<std::mutex> lock(arena->mutex);
+            release_cached_locked(arena);
+        }
+        delete arena;
+    }
+};
+
+static ScratchArena* current_arena() {
+    static thread_local ArenaOwner owner;
+    return owner.arena;
+}
+
+ScratchBuffer::ScratchBuffer(size_t bytes)
+    : arena_(current_arena()), data_(nullptr), size_(0), sizeClass_(size_class_for(bytes)) {
+    if (bytes == 0) bytes = 1;
+
+    if (sizeClass_ < 0) {
+        // 超大请求：不进池
+        data_ = aligned_alloc_bytes(bytes);
+        size_ = data_ ? bytes : 0;
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(arena_->mutex);
+            auto& list = arena_->freeLists[sizeClass_];
+            if (!list.empty()) {
+                data_ = list.back();
+                list.pop_back();
+                arena_->cachedBytes -= class_bytes(sizeClass_);
+            }
+        }
+        if (!data_) {
+            data_ = aligned_alloc_bytes(class_bytes(sizeClass_));
+        }
+        size_ = data_ ? class_bytes(sizeClass_) : 0;
+    }
+
+    if (!data_) {
+        LOGE("Scratch allocation failed: %zu bytes", bytes);
+    }
+}
+
+ScratchBuffer::~ScratchBuffer() {
+    if (!data_) return;
+
+    if (sizeClass_ >= 0) {
+        std::lock_guard<std::mutex> lock(arena_->mutex);
+        auto& list = arena_->freeLists[sizeClass_];
+        if (static_cast<int>(list.size()) < kMaxCachedPerClass) {
+            list.push_back(data_);
+            arena_->cachedBytes += class_bytes(sizeClass_);
+            return;
+        }
+    }
+    free(data_);
+}
+
+void scratch_arena_prewarm(size_t bytes, int count) {
+    int sizeClass = size_class_for(bytes);
+    if (sizeClass < 0 || count <= 0) return;
+
+    ScratchArena* arena = current_arena();
+    std::lock_guard<std::mutex> lock(arena->mutex);
+    auto& list = arena->freeLists[sizeClass];
+    int target = std::min(count, kMaxCachedPerClass);
+    while (static_cast<int>(list.size()) < target) {
+        void* p = aligned_alloc_bytes(class_bytes(sizeClass));
+        if (!p) {
+            LOGE("Scratch prewarm failed: %zu bytes", class_bytes(sizeClass));
+            break;
+        }
+        list.push_back(p);
+        arena->cachedBytes += class_bytes(sizeClass);
+    }
+}
+
+size_t scratch_arena_trim() {
+    size_t released = 0;
+    std::lock_guard<std::mutex> registryLock(g_registryMutex);
+    for (ScratchArena* arena : registry()) {
+        std::lock_guard<std::mutex> lock(arena->mutex);
+        released += release_cached_locked(arena);
+    }
+    LOGD("Scratch arena trimmed: %zu bytes released", released);
+    return released;
+}
+
+size_t scratch_arena_cached_bytes() {
+    size_t total = 0;
+    std::lock_guard<std::mutex> registryLock(g_registryMutex);
+    for (ScratchArena* arena : registry()) {
+        std::lock_guard<std::mutex> lock(arena->mutex);
+        total += arena->cachedBytes;
+    }
+    return total;
+}
@@ -0,0 +1,79 @@
+/**
+ * scratch_arena.h - 可复用的原生临时缓冲区（按尺寸分级的线程本地内存池）
+ *
+ * 背景：
+ * - 各滤波器每次调用都 new[]/delete[] 整帧临时缓冲，60 fps 下每帧多达 7 次整帧堆分配
+ * - 这里改为从线程本地内存池取用，缓冲归还后留在池中供下一帧复用
+ *
+ * 设计：
+ * - 尺寸分级：按 2 的幂向上取整（最小 4 KB），同级缓冲可互换复用
+ * - 每个线程一个内存池（thread_local），取用/归还无竞争
+ * - 全局登记所有线程的内存池，scratch_arena_trim() 可从任意线程释放全部空闲缓冲
+ * - 缓冲 64 字节对齐（缓存行 / NEON 友好）
+ *
+ * 使用方式：
+ *   ScratchBuffer buf(bytes);          // 从当前线程的内存池取用
+ *   float* p = buf.as<float>();        // 析构时自动归还
+ */
+
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+
+struct ScratchArena;
+
+/**
+ * 临时缓冲句柄（RAII）
+ *
+ * 内容未初始化；析构时归还到取用时所在线程的内存池
+ */
+class ScratchBuffer {
+public:
+    explicit ScratchBuffer(size_t bytes);
+    ~ScratchBuffer();
+
+    ScratchBuffer(const ScratchBuffer&) = delete;
+    ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+    void* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    template <typename T>
+    T* as() const { return static_cast<T*>(data_); }
+
+    /**
+     * 分配是否成功（内存不足时为 false）
+     */
+    explicit operator bool() const { return data_ != nullptr; }
+
+private:
+    ScratchArena* arena_;
+    void* data_;
+    size_t size_;     // 实际容量（分级后）
+    int sizeClass_;
+};
+
+/**
+ * 预热当前线程的内存池
+ *
+ * 预先分配 count 块不小于 bytes 的缓冲并放入池中，避免首帧分配抖动
+ */
+void scratch_arena_prewarm(size_t bytes, int count);
+
+/**
+ * 释放所有线程内存池中的空闲缓冲（使用中的缓冲不受影响）
+ *
+ * 用于 onTrimMemory / 页面退出
+ *
+ * @return 释放的字节数
+ */
+size_t scratch_arena_trim();
+
+/**
+ * 当前所有内存池中的空闲缓冲总字节数
+ */
+size_t scratch_arena_cached_bytes();
+
+#endif // SCRATCH_ARENA_H
@@ -0,0 +1,253 @@
+/**
+ * sdf_generator.cpp - 基于 Alpha 的欧氏距离场与法线贴图生成
+ *
+ * 实现细节：
+ * - 边缘点（feature）= Alpha < 阈值的像素，以及图像四周一圈虚拟像素
+ * - 纵向：每列自上而下、自下而上各扫描一次，记录最近边缘点的行号
+ *   （按 64 列条带处理，每次读取一整段连续内存）
+ * - 横向：f(p) = (y - 最近行号)²，求 min_p((x - p)² + f(p)) 的下包络抛物线；
+ *   数组两端各补一个虚拟边缘点（f = 0），对应图像左右边界
+ * - 距离为到最近边缘点的距离减 1：紧邻透明像素 / 图像边界的像素距离为 0，
+ *   与 Kotlin 版本的"到矩形边界的距离"定义一致
+ */
+
+#include "sdf_generator.h"
+#include "scratch_arena.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <android/log.h>
+
+#define LOG_TAG "SdfGenerator"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// 纵向扫描条带宽度（列数）
+static const int kSdfStripColumns = 64;
+
+// 非边缘点的初始距离（足够大，但平方运算不溢出 float）
+static const float kSdfInfinity = 1e20f;
+
+/**
+ * 纵向扫描：求 [colBegin, colEnd) 各列中每个像素到本列最近边缘点的行号
+ *
+ * 上方虚拟边缘点行号为 -1，下方为 height
+ */
+static void nearest_rows_in_columns(
+    const uint8_t* source,
+    int sourceStride,
+    int32_t* nearestRow,
+    int width,
+    int height,
+    int colBegin,
+    int colEnd,
+    int alphaThreshold
+) {
+    int32_t last[kSdfStripColumns];
+
+    for (int x0 = colBegin; x0 < colEnd; x0 += kSdfStripColumns) {
+        const int lanes = std::min(kSdfStripColumns, colEnd - x0);
+
+        // 自上而下：最近的上方边缘点
+        for (int i = 0; i < lanes; ++i) last[i] = -1;
+        for (int y = 0; y < height; ++y) {
+            const uint8_t* row = source + y * sourceStride + x0 * 4;
+            int32_t* out = nearestRow + y * width + x0;
+            for (int i = 0; i < lanes; ++i) {
+                if (row[i * 4 + 3] < alphaThreshold) last[i] = y;
+                out[i] = last[i];
+            }
+        }
+
+        // 自下而上：与下方边缘点比较，取更近者
+        for (int i = 0; i < lanes; ++i) last[i] = height;
+        for (int y = height - 1; y >= 0; --y) {
+            const uint8_t* row = source + y * sourceStride + x0 * 4;
+            int32_t* out = nearestRow + y * width + x0;
+            for (int i = 0; i < lanes; ++i) {
+                if (row[i * 4 + 3] < alphaThreshold) last[i] = y;
+                if (last[i] - y < y - out[i]) out[i] = last[i];
+            }
+        }
+    }
+}
+
+/**
+ * 以 q、p 为顶点的两条抛物线 (x - q)² + f(q) 与 (x - p)² + f(p) 的交点横坐标
+ */
+static inline float intersect_parabolas(const float* f, int q, int p) {
+    return ((f[q] + static_cast<float>(q) * q) - (f[p] + static_cast<float>(p) * p)) /
+           (2.0f * (q - p));
+}
+
+/**
+ * 横向距离变换 + 输出一行
+ *
+ * @param f 工作缓冲（width + 2）
+ * @param v 工作缓冲（width + 2）：下包络抛物线的顶点位置
+ * @param z 工作缓冲（width + 3）：相邻抛物线的交点
+ */
+static void transform_row(
+    const uint8_t* sourceRow,
+    const int32_t* nearestRow,
+    uint8_t* edgeRow,
+    uint8_t* normalRow,
+    int width,
+    int y,
+    int alphaThreshold,
+    float distanceScale,
+    float* f,
+    int32_t* v,
+    float* z
+) {
+    const int n = width + 2;
+
+    // 采样位置 p 对应图像列 p - 1；两端为虚拟边缘点
+    f[0] = 0.0f;
+    f[n - 1] = 0.0f;
+    for (int x = 0; x < width; ++x) {
+        const float dy = static_cast<float>(y - nearestRow[x]);
+        f[x + 1] = dy * dy;
+    }
+
+    // 下包络
+    int k = 0;
+    v[0] = 0;
+    z[0] = -kSdfInfinity;
+    z[1] = kSdfInfinity;
+    for (int q = 1; q < n; ++q) {
+        // z[0] = -∞，循环至多退回到 k = 0
+        float s = intersect_parabolas(f, q, v[k]);
+        while (s <= z[k]) {
+            --k;
+            s = intersect_parabolas(f, q, v[k]);
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = kSdfInfinity;
+    }
+
+    // 查询并输出
+    k = 0;
+    for (int x = 0; x < width; ++x) {
+        uint8_t* edgePixel = edgeRow + x * 4;
+        uint8_t* normalPixel = normalRow ? normalRow + x * 4 : nullptr;
+
+        const int q = x + 1;
+        while (z[k + 1] < q) ++k;
+
+        if (sourceRow[x * 4 + 3] < alphaThreshold) {
+            // 透明像素：距离为 0，法线为 0
+            edgePixel[0] = edgePixel[1] = edgePixel[2] = 0;
+            edgePixel[3] = 255;
+            if (normalPixel) {
+                normalPixel[0] = normalPixel[1] = normalPixel[2] = 128;
+                normalPixel[3] = 255;
+            }
+            continue;
+        }
+
+        const int p = v[k];
+        const float dx = static_cast<float>(p - q);
+        const float d2 = dx * dx + f[p];
+        const float dist = sqrtf(d2);
+
+        // 归一化到 [0, 255]
+        const float value = std::max(0.0f, std::min(255.0f, (dist - 1.0f) * distanceScale));
+        const uint8_t d = static_cast<uint8_t>(value);
+        edgePixel[0] = edgePixel[1] = edgePixel[2] = d;
+        edgePixel[3] = 255;
+
+        if (normalPixel) {
+            // 最近边缘点：列 p - 1；虚拟左右边界点与当前像素同行
+            const int featureX = p - 1;
+            const int featureY = (p == 0 || p == width + 1) ? y : nearestRow[featureX];
+            const float inv = dist > 0.0f ? 1.0f / dist : 0.0f;
+            const float nx = (featureX - x) * inv;
+            const float ny = (featureY - y) * inv;
+
+            // 法线分量范围 [-1, 1] -> [0, 255]
+            normalPixel[0] = static_cast<uint8_t>(std::max(0.0f, std::min(255.0f, (nx + 1.0f) * 0.5f * 255.0f)));
+            normalPixel[1] = static_cast<uint8_t>(std::max(0.0f, std::min(255.0f, (ny + 1.0f) * 0.5f * 255.0f)));
+            normalPixel[2] = 128;  // Z 分量固定为 0（映射到 128）
+            normalPixel[3] = 255;
+        }
+    }
+}
+
+void generate_edge_maps_from_alpha(
+    const uint8_t* source,
+    int sourceStride,
+    uint8_t* edgeDistance,
+    int edgeDistanceStride,
+    uint8_t* normalMap,
+    int normalMapStride,
+    int width,
+    int height,
+    int alphaThreshold,
+    float maxDistance
+) {
+    // 参数校验
+    if (!source || !edgeDistance) {
+        LOGE("Invalid parameters: null pointer");
+        return;
+    }
+
+    if (width <= 0 || height <= 0) {
+        LOGE("Invalid dimensions: %dx%d", width, height);
+        return;
+    }
+
+    if (sourceStride < width * 4 || edgeDistanceStride < width * 4 ||
+        (normalMap && normalMapStride < width * 4)) {
+        LOGE("Invalid stride: source=%d, edgeDistance=%d, normalMap=%d, min=%d",
+             sourceStride, edgeDistanceStride, normalMapStride, width * 4);
+        return;
+    }
+
+    // 默认归一化距离：半对角线（与 Kotlin 版本一致）
+    if (maxDistance <= 0.0f) {
+        maxDistance = sqrtf(static_cast<float>(width) * width + static_cast<float>(height) * height) / 2.0f;
+    }
+    const float distanceScale = 255.0f / maxDistance;
+
+    // 每列最近边缘点行号（整帧）+ 每个线程的横向工作缓冲
+    const int threads = thread_pool_concurrency();
+    const size_t rowsBytes = sizeof(int32_t) * static_cast<size_t>(width) * height;
+    const size_t slotFloats = static_cast<size_t>(width + 2) * 2 + (width + 3);
+    const size_t slotBytes = ((sizeof(float) * slotFloats + 63) / 64) * 64;
+
+    ScratchBuffer buffer(rowsBytes + slotBytes * threads);
+    if (!buffer) {
+        LOGE("Failed to allocate SDF buffers: %dx%d", width, height);
+        return;
+    }
+    int32_t* nearestRow = buffer.as<int32_t>();
+    uint8_t* slots = buffer.as<uint8_t>() + rowsBytes;
+
+    // 1. 纵向（按列条带并行）
+    const int strips = (width + kSdfStripColumns - 1) / kSdfStripColumns;
+    parallel_for(0, strips, parallel_rows_grain(height * kSdfStripColumns), [&](int s0, int s1, int) {
+        nearest_rows_in_columns(source, sourceStride, nearestRow, width, height,
+                                s0 * kSdfStripColumns, std::min(width, s1 * kSdfStripColumns),
+                                alphaThreshold);
+    });
+
+    // 2. 横向 + 输出（按行带并行）
+    parallel_for(0, height, parallel_rows_grain(width), [&](int rowBegin, int rowEnd, int slot) {
+        float* f = reinterpret_cast<float*>(slots + slotBytes * slot);
+        int32_t* v = reinterpret_cast<int32_t*>(f + (width + 2));
+        float* z = reinterpret_cast<float*>(v + (width + 2));
+
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            transform_row(source + y * sourceStride,
+                          nearestRow + y * width,
+                          edgeDistance + y * edgeDistanceStride,
+                          normalMap ? normalMap + y * normalMapStride : nullptr,
+                          width, y, alphaThreshold, distanceScale,
+                          f, v, z);
+        }
+    });
+
+}
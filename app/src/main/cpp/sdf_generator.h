@@ -0,0 +1,56 @@
+/**
+ * sdf_generator.h - 色散辅助贴图生成（基于 Alpha 的欧氏距离场 + 法线）
+ *
+ * 功能：
+ * 从源图像的 Alpha 轮廓生成色散效果所需的两张贴图：
+ * 1. 边缘距离贴图：每个不透明像素到最近透明像素（或图像边界）的欧氏距离
+ * 2. 法线贴图：从像素指向最近边缘点的单位向量（即向外的轮廓法线）
+ *
+ * 算法：
+ * - 精确欧氏距离变换（Felzenszwalb & Huttenlocher 两遍线性时间算法）
+ *   1. 纵向：逐列两次扫描，得到每个像素到本列最近边缘点的行号
+ *   2. 横向：逐行求下包络抛物线，得到平方距离与最近边缘点所在列
+ * - 横向遍历时同时记录最近边缘点坐标，距离与法线在同一遍写出
+ * - 图像外部视为透明：完全不透明的图像得到到矩形边界的距离
+ *
+ * 输出格式（与 DispersionMapGenerator.kt 一致）：
+ * - 边缘距离：R = G = B = 归一化距离（0 = 边缘，255 = 中心），A = 255
+ * - 法线：R = X 分量，G = Y 分量（0-255，128 为 0），B = 128，A = 255
+ *
+ * 复杂度：O(W×H)，与形状无关；纵向按列条带、横向按行带并行
+ */
+
+#ifndef SDF_GENERATOR_H
+#define SDF_GENERATOR_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * 从 Alpha 通道生成边缘距离贴图与法线贴图
+ *
+ * @param source 源图像（RGBA8888，只使用 Alpha）
+ * @param sourceStride 源图像行跨度（字节数）
+ * @param edgeDistance 输出边缘距离贴图（RGBA8888，与源图像尺寸相同）
+ * @param edgeDistanceStride 边缘距离贴图行跨度（字节数）
+ * @param normalMap 输出法线贴图（可为 nullptr，不生成）
+ * @param normalMapStride 法线贴图行跨度（字节数）
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param alphaThreshold Alpha 低于此值视为透明（边缘外），推荐 10
+ * @param maxDistance 归一化距离（映射为 255）；<= 0 时使用半对角线长度
+ */
+void generate_edge_maps_from_alpha(
+    const uint8_t* source,
+    int sourceStride,
+    uint8_t* edgeDistance,
+    int edgeDistanceStride,
+    uint8_t* normalMap,
+    int normalMapStride,
+    int width,
+    int height,
+    int alphaThreshold,
+    float maxDistance
+);
+
+#endif // SDF_GENERATOR_H
@@ -0,0 +1,199 @@
+/**
+ * thread_pool.cpp - 原生滤波器共享线程池实现
+ *
+ * 实现细节：
+ * - 常驻工作线程在条件变量上等待，按“代数”（generation）识别新任务
+ * - 任务块通过原子计数器动态领取，负载不均时快线程多做
+ * - 调用线程领取块的方式与工作线程相同，完成后等待所有工作线程退出本代任务
+ * - 线程池对象有意不析构：进程退出时由系统回收，避免 JNI 卸载期 join 卡死
+ */
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <pthread.h>
+#include <android/log.h>
+
+#define LOG_TAG "ThreadPool"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// 并行度上限（超过 8 个线程时同步开销大于收益）
+static const int kMaxConcurrency = 8;
+
+// 当前线程是否已在并行任务中（用于嵌套调用降级为串行）
+static thread_local bool t_inParallelTask = false;
+
+/**
+ * 读取某个 CPU 的最高频率（kHz），失败返回 0
+ */
+static long read_cpu_max_freq(int cpu) {
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+    FILE* f = fopen(path, "r");
+    if (!f) return 0;
+    long freq = 0;
+    if (fscanf(f, "%ld", &freq) != 1) freq = 0;
+    fclose(f);
+    return freq;
+}
+
+/**
+ * 统计大核数量
+ *
+ * big.LITTLE / DynamIQ：最高频率高于最低档的核心都算作大核（含中核）；
+ * 频率信息不可用或各核相同时，使用全部在线核心
+ */
+static int detect_big_cores() {
+    int cpuCount = static_cast<int>(sysconf(_SC_NPROCESSORS_CONF));
+    if (cpuCount <= 0) {
+        cpuCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    cpuCount = std::max(1, cpuCount);
+
+    std::vector<long> freqs;
+    for (int i = 0; i < cpuCount; ++i) {
+        long f = read_cpu_max_freq(i);
+        if (f > 0) freqs.push_back(f);
+    }
+
+    int bigCores = cpuCount;
+    if (!freqs.empty()) {
+        long minFreq = *std::min_element(freqs.begin(), freqs.end());
+        long maxFreq = *std::max_element(freqs.begin(), freqs.end());
+        if (maxFreq > minFreq) {
+            bigCores = static_cast<int>(std::count_if(freqs.begin(), freqs.end(),
+                                                      [minFreq](long f) { return f > minFreq; }));
+        }
+    }
+
+    return std::max(1, std::min(kMaxConcurrency, bigCores));
+}
+
+class ThreadPool {
+public:
+    explicit ThreadPool(int concurrency) : concurrency_(concurrency) {
+        for (int i = 1; i < concurrency_; ++i) {
+            workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+        }
+        LOGD("Thread pool started: %d threads (including caller)", concurrency_);
+    }
+
+    int concurrency() const { return concurrency_; }
+
+    void run(int begin, int end, int grain, const ParallelTask& task) {
+        const int total = end - begin;
+        if (total <= 0) return;
+
+        grain = std::max(1, grain);
+
+        // 小任务、单线程配置或嵌套调用：直接串行执行
+        if (concurrency_ <= 1 || total <= grain || t_inParallelTask) {
+            task(begin, end, 0);
+            return;
+        }
+
+        // 其他线程正在使用线程池：串行执行，不阻塞调用方
+        std::unique_lock<std::mutex> submitLock(submitMutex_, std::try_to_lock);
+        if (!submitLock.owns_lock()) {
+            task(begin, end, 0);
+            return;
+        }
+
+        // 每个线程约分到 4 块，兼顾负载均衡与调度开销
+        int chunk = std::max(grain, (total + concurrency_ * 4 - 1) / (concurrency_ * 4));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &task;
+            begin_ = begin;
+            end_ = end;
+            chunk_ = chunk;
+            nextChunk_.store(0, std::memory_order_relaxed);
+            activeWorkers_ = static_cast<int>(workers_.size());
+            ++generation_;
+        }
+        wakeCv_.notify_all();
+
+        // 调用线程作为 0 号线程参与计算
+        t_inParallelTask = true;
+        run_chunks(0);
+        t_inParallelTask = false;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        doneCv_.wait(lock, [this] { return activeWorkers_ == 0; });
+        task_ = nullptr;
+    }
+
+private:
+    void run_chunks(int slot) {
+        for (;;) {
+            int index = nextChunk_.fetch_add(1, std::memory_order_relaxed);
+            int chunkBegin = begin_ + index * chunk_;
+            if (chunkBegin >= end_) break;
+            int chunkEnd = std::min(end_, chunkBegin + chunk_);
+            (*task_)(chunkBegin, chunkEnd, slot);
+        }
+    }
+
+    void worker_loop(int slot) {
+        char name[16];
+        snprintf(name, sizeof(name), "nativegauss-%d", slot);
+        pthread_setname_np(pthread_self(), name);
+
+        t_inParallelTask = true;
+        uint64_t seenGeneration = 0;
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wakeCv_.wait(lock, [&] { return generation_ != seenGeneration; });
+                seenGeneration = generation_;
+            }
+
+            run_chunks(slot);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --activeWorkers_;
+            }
+            doneCv_.notify_one();
+        }
+    }
+
+    const int concurrency_;
+    std::vector<std::thread> workers_;
+
+    std::mutex submitMutex_;  // 同一时刻只允许一个并行任务
+    std::mutex mutex_;        // 保护以下任务状态
+    std::condition_variable wakeCv_;
+    std::condition_variable doneCv_;
+    uint64_t generation_ = 0;
+    int activeWorkers_ = 0;
+
+    const ParallelTask* task_ = nullptr;
+    int begin_ = 0;
+    int end_ = 0;
+    int chunk_ = 1;
+    std::atomic<int> nextChunk_{0};
+};
+
+static ThreadPool& get_pool() {
+    // 有意泄漏：见文件头说明
+    static ThreadPool* pool = new ThreadPool(detect_big_cores());
+    return *pool;
+}
+
+int thread_pool_concurrency() {
+    return get_pool().concurrency();
+}
+
+void parallel_for(int begin, int end, int grain, const ParallelTask& task) {
+    get_pool().run(begin, end, grain, task);
+}
@@ -0,0 +1,62 @@
+/**
+ * thread_pool.h - 原生滤波器共享线程池
+ *
+ * 设计目标：
+ * - 所有滤波器（IIR、Box3、色差、色散）共用一个常驻线程池，避免每次调用创建线程
+ * - 线程数按大核数量确定（读取 cpufreq 的 cpuinfo_max_freq 区分大小核）
+ * - 调用线程本身也参与计算，工作线程数 = 并行度 - 1
+ *
+ * 任务划分约定：
+ * - 横向 pass：按行分块
+ * - 纵向 pass：按列条带分块
+ * - 逐像素效果：按行带分块
+ *
+ * 线程安全：
+ * - 同一时刻只执行一个并行任务；若线程池正忙（其他 JNI 线程占用）
+ *   或在工作线程内嵌套调用，则直接在调用线程上串行执行，不会阻塞或死锁
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <functional>
+
+/**
+ * 并行任务回调
+ *
+ * @param begin 本块起始索引（含）
+ * @param end 本块结束索引（不含）
+ * @param slot 执行线程编号，范围 [0, thread_pool_concurrency())，
+ *             可用于索引按线程预分配的工作缓冲
+ */
+typedef std::function<void(int begin, int end, int slot)> ParallelTask;
+
+/**
+ * 获取并行度（工作线程数 + 调用线程）
+ *
+ * 首次调用时创建线程池
+ */
+int thread_pool_concurrency();
+
+/**
+ * 将 [begin, end) 划分为若干块并行执行
+ *
+ * @param begin 起始索引
+ * @param end 结束索引
+ * @param grain 每块最小数量；总量不超过 grain 时直接在调用线程执行
+ * @param task 任务回调，返回前所有块均已完成
+ */
+void parallel_for(int begin, int end, int grain, const ParallelTask& task);
+
+/**
+ * 根据每行像素数计算按行划分的块大小
+ *
+ * 每块约 16K 像素：过小的图像不值得跨线程分发
+ */
+inline int parallel_rows_grain(int width) {
+    const int kPixelsPerTask = 16 * 1024;
+    int rows = kPixelsPerTask / (width > 0 ? width : 1);
+    return rows > 1 ? rows : 1;
+}
+
+#endif // THREAD_POOL_H
@@ -20,6 +20,9 @@
 package com.example.blur
 
 import android.graphics.Bitmap
+import android.graphics.Canvas
+import android.graphics.Paint
+import android.graphics.Rect
 
 object NativeGauss {
 
@@ -32,17 +35,114 @@ object NativeGauss {
         }
     }
 
+    // FP16 半精度算术检测（ARMv8.2-A，延迟初始化）
+    private val fp16Supported: Boolean by lazy {
+        try {
+            hasFp16Support()
+        } catch (e: UnsatisfiedLinkError) {
+            false
+        }
+    }
+
+    /**
+     * FP16 路径的最大 σ（与 gauss_iir_fp16.h 中 kFp16MaxSigma 一致，超过时原生层回退 FP32）
+     */
+    const val FP16_MAX_SIGMA = 32.0f
+
     init {
         System.loadLibrary("nativegauss")
     }
 
     /**
-     * 检测当前设备是否支持 NEON 向量化
+     * 检测当前设备是否有向量 IIR 后端
      *
-     * @return true 如果支持 NEON，false 否则
+     * 历史名称：ARM 上为 NEON；x86 / x86_64 上为 SSE4.1 / AVX2（运行时检测），
+     * 两者都经 gaussianIIRNeonInplace 调用
+     *
+     * @return true 如果 gaussianIIRNeonInplace 会走向量内核，false 否则
      */
     external fun hasNeonSupport(): Boolean
 
+    /**
+     * CPU 特性位（与 cpu_features.h 中 CpuFeature 一致）
+     */
+    const val CPU_FEATURE_NEON = 1 shl 0
+    const val CPU_FEATURE_FP16 = 1 shl 1
+    const val CPU_FEATURE_DOTPROD = 1 shl 2
+    const val CPU_FEATURE_SSE41 = 1 shl 3
+    const val CPU_FEATURE_AVX2 = 1 shl 4
+
+    /**
+     * 当前可用的 CPU 特性（CPU_FEATURE_* 的组合，已去掉 setCpuFeaturesDisabled 屏蔽的位）
+     */
+    external fun cpuFeatures(): Int
+
+    /**
+     * 特性位的可读描述（如 "neon fp16 dotprod"、"sse4.1 avx2"，无特性时为 "scalar"）
+     */
+    external fun describeCpuFeatures(features: Int = cpuFeatures()): String
+
+    /**
+     * 屏蔽部分 CPU 特性，原生层的分派立即改走下一级后端（AVX2 → SSE4.1 → 标量，FP16 → NEON → 标量）
+     *
+     * 用于测试 / 基准对比各后端；0 表示全部启用。
+     * 注意：smartBlur 等 Kotlin 层的选择在首次使用时已确定，屏蔽后由原生入口内部回退
+     *
+     * @param mask CPU_FEATURE_* 的组合
+     */
+    external fun setCpuFeaturesDisabled(mask: Int)
+
+    /**
+     * smartBlur 的候选方法（与 blur_tuner.h 中 BlurTunerMethod 一致）
+     */
+    const val SMART_METHOD_IIR = 0
+    const val SMART_METHOD_BOX3 = 1
+    const val SMART_METHOD_PYRAMID = 2
+
+    /**
+     * 按交叉点表选择 smartBlur 的方法（未校准时为默认表，与原先的固定阈值一致）
+     *
+     * @return SMART_METHOD_*；highQuality 为 true 时不会返回 SMART_METHOD_PYRAMID
+     */
+    external fun selectSmartMethod(
+        width: Int,
+        height: Int,
+        sigma: Float,
+        highQuality: Boolean
+    ): Int
+
+    /**
+     * 实测各候选方法并更新交叉点表（耗时数百毫秒，必须在后台线程调用）
+     *
+     * 推荐通过 SmartBlurTuner.ensureCalibrated() 调用，结果会被持久化
+     *
+     * @param budgetMs 时间预算（毫秒，≤ 0 表示不限），超出时剩余尺寸档沿用已校准结果
+     * @return 导出的交叉点表（可传给 importSmartBlurTable）
+     */
+    external fun calibrateSmartBlur(budgetMs: Int): ByteArray
+
+    /**
+     * 导出当前交叉点表
+     */
+    external fun exportSmartBlurTable(): ByteArray
+
+    /**
+     * 导入交叉点表（calibrateSmartBlur / exportSmartBlurTable 的结果）
+     *
+     * @return false 如果版本或内容不匹配（当前表保持不变）
+     */
+    external fun importSmartBlurTable(table: ByteArray): Boolean
+
+    /**
+     * 恢复默认交叉点表
+     */
+    external fun resetSmartBlurTable()
+
+    /**
+     * 当前交叉点表是否来自校准（或导入的校准结果）
+     */
+    external fun isSmartBlurCalibrated(): Boolean
+
     /**
      * IIR 递归高斯模糊（原位处理）
      *
@@ -80,14 +180,39 @@ object NativeGauss {
      * @param bitmap 待处理位图（ARGB_8888, mutable）
      * @param sigma 高斯标准差
      * @param linear 是否在线性色彩空间处理
+     * @param colorMatrix 可选颜色矩阵（android.graphics.ColorMatrix.array，20 个元素），
+     *                    在最终打包前融合套用，省去单独一遍饱和度处理；null 表示不套用
      *
-     * @throws IllegalArgumentException 如果 Bitmap 格式不是 ARGB_8888 或不可编辑
+     * @throws IllegalArgumentException 如果 Bitmap 格式不是 ARGB_8888 或不可编辑，或矩阵长度不是 20
      * @throws UnsatisfiedLinkError 如果设备不支持 NEON
      */
     external fun gaussianIIRNeonInplace(
         bitmap: Bitmap,
         sigma: Float,
-        linear: Boolean = false
+        linear: Boolean = false,
+        colorMatrix: FloatArray? = null
+    )
+
+    /**
+     * 检测当前设备是否支持 FP16 向量算术（ARMv8.2-A，Cortex-A55/A75 及以后）
+     */
+    external fun hasFp16Support(): Boolean
+
+    /**
+     * IIR 递归高斯模糊（FP16 半精度版本，非线性模式，原位处理）
+     *
+     * - 每个寄存器保存 2 个像素，纵向工作缓冲减半
+     * - 与 gaussianIIRNeonInplace(linear = false) 相比最大误差 2 LSB（σ ≤ 32）
+     * - 设备不支持 FP16 或 σ > FP16_MAX_SIGMA 时自动回退 FP32 实现，任何设备都可调用
+     *
+     * @param bitmap 待处理位图（ARGB_8888, mutable）
+     * @param sigma 高斯标准差
+     *
+     * @throws IllegalArgumentException 如果 Bitmap 格式不是 ARGB_8888 或不可编辑
+     */
+    external fun gaussianIIRFp16Inplace(
+        bitmap: Bitmap,
+        sigma: Float
     )
     
     /**
@@ -103,12 +228,30 @@ object NativeGauss {
      *               - radius = 3：轻度模糊，近似 σ ≈ 2.5
      *               - radius = 6：中度模糊，近似 σ ≈ 5.0
      *               - radius = 12：强烈模糊，近似 σ ≈ 10.0
+     * @param colorMatrix 可选颜色矩阵（20 个元素），在最后一遍写回时融合套用；null 表示不套用
      * 
-     * @throws IllegalArgumentException 如果 Bitmap 格式不是 ARGB_8888 或不可编辑
+     * @throws IllegalArgumentException 如果 Bitmap 格式不是 ARGB_8888 或不可编辑，或矩阵长度不是 20
      */
     external fun box3Inplace(
         bitmap: Bitmap,
-        radius: Int
+        radius: Int,
+        colorMatrix: FloatArray? = null
+    )
+
+    /**
+     * 单独套用颜色矩阵（原位处理）
+     *
+     * 用于无法融合矩阵的模糊路径（标量 IIR、FP16 等），仍比 Canvas + ColorMatrixColorFilter
+     * 少一张整帧 Bitmap 分配
+     *
+     * @param bitmap 待处理位图（ARGB_8888, mutable）
+     * @param colorMatrix android.graphics.ColorMatrix.array（20 个元素）
+     *
+     * @throws IllegalArgumentException 如果 Bitmap 格式不是 ARGB_8888 或不可编辑，或矩阵长度不是 20
+     */
+    external fun colorMatrixInplace(
+        bitmap: Bitmap,
+        colorMatrix: FloatArray
     )
 
     /**
@@ -130,13 +273,15 @@ object NativeGauss {
      * @param downscale 降采样比例（0.01-1.0），推荐 0.5
      *                  - 0.5：降采样 50%，速度提升约 4×
      *                  - 0.25：降采样 75%，速度提升约 16×
+     * @param colorMatrix 可选颜色矩阵（20 个元素），在上采样前作用于小图；null 表示不套用
      *
-     * @throws IllegalArgumentException 如果 Bitmap 格式不是 ARGB_8888 或不可编辑
+     * @throws IllegalArgumentException 如果 Bitmap 格式不是 ARGB_8888 或不可编辑，或矩阵长度不是 20
      */
     external fun advancedBoxBlurInplace(
         bitmap: Bitmap,
         radius: Float,
-        downscale: Float = 0.5f
+        downscale: Float = 0.5f,
+        colorMatrix: FloatArray? = null
     )
 
     /**
@@ -150,22 +295,214 @@ object NativeGauss {
      * 优势：
      * - 质量好，平滑无锯齿
      * - 适合需要高质量的场景
-     *
-     * 缺点：
-     * - 速度较慢（大量浮点运算）
+     * - 缩放使用定点查找表实现（见 resizeBilinear），开销接近快速版本
      *
      * @param bitmap 待处理位图（ARGB_8888, mutable）
      * @param radius 模糊半径（0-25），应用于降采样后的图像
      * @param downscale 降采样比例（0.01-1.0），推荐 0.5
+     * @param colorMatrix 可选颜色矩阵（20 个元素），在上采样前作用于小图；null 表示不套用
      *
-     * @throws IllegalArgumentException 如果 Bitmap 格式不是 ARGB_8888 或不可编辑
+     * @throws IllegalArgumentException 如果 Bitmap 格式不是 ARGB_8888 或不可编辑，或矩阵长度不是 20
      */
     external fun advancedBoxBlurInplaceHQ(
         bitmap: Bitmap,
         radius: Float,
-        downscale: Float = 0.5f
+        downscale: Float = 0.5f,
+        colorMatrix: FloatArray? = null
     )
 
+    /**
+     * 多级降采样金字塔模糊（原位处理）
+     *
+     * 算法流程：
+     * 1. 逐级 2× 降采样（4×4 邻域 [1 3 3 1] 加权，混叠远小于单级最近邻降采样）
+     * 2. 在最小一级上补足剩余的 IIR 高斯模糊
+     * 3. 逐级 2× 双线性上采样回原尺寸
+     *
+     * 性能特性：
+     * - 全部层级之和不超过原图的 1/3，总耗时基本与 σ 无关，适合 σ > 15 的强模糊
+     * - 与同 σ 的 gaussianIIRNeonInplace 模糊程度一致（PSNR ≈ 45-50 dB）
+     * - σ 较小（< 3）时不降采样，等同 IIR
+     *
+     * @param bitmap 待处理位图（ARGB_8888, mutable）
+     * @param sigma 等效高斯标准差（原图像素）
+     *
+     * @throws IllegalArgumentException 如果 Bitmap 格式不是 ARGB_8888 或不可编辑
+     */
+    external fun pyramidBlurInplace(
+        bitmap: Bitmap,
+        sigma: Float
+    )
+
+    /**
+     * 双线性缩放（8.8 定点，原生实现）
+     *
+     * - 坐标映射与 Bitmap.createScaledBitmap(filter = true) 相同，放大 / 缩小均可
+     * - 每列 / 每行的源索引与权重只计算一次，NEON 每次插值 4 个像素
+     *
+     * @param source 源图像（ARGB_8888，只读）
+     * @param destination 目标图像（ARGB_8888, mutable，尺寸即缩放目标，不能与 source 相同）
+     *
+     * @throws IllegalArgumentException 如果 Bitmap 格式不是 ARGB_8888，或 source 与 destination 相同
+     */
+    external fun resizeBilinear(
+        source: Bitmap,
+        destination: Bitmap
+    )
+
+    /**
+     * 预热原生临时缓冲池
+     *
+     * 各滤波器的整帧临时缓冲取自线程本地内存池并跨帧复用，
+     * 首帧前预热可避免分配抖动。缓冲池按线程区分，应在执行模糊的同一线程调用。
+     *
+     * @param width 预期处理的图像宽度
+     * @param height 预期处理的图像高度
+     */
+    external fun prewarmScratch(width: Int, height: Int)
+
+    /**
+     * 释放原生临时缓冲池中的空闲缓冲，以及色散的径向法线缓存表
+     *
+     * 建议在 onTrimMemory / onDestroy 中调用；之后的模糊调用会按需重新分配
+     *
+     * @return 释放的字节数
+     */
+    external fun releaseScratch(): Long
+
+    /**
+     * 单个 (滤波器, 阶段) 的原生耗时统计
+     *
+     * @property filter 滤波器名（见 STATS_FILTER_NAMES）
+     * @property stage 阶段名（见 STATS_STAGE_NAMES）
+     * @property count 累计调用次数
+     * @property totalNs 累计耗时（纳秒）
+     * @property maxNs 最大单次耗时（纳秒）
+     * @property p50Ns 最近样本中位数（纳秒）
+     * @property p99Ns 最近样本 p99（纳秒）
+     */
+    data class StageStats(
+        val filter: String,
+        val stage: String,
+        val count: Long,
+        val totalNs: Long,
+        val maxNs: Long,
+        val p50Ns: Long,
+        val p99Ns: Long
+    ) {
+        val meanNs: Long get() = if (count > 0) totalNs / count else 0L
+    }
+
+    /**
+     * 滤波器名（与 perf_trace.h 中 TraceFilter 顺序一致）
+     */
+    val STATS_FILTER_NAMES = arrayOf(
+        "IIR", "IIR_NEON", "IIR_FP16", "Box3", "BoxSingle", "AdvancedBox", "AdvancedBoxHQ", "Aberration", "Dispersion", "Pyramid", "Resample", "Distortion"
+    )
+
+    /**
+     * 阶段名（与 perf_trace.h 中 TraceStage 顺序一致）
+     *
+     * convert / pack 为各线程耗时之和，已包含在 horizontal / vertical 中；其余为墙钟时间
+     */
+    val STATS_STAGE_NAMES = arrayOf(
+        "total", "alloc", "convert", "horizontal", "vertical", "pack", "setup", "sample"
+    )
+
+    /**
+     * 读取分阶段性能统计（只返回有记录的条目）
+     *
+     * 同样的阶段可在 systrace / Perfetto 中以 "IIR_NEON.horizontal" 等区段查看
+     */
+    fun getStats(): List<StageStats> {
+        val raw = getStatsRaw()
+        return (0 until raw.size / 7).map { i ->
+            val o = i * 7
+            StageStats(
+                filter = STATS_FILTER_NAMES.getOrElse(raw[o].toInt()) { "?" },
+                stage = STATS_STAGE_NAMES.getOrElse(raw[o + 1].toInt()) { "?" },
+                count = raw[o + 2],
+                totalNs = raw[o + 3],
+                maxNs = raw[o + 4],
+                p50Ns = raw[o + 5],
+                p99Ns = raw[o + 6]
+            )
+        }
+    }
+
+    /**
+     * 原始统计数组（每个条目 7 个 long：filter, stage, count, totalNs, maxNs, p50Ns, p99Ns）
+     */
+    external fun getStatsRaw(): LongArray
+
+    /**
+     * 清空分阶段性能统计
+     */
+    external fun resetStats()
+
+    /**
+     * 开启 / 关闭分阶段性能统计（默认开启，关闭后每阶段只剩一次原子读）
+     */
+    external fun setStatsEnabled(enabled: Boolean)
+
+    /**
+     * 双线性缩放到新 Bitmap（Bitmap.createScaledBitmap(source, width, height, true) 的原生替代）
+     *
+     * - 尺寸相同时返回 source 本身（与 createScaledBitmap 一致）
+     * - source 不是 ARGB_8888 或无法锁定像素（如硬件 Bitmap）时回退 createScaledBitmap
+     *
+     * @param source 源图像
+     * @param width 目标宽度
+     * @param height 目标高度
+     * @return 缩放后的位图
+     */
+    fun scaleBitmap(source: Bitmap, width: Int, height: Int): Bitmap {
+        if (source.width == width && source.height == height) return source
+        if (source.config != Bitmap.Config.ARGB_8888) {
+            return Bitmap.createScaledBitmap(source, width, height, true)
+        }
+
+        val result = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
+        return try {
+            resizeBilinear(source, result)
+            result
+        } catch (e: RuntimeException) {
+            result.recycle()
+            Bitmap.createScaledBitmap(source, width, height, true)
+        }
+    }
+
+    /**
+     * 双线性缩放到已有 Bitmap（供对象池复用目标）
+     *
+     * 原生路径不可用时回退 Canvas 过滤绘制
+     *
+     * @param source 源图像
+     * @param destination 目标图像（mutable，尺寸即缩放目标）
+     */
+    fun scaleInto(source: Bitmap, destination: Bitmap) {
+        if (source !== destination &&
+            source.config == Bitmap.Config.ARGB_8888 &&
+            destination.config == Bitmap.Config.ARGB_8888
+        ) {
+            try {
+                resizeBilinear(source, destination)
+                return
+            } catch (e: RuntimeException) {
+                // 回退 Canvas
+            }
+        }
+
+        val canvas = Canvas(destination)
+        val paint = Paint(Paint.ANTI_ALIAS_FLAG or Paint.FILTER_BITMAP_FLAG)
+        canvas.drawBitmap(
+            source,
+            Rect(0, 0, source.width, source.height),
+            Rect(0, 0, destination.width, destination.height),
+            paint
+        )
+    }
+
     /**
      * 辅助函数：根据目标半径计算等效 σ
      * 
@@ -190,27 +527,43 @@ object NativeGauss {
      * 智能模糊：根据图像尺寸和模糊强度自动选择最优算法
      *
      * 策略：
-     * - 小图（< 64×64）且 σ < 8：使用 Box3
-     * - 支持 NEON 的设备：使用 NEON 优化版本
-     * - 其他情况：使用标量 IIR
+     * - 方法由交叉点表决定（selectSmartMethod）：IIR / Box3 / 金字塔
+     * - 未校准时使用默认表：小图（< 64×64）且 σ < 8 使用 Box3，其余使用 IIR
+     * - 校准（SmartBlurTuner）后按本机实测的快慢交叉点选择
+     * - IIR：非线性模式、支持 FP16 且 σ ≤ FP16_MAX_SIGMA 时使用 FP16 半精度版本，
+     *   其次 NEON 优化版本，其他情况使用标量 IIR
      *
      * @param bitmap 待处理位图
      * @param sigma 高斯标准差
      * @param highQuality 是否启用高质量模式（线性色彩空间）
+     * @param colorMatrix 可选颜色矩阵（20 个元素）：Box3 / NEON 路径融合套用，其余路径模糊后单独套用
      */
-    fun smartBlur(bitmap: Bitmap, sigma: Float, highQuality: Boolean = false) {
-        val pixels = bitmap.width * bitmap.height
-
-        // 小图且轻度模糊：使用 Box3
-        if (pixels < 64 * 64 && sigma < 8.0f) {
-            val radius = (sigma * 1.2f).toInt().coerceAtLeast(1)
-            box3Inplace(bitmap, radius)
-        } else {
-            // 其他情况：优先使用 NEON 优化版本
-            if (neonSupported) {
-                gaussianIIRNeonInplace(bitmap, sigma, highQuality)
-            } else {
-                gaussianIIRInplace(bitmap, sigma, highQuality)
+    fun smartBlur(
+        bitmap: Bitmap,
+        sigma: Float,
+        highQuality: Boolean = false,
+        colorMatrix: FloatArray? = null
+    ) {
+        when (selectSmartMethod(bitmap.width, bitmap.height, sigma, highQuality)) {
+            SMART_METHOD_BOX3 -> {
+                val radius = (sigma * 1.2f).toInt().coerceAtLeast(1)
+                box3Inplace(bitmap, radius, colorMatrix)
+            }
+            SMART_METHOD_PYRAMID -> {
+                pyramidBlurInplace(bitmap, sigma)
+                colorMatrix?.let { colorMatrixInplace(bitmap, it) }
+            }
+            else -> {
+                // 非线性模式优先 FP16，其次 NEON 优化版本
+                if (!highQuality && fp16Supported && sigma <= FP16_MAX_SIGMA) {
+                    gaussianIIRFp16Inplace(bitmap, sigma)
+                    colorMatrix?.let { colorMatrixInplace(bitmap, it) }
+                } else if (neonSupported) {
+                    gaussianIIRNeonInplace(bitmap, sigma, highQuality, colorMatrix)
+                } else {
+                    gaussianIIRInplace(bitmap, sigma, highQuality)
+                    colorMatrix?.let { colorMatrixInplace(bitmap, it) }
+                }
             }
         }
     }
@@ -231,13 +584,15 @@ object NativeGauss {
      * @param sigma 高斯标准差（原图尺度）
      * @param scale 下采样倍数（2 或 3）
      * @param highQuality 是否启用高质量模式
+     * @param colorMatrix 可选颜色矩阵（20 个元素），在上采样前作用于小图；null 表示不套用
      * @return 模糊后的位图（新创建）
      */
     fun downsampleBlur(
         bitmap: Bitmap,
         sigma: Float,
         scale: Int = 2,
-        highQuality: Boolean = false
+        highQuality: Boolean = false,
+        colorMatrix: FloatArray? = null
     ): Bitmap {
         require(scale in 2..3) { "Scale must be 2 or 3" }
 
@@ -245,18 +600,19 @@ object NativeGauss {
         val smallH = bitmap.height / scale
 
         // 下采样
-        val small = Bitmap.createScaledBitmap(bitmap, smallW, smallH, true)
+        val small = scaleBitmap(bitmap, smallW, smallH)
 
         // 在小图上模糊（调整 σ，优先使用 NEON）
         val adjustedSigma = sigma / scale
         if (neonSupported) {
-            gaussianIIRNeonInplace(small, adjustedSigma, highQuality)
+            gaussianIIRNeonInplace(small, adjustedSigma, highQuality, colorMatrix)
         } else {
             gaussianIIRInplace(small, adjustedSigma, highQuality)
+            colorMatrix?.let { colorMatrixInplace(small, it) }
         }
 
         // 上采样回原尺寸
-        val result = Bitmap.createScaledBitmap(small, bitmap.width, bitmap.height, true)
+        val result = scaleBitmap(small, bitmap.width, bitmap.height)
         small.recycle()
 
         return result
@@ -0,0 +1,108 @@
+/**
+ * SmartBlurTuner - smartBlur 交叉点表的校准与持久化
+ *
+ * 功能：
+ * 1. 首次启动时在后台线程实测各模糊方法（IIR / Box3 / 金字塔），生成本机的交叉点表
+ * 2. 表保存在 SharedPreferences 中，之后启动直接导入，不必重新校准
+ * 3. 系统版本（Build.FINGERPRINT）或 CPU 特性变化时自动重新校准
+ *
+ * 使用示例：
+ * ```kotlin
+ * // Application / Activity.onCreate 中调用一次
+ * SmartBlurTuner.ensureCalibrated(applicationContext)
+ * ```
+ *
+ * 校准完成前 smartBlur 使用默认表（与原先的固定阈值一致），不会阻塞渲染
+ */
+package com.example.blur
+
+import android.content.Context
+import android.os.Build
+import android.util.Base64
+import android.util.Log
+import java.util.concurrent.atomic.AtomicBoolean
+
+object SmartBlurTuner {
+
+    private const val TAG = "SmartBlurTuner"
+    private const val PREF_NAME = "nativegauss_tuner"
+    private const val KEY_TABLE = "table"
+    private const val KEY_FINGERPRINT = "fingerprint"
+
+    /**
+     * 默认校准时间预算（毫秒）
+     */
+    const val DEFAULT_BUDGET_MS = 1500
+
+    // 每个进程只加载 / 校准一次
+    private val started = AtomicBoolean(false)
+
+    /**
+     * 加载已保存的交叉点表；没有或已失效时在后台线程校准并保存
+     *
+     * 可从主线程调用（只读取 SharedPreferences），重复调用无副作用
+     *
+     * @param context 任意 Context（内部使用 applicationContext）
+     * @param budgetMs 校准时间预算（毫秒）
+     */
+    fun ensureCalibrated(context: Context, budgetMs: Int = DEFAULT_BUDGET_MS) {
+        if (!started.compareAndSet(false, true)) {
+            return
+        }
+
+        val appContext = context.applicationContext
+        try {
+            val prefs = appContext.getSharedPreferences(PREF_NAME, Context.MODE_PRIVATE)
+            val saved = prefs.getString(KEY_TABLE, null)
+            if (saved != null && prefs.getString(KEY_FINGERPRINT, null) == fingerprint()) {
+                if (NativeGauss.importSmartBlurTable(Base64.decode(saved, Base64.NO_WRAP))) {
+                    Log.d(TAG, "Loaded smart blur table")
+                    return
+                }
+            }
+        } catch (e: UnsatisfiedLinkError) {
+            Log.e(TAG, "Native library not available: ${e.message}")
+            return
+        } catch (e: IllegalArgumentException) {
+            Log.e(TAG, "Saved smart blur table is corrupt: ${e.message}")
+        }
+
+        startCalibration(appContext, budgetMs)
+    }
+
+    /**
+     * 丢弃已保存的表并在后台线程重新校准
+     */
+    fun recalibrate(context: Context, budgetMs: Int = DEFAULT_BUDGET_MS) {
+        started.set(true)
+        startCalibration(context.applicationContext, budgetMs)
+    }
+
+    private fun startCalibration(appContext: Context, budgetMs: Int) {
+        val thread = Thread({
+            try {
+                val start = System.nanoTime()
+                val table = NativeGauss.calibrateSmartBlur(budgetMs)
+                val elapsedMs = (System.nanoTime() - start) / 1_000_000
+                appContext.getSharedPreferences(PREF_NAME, Context.MODE_PRIVATE)
+                    .edit()
+                    .putString(KEY_TABLE, Base64.encodeToString(table, Base64.NO_WRAP))
+                    .putString(KEY_FINGERPRINT, fingerprint())
+                    .apply()
+                Log.d(TAG, "Smart blur calibrated in ${elapsedMs}ms")
+            } catch (e: UnsatisfiedLinkError) {
+                Log.e(TAG, "Native library not available: ${e.message}")
+            }
+        }, "SmartBlurTuner")
+        thread.isDaemon = true
+        thread.priority = Thread.MIN_PRIORITY
+        thread.start()
+    }
+
+    /**
+     * 表的有效性标识：系统更新或 CPU 特性变化后重新校准
+     */
+    private fun fingerprint(): String {
+        return "${Build.FINGERPRINT}|${NativeGauss.cpuFeatures()}"
+    }
+}
@@ -0,0 +1,213 @@
+/**
+ * StreamingGaussianBlur - 流式 IIR 高斯模糊（按行条带输入 / 输出，工作内存有界）
+ *
+ * 用于壁纸 / 分享图等超大图像（如 4000×6000）：
+ * - 行条带从上到下依次 push，已完成的行随时 pull，整张图像不必同时驻留内存
+ * - 工作内存约 (B + L) × width × 4 字节（L = 4σ，线性模式 6σ；B = clamp(2L, 32, 256)），与图像高度无关
+ * - 结果与 NativeGauss.gaussianIIRInplace 对整张图像模糊相差不超过 1 LSB（sRGB 与线性模式相同，原理见 gauss_iir_stream.h）
+ *
+ * 使用示例：
+ * ```kotlin
+ * // 直接从 BitmapRegionDecoder 按条带解码、模糊、输出
+ * StreamingGaussianBlur.blurRegionDecoder(decoder, sigma = 25f) { strip, top, rows ->
+ *     // strip 的第 0 ~ rows 行为结果图像的第 top ~ top + rows 行（回调返回后 strip 会被复用）
+ * }
+ *
+ * // 或手动推进
+ * StreamingGaussianBlur(width, height, sigma = 25f).use { blur ->
+ *     var offset = 0
+ *     while (offset < strip.height) {
+ *         offset += blur.push(strip, offset)  // 输出没有取走时可能只接受一部分
+ *         while (blur.availableRows > 0) blur.pull(out)
+ *     }
+ * }
+ * ```
+ *
+ * 线程约束：同一个实例的调用须串行；σ 钳位到 50，≤ 0.1 时原样输出
+ */
+package com.example.blur
+
+import android.graphics.Bitmap
+import android.graphics.BitmapFactory
+import android.graphics.BitmapRegionDecoder
+import android.graphics.Rect
+import java.io.Closeable
+
+class StreamingGaussianBlur(
+    val width: Int,
+    val height: Int,
+    val sigma: Float,
+    val highQuality: Boolean = false
+) : Closeable {
+
+    companion object {
+        /**
+         * blurRegionDecoder 默认的条带高度（行）
+         */
+        const val DEFAULT_STRIP_HEIGHT = 256
+
+        init {
+            System.loadLibrary("nativegauss")
+        }
+
+        @JvmStatic
+        private external fun nativeCreate(width: Int, height: Int, sigma: Float, highQuality: Boolean): Long
+
+        @JvmStatic
+        private external fun nativeDestroy(handle: Long)
+
+        @JvmStatic
+        private external fun nativePush(handle: Long, strip: Bitmap, firstRow: Int, rowCount: Int): Int
+
+        @JvmStatic
+        private external fun nativePull(handle: Long, out: Bitmap, firstRow: Int, rowCount: Int): Int
+
+        @JvmStatic
+        private external fun nativeAvailable(handle: Long): Int
+
+        @JvmStatic
+        private external fun nativeMemoryBytes(handle: Long): Long
+
+        /**
+         * 按条带解码整张图像并流式模糊，结果按条带交给 sink
+         *
+         * 解码条带与输出条带各复用一个 stripHeight 行的 Bitmap，峰值内存与图像高度无关
+         *
+         * @param decoder 区域解码器（调用期间不要在其他线程使用）
+         * @param sigma 高斯标准差
+         * @param highQuality 是否在线性色彩空间处理
+         * @param stripHeight 条带高度（行）
+         * @param sink 结果回调：strip 的第 0 ~ rows 行对应结果图像的第 top ~ top + rows 行；
+         *             回调返回后 strip 会被覆盖，需要保留时自行复制
+         * @throws IllegalStateException 如果区域解码失败
+         */
+        @JvmStatic
+        fun blurRegionDecoder(
+            decoder: BitmapRegionDecoder,
+            sigma: Float,
+            highQuality: Boolean = false,
+            stripHeight: Int = DEFAULT_STRIP_HEIGHT,
+            sink: (strip: Bitmap, top: Int, rows: Int) -> Unit
+        ) {
+            require(stripHeight > 0) { "stripHeight must be positive" }
+            val width = decoder.width
+            val height = decoder.height
+            val options = BitmapFactory.Options().apply {
+                inPreferredConfig = Bitmap.Config.ARGB_8888
+                inMutable = true
+            }
+            val out = Bitmap.createBitmap(width, minOf(stripHeight, height), Bitmap.Config.ARGB_8888)
+
+            try {
+                StreamingGaussianBlur(width, height, sigma, highQuality).use { blur ->
+                    fun drain(): Int {
+                        var drained = 0
+                        while (true) {
+                            val top = blur.rowsPulled
+                            val rows = blur.pull(out)
+                            if (rows == 0) return drained
+                            sink(out, top, rows)
+                            drained += rows
+                        }
+                    }
+
+                    var top = 0
+                    while (top < height) {
+                        val rows = minOf(stripHeight, height - top)
+                        val strip = decoder.decodeRegion(Rect(0, top, width, top + rows), options)
+                            ?: throw IllegalStateException("Failed to decode rows $top..${top + rows}")
+                        options.inBitmap = strip
+
+                        var offset = 0
+                        while (offset < rows) {
+                            val accepted = blur.push(strip, offset, rows - offset)
+                            offset += accepted
+                            check(drain() > 0 || accepted > 0) { "Streaming blur stalled at row ${top + offset}" }
+                        }
+                        top += rows
+                    }
+                    drain()
+                }
+            } finally {
+                options.inBitmap?.recycle()
+                out.recycle()
+            }
+        }
+    }
+
+    init {
+        require(width > 0 && height > 0) { "Image size must be positive: ${width}x$height" }
+    }
+
+    private var handle: Long = nativeCreate(width, height, sigma, highQuality)
+
+    /**
+     * 已输入的行数
+     */
+    var rowsPushed = 0
+        private set
+
+    /**
+     * 已取走的行数
+     */
+    var rowsPulled = 0
+        private set
+
+    /**
+     * 已完成、可以取走的行数
+     */
+    val availableRows: Int
+        get() = if (handle == 0L) 0 else nativeAvailable(handle)
+
+    /**
+     * 原生工作内存（字节）
+     */
+    val workingMemoryBytes: Long
+        get() = if (handle == 0L) 0L else nativeMemoryBytes(handle)
+
+    /**
+     * 所有行是否都已取走
+     */
+    val isFinished: Boolean
+        get() = rowsPulled == height
+
+    /**
+     * 按从上到下的顺序输入 strip 的第 firstRow ~ firstRow + rowCount 行
+     *
+     * @param strip 行条带（ARGB_8888，宽度等于 width，可以是不可变 Bitmap）
+     * @return 接受的行数；已完成的行没有取走、环形缓冲已满时可能少于 rowCount，取走后再输入剩余行
+     * @throws IllegalArgumentException 如果 Bitmap 格式 / 宽度不匹配或行范围越界
+     */
+    fun push(strip: Bitmap, firstRow: Int = 0, rowCount: Int = strip.height - firstRow): Int {
+        require(strip.width == width) { "Strip width ${strip.width} != $width" }
+        check(handle != 0L) { "Streaming blur has been closed" }
+        val accepted = nativePush(handle, strip, firstRow, rowCount)
+        rowsPushed += accepted
+        return accepted
+    }
+
+    /**
+     * 按从上到下的顺序取走已完成的行，写入 out 的第 firstRow 行起
+     *
+     * @param out 输出条带（ARGB_8888，mutable，宽度等于 width）
+     * @param rowCount 最多取走的行数
+     * @return 写入的行数（没有已完成的行时为 0）
+     * @throws IllegalArgumentException 如果 Bitmap 格式 / 宽度不匹配或行范围越界
+     */
+    fun pull(out: Bitmap, firstRow: Int = 0, rowCount: Int = out.height - firstRow): Int {
+        require(out.width == width) { "Output width ${out.width} != $width" }
+        check(handle != 0L) { "Streaming blur has been closed" }
+        val pulled = nativePull(handle, out, firstRow, rowCount)
+        rowsPulled += pulled
+        return pulled
+    }
+
+    /**
+     * 释放原生缓冲（未取走的行被丢弃），重复调用无副作用
+     */
+    override fun close() {
+        if (handle == 0L) return
+        nativeDestroy(handle)
+        handle = 0L
+    }
+}
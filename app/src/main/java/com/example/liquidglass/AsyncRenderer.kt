@@ -1,161 +1,177 @@
 /**
- * 异步渲染器 - 双缓冲后台渲染系统
- * 
- * 将耗时的渲染操作移到后台线程，主线程只负责绘制已渲染好的结果
- * 性能提升：主线程不再阻塞，UI 始终流畅
+ * 异步渲染器 - 原生“最新请求优先”渲染队列的 Kotlin 封装
+ *
+ * 将玻璃效果管线移到原生调度线程执行，主线程只负责提交参数快照与绘制已完成的帧：
+ * - submit：复制背景 / 贴图 / 参数后立即返回，不加锁、不等待渲染
+ * - 渲染尚未开始的旧请求被新请求直接覆盖，只渲染最新的一个（触摸拖动时不会积压）
+ * - 输出三缓冲：acquire 随时取最新完成帧复制到结果 Bitmap，没有新帧时立即返回
+ * - 管线各阶段仍分发到共享原生线程池（见 render_queue.h）
+ *
+ * 使用示例：
+ * ```kotlin
+ * val renderer = AsyncRenderer()
+ * renderer.submit(backdrop, blurMode = NativeGlassPipeline.BLUR_IIR, sigma = 8f)  // 参数变化时
+ * if (renderer.acquire(result)) invalidate()                                     // 每帧
+ * if (renderer.hasPendingFrames) postInvalidateOnAnimation()                     // 继续等待新帧
+ * renderer.stop()
+ * ```
+ *
+ * 线程约束：submit / acquire 须在同一线程（通常为主线程）调用
  */
 package com.example.liquidglass
 
 import android.graphics.Bitmap
-import android.graphics.RectF
 import android.util.Log
-import java.util.concurrent.atomic.AtomicBoolean
-import java.util.concurrent.atomic.AtomicReference
-import kotlin.concurrent.thread
+import kotlin.math.abs
 
-/**
- * 异步渲染器
- * 
- * 使用双缓冲机制：
- * - 前台缓冲：主线程读取，用于绘制
- * - 后台缓冲：后台线程写入，渲染完成后与前台缓冲交换
- */
-class AsyncRenderer(
-    private val renderCallback: (RenderParams) -> Bitmap?
-) {
+class AsyncRenderer {
     companion object {
         private const val TAG = "AsyncRenderer"
+
+        init {
+            System.loadLibrary("nativegauss")
+        }
+
+        @JvmStatic
+        private external fun nativeCreate(): Long
+
+        @JvmStatic
+        private external fun nativeDestroy(handle: Long)
+
+        @JvmStatic
+        private external fun nativeSubmit(
+            handle: Long,
+            backdrop: Bitmap,
+            displacement: Bitmap?,
+            edgeDistance: Bitmap?,
+            normalMap: Bitmap?,
+            blurMode: Int,
+            sigma: Float,
+            highQuality: Boolean,
+            saturation: Float,
+            effect: Int,
+            scale: Float,
+            redOffset: Float,
+            greenOffset: Float,
+            blueOffset: Float,
+            refThickness: Float,
+            refFactor: Float,
+            refDispersion: Float,
+            dpr: Float,
+            useBilinear: Boolean
+        ): Long
+
+        @JvmStatic
+        private external fun nativeAcquire(handle: Long, result: Bitmap): Long
+
+        @JvmStatic
+        private external fun nativeStats(handle: Long): LongArray?
     }
-    
-    // 双缓冲
-    private val frontBuffer = AtomicReference<Bitmap?>(null)
-    private val backBuffer = AtomicReference<Bitmap?>(null)
-    
-    // 渲染状态
-    private val isRendering = AtomicBoolean(false)
-    private val shouldStop = AtomicBoolean(false)
-    private var renderThread: Thread? = null
-    
-    // 待渲染参数
-    private val pendingParams = AtomicReference<RenderParams?>(null)
-    
+
     /**
-     * 渲染参数
+     * 队列统计（自创建起累计）
+     *
+     * @property coalesced 渲染前被更新请求覆盖的请求数
+     * @property dropped 渲染完成但被更新帧覆盖、从未被取走的帧数
+     * @property lastRenderMs 最近一帧的渲染耗时
      */
-    data class RenderParams(
-        val bounds: RectF,
-        val blurRadius: Float,
-        val displacementScale: Float,
-        val aberrationIntensity: Float,
-        val timestamp: Long = System.currentTimeMillis()
+    data class Stats(
+        val submitted: Long,
+        val coalesced: Long,
+        val rendered: Long,
+        val dropped: Long,
+        val presented: Long,
+        val lastRenderMs: Float
     )
-    
+
+    private var handle: Long = nativeCreate()
+
+    // 最近提交 / 最近取走的请求序号
+    private var lastSubmitted = 0L
+    private var lastAcquired = 0L
+
     /**
-     * 请求异步渲染
-     * 
-     * @param params 渲染参数
-     * @return 当前可用的渲染结果（可能是上一帧的）
+     * 最新提交的请求是否还没有取走对应的帧
      */
-    fun requestRender(params: RenderParams): Bitmap? {
-        // 更新待渲染参数
-        pendingParams.set(params)
-        
-        // 如果后台线程空闲，启动渲染
-        if (!isRendering.get()) {
-            startRenderThread()
-        }
-        
-        // 返回当前前台缓冲（可能是上一帧的结果）
-        return frontBuffer.get()
-    }
-    
+    val hasPendingFrames: Boolean
+        get() = lastAcquired < lastSubmitted
+
     /**
-     * 获取当前可用的渲染结果
+     * 提交渲染请求（参数含义同 NativeGlassPipeline.render）
+     *
+     * 背景与贴图在调用内被复制，返回后即可回收或修改
+     *
+     * @return 是否已提交（队列已停止或创建失败时返回 false）
+     * @throws IllegalArgumentException 如果 Bitmap 格式 / 尺寸不满足要求，或缺少所选效果的贴图
      */
-    fun getCurrentFrame(): Bitmap? {
-        return frontBuffer.get()
+    fun submit(
+        backdrop: Bitmap,
+        blurMode: Int = NativeGlassPipeline.BLUR_SMART,
+        sigma: Float = 0f,
+        highQuality: Boolean = false,
+        saturation: Float = 1f,
+        effect: Int = NativeGlassPipeline.EFFECT_NONE,
+        displacement: Bitmap? = null,
+        scale: Float = 70f,
+        redOffset: Float = 0f,
+        greenOffset: Float = -0.05f,
+        blueOffset: Float = -0.1f,
+        edgeDistance: Bitmap? = null,
+        normalMap: Bitmap? = null,
+        refThickness: Float = 100f,
+        refFactor: Float = 1.5f,
+        refDispersion: Float = 7f,
+        dpr: Float = 1f,
+        useBilinear: Boolean = true
+    ): Boolean {
+        if (handle == 0L) return false
+        val sequence = nativeSubmit(
+            handle, backdrop, displacement, edgeDistance, normalMap,
+            blurMode, sigma, highQuality, saturation,
+            effect, scale, redOffset, greenOffset, blueOffset,
+            refThickness, refFactor, refDispersion, dpr,
+            useBilinear
+        )
+        if (sequence <= 0L) return false
+        lastSubmitted = sequence
+        return true
     }
-    
+
     /**
-     * 启动后台渲染线程
+     * 取最新完成帧复制到 result（不等待）
+     *
+     * @param result 结果 Bitmap（ARGB_8888, mutable，尺寸须与提交时的背景相同，否则该帧被丢弃）
+     * @return true 已复制新帧；false 没有新帧（result 保持不变）
      */
-    private fun startRenderThread() {
-        if (isRendering.compareAndSet(false, true)) {
-            renderThread = thread(name = "LiquidGlass-Renderer") {
-                try {
-                    renderLoop()
-                } catch (e: Exception) {
-                    Log.e(TAG, "渲染线程异常: ${e.message}", e)
-                } finally {
-                    isRendering.set(false)
-                }
-            }
-        }
+    fun acquire(result: Bitmap): Boolean {
+        if (handle == 0L) return false
+        val sequence = nativeAcquire(handle, result)
+        if (sequence == 0L) return false
+        lastAcquired = abs(sequence)
+        return sequence > 0L
     }
-    
+
     /**
-     * 渲染循环
+     * 读取队列统计；已停止时返回 null
      */
-    private fun renderLoop() {
-        while (!shouldStop.get()) {
-            // 获取待渲染参数
-            val params = pendingParams.getAndSet(null)
-
-            if (params == null) {
-                // 没有待渲染任务，退出循环
-                break
-            }
-
-            // 执行渲染
-            val startTime = System.nanoTime()
-            val result = try {
-                renderCallback(params)
-            } catch (e: Exception) {
-                Log.e(TAG, "渲染失败: ${e.message}", e)
-                null
-            }
-            val duration = (System.nanoTime() - startTime) / 1_000_000f
-
-            if (result != null) {
-                // ✅ 安全的缓冲交换：
-                // 1. 将新结果放入后台缓冲
-                val oldBackBuffer = backBuffer.getAndSet(result)
-
-                // 2. 交换前后台缓冲（原子操作）
-                val oldFrontBuffer = frontBuffer.getAndSet(result)
-
-                // 3. 回收旧的前台缓冲（主线程已经不再使用）
-                // 注意：不要回收 oldBackBuffer，因为它现在是 oldFrontBuffer
-                if (oldFrontBuffer != null && oldFrontBuffer != oldBackBuffer) {
-                    oldFrontBuffer.recycle()
-                }
-
-                Log.d(TAG, "异步渲染完成: ${duration}ms")
-            }
-        }
+    fun stats(): Stats? {
+        if (handle == 0L) return null
+        val raw = nativeStats(handle) ?: return null
+        return Stats(raw[0], raw[1], raw[2], raw[3], raw[4], raw[5] / 1_000_000f)
     }
-    
+
     /**
-     * 停止渲染并清理资源
+     * 停止渲染并释放原生队列（不等待进行中的渲染）
      */
     fun stop() {
-        shouldStop.set(true)
-        
-        // 等待渲染线程结束
-        renderThread?.join(1000)
-        
-        // 清理缓冲
-        frontBuffer.getAndSet(null)?.recycle()
-        backBuffer.getAndSet(null)?.recycle()
-        
-        Log.d(TAG, "异步渲染器已停止")
-    }
-    
-    /**
-     * 检查是否正在渲染
-     */
-    fun isRendering(): Boolean {
-        return isRendering.get()
+        if (handle == 0L) return
+        stats()?.let {
+            Log.d(TAG, "异步渲染器已停止: 提交 ${it.submitted}, 合并 ${it.coalesced}, " +
+                    "渲染 ${it.rendered}, 丢弃 ${it.dropped}, 显示 ${it.presented}")
+        }
+        nativeDestroy(handle)
+        handle = 0L
+        lastSubmitted = 0L
+        lastAcquired = 0L
     }
 }
-
@@ -53,9 +53,8 @@ enum class BlurMethod {
     /**
      * 智能选择（推荐）
      * - 根据图像尺寸和模糊强度自动选择最优算法
-     * - 小图 → Box3
-     * - NEON 可用 → IIR NEON
-     * - 其他 → IIR 标量
+     * - 按交叉点表选择 Box3 / IIR / 金字塔（SmartBlurTuner 校准后按本机实测结果）
+     * - 未校准：小图 → Box3，其他 → IIR（FP16 / NEON / 标量）
      */
     SMART,
 
@@ -65,6 +64,14 @@ enum class BlurMethod {
      * - 适合强模糊场景（σ > 15）
      * - 性能提升 2-5×
      */
-    DOWNSAMPLE
+    DOWNSAMPLE,
+
+    /**
+     * 多级金字塔模糊（大半径推荐）
+     * - 逐级 2× 降采样 → 最小一级 IIR → 逐级 2× 上采样
+     * - 耗时基本与 σ 无关，混叠远小于单级下采样
+     * - 与同 σ 的 IIR 模糊程度一致
+     */
+    PYRAMID
 }
 
@@ -18,6 +18,7 @@ package com.example.liquidglass
 
 import android.graphics.*
 import android.util.Log
+import com.example.blur.NativeGauss
 import kotlin.math.roundToInt
 
 /**
@@ -138,11 +139,7 @@ class ChromaticAberrationEffect {
             // ✅ 从对象池获取 Bitmap
             val smallSource = if (downscale < 1.0f) {
                 val temp = bitmapPool.get(processWidth, processHeight, Bitmap.Config.ARGB_8888)
-                val canvas = Canvas(temp)
-                val paint = Paint(Paint.ANTI_ALIAS_FLAG or Paint.FILTER_BITMAP_FLAG)  // ✅ 添加过滤
-                val srcRect = Rect(0, 0, source.width, source.height)
-                val dstRect = Rect(0, 0, processWidth, processHeight)
-                canvas.drawBitmap(source, srcRect, dstRect, paint)
+                NativeGauss.scaleInto(source, temp)  // ✅ 原生定点双线性缩放
                 temp
             } else {
                 source.copy(Bitmap.Config.ARGB_8888, true) ?: source
@@ -151,11 +148,7 @@ class ChromaticAberrationEffect {
             // 缩放位移贴图到处理尺寸
             val scaledMap = if (displacementMap.width != processWidth || displacementMap.height != processHeight) {
                 val temp = bitmapPool.get(processWidth, processHeight, Bitmap.Config.ARGB_8888)
-                val canvas = Canvas(temp)
-                val paint = Paint(Paint.ANTI_ALIAS_FLAG or Paint.FILTER_BITMAP_FLAG)  // ✅ 添加过滤
-                val srcRect = Rect(0, 0, displacementMap.width, displacementMap.height)
-                val dstRect = Rect(0, 0, processWidth, processHeight)
-                canvas.drawBitmap(displacementMap, srcRect, dstRect, paint)
+                NativeGauss.scaleInto(displacementMap, temp)
                 temp
             } else {
                 displacementMap.copy(Bitmap.Config.ARGB_8888, true) ?: displacementMap
@@ -195,11 +188,7 @@ class ChromaticAberrationEffect {
             // ✅ 放大回原始尺寸（使用双线性插值平滑放大）
             val finalResult = if (downscale < 1.0f) {
                 val upscaled = bitmapPool.get(originalWidth, originalHeight, Bitmap.Config.ARGB_8888)
-                val canvas = Canvas(upscaled)
-                val paint = Paint(Paint.ANTI_ALIAS_FLAG or Paint.FILTER_BITMAP_FLAG)
-                val srcRect = Rect(0, 0, processWidth, processHeight)
-                val dstRect = Rect(0, 0, originalWidth, originalHeight)
-                canvas.drawBitmap(result, srcRect, dstRect, paint)
+                NativeGauss.scaleInto(result, upscaled)
                 bitmapPool.put(result)
                 upscaled
             } else {
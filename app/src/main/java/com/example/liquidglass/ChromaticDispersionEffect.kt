@@ -25,6 +25,7 @@ import android.graphics.PorterDuff
 import android.graphics.PorterDuffXfermode
 import android.graphics.RectF
 import android.util.Log
+import com.example.blur.NativeGauss
 import kotlin.math.min
 
 /**
@@ -87,6 +88,10 @@ class ChromaticDispersionEffect {
     private var cachedNormalMap: Bitmap? = null
     private var cachedSize = Pair(0, 0)
 
+    // 融合管线使用的边缘距离贴图（按尺寸 + 圆角半径缓存）
+    private var pipelineEdgeMap: Bitmap? = null
+    private var pipelineEdgeKey = Triple(0, 0, -1f)
+
     /**
      * 应用色散效果
      *
@@ -117,7 +122,7 @@ class ChromaticDispersionEffect {
         Log.d(TAG, "Processing ${source.width}x${source.height} -> ${processWidth}x${processHeight} (downscale=$downscale)")
 
         val smallSource = if (downscale < 1.0f) {
-            Bitmap.createScaledBitmap(source, processWidth, processHeight, true)
+            NativeGauss.scaleBitmap(source, processWidth, processHeight)
         } else {
             source
         }
@@ -134,29 +139,23 @@ class ChromaticDispersionEffect {
         }
 
         // 生成或复用边缘距离贴图（基于 Alpha 通道检测边缘）
-        val edgeMap = if (cachedEdgeMap != null && cachedSize == Pair(processWidth, processHeight)) {
-            cachedEdgeMap!!
-        } else {
-            Log.d(TAG, "Generating edge distance map from alpha channel...")
-            val map = DispersionMapGenerator.generateEdgeDistanceMapFromAlpha(clippedSource)
+        // 需要法线贴图时一次遍历同时生成两者，法线沿轮廓向外
+        val sizeMatches = cachedSize == Pair(processWidth, processHeight)
+        if (cachedEdgeMap == null || !sizeMatches || (useNormalMap && cachedNormalMap == null)) {
+            Log.d(TAG, "Generating edge maps from alpha channel (normals=$useNormalMap)...")
+            val (map, normals) = DispersionMapGenerator.generateEdgeMapsFromAlpha(clippedSource, useNormalMap)
+            cachedEdgeMap?.recycle()
+            cachedNormalMap?.recycle()
             cachedEdgeMap = map
-            cachedSize = Pair(processWidth, processHeight)
-            map
-        }
-
-        // 生成或复用法线贴图（如果需要）
-        val normalMap = if (useNormalMap) {
-            if (cachedNormalMap != null && cachedSize == Pair(processWidth, processHeight)) {
-                cachedNormalMap!!
+            cachedNormalMap = if (useNormalMap) {
+                normals ?: DispersionMapGenerator.generateRadialNormalMap(processWidth, processHeight)
             } else {
-                Log.d(TAG, "Generating normal map...")
-                val map = DispersionMapGenerator.generateRadialNormalMap(processWidth, processHeight)
-                cachedNormalMap = map
-                map
+                null
             }
-        } else {
-            null
+            cachedSize = Pair(processWidth, processHeight)
         }
+        val edgeMap = cachedEdgeMap!!
+        val normalMap = if (useNormalMap) cachedNormalMap else null
 
         // 创建结果 Bitmap
         val result = Bitmap.createBitmap(processWidth, processHeight, Bitmap.Config.ARGB_8888)
@@ -178,7 +177,7 @@ class ChromaticDispersionEffect {
 
         // 上采样回原始分辨率
         val finalResult = if (downscale < 1.0f) {
-            val upscaled = Bitmap.createScaledBitmap(result, source.width, source.height, true)
+            val upscaled = NativeGauss.scaleBitmap(result, source.width, source.height)
             result.recycle()
             upscaled
         } else {
@@ -234,6 +233,37 @@ class ChromaticDispersionEffect {
         }
     }
 
+    /**
+     * 获取指定尺寸的边缘距离贴图（供 NativeGlassPipeline 使用）
+     *
+     * 与 apply() 相同，边缘由圆角矩形的 Alpha 轮廓决定；贴图只取决于尺寸和圆角半径，
+     * 参数不变时复用缓存，不随每帧背景重新生成
+     *
+     * @param width 处理宽度
+     * @param height 处理高度
+     * @param cornerRadius 圆角半径（处理尺寸下的像素，0 = 矩形）
+     * @return 边缘距离贴图（由本对象持有，调用方不要回收）
+     */
+    fun edgeDistanceMap(width: Int, height: Int, cornerRadius: Float): Bitmap {
+        val clampedRadius = min(cornerRadius, min(width, height) / 2f)
+        val key = Triple(width, height, clampedRadius)
+        pipelineEdgeMap?.let {
+            if (pipelineEdgeKey == key && !it.isRecycled) return it
+        }
+
+        val mask = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
+        mask.eraseColor(android.graphics.Color.WHITE)
+        val clipped = if (clampedRadius > 0) applyRoundedCornerClip(mask, clampedRadius) else mask
+        val map = DispersionMapGenerator.generateEdgeDistanceMapFromAlpha(clipped)
+        if (clipped != mask) clipped.recycle()
+        mask.recycle()
+
+        pipelineEdgeMap?.recycle()
+        pipelineEdgeMap = map
+        pipelineEdgeKey = key
+        return map
+    }
+
     /**
      * 应用圆角裁剪（设置圆角外的像素为透明）
      *
@@ -268,7 +298,7 @@ class ChromaticDispersionEffect {
     }
 
     /**
-     * 清理缓存的贴图
+     * 清理缓存的贴图（含原生径向法线表）
      */
     fun clearCache() {
         cachedEdgeMap?.recycle()
@@ -276,6 +306,10 @@ class ChromaticDispersionEffect {
         cachedNormalMap?.recycle()
         cachedNormalMap = null
         cachedSize = Pair(0, 0)
+        pipelineEdgeMap?.recycle()
+        pipelineEdgeMap = null
+        pipelineEdgeKey = Triple(0, 0, -1f)
+        NativeChromaticDispersion.releaseCache()
     }
 
     /**
@@ -19,7 +19,6 @@ import android.util.Log
 import kotlin.math.sqrt
 import kotlin.math.min
 import kotlin.math.max
-import kotlin.math.abs
 
 /**
  * 色散贴图生成器
@@ -28,6 +27,9 @@ object DispersionMapGenerator {
 
     private const val TAG = "DispersionMapGenerator"
 
+    // Alpha 低于此值视为透明（边缘外）
+    private const val ALPHA_THRESHOLD = 10
+
     /**
      * 形状类型
      */
@@ -40,55 +42,74 @@ object DispersionMapGenerator {
     /**
      * 从源图像生成边缘距离贴图（基于 Alpha 通道）
      *
-     * 检测 Alpha 通道来识别实际的元素边缘，计算每个像素到最近边缘的距离
+     * 检测 Alpha 通道来识别实际的元素边缘，计算每个像素到最近透明像素（或图像边界）的欧氏距离
      * 适用于已裁剪成圆角形状的图像（圆角外的像素为透明）
      *
+     * 优先使用原生实现（精确距离变换，O(W×H)）；原生库不可用时回退到 Kotlin 实现
+     *
      * @param source 源图像（必须包含 Alpha 通道）
      * @return 边缘距离贴图（灰度图，0=边缘，255=中心）
      */
     fun generateEdgeDistanceMapFromAlpha(source: Bitmap): Bitmap {
+        return generateEdgeMapsFromAlpha(source, withNormalMap = false).first
+    }
+
+    /**
+     * 从源图像生成边缘距离贴图与法线贴图（基于 Alpha 通道，一次遍历）
+     *
+     * 法线从像素指向最近的边缘点（向外），格式与 generateRadialNormalMap 相同
+     *
+     * @param source 源图像（必须包含 Alpha 通道）
+     * @param withNormalMap 是否同时生成法线贴图
+     * @return Pair(边缘距离贴图, 法线贴图)；withNormalMap = false 或原生库不可用时法线贴图为 null
+     */
+    fun generateEdgeMapsFromAlpha(
+        source: Bitmap,
+        withNormalMap: Boolean = true
+    ): Pair<Bitmap, Bitmap?> {
         val width = source.width
         val height = source.height
-        val bitmap = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
-
-        Log.d(TAG, "Generating edge distance map from alpha channel: ${width}x${height}")
-
-        // 第一步：检测边缘像素（Alpha < 255 或相邻像素 Alpha 变化大）
-        val edgePixels = mutableListOf<Pair<Int, Int>>()
-        for (y in 0 until height) {
-            for (x in 0 until width) {
-                val pixel = source.getPixel(x, y)
-                val alpha = Color.alpha(pixel)
-
-                // 检测边缘：Alpha < 255 或者相邻像素 Alpha 不同
-                val isEdge = alpha < 255 || isAlphaEdge(source, x, y)
-                if (isEdge) {
-                    edgePixels.add(Pair(x, y))
-                }
-            }
+        val edgeMap = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
+        val normalMap = if (withNormalMap) Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888) else null
+
+        val input = if (source.config == Bitmap.Config.ARGB_8888) source else source.copy(Bitmap.Config.ARGB_8888, false)
+        try {
+            NativeChromaticDispersion.generateEdgeMaps(input, edgeMap, normalMap, ALPHA_THRESHOLD, 0f)
+            return Pair(edgeMap, normalMap)
+        } catch (e: UnsatisfiedLinkError) {
+            Log.w(TAG, "Native edge map generator unavailable, falling back to Kotlin", e)
+        } finally {
+            if (input !== source) input.recycle()
         }
 
-        Log.d(TAG, "Detected ${edgePixels.size} edge pixels")
+        edgeMap.recycle()
+        normalMap?.recycle()
+        return Pair(generateEdgeDistanceMapFromAlphaKotlin(source), null)
+    }
 
-        // 如果没有检测到边缘，返回全白图（所有像素都是中心）
-        if (edgePixels.isEmpty()) {
-            bitmap.eraseColor(Color.WHITE)
-            Log.w(TAG, "No edge pixels detected, returning white map")
-            return bitmap
-        }
+    /**
+     * Kotlin 回退实现（到矩形边界的距离，透明像素为 0）
+     *
+     * 整行批量读写像素，避免逐像素 getPixel / setPixel
+     */
+    private fun generateEdgeDistanceMapFromAlphaKotlin(source: Bitmap): Bitmap {
+        val width = source.width
+        val height = source.height
+        val bitmap = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
+
+        Log.d(TAG, "Generating edge distance map from alpha channel: ${width}x${height}")
 
-        // 第二步：使用快速算法计算距离场
-        // 使用简化的距离场算法（基于矩形边界 + Alpha 检测）
         val maxDist = sqrt((width * width + height * height).toFloat()) / 2f
+        val pixels = IntArray(width * height)
+        source.getPixels(pixels, 0, width, 0, 0, width, height)
 
         for (y in 0 until height) {
             for (x in 0 until width) {
-                val pixel = source.getPixel(x, y)
-                val alpha = Color.alpha(pixel)
+                val index = y * width + x
 
                 // 如果像素是透明的，距离为 0（边缘外）
-                if (alpha < 10) {
-                    bitmap.setPixel(x, y, Color.rgb(0, 0, 0))
+                if (Color.alpha(pixels[index]) < ALPHA_THRESHOLD) {
+                    pixels[index] = Color.rgb(0, 0, 0)
                     continue
                 }
 
@@ -102,44 +123,15 @@ object DispersionMapGenerator {
 
                 // 归一化到 [0, 255]
                 val normalizedDistance = (minDistance / maxDist * 255f).coerceIn(0f, 255f).toInt()
-
-                bitmap.setPixel(x, y, Color.rgb(normalizedDistance, normalizedDistance, normalizedDistance))
+                pixels[index] = Color.rgb(normalizedDistance, normalizedDistance, normalizedDistance)
             }
         }
 
+        bitmap.setPixels(pixels, 0, width, 0, 0, width, height)
         Log.d(TAG, "Edge distance map generated successfully")
         return bitmap
     }
 
-    /**
-     * 检测像素是否在 Alpha 边缘上
-     */
-    private fun isAlphaEdge(source: Bitmap, x: Int, y: Int): Boolean {
-        val width = source.width
-        val height = source.height
-        val centerAlpha = Color.alpha(source.getPixel(x, y))
-
-        // 检查 4 个相邻像素
-        val neighbors = listOf(
-            Pair(x - 1, y),
-            Pair(x + 1, y),
-            Pair(x, y - 1),
-            Pair(x, y + 1)
-        )
-
-        for ((nx, ny) in neighbors) {
-            if (nx in 0 until width && ny in 0 until height) {
-                val neighborAlpha = Color.alpha(source.getPixel(nx, ny))
-                // 如果相邻像素 Alpha 差异大于 10，认为是边缘
-                if (abs(centerAlpha - neighborAlpha) > 10) {
-                    return true
-                }
-            }
-        }
-
-        return false
-    }
-
     /**
      * 生成边缘距离贴图
      *
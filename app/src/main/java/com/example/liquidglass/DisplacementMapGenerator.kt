@@ -13,6 +13,7 @@ package com.example.liquidglass
 
 import android.graphics.Bitmap
 import android.graphics.Color
+import android.util.Log
 import kotlin.math.*
 
 /**
@@ -40,10 +41,24 @@ class DisplacementMapGenerator(
     /**
      * 生成位移贴图
      * 
+     * 优先使用原生实现（NEON + 多线程）；原生库不可用时回退到 Kotlin 实现
+     * 
      * @param mode 位移模式
      * @return 位移贴图 Bitmap
      */
     fun generate(mode: DisplacementMode = DisplacementMode.STANDARD): Bitmap {
+        try {
+            return NativeDisplacementMap.generate(width, height, mode)
+        } catch (e: UnsatisfiedLinkError) {
+            Log.w(TAG, "Native displacement map unavailable, falling back to Kotlin", e)
+        }
+        return generateKotlin(mode)
+    }
+    
+    /**
+     * Kotlin 实现（逐像素执行片段着色器）
+     */
+    private fun generateKotlin(mode: DisplacementMode): Bitmap {
         val bitmap = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
         
         // 第一遍:计算原始位移值
@@ -209,6 +224,8 @@ class DisplacementMapGenerator(
     }
     
     companion object {
+        private const val TAG = "DisplacementMapGenerator"
+        
         /**
          * 预生成标准尺寸的位移贴图
          */
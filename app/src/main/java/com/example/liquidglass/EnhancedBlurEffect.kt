@@ -29,8 +29,10 @@
 package com.example.liquidglass
 
 import android.graphics.*
+import android.os.Build
 import android.util.Log
 import android.view.View
+import androidx.annotation.RequiresApi
 import com.example.blur.NativeGauss
 import kotlin.math.roundToInt
 
@@ -94,21 +96,63 @@ class EnhancedBlurEffect(
      */
     fun captureBackdrop(bounds: RectF): Bitmap? {
         val parent = view.parent as? View ?: return null
+        val captureBounds = captureBoundsFor(bounds)
 
+        // 创建背景 Bitmap
+        val width = captureBounds.width().toInt().coerceAtLeast(1)
+        val height = captureBounds.height().toInt().coerceAtLeast(1)
+        val backdrop = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
+        drawBackdrop(Canvas(backdrop), parent, captureBounds)
+        return backdrop
+    }
+
+    /**
+     * 捕获视图背后的背景到 HardwareBuffer（零拷贝路径，GPU 绘制，见 HardwareBufferRenderer）
+     *
+     * @param bounds 视图边界
+     * @param renderer 零拷贝渲染器（捕获尺寸 = 捕获区域 × scale）
+     * @param scale 处理尺寸相对捕获区域的比例（全局下采样）
+     * @return 是否已提交捕获；不支持时返回 false，调用方回退到 captureBackdrop
+     */
+    @RequiresApi(Build.VERSION_CODES.Q)
+    fun captureBackdropHardware(bounds: RectF, renderer: HardwareBufferRenderer, scale: Float = 1f): Boolean {
+        val parent = view.parent as? View ?: return false
+        val captureBounds = captureBoundsFor(bounds)
+
+        // 与 captureBackdrop + 全局下采样得到的处理尺寸一致
+        val captureWidth = captureBounds.width().toInt().coerceAtLeast(1)
+        val captureHeight = captureBounds.height().toInt().coerceAtLeast(1)
+        val width = (captureWidth * scale).toInt().coerceAtLeast(1)
+        val height = (captureHeight * scale).toInt().coerceAtLeast(1)
+        val canvas = renderer.beginCapture(width, height) ?: return false
+        try {
+            // 硬件 Surface 不会自动清屏，先清除上一轮缓冲中的内容
+            canvas.drawColor(Color.TRANSPARENT, PorterDuff.Mode.CLEAR)
+            canvas.scale(width.toFloat() / captureWidth, height.toFloat() / captureHeight)
+            drawBackdrop(canvas, parent, captureBounds)
+        } finally {
+            renderer.endCapture(canvas)
+        }
+        return true
+    }
+
+    /**
+     * 计算实际捕获区域（视图坐标）
+     */
+    fun captureBoundsFor(bounds: RectF): RectF {
         // ✅ 优化捕获范围：根据是否启用优化捕获来决定捕获区域
-        val captureBounds = if (enableOptimizedCapture && cornerRadius > 0) {
+        return if (enableOptimizedCapture && cornerRadius > 0) {
             // 计算实际需要捕获的最小矩形区域（考虑圆角和模糊扩散）
             calculateOptimizedBounds(bounds)
         } else {
             bounds
         }
+    }
 
-        // 创建背景 Bitmap
-        val width = captureBounds.width().toInt().coerceAtLeast(1)
-        val height = captureBounds.height().toInt().coerceAtLeast(1)
-        val backdrop = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
-        val canvas = Canvas(backdrop)
-
+    /**
+     * 把父视图（不含当前视图）在捕获区域内的内容画到 canvas 原点
+     */
+    private fun drawBackdrop(canvas: Canvas, parent: View, captureBounds: RectF) {
         try {
             // 获取视图在父容器中的实际位置
             val location = IntArray(2)
@@ -150,8 +194,6 @@ class EnhancedBlurEffect(
             // 如果捕获失败，返回半透明白色背景
             canvas.drawColor(android.graphics.Color.argb(200, 255, 255, 255))
         }
-
-        return backdrop
     }
 
     /**
@@ -179,29 +221,49 @@ class EnhancedBlurEffect(
     /**
      * 应用模糊和饱和度效果
      *
+     * contentHash 非 0 时先查原生模糊结果缓存：相同背景、相同方法与参数直接复制缓存结果，跳过滤波
+     *
+     * 饱和度：支持融合的模糊方式（见 supportsFusedColorMatrix）把饱和度矩阵交给原生滤波器，
+     * 在最终打包前一并套用，省去单独一遍 Canvas 绘制和一张整帧 Bitmap
+     *
      * @param backdrop 原始背景
      * @param blurRadius 模糊半径 (0-25)
      * @param saturation 饱和度 (100 = 原始, 140 = 增强 40%)
+     * @param contentHash 背景内容哈希（NativeGlassPipeline.hashBitmap；0 = 不使用缓存）
      * @return 处理后的背景
      */
     fun applyEffect(
         backdrop: Bitmap,
         blurRadius: Float,
-        saturation: Float
+        saturation: Float,
+        contentHash: Long = 0L
     ): Bitmap {
+        val useCache = contentHash != 0L && blurRadius > 0f
+        if (useCache) {
+            loadCachedEffect(backdrop, contentHash, blurRadius, saturation)?.let { return it }
+        }
+
         var result = backdrop
         var intermediate: Bitmap? = null
 
-        // 1. 应用模糊
+        // 饱和度能否融合进模糊
+        val fuseSaturation = saturation != 100f && blurRadius > 0f && supportsFusedColorMatrix()
+        val saturationMatrix = if (fuseSaturation) {
+            ColorMatrix().apply { setSaturation(saturation / 100f) }.array
+        } else {
+            null
+        }
+
+        // 1. 应用模糊（可融合饱和度）
         if (blurRadius > 0f) {
-            result = applyBlur(result, blurRadius)
+            result = applyBlur(result, blurRadius, saturationMatrix)
             if (result != backdrop) {
                 intermediate = result  // 保存中间结果以便后续回收
             }
         }
 
-        // 2. 应用饱和度
-        if (saturation != 100f) {
+        // 2. 应用饱和度（未融合时单独处理）
+        if (saturation != 100f && !fuseSaturation) {
             val saturated = applySaturation(result, saturation / 100f)
             // 如果有中间结果且不是最终结果，回收它
             if (intermediate != null && saturated != intermediate) {
@@ -210,33 +272,114 @@ class EnhancedBlurEffect(
             result = saturated
         }
 
+        // 查找时按背景尺寸取键，尺寸不同的结果存入也无法命中
+        if (useCache && result != backdrop && result.width == backdrop.width && result.height == backdrop.height) {
+            storeCachedEffect(result, contentHash, blurRadius, saturation)
+        }
+
         return result
     }
+
+    /**
+     * 当前模糊方式的原生滤波器能否融合颜色矩阵
+     *
+     * Kotlin Box Blur 与金字塔模糊没有融合入口，仍单独执行饱和度
+     */
+    private fun supportsFusedColorMatrix(): Boolean = when (blurMethod) {
+        BlurMethod.BOX_BLUR_CPP,
+        BlurMethod.IIR_GAUSSIAN_NEON,
+        BlurMethod.BOX3,
+        BlurMethod.SMART,
+        BlurMethod.DOWNSAMPLE -> true
+        BlurMethod.BOX_BLUR,
+        BlurMethod.IIR_GAUSSIAN,
+        BlurMethod.PYRAMID -> false
+    }
+
+    /**
+     * 缓存键中的模糊方式：每种 BlurMethod 一个自定义值（与管线结果区分）
+     */
+    private fun cacheMethod(): Int = NativeGlassPipeline.BLUR_CACHE_CUSTOM_METHOD + blurMethod.ordinal
+
+    /**
+     * 缓存键中的其余选项：highQuality 与下采样倍数
+     */
+    private fun cacheVariant(): Int = (if (highQuality) 1 else 0) or (downsampleScale shl 1)
+
+    /**
+     * 从原生缓存取出结果（未命中时不分配 Bitmap）
+     */
+    private fun loadCachedEffect(backdrop: Bitmap, hash: Long, blurRadius: Float, saturation: Float): Bitmap? {
+        val sigma = blurSigma(blurRadius)
+        val factor = saturation / 100f
+        return try {
+            if (!NativeGlassPipeline.blurCacheContains(
+                    hash, backdrop.width, backdrop.height, cacheMethod(), cacheVariant(), sigma, factor)) {
+                return null
+            }
+            val cached = Bitmap.createBitmap(backdrop.width, backdrop.height, Bitmap.Config.ARGB_8888)
+            if (NativeGlassPipeline.blurCacheLookup(hash, cacheMethod(), cacheVariant(), sigma, factor, cached)) {
+                cached
+            } else {
+                // 检查与复制之间被其他线程淘汰
+                cached.recycle()
+                null
+            }
+        } catch (e: Exception) {
+            Log.e(TAG, "Blur cache lookup failed: ${e.message}")
+            null
+        }
+    }
+
+    /**
+     * 把结果存入原生缓存（只缓存 ARGB_8888 结果）
+     */
+    private fun storeCachedEffect(result: Bitmap, hash: Long, blurRadius: Float, saturation: Float) {
+        if (result.config != Bitmap.Config.ARGB_8888) return
+        try {
+            NativeGlassPipeline.blurCacheStore(
+                hash, cacheMethod(), cacheVariant(), blurSigma(blurRadius), saturation / 100f, result)
+        } catch (e: Exception) {
+            Log.e(TAG, "Blur cache store failed: ${e.message}")
+        }
+    }
     
     /**
      * 应用模糊效果（根据选择的方法）
      *
      * @param bitmap 原始图像
      * @param radius 模糊半径 (0-25)
+     * @param colorMatrix 融合套用的颜色矩阵（ColorMatrix.array；null 表示不套用）
      * @return 模糊后的图像
      */
-    private fun applyBlur(bitmap: Bitmap, radius: Float): Bitmap {
+    private fun applyBlur(bitmap: Bitmap, radius: Float, colorMatrix: FloatArray? = null): Bitmap {
         val clampedRadius = radius.coerceIn(0f, 25f)
 
         // 转换为 σ 值（用于 IIR 高斯）
-        val sigma = clampedRadius * RADIUS_TO_SIGMA
+        val sigma = blurSigma(clampedRadius)
 
         return when (blurMethod) {
             BlurMethod.BOX_BLUR -> applyBoxBlur(bitmap, clampedRadius)
-            BlurMethod.BOX_BLUR_CPP -> applyBoxBlurCpp(bitmap, clampedRadius)
-            BlurMethod.IIR_GAUSSIAN -> applyIIRGaussian(bitmap, sigma)
-            BlurMethod.IIR_GAUSSIAN_NEON -> applyIIRGaussianNeon(bitmap, sigma)
-            BlurMethod.BOX3 -> applyBox3(bitmap, sigma)
-            BlurMethod.SMART -> applySmartBlur(bitmap, sigma)
-            BlurMethod.DOWNSAMPLE -> applyDownsampleBlur(bitmap, sigma)
+            BlurMethod.BOX_BLUR_CPP -> applyBoxBlurCpp(bitmap, clampedRadius, colorMatrix)
+            BlurMethod.IIR_GAUSSIAN -> applyIIRGaussian(bitmap, sigma, colorMatrix)
+            BlurMethod.IIR_GAUSSIAN_NEON -> applyIIRGaussianNeon(bitmap, sigma, colorMatrix)
+            BlurMethod.BOX3 -> applyBox3(bitmap, sigma, colorMatrix)
+            BlurMethod.SMART -> applySmartBlur(bitmap, sigma, colorMatrix)
+            BlurMethod.DOWNSAMPLE -> applyDownsampleBlur(bitmap, sigma, colorMatrix)
+            BlurMethod.PYRAMID -> applyPyramidBlur(bitmap, sigma)
         }
     }
     
+    /**
+     * 模糊半径转换为 σ（与 applyEffect 使用相同的钳位与换算）
+     *
+     * @param radius 模糊半径 (0-25)
+     * @return 对应的 σ 值
+     */
+    fun blurSigma(radius: Float): Float {
+        return radius.coerceIn(0f, 25f) * RADIUS_TO_SIGMA
+    }
+
     /**
      * 传统 Box Blur（使用 AdvancedFastBlur - Kotlin 实现）
      */
@@ -251,7 +394,7 @@ class EnhancedBlurEffect(
     /**
      * C++ Box Blur（使用 C++ 原生实现）
      */
-    private fun applyBoxBlurCpp(bitmap: Bitmap, radius: Float): Bitmap {
+    private fun applyBoxBlurCpp(bitmap: Bitmap, radius: Float, colorMatrix: FloatArray? = null): Bitmap {
         // 创建可编辑副本
         val mutableBitmap = bitmap.copy(Bitmap.Config.ARGB_8888, true)
 
@@ -259,12 +402,13 @@ class EnhancedBlurEffect(
             NativeGauss.advancedBoxBlurInplace(
                 bitmap = mutableBitmap,
                 radius = radius,
-                downscale = 0.5f  // 降采样 50%
+                downscale = 0.5f,  // 降采样 50%
+                colorMatrix = colorMatrix
             )
         } catch (e: Exception) {
             Log.e(TAG, "C++ Box Blur failed: ${e.message}")
             // 回退到 Kotlin Box Blur
-            return applyBoxBlur(bitmap, radius)
+            return withColorMatrix(applyBoxBlur(bitmap, radius), bitmap, colorMatrix)
         }
 
         return mutableBitmap
@@ -273,16 +417,19 @@ class EnhancedBlurEffect(
     /**
      * IIR 递归高斯模糊（标量版本）
      */
-    private fun applyIIRGaussian(bitmap: Bitmap, sigma: Float): Bitmap {
+    private fun applyIIRGaussian(bitmap: Bitmap, sigma: Float, colorMatrix: FloatArray? = null): Bitmap {
         // 创建可编辑副本
         val mutableBitmap = bitmap.copy(Bitmap.Config.ARGB_8888, true)
         
         try {
             NativeGauss.gaussianIIRInplace(mutableBitmap, sigma, highQuality)
+            // 标量版本无融合入口，模糊后单独套用
+            colorMatrix?.let { NativeGauss.colorMatrixInplace(mutableBitmap, it) }
         } catch (e: Exception) {
             Log.e(TAG, "IIR Gaussian blur failed: ${e.message}")
             // 回退到 Box Blur
-            return applyBoxBlur(bitmap, sigma * 3f)
+            mutableBitmap.recycle()
+            return withColorMatrix(applyBoxBlur(bitmap, sigma * 3f), bitmap, colorMatrix)
         }
         
         return mutableBitmap
@@ -291,21 +438,22 @@ class EnhancedBlurEffect(
     /**
      * IIR 递归高斯模糊（NEON 优化版本）
      */
-    private fun applyIIRGaussianNeon(bitmap: Bitmap, sigma: Float): Bitmap {
+    private fun applyIIRGaussianNeon(bitmap: Bitmap, sigma: Float, colorMatrix: FloatArray? = null): Bitmap {
         if (!neonSupported) {
             Log.w(TAG, "NEON not supported, fallback to scalar IIR")
-            return applyIIRGaussian(bitmap, sigma)
+            return applyIIRGaussian(bitmap, sigma, colorMatrix)
         }
         
         // 创建可编辑副本
         val mutableBitmap = bitmap.copy(Bitmap.Config.ARGB_8888, true)
         
         try {
-            NativeGauss.gaussianIIRNeonInplace(mutableBitmap, sigma, highQuality)
+            NativeGauss.gaussianIIRNeonInplace(mutableBitmap, sigma, highQuality, colorMatrix)
         } catch (e: Exception) {
             Log.e(TAG, "IIR Gaussian NEON blur failed: ${e.message}")
             // 回退到标量版本
-            return applyIIRGaussian(bitmap, sigma)
+            mutableBitmap.recycle()
+            return applyIIRGaussian(bitmap, sigma, colorMatrix)
         }
         
         return mutableBitmap
@@ -314,7 +462,7 @@ class EnhancedBlurEffect(
     /**
      * Box3 快速模糊
      */
-    private fun applyBox3(bitmap: Bitmap, sigma: Float): Bitmap {
+    private fun applyBox3(bitmap: Bitmap, sigma: Float, colorMatrix: FloatArray? = null): Bitmap {
         // 创建可编辑副本
         val mutableBitmap = bitmap.copy(Bitmap.Config.ARGB_8888, true)
         
@@ -322,11 +470,11 @@ class EnhancedBlurEffect(
         val radius = (sigma * 1.2f).toInt().coerceAtLeast(1)
         
         try {
-            NativeGauss.box3Inplace(mutableBitmap, radius)
+            NativeGauss.box3Inplace(mutableBitmap, radius, colorMatrix)
         } catch (e: Exception) {
             Log.e(TAG, "Box3 blur failed: ${e.message}")
             // 回退到 Box Blur
-            return applyBoxBlur(bitmap, sigma * 3f)
+            return withColorMatrix(applyBoxBlur(bitmap, sigma * 3f), bitmap, colorMatrix)
         }
         
         return mutableBitmap
@@ -335,16 +483,16 @@ class EnhancedBlurEffect(
     /**
      * 智能选择模糊算法
      */
-    private fun applySmartBlur(bitmap: Bitmap, sigma: Float): Bitmap {
+    private fun applySmartBlur(bitmap: Bitmap, sigma: Float, colorMatrix: FloatArray? = null): Bitmap {
         // 创建可编辑副本
         val mutableBitmap = bitmap.copy(Bitmap.Config.ARGB_8888, true)
         
         try {
-            NativeGauss.smartBlur(mutableBitmap, sigma, highQuality)
+            NativeGauss.smartBlur(mutableBitmap, sigma, highQuality, colorMatrix)
         } catch (e: Exception) {
             Log.e(TAG, "Smart blur failed: ${e.message}")
             // 回退到 Box Blur
-            return applyBoxBlur(bitmap, sigma * 3f)
+            return withColorMatrix(applyBoxBlur(bitmap, sigma * 3f), bitmap, colorMatrix)
         }
         
         return mutableBitmap
@@ -353,14 +501,32 @@ class EnhancedBlurEffect(
     /**
      * 下采样管线模糊
      */
-    private fun applyDownsampleBlur(bitmap: Bitmap, sigma: Float): Bitmap {
+    private fun applyDownsampleBlur(bitmap: Bitmap, sigma: Float, colorMatrix: FloatArray? = null): Bitmap {
         try {
-            return NativeGauss.downsampleBlur(bitmap, sigma, downsampleScale, highQuality)
+            return NativeGauss.downsampleBlur(bitmap, sigma, downsampleScale, highQuality, colorMatrix)
         } catch (e: Exception) {
             Log.e(TAG, "Downsample blur failed: ${e.message}")
             // 回退到智能模糊
+            return applySmartBlur(bitmap, sigma, colorMatrix)
+        }
+    }
+
+    /**
+     * 多级金字塔模糊
+     */
+    private fun applyPyramidBlur(bitmap: Bitmap, sigma: Float): Bitmap {
+        // 创建可编辑副本
+        val mutableBitmap = bitmap.copy(Bitmap.Config.ARGB_8888, true)
+
+        try {
+            NativeGauss.pyramidBlurInplace(mutableBitmap, sigma)
+        } catch (e: Exception) {
+            Log.e(TAG, "Pyramid blur failed: ${e.message}")
+            // 回退到智能模糊
             return applySmartBlur(bitmap, sigma)
         }
+
+        return mutableBitmap
     }
     
     /**
@@ -371,19 +537,43 @@ class EnhancedBlurEffect(
      * @return 调整后的图像
      */
     private fun applySaturation(bitmap: Bitmap, saturation: Float): Bitmap {
-        val result = bitmap.copy(bitmap.config ?: Bitmap.Config.ARGB_8888, true)
-        val canvas = Canvas(result)
-        val paint = Paint()
-        
         // 使用 ColorMatrix 调整饱和度
         val colorMatrix = ColorMatrix()
         colorMatrix.setSaturation(saturation)
+        return applyColorMatrix(bitmap, colorMatrix)
+    }
+
+    /**
+     * 通过 Canvas + ColorMatrixColorFilter 套用颜色矩阵
+     *
+     * @param bitmap 原始图像
+     * @param colorMatrix 颜色矩阵
+     * @return 调整后的图像（新创建）
+     */
+    private fun applyColorMatrix(bitmap: Bitmap, colorMatrix: ColorMatrix): Bitmap {
+        val result = bitmap.copy(bitmap.config ?: Bitmap.Config.ARGB_8888, true)
+        val canvas = Canvas(result)
+        val paint = Paint()
         paint.colorFilter = ColorMatrixColorFilter(colorMatrix)
         
         canvas.drawBitmap(bitmap, 0f, 0f, paint)
         
         return result
     }
+
+    /**
+     * 回退路径补套颜色矩阵（融合失败后走了无融合入口的实现时使用）
+     *
+     * @param blurred 回退实现的模糊结果
+     * @param source 原始背景（blurred 与之不同时回收 blurred）
+     * @param colorMatrix 颜色矩阵（null 时原样返回）
+     */
+    private fun withColorMatrix(blurred: Bitmap, source: Bitmap, colorMatrix: FloatArray?): Bitmap {
+        if (colorMatrix == null) return blurred
+        val result = applyColorMatrix(blurred, ColorMatrix(colorMatrix))
+        if (blurred != source) blurred.recycle()
+        return result
+    }
     
     /**
      * 释放资源
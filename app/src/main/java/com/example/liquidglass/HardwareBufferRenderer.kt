@@ -0,0 +1,221 @@
+/**
+ * 零拷贝渲染器 - HardwareBuffer 捕获 → 原生管线 → HARDWARE Bitmap 显示（API 29+）
+ *
+ * 软件路径每帧：父视图画进新的软件 Bitmap（复制 1）→ 管线结果写入软件 Bitmap（复制 2）→
+ * 绘制时上传纹理。本路径：
+ * - 捕获：beginCapture 返回原生 AImageReader Surface 的硬件 Canvas，由 GPU 绘制背景
+ * - 处理：render 取最新绘制完成的帧，等待 GPU 栅栏后直接映射读取（不复制）
+ * - 显示：结果写入 GPU 可采样的 HardwareBuffer，以 Bitmap.wrapHardwareBuffer 包装返回，
+ *   绘制时 GPU 直接采样，不再上传纹理
+ *
+ * 使用示例：
+ * ```kotlin
+ * val renderer = HardwareBufferRenderer()
+ * renderer.beginCapture(width, height)?.let { canvas ->
+ *     parent.draw(canvas)
+ *     renderer.endCapture(canvas)
+ * }
+ * val frame = renderer.render(blurMode = NativeGlassPipeline.BLUR_IIR, sigma = 8f)  // null = 帧尚未就绪
+ * frame?.let { canvas.drawBitmap(it, 0f, 0f, null) }
+ * renderer.release()
+ * ```
+ *
+ * 注意：
+ * - 结果缓冲轮流复用（三缓冲），返回的 Bitmap 在两次后续 render 之后会被覆盖，不要长期持有
+ * - GPU 绘制是异步的，刚提交的捕获可能要到下一帧才能取到
+ * - 线程约束：所有方法须在同一线程（通常为主线程）调用
+ */
+package com.example.liquidglass
+
+import android.graphics.Bitmap
+import android.graphics.Canvas
+import android.graphics.ColorSpace
+import android.hardware.HardwareBuffer
+import android.os.Build
+import android.util.Log
+import android.view.Surface
+import androidx.annotation.RequiresApi
+
+@RequiresApi(Build.VERSION_CODES.Q)
+class HardwareBufferRenderer {
+    companion object {
+        private const val TAG = "HardwareBufferRenderer"
+
+        // 显示中 1 帧 + RenderThread 可能仍在采样的 1 帧 + 本次写入 1 帧
+        private const val RESULT_BUFFERS = 3
+
+        init {
+            System.loadLibrary("nativegauss")
+        }
+
+        /**
+         * 设备是否支持零拷贝路径（AImageReader + AHardwareBuffer 在运行时解析）
+         */
+        @JvmStatic
+        external fun isSupported(): Boolean
+
+        @JvmStatic
+        private external fun nativeCreate(width: Int, height: Int): Long
+
+        @JvmStatic
+        private external fun nativeDestroy(handle: Long)
+
+        @JvmStatic
+        private external fun nativeGetSurface(handle: Long): Surface?
+
+        @JvmStatic
+        private external fun nativeRender(
+            handle: Long,
+            displacement: Bitmap?,
+            edgeDistance: Bitmap?,
+            normalMap: Bitmap?,
+            result: HardwareBuffer,
+            blurMode: Int,
+            sigma: Float,
+            highQuality: Boolean,
+            saturation: Float,
+            effect: Int,
+            scale: Float,
+            redOffset: Float,
+            greenOffset: Float,
+            blueOffset: Float,
+            refThickness: Float,
+            refFactor: Float,
+            refDispersion: Float,
+            dpr: Float,
+            useBilinear: Boolean
+        ): Boolean
+    }
+
+    private var handle = 0L
+    private var surface: Surface? = null
+    private val buffers = arrayOfNulls<HardwareBuffer>(RESULT_BUFFERS)
+    private val frames = arrayOfNulls<Bitmap>(RESULT_BUFFERS)
+    private var nextFrame = 0
+
+    /**
+     * 当前捕获 / 输出尺寸
+     */
+    var width = 0
+        private set
+    var height = 0
+        private set
+
+    /**
+     * 开始捕获一帧背景
+     *
+     * 尺寸变化时重建捕获 Surface 与结果缓冲
+     *
+     * @return 硬件 Canvas（须调用 endCapture 提交）；不支持或创建失败时返回 null
+     */
+    fun beginCapture(width: Int, height: Int): Canvas? {
+        if (!ensureSize(width, height)) return null
+        return try {
+            surface?.lockHardwareCanvas()
+        } catch (e: Exception) {
+            Log.e(TAG, "lockHardwareCanvas failed: ${e.message}")
+            null
+        }
+    }
+
+    /**
+     * 提交 beginCapture 返回的 Canvas（GPU 异步绘制）
+     */
+    fun endCapture(canvas: Canvas) {
+        try {
+            surface?.unlockCanvasAndPost(canvas)
+        } catch (e: Exception) {
+            Log.e(TAG, "unlockCanvasAndPost failed: ${e.message}")
+        }
+    }
+
+    /**
+     * 以最新捕获的背景执行玻璃效果管线（参数含义同 NativeGlassPipeline.render，贴图尺寸须与捕获尺寸相同）
+     *
+     * @return 渲染结果（HARDWARE Bitmap）；没有新捕获帧或渲染失败时返回 null
+     * @throws IllegalArgumentException 如果贴图格式 / 尺寸不满足要求，或缺少所选效果的贴图
+     */
+    fun render(
+        blurMode: Int = NativeGlassPipeline.BLUR_SMART,
+        sigma: Float = 0f,
+        highQuality: Boolean = false,
+        saturation: Float = 1f,
+        effect: Int = NativeGlassPipeline.EFFECT_NONE,
+        displacement: Bitmap? = null,
+        scale: Float = 70f,
+        redOffset: Float = 0f,
+        greenOffset: Float = -0.05f,
+        blueOffset: Float = -0.1f,
+        edgeDistance: Bitmap? = null,
+        normalMap: Bitmap? = null,
+        refThickness: Float = 100f,
+        refFactor: Float = 1.5f,
+        refDispersion: Float = 7f,
+        dpr: Float = 1f,
+        useBilinear: Boolean = true
+    ): Bitmap? {
+        if (handle == 0L) return null
+
+        val index = nextFrame
+        val buffer = buffers[index] ?: HardwareBuffer.create(
+            width, height, HardwareBuffer.RGBA_8888, 1,
+            HardwareBuffer.USAGE_CPU_WRITE_OFTEN or HardwareBuffer.USAGE_GPU_SAMPLED_IMAGE
+        ).also { buffers[index] = it }
+
+        val rendered = nativeRender(
+            handle, displacement, edgeDistance, normalMap, buffer,
+            blurMode, sigma, highQuality, saturation,
+            effect, scale, redOffset, greenOffset, blueOffset,
+            refThickness, refFactor, refDispersion, dpr,
+            useBilinear
+        )
+        if (!rendered) return null
+
+        // 包装一次后跨帧复用：HARDWARE Bitmap 直接引用缓冲，内容更新无需重新包装
+        val frame = frames[index]
+            ?: Bitmap.wrapHardwareBuffer(buffer, ColorSpace.get(ColorSpace.Named.SRGB))?.also { frames[index] = it }
+            ?: return null
+        nextFrame = (index + 1) % RESULT_BUFFERS
+        return frame
+    }
+
+    /**
+     * 释放捕获 Surface 与结果缓冲
+     */
+    fun release() {
+        surface?.release()
+        surface = null
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+        for (i in 0 until RESULT_BUFFERS) {
+            frames[i]?.recycle()
+            frames[i] = null
+            buffers[i]?.close()
+            buffers[i] = null
+        }
+        nextFrame = 0
+        width = 0
+        height = 0
+    }
+
+    private fun ensureSize(width: Int, height: Int): Boolean {
+        if (handle != 0L && width == this.width && height == this.height) return true
+        release()
+        if (width <= 0 || height <= 0 || !isSupported()) return false
+
+        handle = nativeCreate(width, height)
+        if (handle == 0L) return false
+        surface = nativeGetSurface(handle)
+        if (surface == null) {
+            release()
+            return false
+        }
+
+        this.width = width
+        this.height = height
+        Log.d(TAG, "零拷贝渲染器已创建: ${width}x$height")
+        return true
+    }
+}
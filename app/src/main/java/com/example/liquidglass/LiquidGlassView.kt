@@ -28,6 +28,7 @@ package com.example.liquidglass
 import android.animation.ValueAnimator
 import android.content.Context
 import android.graphics.*
+import android.os.Build
 import android.util.AttributeSet
 import android.util.Log
 import android.view.MotionEvent
@@ -35,6 +36,7 @@ import android.view.View
 import android.view.ViewGroup
 import android.view.animation.DecelerateInterpolator
 import android.widget.FrameLayout
+import androidx.annotation.RequiresApi
 import kotlin.math.*
 
 class LiquidGlassView @JvmOverloads constructor(
@@ -51,6 +53,9 @@ class LiquidGlassView @JvmOverloads constructor(
         // ✅ 极致优化参数
         private const val DOWNSCALE_FACTOR = 0.05f  // 降采样比例 (0.4 = 6.25倍提升, 0.5 = 4倍提升)
         private const val RENDER_INTERVAL = 1  // 渲染间隔 (改为1以避免闪烁)
+
+        // 零拷贝渲染连续取不到捕获帧的上限（超过后判定设备不可用，回退软件路径）
+        private const val MAX_HARDWARE_MISSES = 30
     }
 
     // ✅ 效果开关
@@ -118,6 +123,56 @@ class LiquidGlassView @JvmOverloads constructor(
             }
         }
 
+    // ✅ 原生融合管线（模糊 + 饱和度 + 色差/色散一次 JNI 调用完成，不生成中间 Bitmap）
+    // 当前模糊方法不被管线支持时（Kotlin 盒式 / 降采样类）自动回退到分步渲染
+    var useNativePipeline = false
+        set(value) {
+            if (field != value) {
+                field = value
+                blurDirty = true
+                aberrationDirty = true
+                dispersionDirty = true
+                invalidate()
+            }
+        }
+
+    // ✅ 异步渲染（原生“最新请求优先”队列，见 AsyncRenderer）：主线程只提交参数快照并绘制最新完成帧，
+    // 触摸拖动等快速变化不会在 UI 线程积压；仅对原生融合管线生效，结果比参数变化晚一到两帧
+    var useAsyncRenderer = false
+        set(value) {
+            if (field != value) {
+                field = value
+                if (!value) {
+                    asyncRenderer?.stop()
+                    asyncRenderer = null
+                    asyncTarget?.recycle()
+                    asyncTarget = null
+                }
+                lastAsyncKey = null
+                lastPipelineKey = null
+                blurDirty = true
+                aberrationDirty = true
+                dispersionDirty = true
+                invalidate()
+            }
+        }
+
+    // ✅ 零拷贝渲染（API 29+，见 HardwareBufferRenderer）：背景由 GPU 画进 HardwareBuffer，原生管线直接映射读取，
+    // 结果写入 GPU 可采样的 HardwareBuffer 绘制，省去两次整帧复制与一次纹理上传；
+    // 仅对原生融合管线生效（异步渲染开启时不使用），设备不支持时自动回退软件 Bitmap 路径
+    var useHardwareBuffers = false
+        set(value) {
+            if (field != value) {
+                field = value
+                if (!value) releaseHardwareRenderer()
+                hardwareMisses = 0
+                blurDirty = true
+                aberrationDirty = true
+                dispersionDirty = true
+                invalidate()
+            }
+        }
+
     // ✅ 全局下采样比例（应用于所有效果：截图→缩小→处理→放大）
     var globalDownsampleFactor = 1.0f
         set(value) {
@@ -331,8 +386,27 @@ class LiquidGlassView @JvmOverloads constructor(
     private var cachedBlurred: Bitmap? = null           // L2: 模糊后的背景
     private var cachedResult: Bitmap? = null            // L3: 最终结果
 
+    // 融合管线使用的位移贴图（缩放到处理尺寸后缓存）
+    private var pipelineDisplacementMap: Bitmap? = null
+    private var pipelineDisplacementSource: Bitmap? = null
+
+    // 融合管线增量渲染：模糊结果缓存、上次渲染参数、尚未处理的背景变化区域
+    private var pipelineBlurred: Bitmap? = null
+    private var lastPipelineKey: PipelineKey? = null
+    private var pendingDamage: Rect? = null
+
+    // 异步渲染队列、最近一次提交的参数与首帧完成前常驻的待写入 Bitmap
+    private var asyncRenderer: AsyncRenderer? = null
+    private var lastAsyncKey: PipelineKey? = null
+    private var asyncTarget: Bitmap? = null
+
+    // 零拷贝渲染器、最近一帧结果（HARDWARE Bitmap，归渲染器所有）与连续取帧失败次数
+    private var hardwareRenderer: HardwareBufferRenderer? = null
+    private var hardwareFrame: Bitmap? = null
+    private var hardwareMisses = 0
+
     // 背景变化检测
-    private var lastBackdropHash: Int = 0
+    private var lastBackdropHash: Long = 0L  // 背景内容哈希（0 = 未知）
     private var lastBlurRadius: Float = -1f
     private var lastSaturation: Float = -1f
     private var lastAberrationIntensity: Float = -1f
@@ -432,9 +506,13 @@ class LiquidGlassView @JvmOverloads constructor(
         cachedBackdrop = null
         cachedBlurred = null
         cachedResult = null
+        pipelineBlurred?.recycle()
+        pipelineBlurred = null
+        lastPipelineKey = null
+        pendingDamage = null
 
         // 标记所有层为脏（背景每帧都会捕获，不需要标记）
-        lastBackdropHash = 0  // 重置背景哈希
+        lastBackdropHash = 0L  // 重置背景哈希
         blurDirty = true
         aberrationDirty = true
         needsRedraw = true
@@ -491,8 +569,9 @@ class LiquidGlassView @JvmOverloads constructor(
         // 直接调用渲染逻辑
         renderGlassEffectSync(bounds, calculatedBlurRadius)
 
-        // 绘制结果（应用圆角裁剪）
-        cachedResult?.let {
+        // 绘制结果（应用圆角裁剪）；HARDWARE Bitmap 不能画到软件 Canvas（如其他视图的背景捕获）
+        val frame = if (canvas.isHardwareAccelerated) hardwareFrame ?: cachedResult else cachedResult
+        frame?.let {
             if (!it.isRecycled) {
                 // 保存 canvas 状态
                 val saveCount = canvas.save()
@@ -580,6 +659,16 @@ class LiquidGlassView @JvmOverloads constructor(
             enhancedBlurEffect.captureMargin = blurRadius * 2f  // 模糊扩散边距
         }
 
+        // 零拷贝路径：捕获、处理、显示都在 HardwareBuffer 上完成，不经过 L1 / L3 软件 Bitmap
+        if (useHardwareBuffers && useNativePipeline && !useAsyncRenderer && customBackdropCapture == null &&
+            Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q && renderHardwarePipeline(bounds, blurRadius)) {
+            if (ENABLE_PERFORMANCE_LOG) {
+                Log.d(TAG, "📊 [性能分析] 零拷贝管线: ${String.format("%.3f", (System.nanoTime() - t1) / 1_000_000f)}ms")
+            }
+            return
+        }
+        hardwareFrame = null
+
         // 1. 捕获背景（L1 缓存）- 每帧都捕获以支持动态背景
         var backdrop = if (customBackdropCapture != null) {
             customBackdropCapture?.invoke(bounds)
@@ -610,26 +699,58 @@ class LiquidGlassView @JvmOverloads constructor(
 
         backdrop = processedBackdrop
 
-        // ✅ 检测背景是否真的变化了（支持滚动背景）
-        val backdropHash = backdrop.hashCode()
-        if (backdropHash != lastBackdropHash) {
-            cachedBackdrop?.recycle()
-            cachedBackdrop = backdrop
-            lastBackdropHash = backdropHash
-            blurDirty = true
+        // ✅ 检测背景是否真的变化了（按像素内容哈希，支持滚动背景）
+        val backdropHash = contentHashOf(backdrop)
+        if (backdropHash == 0L || backdropHash != lastBackdropHash) {
+            val damage = backdropDamage(backdrop)
+            if (damage != null && damage.isEmpty) {
+                // 新捕获的像素与上一帧完全相同，沿用旧背景
+                backdrop.recycle()
+            } else {
+                cachedBackdrop?.recycle()
+                cachedBackdrop = backdrop
+                lastBackdropHash = backdropHash
+                if (damage != null) {
+                    // 原生管线只重算变化区域（多帧未渲染时合并）
+                    pendingDamage = pendingDamage?.apply { union(damage) } ?: damage
+                } else {
+                    blurDirty = true
+                }
+            }
         } else {
-            // 背景没变化，回收新捕获的
+            // 背景内容没变化，回收新捕获的
             backdrop.recycle()
         }
 
         if (ENABLE_PERFORMANCE_LOG) t2 = System.nanoTime()
 
+        // 2-3. 原生融合管线：一次调用完成模糊、饱和度与色差/色散
+        if (useNativePipeline && renderNativePipeline(blurRadius, blurChanged, aberrationChanged)) {
+            if (ENABLE_PERFORMANCE_LOG) {
+                t5 = System.nanoTime()
+                val captureTime = (t2 - t1) / 1_000_000f
+                val pipelineTime = (t5 - t2) / 1_000_000f
+                Log.d(TAG, "📊 [性能分析] 原生管线: 捕获 ${String.format("%.3f", captureTime)}ms, " +
+                        "模糊+效果 ${String.format("%.3f", pipelineTime)}ms")
+            }
+            if (ENABLE_MEMORY_LOG) {
+                logMemoryUsage()
+            }
+            return
+        }
+
+        // 分步渲染不支持增量，背景的局部变化按整帧重新模糊
+        if (pendingDamage != null) {
+            pendingDamage = null
+            blurDirty = true
+        }
+
         // 2. 应用模糊和饱和度（L2 缓存）- 可选
         if (enableBackdropBlur && (blurDirty || blurChanged)) {
             cachedBackdrop?.let { backdrop ->
                 cachedBlurred?.recycle()
-                // ✅ 使用增强模糊效果（支持多种算法）
-                cachedBlurred = enhancedBlurEffect.applyEffect(backdrop, blurRadius, saturation)
+                // ✅ 使用增强模糊效果（支持多种算法；相同背景 + 参数命中原生结果缓存）
+                cachedBlurred = enhancedBlurEffect.applyEffect(backdrop, blurRadius, saturation, lastBackdropHash)
                 lastBlurRadius = blurRadius
                 lastSaturation = saturation
                 aberrationDirty = true
@@ -728,6 +849,7 @@ class LiquidGlassView @JvmOverloads constructor(
                 |📊 [性能分析] 各效果耗时:
                 |  1️⃣ 捕获背景: ${String.format("%.3f", captureTime)}ms ${if (enableBackdropBlur) "✅" else "⏭️"}
                 |  2️⃣ 模糊处理: ${String.format("%.3f", blurTime)}ms ${if (enableBackdropBlur) "✅" else "⏭️"}
+                |  📐 模糊尺寸: ${cachedBlurred?.width ?: 0}x${cachedBlurred?.height ?: 0}
                 |  3️⃣ $effectName 效果: ${String.format("%.3f", aberrationTime)}ms ${if (enableChromaticDispersion || enableChromaticAberration) "✅" else "⏭️"}
                 |  4️⃣ 最终处理: ${String.format("%.3f", finalizeTime)}ms
                 |  ⏱️ 总耗时: ${String.format("%.3f", totalTime)}ms (~${(1000f / totalTime).toInt()} FPS)
@@ -748,6 +870,431 @@ class LiquidGlassView @JvmOverloads constructor(
         }
     }
 
+    /**
+     * 使用原生融合管线渲染（模糊 → 饱和度 → 色差/色散）
+     *
+     * 直接从 L1 背景生成 L3 结果，跳过 L2 中间 Bitmap；效果在背景分辨率下处理
+     * （不再单独降采样）
+     *
+     * 参数与上一帧相同且只有背景局部变化时增量渲染：只重算 pendingDamage 附近的区域，
+     * 其余像素沿用上一帧的 L3 结果与模糊缓存（pipelineBlurred）
+     *
+     * @return true 已渲染（或无需重绘）；false 当前配置不被管线支持，需回退分步渲染
+     */
+    private fun renderNativePipeline(blurRadius: Float, blurChanged: Boolean, aberrationChanged: Boolean): Boolean {
+        val backdrop = cachedBackdrop ?: return false
+        val processWidth = backdrop.width
+        val processHeight = backdrop.height
+        val key = pipelineKeyFor(processWidth, processHeight, blurRadius) ?: return false
+        val effect = key.effect
+
+        if (useAsyncRenderer) {
+            return renderNativePipelineAsync(backdrop, key, blurRadius)
+        }
+
+        // 复用 L3 结果 Bitmap（尺寸一致且未与 L1/L2 共享时）
+        val previous = cachedResult
+        val reusable = previous != null && !previous.isRecycled && previous.isMutable &&
+                previous.width == processWidth && previous.height == processHeight &&
+                previous != cachedBackdrop && previous != cachedBlurred
+
+        // 有效果阶段时还需要模糊结果缓存（无效果时 result 本身就是模糊结果）
+        val needsBlurred = effect != NativeGlassPipeline.EFFECT_NONE
+        val cachedPipelineBlurred = pipelineBlurred
+        val blurredReusable = cachedPipelineBlurred != null && !cachedPipelineBlurred.isRecycled &&
+                cachedPipelineBlurred.width == processWidth && cachedPipelineBlurred.height == processHeight
+
+        // 上一帧输出可作为增量基础：结果与缓存仍有效，且参数与上次完全相同
+        val incremental = reusable && (!needsBlurred || blurredReusable) && key == lastPipelineKey &&
+                !(blurDirty || blurChanged || aberrationDirty || aberrationChanged || dispersionDirty)
+        val damage = pendingDamage
+        if (incremental && damage == null) return true
+
+        val result = if (reusable) {
+            previous!!
+        } else {
+            if (previous != null && previous != cachedBackdrop && previous != cachedBlurred) {
+                previous.recycle()
+            }
+            Bitmap.createBitmap(processWidth, processHeight, Bitmap.Config.ARGB_8888)
+        }
+
+        val blurred = when {
+            !needsBlurred -> null
+            blurredReusable -> cachedPipelineBlurred
+            else -> {
+                cachedPipelineBlurred?.recycle()
+                Bitmap.createBitmap(processWidth, processHeight, Bitmap.Config.ARGB_8888).also {
+                    pipelineBlurred = it
+                }
+            }
+        }
+
+        // 非增量时按整帧处理（同时重建模糊缓存）
+        val region = if (incremental) damage!! else Rect(0, 0, processWidth, processHeight)
+
+        try {
+            NativeGlassPipeline.renderGlassPipelineRegion(
+                backdrop = backdrop,
+                displacement = key.displacement,
+                edgeDistance = key.edgeDistance,
+                normalMap = null,
+                blurred = blurred,
+                result = result,
+                damageLeft = region.left,
+                damageTop = region.top,
+                damageRight = region.right,
+                damageBottom = region.bottom,
+                blurMode = key.blurMode,
+                sigma = key.sigma,
+                highQuality = key.highQuality,
+                saturation = key.saturation,
+                effect = key.effect,
+                scale = key.scale,
+                redOffset = key.redOffset,
+                greenOffset = key.greenOffset,
+                blueOffset = key.blueOffset,
+                refThickness = key.refThickness,
+                refFactor = key.refFactor,
+                refDispersion = key.refDispersion,
+                dpr = key.dpr,
+                useBilinear = key.useBilinear,
+                maskRight = key.maskRight,
+                maskBottom = key.maskBottom,
+                maskRadius = key.maskRadius
+            )
+        } catch (e: Exception) {
+            Log.e(TAG, "Native pipeline failed: ${e.message}")
+            result.recycle()
+            cachedResult = null
+            lastPipelineKey = null
+            return false
+        }
+
+        cachedResult = result
+        lastPipelineKey = key
+        pendingDamage = null
+        lastBlurRadius = blurRadius
+        lastSaturation = saturation
+        lastAberrationIntensity = aberrationIntensity
+        blurDirty = false
+        aberrationDirty = false
+        dispersionDirty = false
+        return true
+    }
+
+    /**
+     * 通过零拷贝路径执行融合管线（useHardwareBuffers，API 29+）
+     *
+     * 每帧由 GPU 把背景画进捕获 Surface，原生侧取最新画完的一帧直接映射处理，结果为 HARDWARE Bitmap；
+     * 不做增量渲染。GPU 尚未画完时沿用上一帧并在下一个 vsync 重试
+     *
+     * @return true 已渲染或沿用上一帧；false 不支持（设备 / 模糊方法 / 连续取不到帧），需回退软件路径
+     */
+    @RequiresApi(Build.VERSION_CODES.Q)
+    private fun renderHardwarePipeline(bounds: RectF, blurRadius: Float): Boolean {
+        if (hardwareMisses >= MAX_HARDWARE_MISSES || !HardwareBufferRenderer.isSupported()) return false
+
+        // 处理尺寸与软件路径（捕获 → 全局下采样）一致
+        val captureBounds = enhancedBlurEffect.captureBoundsFor(bounds)
+        val factor = globalDownsampleFactor
+        val processWidth = (captureBounds.width().toInt().coerceAtLeast(1) * factor).toInt().coerceAtLeast(1)
+        val processHeight = (captureBounds.height().toInt().coerceAtLeast(1) * factor).toInt().coerceAtLeast(1)
+        val key = pipelineKeyFor(processWidth, processHeight, blurRadius) ?: return false
+
+        val renderer = hardwareRenderer ?: HardwareBufferRenderer().also { hardwareRenderer = it }
+        if (!enhancedBlurEffect.captureBackdropHardware(bounds, renderer, factor)) {
+            releaseHardwareRenderer()
+            return false
+        }
+
+        val frame = try {
+            renderer.render(
+                blurMode = key.blurMode,
+                sigma = key.sigma,
+                highQuality = key.highQuality,
+                saturation = key.saturation,
+                effect = key.effect,
+                displacement = key.displacement,
+                scale = key.scale,
+                redOffset = key.redOffset,
+                greenOffset = key.greenOffset,
+                blueOffset = key.blueOffset,
+                edgeDistance = key.edgeDistance,
+                refThickness = key.refThickness,
+                refFactor = key.refFactor,
+                refDispersion = key.refDispersion,
+                dpr = key.dpr,
+                useBilinear = key.useBilinear
+            )
+        } catch (e: Exception) {
+            Log.e(TAG, "Hardware buffer pipeline failed: ${e.message}")
+            releaseHardwareRenderer()
+            return false
+        }
+
+        if (frame == null) {
+            // GPU 还没画完本次捕获：沿用上一帧，下一个 vsync 再取
+            if (++hardwareMisses >= MAX_HARDWARE_MISSES) {
+                Log.w(TAG, "零拷贝渲染连续 $hardwareMisses 帧未取到捕获结果，回退软件路径")
+                releaseHardwareRenderer()
+                return false
+            }
+            postInvalidateOnAnimation()
+            return true
+        }
+
+        hardwareFrame = frame
+        hardwareMisses = 0
+        lastBlurRadius = blurRadius
+        lastSaturation = saturation
+        lastAberrationIntensity = aberrationIntensity
+        blurDirty = false
+        aberrationDirty = false
+        dispersionDirty = false
+        return true
+    }
+
+    /**
+     * 释放零拷贝渲染器（hardwareFrame 归渲染器所有，一并清除）
+     */
+    private fun releaseHardwareRenderer() {
+        hardwareFrame = null
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q) {
+            hardwareRenderer?.release()
+        }
+        hardwareRenderer = null
+    }
+
+    /**
+     * 按当前视图属性组装融合管线参数
+     *
+     * @param processWidth 处理宽度（背景尺寸）
+     * @param processHeight 处理高度
+     * @return 管线参数；当前模糊方法不被管线支持时返回 null
+     */
+    private fun pipelineKeyFor(processWidth: Int, processHeight: Int, blurRadius: Float): PipelineKey? {
+        val blurMode = if (enableBackdropBlur) {
+            NativeGlassPipeline.blurModeFor(blurMethod) ?: return null
+        } else {
+            NativeGlassPipeline.BLUR_NONE
+        }
+
+        val displacementMap = displacementMaps?.get(displacementMode)
+        val effect = when {
+            enableChromaticDispersion -> NativeGlassPipeline.EFFECT_DISPERSION
+            enableChromaticAberration && aberrationIntensity > 0 && displacementMap != null ->
+                NativeGlassPipeline.EFFECT_ABERRATION
+            else -> NativeGlassPipeline.EFFECT_NONE
+        }
+
+        // 处理尺寸相对视图尺寸的比例（全局下采样）
+        val processScale = processWidth.toFloat() / width.coerceAtLeast(1)
+
+        // 可见区域（与 drawGlassEffect 的 clipPath 一致）：下采样时整张位图缩放到视图，
+        // 否则位图按原尺寸画在视图原点，超出视图的捕获边距不可见
+        val downsampled = globalDownsampleFactor < 1.0f
+        val maskRight = if (downsampled) processWidth else min(width, processWidth)
+        val maskBottom = if (downsampled) processHeight else min(height, processHeight)
+        val maskRadius = if (downsampled) cornerRadius * processScale else cornerRadius
+
+        return PipelineKey(
+            blurMode = blurMode,
+            sigma = enhancedBlurEffect.blurSigma(blurRadius),
+            highQuality = highQualityBlur,
+            saturation = saturation / 100f,
+            effect = effect,
+            displacement = if (effect == NativeGlassPipeline.EFFECT_ABERRATION) {
+                pipelineDisplacementFor(displacementMap!!, processWidth, processHeight)
+            } else {
+                null
+            },
+            edgeDistance = if (effect == NativeGlassPipeline.EFFECT_DISPERSION) {
+                chromaticDispersionEffect.edgeDistanceMap(processWidth, processHeight, cornerRadius * processScale)
+            } else {
+                null
+            },
+            scale = displacementScale,
+            redOffset = aberrationRedOffset * aberrationIntensity,
+            greenOffset = aberrationGreenOffset * aberrationIntensity,
+            blueOffset = aberrationBlueOffset * aberrationIntensity,
+            refThickness = dispersionThickness,
+            refFactor = dispersionFactor,
+            refDispersion = dispersionGain,
+            dpr = chromaticDispersionEffect.devicePixelRatio,
+            useBilinear = if (effect == NativeGlassPipeline.EFFECT_DISPERSION) {
+                chromaticDispersionEffect.useBilinearInterpolation
+            } else {
+                chromaticAberrationEffect.useBilinearInterpolation
+            },
+            maskRight = maskRight,
+            maskBottom = maskBottom,
+            maskRadius = maskRadius
+        )
+    }
+
+    /**
+     * 通过异步渲染队列执行融合管线（useAsyncRenderer）
+     *
+     * 参数或背景变化时提交一次快照（不等待），随后取最新完成帧；
+     * 提交的帧尚未完成时沿用上一帧，并在下一个 vsync 再检查一次
+     *
+     * @return true 已提交或无需提交；false 提交失败，需回退分步渲染
+     */
+    private fun renderNativePipelineAsync(backdrop: Bitmap, key: PipelineKey, blurRadius: Float): Boolean {
+        val renderer = asyncRenderer ?: AsyncRenderer().also { asyncRenderer = it }
+
+        val changed = key != lastAsyncKey || pendingDamage != null ||
+                blurDirty || aberrationDirty || dispersionDirty
+        if (changed) {
+            val submitted = try {
+                renderer.submit(
+                    backdrop = backdrop,
+                    blurMode = key.blurMode,
+                    sigma = key.sigma,
+                    highQuality = key.highQuality,
+                    saturation = key.saturation,
+                    effect = key.effect,
+                    displacement = key.displacement,
+                    scale = key.scale,
+                    redOffset = key.redOffset,
+                    greenOffset = key.greenOffset,
+                    blueOffset = key.blueOffset,
+                    edgeDistance = key.edgeDistance,
+                    refThickness = key.refThickness,
+                    refFactor = key.refFactor,
+                    refDispersion = key.refDispersion,
+                    dpr = key.dpr,
+                    useBilinear = key.useBilinear
+                )
+            } catch (e: Exception) {
+                Log.e(TAG, "Async pipeline submit failed: ${e.message}")
+                false
+            }
+            if (!submitted) {
+                lastAsyncKey = null
+                return false
+            }
+
+            lastAsyncKey = key
+            pendingDamage = null
+            lastBlurRadius = blurRadius
+            lastSaturation = saturation
+            lastAberrationIntensity = aberrationIntensity
+            blurDirty = false
+            aberrationDirty = false
+            dispersionDirty = false
+        }
+
+        // 复用 L3 结果 Bitmap（尺寸一致且未与 L1/L2 共享时）；
+        // 否则写入常驻的 asyncTarget，首帧完成前不在每个 vsync 重新分配
+        val previous = cachedResult
+        val reusable = previous != null && !previous.isRecycled && previous.isMutable &&
+                previous.width == backdrop.width && previous.height == backdrop.height &&
+                previous != cachedBackdrop && previous != cachedBlurred
+        val target = if (reusable) previous!! else asyncTargetFor(backdrop.width, backdrop.height)
+
+        if (renderer.acquire(target) && target !== previous) {
+            if (previous != null && previous != cachedBackdrop && previous != cachedBlurred) {
+                previous.recycle()
+            }
+            cachedResult = target
+            asyncTarget = null
+        }
+
+        if (renderer.hasPendingFrames) {
+            postInvalidateOnAnimation()
+        }
+        return true
+    }
+
+    /**
+     * 异步管线的待写入 Bitmap：尺寸不变时跨 vsync 复用，取到帧后转为 cachedResult
+     */
+    private fun asyncTargetFor(width: Int, height: Int): Bitmap {
+        asyncTarget?.let {
+            if (!it.isRecycled && it.width == width && it.height == height) return it
+            it.recycle()
+        }
+        return Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888).also { asyncTarget = it }
+    }
+
+    /**
+     * 背景像素内容哈希（无法哈希时返回 0，按背景已变化处理）
+     */
+    private fun contentHashOf(backdrop: Bitmap): Long {
+        return try {
+            NativeGlassPipeline.hashBitmap(backdrop)
+        } catch (e: Exception) {
+            Log.e(TAG, "Backdrop hash failed: ${e.message}")
+            0L
+        }
+    }
+
+    /**
+     * 计算新捕获背景相对 L1 背景的变化区域
+     *
+     * @return 变化区域（两帧相同时为空矩形）；无法比较（未启用原生管线 / 尺寸变化）时返回 null，按整帧处理
+     */
+    private fun backdropDamage(backdrop: Bitmap): Rect? {
+        if (!useNativePipeline) return null
+        val previous = cachedBackdrop ?: return null
+        if (previous.isRecycled || previous.width != backdrop.width || previous.height != backdrop.height) {
+            return null
+        }
+        return try {
+            NativeGlassPipeline.computeDamage(previous, backdrop) ?: Rect()
+        } catch (e: Exception) {
+            Log.e(TAG, "Backdrop damage detection failed: ${e.message}")
+            null
+        }
+    }
+
+    /**
+     * 融合管线的全部输入参数（贴图按实例比较）；与上一帧相同时才能增量渲染
+     */
+    private data class PipelineKey(
+        val blurMode: Int,
+        val sigma: Float,
+        val highQuality: Boolean,
+        val saturation: Float,
+        val effect: Int,
+        val displacement: Bitmap?,
+        val edgeDistance: Bitmap?,
+        val scale: Float,
+        val redOffset: Float,
+        val greenOffset: Float,
+        val blueOffset: Float,
+        val refThickness: Float,
+        val refFactor: Float,
+        val refDispersion: Float,
+        val dpr: Float,
+        val useBilinear: Boolean,
+        val maskRight: Int,
+        val maskBottom: Int,
+        val maskRadius: Float
+    )
+
+    /**
+     * 获取缩放到处理尺寸的位移贴图（按源贴图与尺寸缓存）
+     */
+    private fun pipelineDisplacementFor(map: Bitmap, processWidth: Int, processHeight: Int): Bitmap {
+        if (map.width == processWidth && map.height == processHeight) return map
+
+        pipelineDisplacementMap?.let {
+            if (pipelineDisplacementSource === map && !it.isRecycled &&
+                it.width == processWidth && it.height == processHeight) {
+                return it
+            }
+            it.recycle()
+        }
+
+        val scaled = Bitmap.createScaledBitmap(map, processWidth, processHeight, true)
+        pipelineDisplacementMap = scaled
+        pipelineDisplacementSource = map
+        return scaled
+    }
+
     /**
      * 记录内存使用情况
      */
@@ -864,6 +1411,13 @@ class LiquidGlassView @JvmOverloads constructor(
 
         // ✅ 清理所有缓存和资源
         scaleAnimator?.cancel()
+        asyncRenderer?.stop()  // 不等待进行中的渲染，原生队列自行释放
+        asyncRenderer = null
+        lastAsyncKey = null
+        asyncTarget?.recycle()
+        asyncTarget = null
+        releaseHardwareRenderer()
+        hardwareMisses = 0
         enhancedBlurEffect.release()  // 清理增强模糊效果
 
         // ✅ 清理效果处理器
@@ -878,10 +1432,18 @@ class LiquidGlassView @JvmOverloads constructor(
         cachedBackdrop = null
         cachedBlurred = null
         cachedResult = null
+        pipelineBlurred?.recycle()
+        pipelineBlurred = null
+        lastPipelineKey = null
+        pendingDamage = null
 
         // 清理位移贴图
         displacementMaps?.values?.forEach { it.recycle() }
         displacementMaps = null
+        pipelineDisplacementMap?.recycle()
+        pipelineDisplacementMap = null
+        pipelineDisplacementSource = null
+        chromaticDispersionEffect.clearCache()
     }
 }
 
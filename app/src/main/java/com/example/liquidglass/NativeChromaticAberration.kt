@@ -42,6 +42,7 @@
 package com.example.liquidglass
 
 import android.graphics.Bitmap
+import com.example.blur.NativeGauss
 
 object NativeChromaticAberration {
 
@@ -91,6 +92,29 @@ object NativeChromaticAberration {
         useBilinear: Boolean = true
     )
 
+    /**
+     * 边缘扭曲（按位移贴图整体移动采样位置，对应 EdgeDistortionEffect）
+     *
+     * 与色差共用原生采样器，直接在锁定的 Bitmap 上处理，不经过 Java 堆数组
+     *
+     * @param source 源图像（ARGB_8888）
+     * @param displacement 位移贴图（ARGB_8888，R = X 位移，G = Y 位移，128 为中心）
+     * @param result 结果图像（ARGB_8888, mutable，不能与 source 相同）
+     * @param scale 位移缩放系数（负值为反向位移）
+     * @param fadeWidth 边缘淡化宽度（像素，0 表示不淡化）
+     * @param useBilinear 是否使用双线性插值（false 为最近邻）
+     *
+     * @throws IllegalArgumentException 如果 Bitmap 格式不是 ARGB_8888、尺寸不一致或 result 与 source 相同
+     */
+    external fun edgeDistortion(
+        source: Bitmap,
+        displacement: Bitmap,
+        result: Bitmap,
+        scale: Float = 70.0f,
+        fadeWidth: Int = 0,
+        useBilinear: Boolean = true
+    )
+
     /**
      * 应用色差效果（便捷方法，创建新的结果 Bitmap）
      *
@@ -172,14 +196,14 @@ object NativeChromaticAberration {
         
         // 降采样源图像
         val smallSource = if (downscale < 1.0f) {
-            Bitmap.createScaledBitmap(source, processWidth, processHeight, true)
+            NativeGauss.scaleBitmap(source, processWidth, processHeight)
         } else {
             source
         }
         
         // 降采样位移贴图
         val smallDisplacement = if (downscale < 1.0f) {
-            Bitmap.createScaledBitmap(displacement, processWidth, processHeight, true)
+            NativeGauss.scaleBitmap(displacement, processWidth, processHeight)
         } else {
             displacement
         }
@@ -220,11 +244,10 @@ object NativeChromaticAberration {
         
         // 放大回原尺寸
         val finalResult = if (downscale < 1.0f) {
-            val upscaled = Bitmap.createScaledBitmap(
+            val upscaled = NativeGauss.scaleBitmap(
                 smallResult,
                 originalWidth,
-                originalHeight,
-                true
+                originalHeight
             )
             smallResult.recycle()
             upscaled
@@ -82,5 +82,30 @@ object NativeChromaticDispersion {
 
         return result
     }
-}
 
+    /**
+     * 从 Alpha 通道生成边缘距离贴图与法线贴图（精确欧氏距离变换）
+     *
+     * @param source 源图像（只使用 Alpha）
+     * @param edgeDistance 输出边缘距离贴图（ARGB_8888，mutable，与 source 尺寸相同）
+     * @param normalMap 输出法线贴图（可为 null，不生成）
+     * @param alphaThreshold Alpha 低于此值视为透明（边缘外）
+     * @param maxDistance 归一化距离（映射为 255）；<= 0 时使用半对角线长度
+     *
+     * @throws IllegalArgumentException 如果 Bitmap 格式 / 尺寸不满足要求
+     */
+    external fun generateEdgeMaps(
+        source: Bitmap,
+        edgeDistance: Bitmap,
+        normalMap: Bitmap?,
+        alphaThreshold: Int,
+        maxDistance: Float
+    )
+
+    /**
+     * 释放原生径向法线缓存表（无法线贴图时使用，8 字节/像素），之后按需重建
+     *
+     * @return 释放的字节数
+     */
+    external fun releaseCache(): Long
+}
@@ -0,0 +1,41 @@
+/**
+ * 位移贴图 JNI 接口 (Native Displacement Map)
+ *
+ * DisplacementMapGenerator 三种模式的原生实现（NEON 向量化、多线程），
+ * 直接写入 Bitmap，输出与 Kotlin 版本一致（R = dx，G = B = dy，A = 255）
+ */
+package com.example.liquidglass
+
+import android.graphics.Bitmap
+
+/**
+ * 位移贴图原生接口
+ */
+object NativeDisplacementMap {
+
+    init {
+        System.loadLibrary("nativegauss")
+    }
+
+    /**
+     * 生成位移贴图（写入已有 Bitmap）
+     *
+     * @param bitmap 输出 Bitmap（ARGB_8888, mutable）
+     * @param mode 位移模式（DisplacementMode.ordinal）
+     */
+    external fun generateDisplacementMap(bitmap: Bitmap, mode: Int)
+
+    /**
+     * 便捷方法：生成指定尺寸的位移贴图
+     *
+     * @param width 贴图宽度
+     * @param height 贴图高度
+     * @param mode 位移模式
+     * @return 位移贴图（ARGB_8888）
+     */
+    fun generate(width: Int, height: Int, mode: DisplacementMode): Bitmap {
+        val bitmap = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
+        generateDisplacementMap(bitmap, mode.ordinal)
+        return bitmap
+    }
+}
@@ -0,0 +1,489 @@
+/**
+ * NativeGlassPipeline - 玻璃效果融合管线 JNI 接口层
+ *
+ * 一次原生调用完成 模糊 → 饱和度 → 色差 / 色散：
+ * - 只有一次 JNI 调用、一组 Bitmap 锁定 / 解锁
+ * - 中间结果保存在原生临时缓冲池中（跨帧复用），不创建中间 Bitmap
+ *
+ * 要求：
+ * - 所有 Bitmap 必须为 ARGB_8888 格式，且尺寸相同
+ * - result 必须可编辑（mutable），且不能与 backdrop 是同一个 Bitmap
+ *
+ * 增量渲染（背景只有局部变化时）：
+ * - computeDamage 比较前后两帧背景，得到变化矩形
+ * - renderGlassPipelineRegion 只重算变化矩形外扩模糊支撑半径 / 效果采样偏移的区域，
+ *   blurred / result 跨帧保留；首帧或参数变化时传整帧矩形建立缓存
+ *
+ * 模糊结果缓存：
+ * - 整帧模糊前按背景内容哈希（hashBitmap）查找原生缓存，相同背景 + 相同参数时只复制一次结果
+ * - 默认 4 个条目 / 32 MB，setBlurCacheCapacity(0, 0) 关闭；onTrimMemory 时调用 clearBlurCache
+ * - 分步渲染（EnhancedBlurEffect）通过 blurCache* 方法共用同一缓存
+ *
+ * 批量区域模糊（多个玻璃视图共用一张背景时）：
+ * - blurRegions / blurRegionsIntoFrame 传入整帧背景与各视图矩形，重叠区域只模糊一次，
+ *   不重叠的块在线程池上并行；结果为每个矩形的副本，或整帧 Bitmap 中的对应区域
+ *
+ * HardwareBuffer 输入 / 输出（API 26+，isHardwareBufferSupported 为 true 时）：
+ * - renderGlassPipelineHardwareBuffer 原地映射背景与结果缓冲，不经过软件 Bitmap；
+ *   结果缓冲带 USAGE_GPU_SAMPLED_IMAGE 时可用 Bitmap.wrapHardwareBuffer 直接显示（无纹理上传）
+ * - 视图捕获 + 显示的完整零拷贝路径见 HardwareBufferRenderer
+ *
+ * 使用示例：
+ * ```kotlin
+ * val result = Bitmap.createBitmap(backdrop.width, backdrop.height, Bitmap.Config.ARGB_8888)
+ * NativeGlassPipeline.render(
+ *     backdrop = backdrop,
+ *     result = result,
+ *     blurMode = NativeGlassPipeline.BLUR_SMART,
+ *     sigma = 4f,
+ *     saturation = 1.4f,
+ *     effect = NativeGlassPipeline.EFFECT_ABERRATION,
+ *     displacement = displacementMap
+ * )
+ * ```
+ */
+package com.example.liquidglass
+
+import android.graphics.Bitmap
+import android.graphics.Rect
+import android.hardware.HardwareBuffer
+import android.os.Build
+import androidx.annotation.RequiresApi
+
+object NativeGlassPipeline {
+
+    // 模糊方式（与 glass_pipeline.h 中的 GlassBlurMode 一致）
+    const val BLUR_NONE = 0
+    const val BLUR_IIR = 1
+    const val BLUR_BOX3 = 2
+    const val BLUR_SMART = 3
+    const val BLUR_PYRAMID = 4
+
+    // 效果阶段（与 glass_pipeline.h 中的 GlassEffect 一致）
+    const val EFFECT_NONE = 0
+    const val EFFECT_ABERRATION = 1
+    const val EFFECT_DISPERSION = 2
+
+    /**
+     * 自定义模糊方式的起始值（与 blur_cache.h 中的 kBlurCacheCustomMethod 一致；
+     * 更小的值保留给管线的 BLUR_* 方式）
+     */
+    const val BLUR_CACHE_CUSTOM_METHOD = 16
+
+    init {
+        System.loadLibrary("nativegauss")
+    }
+
+    /**
+     * 执行玻璃效果管线
+     *
+     * @param backdrop 背景（ARGB_8888，只读）
+     * @param displacement 位移贴图（色差效果必需，否则可为 null）
+     * @param edgeDistance 边缘距离贴图（色散效果必需，否则可为 null）
+     * @param normalMap 法线贴图（色散可选，null 使用径向法线）
+     * @param result 结果（ARGB_8888, mutable）
+     * @param blurMode 模糊方式（BLUR_*）
+     * @param sigma 高斯标准差
+     * @param highQuality IIR 是否在线性色彩空间处理
+     * @param saturation 饱和度系数（1.0 = 原始，1.4 = 增强 40%）
+     * @param effect 效果阶段（EFFECT_*）
+     * @param scale 色差位移缩放系数
+     * @param redOffset 色差红色通道偏移（已乘以强度）
+     * @param greenOffset 色差绿色通道偏移（已乘以强度）
+     * @param blueOffset 色差蓝色通道偏移（已乘以强度）
+     * @param refThickness 色散折射厚度
+     * @param refFactor 色散折射系数
+     * @param refDispersion 色散增益
+     * @param dpr 设备像素比
+     * @param useBilinear 是否使用双线性插值
+     * @param maskLeft 可见圆角矩形左边界（含；四个边界构成空矩形时取整帧）
+     * @param maskTop 可见圆角矩形上边界（含）
+     * @param maskRight 可见圆角矩形右边界（不含）
+     * @param maskBottom 可见圆角矩形下边界（不含）
+     * @param maskRadius 可见区域圆角半径（< 0 不遮罩）。启用时色差 / 色散 / 饱和度只处理可见像素，
+     *                   模糊只处理可见区域所需的子图；遮罩外的 result 像素内容未定义，须由调用方裁剪
+     *
+     * @throws IllegalArgumentException 如果 Bitmap 格式 / 尺寸不满足要求，或缺少所选效果的贴图
+     */
+    external fun renderGlassPipeline(
+        backdrop: Bitmap,
+        displacement: Bitmap?,
+        edgeDistance: Bitmap?,
+        normalMap: Bitmap?,
+        result: Bitmap,
+        blurMode: Int,
+        sigma: Float,
+        highQuality: Boolean,
+        saturation: Float,
+        effect: Int,
+        scale: Float,
+        redOffset: Float,
+        greenOffset: Float,
+        blueOffset: Float,
+        refThickness: Float,
+        refFactor: Float,
+        refDispersion: Float,
+        dpr: Float,
+        useBilinear: Boolean,
+        maskLeft: Int = 0,
+        maskTop: Int = 0,
+        maskRight: Int = 0,
+        maskBottom: Int = 0,
+        maskRadius: Float = -1f
+    )
+
+    /**
+     * 执行玻璃效果管线（增量版本）
+     *
+     * 前提：blurred / result 保存着上一帧相同参数下的输出，当前 backdrop 只在 damage 区域内变化。
+     * damage 为整帧时等价于 renderGlassPipeline，并同时填充 blurred
+     *
+     * @param blurred 模糊 + 饱和度结果缓存（ARGB_8888, mutable，跨帧保留）；
+     *                EFFECT_NONE 时 result 本身就是模糊结果，可为 null
+     * @param damageLeft 背景变化区域左边界（含）
+     * @param damageTop 背景变化区域上边界（含）
+     * @param damageRight 背景变化区域右边界（不含）
+     * @param damageBottom 背景变化区域下边界（不含）
+     * 其余参数同 renderGlassPipeline（遮罩需与上一帧相同，否则按整帧调用）
+     *
+     * @throws IllegalArgumentException 如果 Bitmap 格式 / 尺寸不满足要求，或有效果阶段时缺少 blurred
+     */
+    external fun renderGlassPipelineRegion(
+        backdrop: Bitmap,
+        displacement: Bitmap?,
+        edgeDistance: Bitmap?,
+        normalMap: Bitmap?,
+        blurred: Bitmap?,
+        result: Bitmap,
+        damageLeft: Int,
+        damageTop: Int,
+        damageRight: Int,
+        damageBottom: Int,
+        blurMode: Int,
+        sigma: Float,
+        highQuality: Boolean,
+        saturation: Float,
+        effect: Int,
+        scale: Float,
+        redOffset: Float,
+        greenOffset: Float,
+        blueOffset: Float,
+        refThickness: Float,
+        refFactor: Float,
+        refDispersion: Float,
+        dpr: Float,
+        useBilinear: Boolean,
+        maskLeft: Int = 0,
+        maskTop: Int = 0,
+        maskRight: Int = 0,
+        maskBottom: Int = 0,
+        maskRadius: Float = -1f
+    )
+
+    /**
+     * 设备是否支持 HardwareBuffer 入口（AHardwareBuffer 接口在运行时解析，API 26+）
+     */
+    external fun isHardwareBufferSupported(): Boolean
+
+    /**
+     * 执行玻璃效果管线（HardwareBuffer 版本）
+     *
+     * 背景与结果在原地映射读写：省去软件 Bitmap 的复制，结果可直接交给 GPU 采样
+     *
+     * @param backdrop 背景（RGBA_8888，需带 USAGE_CPU_READ_RARELY / OFTEN）
+     * @param result 结果（RGBA_8888，需带 USAGE_CPU_WRITE_RARELY / OFTEN，不能与 backdrop 相同）
+     * 其余参数同 renderGlassPipeline（贴图仍为 ARGB_8888 Bitmap，与背景尺寸相同）
+     *
+     * @throws UnsupportedOperationException 如果设备不支持 AHardwareBuffer
+     * @throws IllegalArgumentException 如果缓冲格式 / 尺寸不满足要求，或缺少所选效果的贴图
+     * @throws IllegalStateException 如果缓冲无法映射（缺少 CPU 访问用途）
+     */
+    @RequiresApi(Build.VERSION_CODES.O)
+    external fun renderGlassPipelineHardwareBuffer(
+        backdrop: HardwareBuffer,
+        displacement: Bitmap?,
+        edgeDistance: Bitmap?,
+        normalMap: Bitmap?,
+        result: HardwareBuffer,
+        blurMode: Int,
+        sigma: Float,
+        highQuality: Boolean,
+        saturation: Float,
+        effect: Int,
+        scale: Float,
+        redOffset: Float,
+        greenOffset: Float,
+        blueOffset: Float,
+        refThickness: Float,
+        refFactor: Float,
+        refDispersion: Float,
+        dpr: Float,
+        useBilinear: Boolean
+    )
+
+    /**
+     * 比较两帧背景（原始格式：[left, top, right, bottom]，两帧相同时为 null）
+     *
+     * @throws IllegalArgumentException 如果两个 Bitmap 尺寸不同
+     */
+    external fun computeDamageRaw(previous: Bitmap, current: Bitmap): IntArray?
+
+    /**
+     * 比较两帧背景，返回变化区域的最小包围矩形
+     *
+     * @param previous 上一帧背景（ARGB_8888）
+     * @param current 当前帧背景（ARGB_8888，与 previous 尺寸相同）
+     * @return 变化区域；两帧完全相同时返回 null
+     */
+    fun computeDamage(previous: Bitmap, current: Bitmap): Rect? {
+        val raw = computeDamageRaw(previous, current) ?: return null
+        return Rect(raw[0], raw[1], raw[2], raw[3])
+    }
+
+    /**
+     * 像素内容哈希（64 位，xxHash 风格，NEON 加速；行跨度填充不参与）
+     *
+     * 用于判断两次捕获的背景是否相同。结果永不为 0，调用方可用 0 表示“未知”
+     *
+     * @param bitmap ARGB_8888 Bitmap（只读）
+     * @throws IllegalArgumentException 如果 Bitmap 不是 ARGB_8888 或无法锁定（如 HARDWARE Bitmap）
+     */
+    external fun hashBitmap(bitmap: Bitmap): Long
+
+    /**
+     * 模糊结果缓存中是否有对应条目（不复制，不计入命中统计）
+     *
+     * @param hash 背景内容哈希（hashBitmap）
+     * @param width 结果宽度
+     * @param height 结果高度
+     * @param method 模糊方式（自定义方式 >= BLUR_CACHE_CUSTOM_METHOD）
+     * @param variant 其余影响结果的选项（由调用方编码）
+     * @param sigma 高斯标准差
+     * @param saturation 饱和度系数（1.0 = 原始）
+     */
+    external fun blurCacheContains(
+        hash: Long,
+        width: Int,
+        height: Int,
+        method: Int,
+        variant: Int,
+        sigma: Float,
+        saturation: Float
+    ): Boolean
+
+    /**
+     * 查找缓存结果并复制到 destination（尺寸作为键的一部分）
+     *
+     * @param destination ARGB_8888, mutable
+     * 其余参数同 blurCacheContains
+     * @return true 如果命中
+     */
+    external fun blurCacheLookup(
+        hash: Long,
+        method: Int,
+        variant: Int,
+        sigma: Float,
+        saturation: Float,
+        destination: Bitmap
+    ): Boolean
+
+    /**
+     * 把模糊结果存入缓存（复制一份；相同键的旧条目被替换）
+     *
+     * @param source ARGB_8888（只读）
+     * 其余参数同 blurCacheContains
+     */
+    external fun blurCacheStore(
+        hash: Long,
+        method: Int,
+        variant: Int,
+        sigma: Float,
+        saturation: Float,
+        source: Bitmap
+    )
+
+    /**
+     * 设置模糊结果缓存容量（超出部分立即淘汰）
+     *
+     * @param entries 最大条目数（0 = 关闭缓存，管线不再计算背景哈希）
+     * @param maxBytes 所有条目的总字节数上限
+     */
+    external fun setBlurCacheCapacity(entries: Int, maxBytes: Long)
+
+    /**
+     * 清空模糊结果缓存
+     *
+     * @return 释放的字节数
+     */
+    external fun clearBlurCache(): Long
+
+    /**
+     * 原始缓存统计：[hits, misses, entries, bytes]
+     */
+    external fun blurCacheStatsRaw(): LongArray
+
+    /**
+     * 模糊结果缓存统计
+     *
+     * @property hits 累计命中次数
+     * @property misses 累计未命中次数
+     * @property entries 当前条目数
+     * @property bytes 当前占用字节数
+     */
+    data class BlurCacheStats(
+        val hits: Long,
+        val misses: Long,
+        val entries: Int,
+        val bytes: Long
+    )
+
+    /**
+     * 读取模糊结果缓存统计
+     */
+    fun blurCacheStats(): BlurCacheStats {
+        val raw = blurCacheStatsRaw()
+        return BlurCacheStats(raw[0], raw[1], raw[2].toInt(), raw[3])
+    }
+
+    /**
+     * 执行玻璃效果管线（带默认参数的便捷方法）
+     */
+    fun render(
+        backdrop: Bitmap,
+        result: Bitmap,
+        blurMode: Int = BLUR_SMART,
+        sigma: Float = 0f,
+        highQuality: Boolean = false,
+        saturation: Float = 1f,
+        effect: Int = EFFECT_NONE,
+        displacement: Bitmap? = null,
+        scale: Float = 70f,
+        redOffset: Float = 0f,
+        greenOffset: Float = -0.05f,
+        blueOffset: Float = -0.1f,
+        edgeDistance: Bitmap? = null,
+        normalMap: Bitmap? = null,
+        refThickness: Float = 100f,
+        refFactor: Float = 1.5f,
+        refDispersion: Float = 7f,
+        dpr: Float = 1f,
+        useBilinear: Boolean = true
+    ) {
+        renderGlassPipeline(
+            backdrop, displacement, edgeDistance, normalMap, result,
+            blurMode, sigma, highQuality, saturation,
+            effect, scale, redOffset, greenOffset, blueOffset,
+            refThickness, refFactor, refDispersion, dpr,
+            useBilinear
+        )
+    }
+
+    /**
+     * 批量区域模糊（原始格式：rects 为 [left, top, right, bottom] × n）
+     *
+     * @param outputs 每个矩形的输出 Bitmap（ARGB_8888，mutable，尺寸 = 矩形尺寸；null 跳过）
+     * @return 实际模糊的块数（合并后）；失败时为 -1
+     * @throws IllegalArgumentException 如果 rects 长度不是 4 的倍数、输出数量或尺寸不匹配
+     */
+    external fun blurRegionsRaw(
+        backdrop: Bitmap,
+        rects: IntArray,
+        outputs: Array<Bitmap?>,
+        blurMode: Int,
+        sigma: Float,
+        highQuality: Boolean,
+        saturation: Float
+    ): Int
+
+    /**
+     * 批量区域模糊，写入整帧 Bitmap 的对应位置（原始格式同 blurRegionsRaw）
+     *
+     * @param frame 整帧输出（ARGB_8888，mutable，与 backdrop 尺寸相同；矩形以外保持不变）
+     * @return 实际模糊的块数（合并后）；失败时为 -1
+     */
+    external fun blurRegionsIntoFrameRaw(
+        backdrop: Bitmap,
+        rects: IntArray,
+        frame: Bitmap,
+        blurMode: Int,
+        sigma: Float,
+        highQuality: Boolean,
+        saturation: Float
+    ): Int
+
+    /**
+     * 批量区域模糊：同一张整帧背景上的多个矩形（如 5-10 张玻璃卡片）共用一次模糊
+     *
+     * 每个矩形的结果与整帧模糊后裁剪一致，只执行模糊与饱和度阶段
+     *
+     * @param backdrop 整帧背景（ARGB_8888）
+     * @param rects 各视图在背景中的矩形（非空，须位于背景范围内）
+     * @return 每个矩形一张新 Bitmap（副本，顺序与 rects 相同）
+     */
+    fun blurRegions(
+        backdrop: Bitmap,
+        rects: List<Rect>,
+        blurMode: Int = BLUR_SMART,
+        sigma: Float = 0f,
+        highQuality: Boolean = false,
+        saturation: Float = 1f
+    ): List<Bitmap> {
+        require(rects.none { it.isEmpty }) { "Rects must not be empty" }
+        val outputs = Array<Bitmap?>(rects.size) { i ->
+            Bitmap.createBitmap(rects[i].width(), rects[i].height(), Bitmap.Config.ARGB_8888)
+        }
+        try {
+            blurRegionsRaw(backdrop, packRects(rects), outputs, blurMode, sigma, highQuality, saturation)
+        } catch (e: RuntimeException) {
+            outputs.forEach { it?.recycle() }
+            throw e
+        }
+        return outputs.map { it!! }
+    }
+
+    /**
+     * 批量区域模糊，结果写入整帧 Bitmap 中各矩形的位置（不为每个矩形分配 Bitmap）
+     *
+     * 调用方按矩形从 frame 中绘制（Canvas.drawBitmap(frame, rect, dst, paint)）即可，无需复制
+     *
+     * @param frame 整帧输出（与 backdrop 尺寸相同，可跨帧复用）
+     * @return 实际模糊的块数；失败时为 -1
+     */
+    fun blurRegionsIntoFrame(
+        backdrop: Bitmap,
+        rects: List<Rect>,
+        frame: Bitmap,
+        blurMode: Int = BLUR_SMART,
+        sigma: Float = 0f,
+        highQuality: Boolean = false,
+        saturation: Float = 1f
+    ): Int {
+        return blurRegionsIntoFrameRaw(backdrop, packRects(rects), frame, blurMode, sigma, highQuality, saturation)
+    }
+
+    private fun packRects(rects: List<Rect>): IntArray {
+        val raw = IntArray(rects.size * 4)
+        rects.forEachIndexed { i, r ->
+            raw[i * 4] = r.left
+            raw[i * 4 + 1] = r.top
+            raw[i * 4 + 2] = r.right
+            raw[i * 4 + 3] = r.bottom
+        }
+        return raw
+    }
+
+    /**
+     * 将 BlurMethod 映射为管线模糊方式
+     *
+     * @return 对应的 BLUR_* 常量；管线不支持的方法（Kotlin 盒式 / 降采样类）返回 null
+     */
+    fun blurModeFor(method: BlurMethod): Int? {
+        return when (method) {
+            BlurMethod.IIR_GAUSSIAN, BlurMethod.IIR_GAUSSIAN_NEON -> BLUR_IIR
+            BlurMethod.BOX3 -> BLUR_BOX3
+            BlurMethod.SMART -> BLUR_SMART
+            BlurMethod.PYRAMID -> BLUR_PYRAMID
+            BlurMethod.BOX_BLUR, BlurMethod.BOX_BLUR_CPP, BlurMethod.DOWNSAMPLE -> null
+        }
+    }
+}
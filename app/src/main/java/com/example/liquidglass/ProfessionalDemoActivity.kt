@@ -13,6 +13,7 @@ package com.example.liquidglass
 
 import android.Manifest
 import android.app.Activity
+import android.content.ComponentCallbacks2
 import android.content.Context
 import android.content.Intent
 import android.content.pm.PackageManager
@@ -36,6 +37,8 @@ import androidx.core.app.ActivityCompat
 import androidx.core.content.ContextCompat
 import androidx.core.view.GravityCompat
 import androidx.drawerlayout.widget.DrawerLayout
+import com.example.blur.NativeGauss
+import com.example.blur.SmartBlurTuner
 import com.google.android.material.floatingactionbutton.FloatingActionButton
 import java.util.Locale
 
@@ -128,6 +131,9 @@ class ProfessionalDemoActivity : AppCompatActivity() {
 
         super.onCreate(savedInstanceState)
 
+        // 加载（或在后台校准）smartBlur 的交叉点表
+        SmartBlurTuner.ensureCalibrated(applicationContext)
+
         // 创建主布局
         createMainLayout()
 
@@ -1270,7 +1276,8 @@ class ProfessionalDemoActivity : AppCompatActivity() {
             getString(R.string.blur_method_iir),
             getString(R.string.blur_method_neon),
             getString(R.string.blur_method_box3),
-            getString(R.string.blur_method_downsample)
+            getString(R.string.blur_method_downsample),
+            getString(R.string.blur_method_pyramid)
         )
         val blurAdapter = ArrayAdapter(this, android.R.layout.simple_spinner_item, blurMethods)
         blurAdapter.setDropDownViewResource(android.R.layout.simple_spinner_dropdown_item)
@@ -1287,6 +1294,7 @@ class ProfessionalDemoActivity : AppCompatActivity() {
                     4 -> BlurMethod.IIR_GAUSSIAN_NEON
                     5 -> BlurMethod.BOX3
                     6 -> BlurMethod.DOWNSAMPLE
+                    7 -> BlurMethod.PYRAMID
                     else -> BlurMethod.SMART
                 }
                 tvBlurMethod.text = "${getString(R.string.current_blur_method).substringBefore(':')}：${blurMethods[position]}"
@@ -1442,7 +1450,7 @@ class ProfessionalDemoActivity : AppCompatActivity() {
             var process: Process? = null
             var reader: java.io.BufferedReader? = null
             try {
-                process = Runtime.getRuntime().exec("logcat -d -s LiquidGlassView:D NativeGauss:D -t 20")
+                process = Runtime.getRuntime().exec("logcat -d -s LiquidGlassView:D -t 20")
                 reader = java.io.BufferedReader(java.io.InputStreamReader(process.inputStream))
                 var line: String?
                 var captureTime = ""
@@ -1467,8 +1475,8 @@ class ProfessionalDemoActivity : AppCompatActivity() {
                             totalTime = it.substringAfter("总耗时: ").substringBefore("ms").trim()
                         }
                         // 提取图片尺寸信息
-                        if (it.contains("gaussianIIRNeonInplace:") || it.contains("box3Inplace:")) {
-                            // 格式: "gaussianIIRNeonInplace: 550x304, sigma=1.98"
+                        if (it.contains("模糊尺寸:")) {
+                            // 格式: "📐 模糊尺寸: 550x304"
                             val sizeMatch = Regex("(\\d+)x(\\d+)").find(it)
                             if (sizeMatch != null) {
                                 blurredSize = "${sizeMatch.groupValues[1]}×${sizeMatch.groupValues[2]}"
@@ -1492,6 +1500,7 @@ class ProfessionalDemoActivity : AppCompatActivity() {
                         BlurMethod.IIR_GAUSSIAN_NEON -> "NEON"
                         BlurMethod.BOX3 -> "Box3"
                         BlurMethod.DOWNSAMPLE -> "下采样"
+                        BlurMethod.PYRAMID -> "金字塔"
                     }
 
                     val aberrationMethodName = when (glassView.chromaticAberrationMode) {
@@ -1567,6 +1576,22 @@ class ProfessionalDemoActivity : AppCompatActivity() {
         // 释放背景图片资源
         customBackgroundBitmap?.recycle()
         customBackgroundBitmap = null
+
+        // 释放原生临时缓冲池与模糊结果缓存
+        NativeGauss.releaseScratch()
+        NativeGlassPipeline.clearBlurCache()
+    }
+
+    override fun onTrimMemory(level: Int) {
+        super.onTrimMemory(level)
+
+        // 界面不可见或系统内存紧张时，归还原生模糊的临时缓冲与结果缓存（下一帧按需重新分配）
+        if (level >= ComponentCallbacks2.TRIM_MEMORY_RUNNING_LOW) {
+            val released = NativeGauss.releaseScratch()
+            val cached = NativeGlassPipeline.clearBlurCache()
+            Log.d("ProfessionalDemo", "onTrimMemory($level): released ${released / 1024} KB native scratch, " +
+                    "${cached / 1024} KB blur cache")
+        }
     }
 
     override fun onBackPressed() {
@@ -1589,6 +1614,7 @@ class ProfessionalDemoActivity : AppCompatActivity() {
             BlurMethod.IIR_GAUSSIAN_NEON -> "C++ 递归高斯(NEON)"
             BlurMethod.BOX3 -> "3次盒式近似高斯"
             BlurMethod.DOWNSAMPLE -> "下采样优化管线"
+            BlurMethod.PYRAMID -> "多级金字塔模糊 (大半径)"
         }
     }
 